@@ -0,0 +1,128 @@
+	.text
+	.file	"string_lib.ll"
+	.globl	__string_equal__                # -- Begin function __string_equal__
+	.p2align	4, 0x90
+	.type	__string_equal__,@function
+__string_equal__:                       # @__string_equal__
+	.cfi_startproc
+# %bb.0:
+	subq	$24, %rsp
+	.cfi_def_cfa_offset 32
+	movq	%rdi, 16(%rsp)
+	movq	%rsi, 8(%rsp)
+	callq	strcmp@PLT
+	testl	%eax, %eax
+	sete	%al
+	addq	$24, %rsp
+	.cfi_def_cfa_offset 8
+	retq
+.Lfunc_end0:
+	.size	__string_equal__, .Lfunc_end0-__string_equal__
+	.cfi_endproc
+                                        # -- End function
+	.globl	__string_not_equal__            # -- Begin function __string_not_equal__
+	.p2align	4, 0x90
+	.type	__string_not_equal__,@function
+__string_not_equal__:                   # @__string_not_equal__
+	.cfi_startproc
+# %bb.0:
+	subq	$24, %rsp
+	.cfi_def_cfa_offset 32
+	movq	%rdi, 16(%rsp)
+	movq	%rsi, 8(%rsp)
+	callq	strcmp@PLT
+	testl	%eax, %eax
+	setne	%al
+	addq	$24, %rsp
+	.cfi_def_cfa_offset 8
+	retq
+.Lfunc_end1:
+	.size	__string_not_equal__, .Lfunc_end1-__string_not_equal__
+	.cfi_endproc
+                                        # -- End function
+	.globl	__string_copy__                 # -- Begin function __string_copy__
+	.p2align	4, 0x90
+	.type	__string_copy__,@function
+__string_copy__:                        # @__string_copy__
+	.cfi_startproc
+# %bb.0:
+	subq	$24, %rsp
+	.cfi_def_cfa_offset 32
+	movq	%rdi, 16(%rsp)
+	callq	strlen@PLT
+	movq	%rax, 8(%rsp)
+	leaq	1(%rax), %rdi
+	callq	malloc@PLT
+	movq	%rax, (%rsp)
+	movq	16(%rsp), %rsi
+	movq	%rax, %rdi
+	callq	strcpy@PLT
+	movq	8(%rsp), %rax
+	movq	(%rsp), %rcx
+	movb	$0, (%rcx,%rax)
+	movq	(%rsp), %rax
+	addq	$24, %rsp
+	.cfi_def_cfa_offset 8
+	retq
+.Lfunc_end2:
+	.size	__string_copy__, .Lfunc_end2-__string_copy__
+	.cfi_endproc
+                                        # -- End function
+	.globl	__string_concat__               # -- Begin function __string_concat__
+	.p2align	4, 0x90
+	.type	__string_concat__,@function
+__string_concat__:                      # @__string_concat__
+	.cfi_startproc
+# %bb.0:
+	subq	$40, %rsp
+	.cfi_def_cfa_offset 48
+	movq	%rdi, 32(%rsp)
+	movq	%rsi, 16(%rsp)
+	callq	strlen@PLT
+	movq	%rax, 8(%rsp)
+	movq	16(%rsp), %rdi
+	callq	strlen@PLT
+	movq	%rax, 24(%rsp)
+	movq	8(%rsp), %rcx
+	leaq	(%rcx,%rax), %rdi
+	addq	$1, %rdi
+	callq	malloc@PLT
+	movq	%rax, (%rsp)
+	movq	32(%rsp), %rsi
+	movq	%rax, %rdi
+	callq	strcpy@PLT
+	movq	(%rsp), %rdi
+	addq	8(%rsp), %rdi
+	movq	16(%rsp), %rsi
+	callq	strcpy@PLT
+	movq	8(%rsp), %rax
+	addq	24(%rsp), %rax
+	movq	(%rsp), %rcx
+	movb	$0, (%rcx,%rax)
+	movq	(%rsp), %rax
+	addq	$40, %rsp
+	.cfi_def_cfa_offset 8
+	retq
+.Lfunc_end3:
+	.size	__string_concat__, .Lfunc_end3-__string_concat__
+	.cfi_endproc
+                                        # -- End function
+	.globl	__string_free__                 # -- Begin function __string_free__
+	.p2align	4, 0x90
+	.type	__string_free__,@function
+__string_free__:                        # @__string_free__
+	.cfi_startproc
+# %bb.0:
+	pushq	%rax
+	.cfi_def_cfa_offset 16
+	movq	%rdi, (%rsp)
+	callq	free@PLT
+	popq	%rax
+	.cfi_def_cfa_offset 8
+	retq
+.Lfunc_end4:
+	.size	__string_free__, .Lfunc_end4-__string_free__
+	.cfi_endproc
+                                        # -- End function
+	.ident	"clang version 3.7.0 (tags/RELEASE_370/final)"
+	.section	".note.GNU-stack","",@progbits
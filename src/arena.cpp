@@ -0,0 +1,61 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+
+namespace arena {
+
+
+thread_local Arena* current_arena = nullptr;
+
+// Large enough for the nodes of most functions; bigger ones take a few blocks.
+static const std::size_t kBlockSize = 32 * 1024;
+
+
+// Arena - member function definitions
+
+Arena* Arena::open () {
+    Arena* arena = new Arena();
+    arena->previous_ = current_arena;
+    current_arena = arena;
+    return arena;
+}
+
+void Arena::close () {
+    if (current_arena == this) {
+        current_arena = previous_;
+    }
+    closed_ = true;
+    if (live_ == 0) {
+        delete this;
+    }
+}
+
+Arena::Arena () : previous_(nullptr) {}
+
+Arena::~Arena () {
+    for (void* block : blocks_) {
+        ::operator delete(block);
+    }
+}
+
+// Starts a new block, or gives an object too large for one a block of its own.
+std::uintptr_t Arena::grow_ (std::size_t size, std::size_t alignment) {
+    std::size_t block_size = std::max(kBlockSize, size + alignment);
+    void* block = ::operator new(block_size);
+    blocks_.push_back(block);
+
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(block);
+    std::uintptr_t p = (begin + alignment - 1) & ~(alignment - 1);
+    if (block_size == kBlockSize) {
+        next_ = p + size;
+        end_  = begin + block_size;
+    }
+    return p;
+}
+
+
+}  // namespace arena
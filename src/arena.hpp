@@ -0,0 +1,159 @@
+#ifndef __CSTR_COMPILER__ARENA_HPP
+#define __CSTR_COMPILER__ARENA_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+#include "stats.hpp"
+
+
+namespace arena {
+
+
+// Bump allocator owning the AST nodes, symbols and symbol tables of one
+// function definition. Nothing is freed individually: the memory is released
+// all at once, when the arena has been closed and the last object allocated
+// from it has been released. That is usually as soon as the function's code
+// has been generated; in whole-module mode (see ast::Module) it is when the
+// module goes away.
+//
+// Objects must be released on the thread that allocated them, like the
+// memory of stats::allocate().
+class Arena {
+  public:
+    // Creates an arena and makes it the current one of this thread.
+    static Arena* open ();
+
+    // Stops allocating from the arena, and makes the arena that was current
+    // before open() the current one again. The arena may be deleted by the
+    // call.
+    void close ();
+
+    void* allocate (std::size_t size, std::size_t alignment) {
+        std::uintptr_t p = (next_ + alignment - 1) & ~(alignment - 1);
+        if (p + size > end_) {
+            p = grow_(size, alignment);
+        } else {
+            next_ = p + size;
+        }
+        ++live_;
+        return reinterpret_cast<void*>(p);
+    }
+
+    // The memory itself is only reclaimed with the rest of the arena.
+    void deallocate () {
+        if (--live_ == 0 and closed_) {
+            delete this;
+        }
+    }
+
+    Arena             (const Arena&) = delete;
+    Arena& operator = (const Arena&) = delete;
+
+  private:
+    Arena ();
+    ~Arena ();
+
+    std::uintptr_t grow_ (std::size_t size, std::size_t alignment);
+
+    std::vector<void*> blocks_;
+    std::uintptr_t     next_   = 0;  // Free space of the last block.
+    std::uintptr_t     end_    = 0;
+    std::size_t        live_   = 0;  // Objects not released yet.
+    bool               closed_ = false;
+    Arena*             previous_;
+};
+
+
+// The arena new objects are allocated from on this thread, or nullptr for the
+// heap.
+extern thread_local Arena* current_arena;
+
+inline Arena* current () { return current_arena; }
+
+
+// The arena of the function definition being parsed, if any. Closes it on
+// destruction, in case an error ended the parse in the middle of a function.
+class Scope {
+  public:
+    Scope () : arena_(nullptr) {}
+    ~Scope () { close(); }
+
+    Scope             (const Scope&) = delete;
+    Scope& operator = (const Scope&) = delete;
+
+    void open () {
+        close();
+        arena_ = Arena::open();
+    }
+
+    void close () {
+        if (arena_) {
+            arena_->close();
+            arena_ = nullptr;
+        }
+    }
+
+  private:
+    Arena* arena_;
+};
+
+
+// Standard allocator placing objects in the arena that was current when it was
+// constructed (or the heap if there was none), and charging their size to
+// `pool` like stats::Allocator. Containers keep allocating from the arena they
+// were created in.
+template <typename T, stats::Pool pool>
+class Allocator {
+  public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind { typedef Allocator<U, pool> other; };
+
+    Allocator () : arena_(current()) {}
+
+    template <typename U>
+    Allocator (const Allocator<U, pool>& other) : arena_(other.arena()) {}
+
+    Arena* arena () const { return arena_; }
+
+    T* allocate (std::size_t n) {
+        if (not arena_) {
+            return static_cast<T*>(stats::allocate(pool, n * sizeof(T)));
+        }
+        stats::charge(pool, n * sizeof(T));
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate (T* p, std::size_t n) {
+        if (not arena_) {
+            stats::deallocate(pool, p, n * sizeof(T));
+            return;
+        }
+        stats::discharge(pool, n * sizeof(T));
+        arena_->deallocate();
+    }
+
+  private:
+    Arena* arena_;
+};
+
+template <typename T, typename U, stats::Pool pool>
+bool operator == (const Allocator<T, pool>& a, const Allocator<U, pool>& b) {
+    return a.arena() == b.arena();
+}
+
+template <typename T, typename U, stats::Pool pool>
+bool operator != (const Allocator<T, pool>& a, const Allocator<U, pool>& b) {
+    return a.arena() != b.arena();
+}
+
+
+}  // namespace arena
+
+
+#endif  // __CSTR_COMPILER__ARENA_HPP
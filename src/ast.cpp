@@ -1,7 +1,209 @@
-
 #include "ast.hpp"
 
 
 namespace ast {
 
+
+thread_local Expression_Store::Ptr current_store;
+
+
+// Expression_Store - member function definitions
+
+const Expression_Store::Ptr& Expression_Store::current () {
+    if (not current_store) {
+        current_store = std::allocate_shared<Expression_Store>(
+            stats::Allocator<Expression_Store, stats::Pool::AST>());
+    }
+    return current_store;
+}
+
+std::uint32_t Expression_Store::add_ (
+    Kind kind,
+    parser::Type type,
+    std::uint8_t op,
+    std::uint32_t lhs,
+    std::uint32_t rhs
+) {
+    kinds_.push_back(static_cast<std::uint8_t>(kind));
+    types_.push_back(static_cast<std::uint8_t>(type));
+    ops_.push_back(op);
+    lhs_.push_back(lhs);
+    rhs_.push_back(rhs);
+    return size() - 1;
+}
+
+std::uint32_t Expression_Store::operand_ (const Expression& operand) const {
+    if (operand.store_ != this) {
+        throw std::logic_error("Operand from another expression store.");
+    }
+    return operand.id_;
+}
+
+
+// Node - member function definitions
+
+// The instructions being released by a call to Node::release_() further up
+// the stack of this thread, if any.
+static thread_local std::vector<Instruction::Ptr>* released_instructions = nullptr;
+
+void Node::release_ (Instruction::Ptr& node) {
+    if (not node) {
+        return;
+    }
+    if (released_instructions) {
+        released_instructions->push_back(std::move(node));
+        return;
+    }
+
+    std::vector<Instruction::Ptr> released;
+    released.push_back(std::move(node));
+    released_instructions = &released;
+    while (not released.empty()) {
+        // Destroying it may add its children.
+        Instruction::Ptr last = std::move(released.back());
+        released.pop_back();
+        last.reset();
+    }
+    released_instructions = nullptr;
+}
+
+
+// Store_Scope - member function definitions
+
+void Store_Scope::open (Expression_Store::Ptr store) {
+    close();
+    if (not store) {
+        store = std::allocate_shared<Expression_Store>(
+            stats::Allocator<Expression_Store, stats::Pool::AST>());
+    }
+    previous_ = std::move(current_store);
+    current_store = std::move(store);
+    open_ = true;
+}
+
+void Store_Scope::close () {
+    if (open_) {
+        current_store = std::move(previous_);
+        previous_.reset();
+        open_ = false;
+    }
+}
+
+
+// Views - member function definitions
+
+Variable Variable::add (Expression_Store& store, const parser::Symbol::Ptr& symbol) {
+    // `symbol` may be that of another variable of the store.
+    parser::Type type = symbol->type();
+    std::uint32_t symbols = static_cast<std::uint32_t>(store.symbols_.size());
+    store.symbols_.push_back(symbol);
+    return Variable(Expression(&store, store.add_(kKind, type, 0, symbols, 0)));
+}
+
+Const_Integer Const_Integer::add (Expression_Store& store, int value) {
+    return Const_Integer(Expression(&store,
+        store.add_(kKind, parser::Type::INT, 0, static_cast<std::uint32_t>(value), 0)));
+}
+
+Const_String Const_String::add (Expression_Store& store, const std::string& value) {
+    std::uint32_t strings = static_cast<std::uint32_t>(store.strings_.size());
+    store.strings_.push_back(value);
+    return Const_String(Expression(&store, store.add_(kKind, parser::Type::STRING, 0, strings, 0)));
+}
+
+Unary_Expression Unary_Expression::add (Expression_Store& store, const Expression& rhs) {
+    return Unary_Expression(Expression(&store, store.add_(kKind, parser::Type::INT,
+        static_cast<std::uint8_t>(Operation::SUBTRACTION), 0, store.operand_(rhs))));
+}
+
+Binary_Expression Binary_Expression::add (
+    Expression_Store& store,
+    const parser::Type& type,
+    Operation op,
+    const Expression& lhs,
+    const Expression& rhs
+) {
+    return Binary_Expression(Expression(&store, store.add_(kKind, type,
+        static_cast<std::uint8_t>(op), store.operand_(lhs), store.operand_(rhs))));
+}
+
+Condition Condition::add (
+    Expression_Store& store,
+    Comparison_Operation op,
+    const Expression& lhs,
+    const Expression& rhs
+) {
+    return Condition(Expression(&store, store.add_(kKind, lhs.type(),
+        static_cast<std::uint8_t>(op), store.operand_(lhs), store.operand_(rhs))));
+}
+
+Assignment Assignment::add (Expression_Store& store, const Variable& lhs, const Expression& rhs) {
+    return Assignment(Expression(&store, store.add_(kKind, lhs.type(), 0,
+        store.operand_(lhs), store.operand_(rhs))));
+}
+
+Function_Call Function_Call::add (Expression_Store& store, const parser::Function::Ptr& function) {
+    const Expression* none = nullptr;
+    return add_(store, function, none, none);
+}
+
+Expression Argument_List::operator [] (std::size_t i) const {
+    return Expression(store_, store_->arguments_[first_ + 1 + i]);
+}
+
+
+const char* kind_name (Kind kind) {
+    switch (kind) {
+        case Kind::DECLARATION_LIST:        return "Declaration_List";
+        case Kind::VARIABLE:                return "Variable";
+        case Kind::CONST_INTEGER:           return "Const_Integer";
+        case Kind::CONST_STRING:            return "Const_String";
+        case Kind::UNARY_EXPRESSION:        return "Unary_Expression";
+        case Kind::BINARY_EXPRESSION:       return "Binary_Expression";
+        case Kind::CONDITION:               return "Condition";
+        case Kind::ASSIGNMENT:              return "Assignment";
+        case Kind::FUNCTION_CALL:           return "Function_Call";
+        case Kind::INSTRUCTION:             return "Instruction";
+        case Kind::EXPRESSION_INSTRUCTION:  return "Expression_Instruction";
+        case Kind::COND_INSTRUCTION:        return "Cond_Instruction";
+        case Kind::WHILE_INSTRUCTION:       return "While_Instruction";
+        case Kind::DO_INSTRUCTION:          return "Do_Instruction";
+        case Kind::FOR_INSTRUCTION:         return "For_Instruction";
+        case Kind::RETURN_INSTRUCTION:      return "Return_Instruction";
+        case Kind::COMPOUND_INSTRUCTION:    return "Compound_Instruction";
+        case Kind::FUNCTION_DECLARATION:    return "Function_Declaration";
+        case Kind::FUNCTION_DEFINITION:     return "Function_Definition";
+        default:                            return "(unknown)";
+    }
+}
+
+
+// Work_List - member function definitions
+
+void Work_List::run (Step step) {
+    // Steps may run lists of their own.
+    std::size_t bottom = stack_.size();
+    std::vector<Step> outer;
+    outer.swap(added_);
+
+    stack_.push_back(std::move(step));
+    try {
+        while (stack_.size() > bottom) {
+            Step next = std::move(stack_.back());
+            stack_.pop_back();
+            next();
+            stack_.insert(std::end(stack_),
+                std::make_move_iterator(added_.rbegin()),
+                std::make_move_iterator(added_.rend()));
+            added_.clear();
+        }
+    } catch (...) {
+        stack_.resize(bottom);
+        added_.swap(outer);
+        throw;
+    }
+    added_.swap(outer);
+}
+
+
 }  // namespace ast
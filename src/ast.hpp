@@ -4,22 +4,35 @@
 
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
 
+#include "arena.hpp"
+#include "stats.hpp"
 #include "symbol.hpp"
 
 
+namespace ast_image {
+
+class Reader;
+class Writer;
+
+}  // namespace ast_image
+
+
 namespace ast {
 
 
 class Node;
 class Expression;
-class Terminal;
 class Declaration_List;
 class Variable;
 class Const_Integer;
@@ -41,77 +54,139 @@ class Function_Declaration;
 class Function_Definition;
 
 
-// Visitor base class for code generation.
+// Lists owned by AST nodes. Their memory is charged to the AST in
+// --mem-report, whatever list they were built from, and comes from the arena
+// of the function being parsed, like the nodes.
+template <typename T>
+using List = std::vector<T, arena::Allocator<T, stats::Pool::AST>>;
+
+
+// The code of nested instructions is generated from an explicit stack rather
+// than recursively, so that the depth of nesting is only bound by memory.
+// Instead of generating the instructions nested in it itself, a visit hands
+// them to generate(), and the code that goes after each of them to then():
+// these steps run in the order they were added once the visit has returned,
+// before the steps added earlier by the visits of enclosing instructions.
+// Node::emit_code() runs all the steps of the tree it is called on before it
+// returns.
+class Work_List {
+  public:
+    typedef std::function<void ()> Step;
+
+    // Runs `step`, then the steps it adds, and so on until none is left.
+    void run (Step step);
+
+    void then (Step step) { added_.push_back(std::move(step)); }
+
+    template <typename Generator>
+    void generate (Generator& generator, const std::shared_ptr<Instruction>& node);
+
+  private:
+    std::vector<Step> stack_;  // Next step last.
+    std::vector<Step> added_;  // By the step running, in order.
+};
+
+
+// Visitor base class for code generation. Nodes are visited by reference (see
+// Node::emit_code()); a visit that needs to keep a node takes a shared_ptr to
+// it with ast::shared(). Expressions are visited through views (see
+// Expression::emit_code()), which can simply be copied.
 class Code_Generator {
   public:
-    virtual void visit (std::shared_ptr<Node> node) {
-        throw std::runtime_error("This code generator does not implement a handler for node class 'Node'.");
-    }
-    virtual void visit (std::shared_ptr<Expression> node) {
-        throw std::runtime_error("This code generator does not implement a handler for node class 'Expression'.");
-    }
-    virtual void visit (std::shared_ptr<Terminal> node) {
-        throw std::runtime_error("This code generator does not implement a handler for node class 'Terminal'.");
-    }
-    virtual void visit (std::shared_ptr<Declaration_List> node) {
+    // Called by Expression::emit_code() on each expression before its
+    // operands are visited, where visit() is called after them.
+    virtual void enter (const Expression& node) {}
+
+    virtual void visit (Declaration_List& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Declaration'.");
     }
-    virtual void visit (std::shared_ptr<Variable> node) {
+    virtual void visit (Variable& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Variable'.");
     }
-    virtual void visit (std::shared_ptr<Const_Integer> node) {
+    virtual void visit (Const_Integer& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Const_Integer'.");
     }
-    virtual void visit (std::shared_ptr<Const_String> node) {
+    virtual void visit (Const_String& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Const_String'.");
     }
-    virtual void visit (std::shared_ptr<Unary_Expression> node) {
+    virtual void visit (Unary_Expression& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Unary_Expression'.");
     }
-    virtual void visit (std::shared_ptr<Binary_Expression> node) {
+    virtual void visit (Binary_Expression& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Binary_Expression'.");
     }
-    virtual void visit (std::shared_ptr<Condition> node) {
+    virtual void visit (Condition& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Condition'.");
     }
-    virtual void visit (std::shared_ptr<Assignment> node) {
+    virtual void visit (Assignment& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Assignment'.");
     }
-    virtual void visit (std::shared_ptr<Function_Call> node) {
+    virtual void visit (Function_Call& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Function_Call'.");
     }
-    virtual void visit (std::shared_ptr<Instruction> node) {
+    virtual void visit (Instruction& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Instruction'.");
     }
-    virtual void visit (std::shared_ptr<Expression_Instruction> node) {
+    virtual void visit (Expression_Instruction& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Expression_Instruction'.");
     }
-    virtual void visit (std::shared_ptr<Cond_Instruction> node) {
+    virtual void visit (Cond_Instruction& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Cond_Instruction'.");
     }
-    virtual void visit (std::shared_ptr<While_Instruction> node) {
+    virtual void visit (While_Instruction& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'While_Instruction'.");
     }
-    virtual void visit (std::shared_ptr<Do_Instruction> node) {
+    virtual void visit (Do_Instruction& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Do_Instruction'.");
     }
-    virtual void visit (std::shared_ptr<For_Instruction> node) {
+    virtual void visit (For_Instruction& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'For_Instruction'.");
     }
-    virtual void visit (std::shared_ptr<Return_Instruction> node) {
+    virtual void visit (Return_Instruction& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Return_Instruction'.");
     }
-    virtual void visit (std::shared_ptr<Compound_Instruction> node) {
+    virtual void visit (Compound_Instruction& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Compound_Instruction'.");
     }
-    virtual void visit (std::shared_ptr<Function_Declaration> node) {
+    virtual void visit (Function_Declaration& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Function_Declaration'.");
     }
-    virtual void visit (std::shared_ptr<Function_Definition> node) {
+    virtual void visit (Function_Definition& node) {
         throw std::runtime_error("This code generator does not implement a handler for node class 'Function_Definition'.");
     }
+
+  protected:
+    friend class Node;
+
+    Work_List work_;
+};
+
+// Concrete node classes, e.g. for the statistics of --time-report.
+enum class Kind : std::size_t {
+    DECLARATION_LIST,
+    VARIABLE,
+    CONST_INTEGER,
+    CONST_STRING,
+    UNARY_EXPRESSION,
+    BINARY_EXPRESSION,
+    CONDITION,
+    ASSIGNMENT,
+    FUNCTION_CALL,
+    INSTRUCTION,
+    EXPRESSION_INSTRUCTION,
+    COND_INSTRUCTION,
+    WHILE_INSTRUCTION,
+    DO_INSTRUCTION,
+    FOR_INSTRUCTION,
+    RETURN_INSTRUCTION,
+    COMPOUND_INSTRUCTION,
+    FUNCTION_DECLARATION,
+    FUNCTION_DEFINITION,
+    kSize
 };
 
+const char* kind_name (Kind kind);
+
 enum class Operation {
     ADDITION,
     SUBTRACTION,
@@ -138,48 +213,258 @@ class Node : public std::enable_shared_from_this<Node> {
 
     virtual ~Node () {}
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    Kind kind () const { return kind_; }
+
+    // Calls the visit() of `generator` for the class of the node, found from
+    // its kind rather than through a virtual call, and without taking a
+    // reference to the node. With a generator whose visits are final, all
+    // calls are direct; the children of a node should be visited this way,
+    // with *this, or handed to the Work_List of the generator. Returns once
+    // the code of the whole tree has been generated.
+    template <typename Generator>
+    void emit_code (Generator& generator);
 
   protected:
-    template <typename T>
-    std::shared_ptr<T> self (T*) {
-        return std::static_pointer_cast<T>(shared_from_this());
-    }
+    explicit Node (Kind kind) : kind_(kind) {}
+
+    // Drops `node`, a child of the node being destroyed. The instructions it
+    // is the last owner of are destroyed one after the other from a list,
+    // instead of each from the destructor of its parent, so that the depth
+    // of nesting of a tree is not bound by the stack.
+    static void release_ (std::shared_ptr<Instruction>& node);
+
+  private:
+    friend class Work_List;
+
+    const Kind kind_;
+
+    // Calls the visit() of `generator` for this node alone.
+    template <typename Generator>
+    void visit_ (Generator& generator);
+};
+
+// Expressions are not objects of their own. Those of a function definition
+// are the rows of an Expression_Store, a structure of arrays in which the
+// operands of an expression are the indices of their rows; Expression and its
+// subclasses are views of a row (a pointer to the store and the index),
+// passed around by value. They are visited like the other nodes, but are
+// created with ast::make() in the current store (see Store_Scope).
+class Expression_Store {
+  public:
+    typedef std::shared_ptr<Expression_Store> Ptr;
+
+    // Number of expressions in the store.
+    std::uint32_t size () const { return static_cast<std::uint32_t>(kinds_.size()); }
+
+    // The store of this thread new expressions are added to: that of the
+    // function definition being parsed or rewritten, or else one the thread
+    // keeps for the expressions created outside of any (e.g. in the unit
+    // tests).
+    static const Ptr& current ();
+
+  private:
+    friend class Expression;
+    friend class Variable;
+    friend class Const_Integer;
+    friend class Const_String;
+    friend class Unary_Expression;
+    friend class Binary_Expression;
+    friend class Condition;
+    friend class Assignment;
+    friend class Function_Call;
+    friend class Argument_List;
+
+    // Reads and writes the arrays as they are.
+    friend class ast_image::Reader;
+    friend class ast_image::Writer;
 
     template <typename T>
-    const std::shared_ptr<T const> self (T const*) const {
-        return std::static_pointer_cast<T const>(shared_from_this());
-    }
+    using Array = std::vector<T, stats::Allocator<T, stats::Pool::AST>>;
+
+    // Adds a row, and returns its index.
+    std::uint32_t add_ (Kind kind, parser::Type type, std::uint8_t op,
+                        std::uint32_t lhs, std::uint32_t rhs);
+
+    // The index of the row of `operand`, which must be in this store.
+    std::uint32_t operand_ (const Expression& operand) const;
+
+    // One element per row. What `lhs_` and `rhs_` hold depends on the kind:
+    //   Variable           lhs_: index in symbols_
+    //   Const_Integer      lhs_: value
+    //   Const_String       lhs_: index in strings_
+    //   Unary_Expression   rhs_: operand
+    //   Binary_Expression,
+    //   Condition,
+    //   Assignment         lhs_, rhs_: operands
+    //   Function_Call      lhs_: index in functions_
+    //                      rhs_: index in arguments_ of the number of
+    //                            arguments, followed by the arguments
+    Array<std::uint8_t>  kinds_;
+    Array<std::uint8_t>  types_;
+    Array<std::uint8_t>  ops_;    // Operation or Comparison_Operation
+    Array<std::uint32_t> lhs_;
+    Array<std::uint32_t> rhs_;
+
+    // Operands that do not fit in a row.
+    Array<parser::Symbol::Ptr>   symbols_;
+    Array<parser::Function::Ptr> functions_;
+    Array<std::string>           strings_;
+    Array<std::uint32_t>         arguments_;
 };
 
-// e.g. 0, 0+1, 1-2, a, a+b, a-b, a+(c+d)
-class Expression : public Node {
+
+// Makes a store the current one of this thread (see
+// Expression_Store::current()) from open() until close(), after which the
+// store that was current before is again. The parser opens a new store for
+// each function definition, and the passes the store of the definition they
+// rewrite.
+class Store_Scope {
   public:
-    typedef std::shared_ptr<Expression> Ptr;
+    Store_Scope () : open_(false) {}
+    ~Store_Scope () { close(); }
+
+    Store_Scope             (const Store_Scope&) = delete;
+    Store_Scope& operator = (const Store_Scope&) = delete;
 
-    Expression (const parser::Type& type)
-          : type_(type) {}
+    // Opens `store`, or a new store if nullptr.
+    void open (Expression_Store::Ptr store = nullptr);
+    void close ();
+
+  private:
+    bool                  open_;
+    Expression_Store::Ptr previous_;
+};
 
-    const parser::Type& type () const { return type_; }
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
+// e.g. 0, 0+1, 1-2, a, a+b, a-b, a+(c+d)
+//
+// A view of any kind of expression. Views of the subclasses are made from it
+// when its kind is known, like a static_cast.
+class Expression {
+  public:
+    // A view of no expression.
+    Expression () : store_(nullptr), id_(0) {}
+
+    explicit operator bool () const { return store_ != nullptr; }
+
+    Kind         kind () const { return static_cast<Kind>(store_->kinds_[id_]); }
+    parser::Type type () const { return static_cast<parser::Type>(store_->types_[id_]); }
+
+    // Index of the expression in its store. Those of a function definition
+    // are numbered from 0 (see Value_Table).
+    std::uint32_t id () const { return id_; }
+
+    // Visits the tree of the expression, from an explicit stack rather than
+    // recursively: the operands of an expression are visited before it, left
+    // to right, and the visit() of `generator` for the class of each is
+    // called with a view of that class. Visits therefore never visit their
+    // operands themselves; what they need done first goes in the enter() of
+    // the generator.
+    template <typename Generator>
+    void emit_code (Generator& generator) const;
+
+    // Whether both are views of the same expression.
+    bool operator == (const Expression& other) const {
+        return store_ == other.store_ and id_ == other.id_;
     }
+    bool operator != (const Expression& other) const { return not (*this == other); }
+
+    // A view of the expression `id` of `store`.
+    Expression (Expression_Store* store, std::uint32_t id)
+          : store_(store), id_(id) {}
+
+  protected:
+    friend class Expression_Store;
+
+    std::uint8_t  op_  () const { return store_->ops_[id_]; }
+    std::uint32_t lhs_ () const { return store_->lhs_[id_]; }
+    std::uint32_t rhs_ () const { return store_->rhs_[id_]; }
+
+    // A view of another expression of the store.
+    Expression operand_ (std::uint32_t id) const { return Expression(store_, id); }
+
+    Expression_Store* store_;
+    std::uint32_t     id_;
 
   private:
-    const parser::Type type_;
+    // Calls the visit() of `generator` for this expression alone.
+    template <typename Generator>
+    void visit_ (Generator& generator) const;
 };
 
 
-class Terminal : public Expression {
+// Values computed by a code generator for the expressions of a function
+// definition (a register, an operand...), indexed by Expression::id(). It
+// has the interface of the map it replaces, and its storage is reused from
+// one function to the next. Charged to code generation in --mem-report.
+template <typename T>
+class Value_Table {
   public:
-    typedef std::shared_ptr<Terminal> Ptr;
+    // Forgets all values, and makes room for `count` of them (see
+    // Function_Definition::expression_count()).
+    void reset (std::size_t count) {
+        slots_.clear();
+        slots_.resize(count);
+        size_ = 0;
+    }
+
+    // The value of `node`, default constructed if it has none yet.
+    T& operator [] (const Expression& node) {
+        Slot& slot = slot_(node);
+        if (not slot.present) {
+            slot.present = true;
+            ++size_;
+        }
+        return slot.value;
+    }
+
+    // The value of `node`, or nullptr if it has none.
+    T* find (const Expression& node) {
+        Slot& slot = slot_(node);
+        return slot.present ? &slot.value : nullptr;
+    }
+
+    T& at (const Expression& node) {
+        T* value = find(node);
+        if (not value) {
+            throw std::out_of_range("expression without a value");
+        }
+        return *value;
+    }
 
-    Terminal (const parser::Type type) : Expression(type) {}
+    void erase (const Expression& node) {
+        Slot& slot = slot_(node);
+        if (slot.present) {
+            slot = Slot();
+            --size_;
+        }
+    }
+
+    // Number of expressions with a value.
+    std::size_t size () const { return size_; }
+
+  private:
+    struct Slot {
+        Slot () : value(), present(false) {}
+
+        T    value;
+        bool present;
+    };
+
+    // The store of the expressions created outside of any function
+    // definition (e.g. by the unit tests) keeps growing.
+    Slot& slot_ (const Expression& node) {
+        if (node.id() >= slots_.size()) {
+            slots_.resize(node.id() + 1);
+        }
+        return slots_[node.id()];
+    }
+
+    std::vector<Slot, stats::Allocator<Slot, stats::Pool::CODEGEN>> slots_;
+    std::size_t size_ = 0;
 };
 
+
 // Declaration, external_declaration
 // It corresponds to Symbol class and Function class
 
@@ -203,78 +488,53 @@ class Terminal : public Expression {
 
 
 
-class Variable : public Terminal {
+class Variable : public Expression {
   public:
-    typedef std::shared_ptr<Variable> Ptr;
-
-    Variable (const parser::Symbol::Ptr& symbol)
-          : Terminal(symbol->type()), symbol_(symbol) {}
+    static constexpr Kind kKind = Kind::VARIABLE;
 
-    const parser::Symbol::Ptr& symbol () const { return symbol_; }
+    explicit Variable (const Expression& node) : Expression(node) {}
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    const parser::Symbol::Ptr& symbol () const { return store_->symbols_[lhs_()]; }
 
-  private:
-    parser::Symbol::Ptr symbol_;
+    static Variable add (Expression_Store& store, const parser::Symbol::Ptr& symbol);
 };
 
 // e.g. 1, 2, 3, ...
 // For example: 1, 2, 3, ...
-class Const_Integer : public Terminal {
+class Const_Integer : public Expression {
   public:
-    typedef std::shared_ptr<Const_Integer> Ptr;
+    static constexpr Kind kKind = Kind::CONST_INTEGER;
 
-    Const_Integer (const int& value)
-          : Terminal(parser::Type::INT), value_(value) {}
+    explicit Const_Integer (const Expression& node) : Expression(node) {}
 
-    int value () const { return value_; }
+    int value () const { return static_cast<int>(lhs_()); }
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
-
-  private:
-    int value_;
+    static Const_Integer add (Expression_Store& store, int value);
 };
 
 // For example: "hello world"
-class Const_String : public Terminal {
+class Const_String : public Expression {
   public:
-    typedef std::shared_ptr<Const_String> Ptr;
+    static constexpr Kind kKind = Kind::CONST_STRING;
 
-    Const_String (const std::string& value)
-          : Terminal(parser::Type::STRING), value_(value) {}
+    explicit Const_String (const Expression& node) : Expression(node) {}
 
-    const std::string& value () const { return value_; }
+    const std::string& value () const { return store_->strings_[lhs_()]; }
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
-
-  private:
-    std::string value_;
+    static Const_String add (Expression_Store& store, const std::string& value);
 };
 
 
 class Unary_Expression : public Expression {
   public:
-    typedef std::shared_ptr<Unary_Expression> Ptr;
+    static constexpr Kind kKind = Kind::UNARY_EXPRESSION;
 
-    Unary_Expression (Expression::Ptr rhs)
-          : Expression(parser::Type::INT), op_(Operation::SUBTRACTION), rhs_(rhs) {}
+    explicit Unary_Expression (const Expression& node) : Expression(node) {}
 
-    const Operation&       op  () const { return op_;  }
-    const Expression::Ptr& rhs () const { return rhs_; }
+    Operation  op  () const { return static_cast<Operation>(op_()); }
+    Expression rhs () const { return operand_(rhs_()); }
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
-
-  private:
-    Operation op_;
-    Expression::Ptr rhs_;
+    static Unary_Expression add (Expression_Store& store, const Expression& rhs);
 };
 
 
@@ -282,109 +542,122 @@ class Unary_Expression : public Expression {
 // e.g. i <= 10, 1+2
 class Binary_Expression : public Expression {
   public:
-    typedef std::shared_ptr<Binary_Expression> Ptr;
+    static constexpr Kind kKind = Kind::BINARY_EXPRESSION;
 
-    Binary_Expression (const parser::Type& type,
-        Operation op, Expression::Ptr lhs, Expression::Ptr rhs)
-          : Expression(type), op_(op), lhs_(lhs), rhs_(rhs) {}
+    explicit Binary_Expression (const Expression& node) : Expression(node) {}
 
-    const Operation&       op  () const { return op_;  }
-    const Expression::Ptr& lhs () const { return lhs_; }
-    const Expression::Ptr& rhs () const { return rhs_; }
-
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    Operation  op  () const { return static_cast<Operation>(op_()); }
+    Expression lhs () const { return operand_(lhs_()); }
+    Expression rhs () const { return operand_(rhs_()); }
 
-  private:
-    Operation op_;
-    Expression::Ptr lhs_;
-    Expression::Ptr rhs_;
+    static Binary_Expression add (Expression_Store& store, const parser::Type& type,
+        Operation op, const Expression& lhs, const Expression& rhs);
 };
 
 // return type is i1
 class Condition : public Expression {
   public:
-    typedef std::shared_ptr<Condition> Ptr;
+    static constexpr Kind kKind = Kind::CONDITION;
 
-    Condition (Comparison_Operation op, Expression::Ptr lhs,
-               Expression::Ptr rhs)
-          : Expression(lhs->type()),
-            op_(op),
-            lhs_(lhs),
-            rhs_(rhs) {}
+    // A view of no condition.
+    Condition () {}
 
-    const Comparison_Operation& op  () const { return op_;  }
-    const Expression::Ptr&      lhs () const { return lhs_; }
-    const Expression::Ptr&      rhs () const { return rhs_; }
+    explicit Condition (const Expression& node) : Expression(node) {}
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    Comparison_Operation op  () const { return static_cast<Comparison_Operation>(op_()); }
+    Expression           lhs () const { return operand_(lhs_()); }
+    Expression           rhs () const { return operand_(rhs_()); }
 
-  private:
-    Comparison_Operation op_;
-    Expression::Ptr lhs_;
-    Expression::Ptr rhs_;
+    static Condition add (Expression_Store& store, Comparison_Operation op,
+        const Expression& lhs, const Expression& rhs);
 };
 
 // For example: a = 1; b = "hello world";
 class Assignment : public Expression {
   public:
-    typedef std::shared_ptr<Assignment> Ptr;
+    static constexpr Kind kKind = Kind::ASSIGNMENT;
 
-    Assignment (Variable::Ptr lhs, Expression::Ptr rhs)
-          : Expression(lhs->type()), lhs_(lhs), rhs_(rhs) {}
+    explicit Assignment (const Expression& node) : Expression(node) {}
 
-    const Variable::Ptr&   lhs () const { return lhs_; }
-    const Expression::Ptr& rhs () const { return rhs_; }
+    Variable   lhs () const { return Variable(operand_(lhs_())); }
+    Expression rhs () const { return operand_(rhs_()); }
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    static Assignment add (Expression_Store& store, const Variable& lhs, const Expression& rhs);
+};
+
+
+// The arguments of a Function_Call, as a range of views.
+class Argument_List {
+  public:
+    class const_iterator {
+      public:
+        const_iterator (const Argument_List& list, std::uint32_t index)
+              : list_(&list), index_(index) {}
+
+        Expression operator * () const { return (*list_)[index_]; }
+        const_iterator& operator ++ () { ++index_; return *this; }
+
+        bool operator == (const const_iterator& other) const { return index_ == other.index_; }
+        bool operator != (const const_iterator& other) const { return index_ != other.index_; }
+
+      private:
+        const Argument_List* list_;
+        std::uint32_t        index_;
+    };
+
+    Argument_List (Expression_Store* store, std::uint32_t first)
+          : store_(store), first_(first) {}
+
+    std::size_t size  () const { return store_->arguments_[first_]; }
+    bool        empty () const { return size() == 0; }
+
+    Expression operator [] (std::size_t i) const;
+
+    const_iterator begin () const { return const_iterator(*this, 0); }
+    const_iterator end   () const { return const_iterator(*this, static_cast<std::uint32_t>(size())); }
 
   private:
-    Variable::Ptr   lhs_;
-    Expression::Ptr rhs_;
+    Expression_Store* store_;
+    std::uint32_t     first_;
 };
 
 
 class Function_Call : public Expression {
   public:
-    typedef std::shared_ptr<Function_Call> Ptr;
+    static constexpr Kind kKind = Kind::FUNCTION_CALL;
 
-    Function_Call (parser::Function::Ptr function)
-          : Expression(function->type()),
-            function_(function) {}
+    explicit Function_Call (const Expression& node) : Expression(node) {}
 
-    Function_Call (
-        parser::Function::Ptr function,
-        const std::vector<Expression::Ptr>& argument_list
-    )
-          : Expression(function->type()),
-            function_(function),
-            argument_list_(argument_list) {}
+    const parser::Function::Ptr& function      () const { return store_->functions_[lhs_()]; }
+    Argument_List                argument_list () const { return Argument_List(store_, rhs_()); }
 
-    const parser::Function::Ptr&        function      () const { return function_;      }
-    const std::vector<Expression::Ptr>& argument_list () const { return argument_list_; }
+    static Function_Call add (Expression_Store& store, const parser::Function::Ptr& function);
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    template <typename Expression_List>
+    static Function_Call add (
+        Expression_Store& store,
+        const parser::Function::Ptr& function,
+        const Expression_List& argument_list
+    );
 
   private:
-    parser::Function::Ptr function_;
-    std::vector<Expression::Ptr> argument_list_;
+    template <typename Iterator>
+    static Function_Call add_ (Expression_Store& store, const parser::Function::Ptr& function,
+                               Iterator first, Iterator last);
 };
 
 
+// The empty instruction, and the base class of the others.
 class Instruction : public Node {
   public:
     typedef std::shared_ptr<Instruction> Ptr;
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    static constexpr Kind kKind = Kind::INSTRUCTION;
+
+    Instruction () : Node(kKind) {}
+
+  protected:
+    explicit Instruction (Kind kind) : Node(kind) {}
 };
 
 
@@ -392,17 +665,15 @@ class Expression_Instruction : public Instruction {
   public:
     typedef std::shared_ptr<Expression_Instruction> Ptr;
 
-    Expression_Instruction (Expression::Ptr expression)
-          : expression_(expression) {}
+    static constexpr Kind kKind = Kind::EXPRESSION_INSTRUCTION;
 
-    const Expression::Ptr& expression () const { return expression_; }
+    Expression_Instruction (const Expression& expression)
+          : Instruction(kKind), expression_(expression) {}
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    const Expression& expression () const { return expression_; }
 
   private:
-    Expression::Ptr expression_;
+    Expression expression_;
 };
 
 // Declarate a list of symbols
@@ -410,21 +681,20 @@ class Declaration_List : public Instruction {
   public:
     typedef std::shared_ptr<Declaration_List> Ptr;
 
-    Declaration_List () {}
+    static constexpr Kind kKind = Kind::DECLARATION_LIST;
 
-    Declaration_List (parser::Symbol_List symbol_list)
-          : symbol_list_(symbol_list) {}
+    Declaration_List () : Instruction(kKind) {}
 
-    const parser::Symbol_List& symbol_list () const { return symbol_list_; }
+    template <typename Symbol_List>
+    explicit Declaration_List (const Symbol_List& symbol_list)
+          : Instruction(kKind), symbol_list_(std::begin(symbol_list), std::end(symbol_list)) {}
 
-    void push_back (parser::Symbol::Ptr symbol) { symbol_list_.push_back(symbol); }
+    const List<parser::Symbol::Ptr>& symbol_list () const { return symbol_list_; }
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    void push_back (parser::Symbol::Ptr symbol) { symbol_list_.push_back(symbol); }
 
   private:
-    parser::Symbol_List symbol_list_;
+    List<parser::Symbol::Ptr> symbol_list_;
 };
 
 
@@ -433,32 +703,37 @@ class Cond_Instruction : public Instruction {
   public:
     typedef std::shared_ptr<Cond_Instruction> Ptr;
 
+    static constexpr Kind kKind = Kind::COND_INSTRUCTION;
+
     Cond_Instruction (
-        Condition::Ptr condition,
+        const Condition& condition,
         Instruction::Ptr instruction
     )
-          : condition_(condition),
+          : Instruction(kKind),
+            condition_(condition),
             instruction_(instruction) {}
 
     Cond_Instruction (
-        Condition::Ptr condition,
+        const Condition& condition,
         Instruction::Ptr instruction,
         Instruction::Ptr else_instruction
     )
-          : condition_(condition),
+          : Instruction(kKind),
+            condition_(condition),
             instruction_(instruction),
             else_instruction_(else_instruction) {}
 
-    const Condition::Ptr&   condition        () const { return condition_;        }
+    ~Cond_Instruction () override {
+        release_(instruction_);
+        release_(else_instruction_);
+    }
+
+    const Condition&        condition        () const { return condition_;        }
     const Instruction::Ptr& instruction      () const { return instruction_;      }
     const Instruction::Ptr& else_instruction () const { return else_instruction_; }
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
-
   private:
-    Condition::Ptr condition_;
+    Condition condition_;
     Instruction::Ptr instruction_;
     Instruction::Ptr else_instruction_;
 };
@@ -468,18 +743,18 @@ class While_Instruction : public Instruction {
   public:
     typedef std::shared_ptr<While_Instruction> Ptr;
 
-    While_Instruction (Condition::Ptr condition, Instruction::Ptr instruction)
-          : condition_(condition), instruction_(instruction) {}
+    static constexpr Kind kKind = Kind::WHILE_INSTRUCTION;
 
-    const Condition::Ptr&   condition   () const { return condition_;   }
-    const Instruction::Ptr& instruction () const { return instruction_; }
+    While_Instruction (const Condition& condition, Instruction::Ptr instruction)
+          : Instruction(kKind), condition_(condition), instruction_(instruction) {}
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    ~While_Instruction () override { release_(instruction_); }
+
+    const Condition&        condition   () const { return condition_;   }
+    const Instruction::Ptr& instruction () const { return instruction_; }
 
   private:
-    Condition::Ptr condition_;
+    Condition condition_;
     Instruction::Ptr instruction_;
 };
 
@@ -488,18 +763,18 @@ class Do_Instruction : public Instruction {
   public:
     typedef std::shared_ptr<Do_Instruction> Ptr;
 
-    Do_Instruction (Condition::Ptr condition, Instruction::Ptr instruction)
-          : condition_(condition), instruction_(instruction) {}
+    static constexpr Kind kKind = Kind::DO_INSTRUCTION;
 
-    const Condition::Ptr&   condition   () const { return condition_;   }
-    const Instruction::Ptr& instruction () const { return instruction_; }
+    Do_Instruction (const Condition& condition, Instruction::Ptr instruction)
+          : Instruction(kKind), condition_(condition), instruction_(instruction) {}
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    ~Do_Instruction () override { release_(instruction_); }
+
+    const Condition&        condition   () const { return condition_;   }
+    const Instruction::Ptr& instruction () const { return instruction_; }
 
   private:
-    Condition::Ptr condition_;
+    Condition condition_;
     Instruction::Ptr instruction_;
 };
 
@@ -508,30 +783,31 @@ class For_Instruction : public Instruction {
   public:
     typedef std::shared_ptr<For_Instruction> Ptr;
 
+    static constexpr Kind kKind = Kind::FOR_INSTRUCTION;
+
     For_Instruction (
-        Expression::Ptr initialization,
-        Condition::Ptr condition,
-        Expression::Ptr increment,
+        const Expression& initialization,
+        const Condition& condition,
+        const Expression& increment,
         Instruction::Ptr instruction
     )
-          : initialization_(initialization),
+          : Instruction(kKind),
+            initialization_(initialization),
             condition_(condition),
             increment_(increment),
             instruction_(instruction) {}
 
-    const Expression::Ptr&  initialization () const { return initialization_; }
-    const Condition::Ptr&   condition      () const { return condition_;      }
-    const Expression::Ptr&  increment      () const { return increment_;      }
-    const Instruction::Ptr& instruction    () const { return instruction_;    }
+    ~For_Instruction () override { release_(instruction_); }
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    const Expression&       initialization () const { return initialization_; }
+    const Condition&        condition      () const { return condition_;      }
+    const Expression&       increment      () const { return increment_;      }
+    const Instruction::Ptr& instruction    () const { return instruction_;    }
 
   private:
-    Expression::Ptr initialization_;
-    Condition::Ptr condition_;
-    Expression::Ptr increment_;
+    Expression initialization_;
+    Condition condition_;
+    Expression increment_;
     Instruction::Ptr instruction_;
 };
 
@@ -544,17 +820,15 @@ class Return_Instruction : public Instruction {
   public:
     typedef std::shared_ptr<Return_Instruction> Ptr;
 
-    Return_Instruction (Expression::Ptr expression)
-          : expression_(expression) {}
+    static constexpr Kind kKind = Kind::RETURN_INSTRUCTION;
 
-    const Expression::Ptr& expression () const { return expression_; }
+    Return_Instruction (const Expression& expression)
+          : Instruction(kKind), expression_(expression) {}
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    const Expression& expression () const { return expression_; }
 
   private:
-    Expression::Ptr expression_;
+    Expression expression_;
 };
 
 // For example
@@ -565,20 +839,22 @@ class Compound_Instruction : public Instruction {
   public:
     typedef std::shared_ptr<Compound_Instruction> Ptr;
 
-    Compound_Instruction (const std::vector<Instruction::Ptr>& instruction_list)
-          : instruction_list_(instruction_list) {}
+    static constexpr Kind kKind = Kind::COMPOUND_INSTRUCTION;
 
-    Compound_Instruction (std::vector<Instruction::Ptr>&& instruction_list)
-          : instruction_list_(std::move(instruction_list)) {}
+    template <typename Instruction_List>
+    explicit Compound_Instruction (const Instruction_List& instruction_list)
+          : Instruction(kKind), instruction_list_(std::begin(instruction_list), std::end(instruction_list)) {}
 
-    const std::vector<Instruction::Ptr>& instruction_list () const { return instruction_list_; }
-
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
+    ~Compound_Instruction () override {
+        for (auto& instruction : instruction_list_) {
+            release_(instruction);
+        }
     }
 
+    const List<Instruction::Ptr>& instruction_list () const { return instruction_list_; }
+
   private:
-    std::vector<Instruction::Ptr> instruction_list_;
+    List<Instruction::Ptr> instruction_list_;
 };
 
 
@@ -587,16 +863,14 @@ class Function_Declaration : public Node {
   public:
     typedef std::shared_ptr<Function_Declaration> Ptr;
 
+    static constexpr Kind kKind = Kind::FUNCTION_DECLARATION;
+
     Function_Declaration (const parser::Type& type, parser::Function::Ptr& function_declarator)
-          : type_(type), function_declarator_(function_declarator) {}
+          : Node(kKind), type_(type), function_declarator_(function_declarator) {}
 
     const parser::Type&          type                () const { return type_;                }
     const parser::Function::Ptr& function_declarator () const { return function_declarator_; }
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
-
   private:
     parser::Type type_;
     parser::Function::Ptr function_declarator_;
@@ -608,29 +882,251 @@ class Function_Definition : public Node {
   public:
     typedef std::shared_ptr<Function_Definition> Ptr;
 
+    static constexpr Kind kKind = Kind::FUNCTION_DEFINITION;
+
     Function_Definition (
         const parser::Type& type,
         parser::Function::Ptr function_declarator,
         Compound_Instruction::Ptr body
     )
-          : type_(type),
+          : Node(kKind),
+            type_(type),
             function_declarator_(function_declarator),
-            body_(body) {}
+            body_(body),
+            expressions_(Expression_Store::current()) {}
+
+    ~Function_Definition () override {
+        Instruction::Ptr body = std::move(body_);
+        release_(body);
+    }
 
     const parser::Type&              type                () const { return type_;                }
     const parser::Function::Ptr&     function_declarator () const { return function_declarator_; }
     const Compound_Instruction::Ptr& body                () const { return body_;                }
 
-    virtual void emit_code (Code_Generator& generator) {
-        generator.visit(self(this));
-    }
+    // Bound of the Expression::id() of the expressions of the definition.
+    std::uint32_t expression_count () const { return expressions_->size(); }
+
+    // The store of the expressions of the definition.
+    const Expression_Store::Ptr& expressions () const { return expressions_; }
+
+    // Key of the IR of this definition in an ir_cache::Cache, derived by the
+    // parser from its tokens and the signatures of the globals it refers to.
+    // Empty if the parser did not compute one.
+    const std::string& cache_key () const { return cache_key_; }
+    void cache_key (std::string&& value) { cache_key_ = std::move(value); }
 
   private:
     parser::Type type_;
     parser::Function::Ptr function_declarator_;
     Compound_Instruction::Ptr body_;
+    Expression_Store::Ptr expressions_;
+    std::string cache_key_;
 };
 
+
+// Node - member function definitions
+
+template <typename Generator>
+void Node::emit_code (Generator& generator) {
+    Work_List& work = static_cast<Code_Generator&>(generator).work_;
+    work.run([this, &generator] { visit_(generator); });
+}
+
+template <typename Generator>
+void Node::visit_ (Generator& generator) {
+    switch (kind_) {
+        case Kind::DECLARATION_LIST:       generator.visit(static_cast<Declaration_List&>(*this));       return;
+        case Kind::INSTRUCTION:            generator.visit(static_cast<Instruction&>(*this));            return;
+        case Kind::EXPRESSION_INSTRUCTION: generator.visit(static_cast<Expression_Instruction&>(*this)); return;
+        case Kind::COND_INSTRUCTION:       generator.visit(static_cast<Cond_Instruction&>(*this));       return;
+        case Kind::WHILE_INSTRUCTION:      generator.visit(static_cast<While_Instruction&>(*this));      return;
+        case Kind::DO_INSTRUCTION:         generator.visit(static_cast<Do_Instruction&>(*this));         return;
+        case Kind::FOR_INSTRUCTION:        generator.visit(static_cast<For_Instruction&>(*this));        return;
+        case Kind::RETURN_INSTRUCTION:     generator.visit(static_cast<Return_Instruction&>(*this));     return;
+        case Kind::COMPOUND_INSTRUCTION:   generator.visit(static_cast<Compound_Instruction&>(*this));   return;
+        case Kind::FUNCTION_DECLARATION:   generator.visit(static_cast<Function_Declaration&>(*this));   return;
+        case Kind::FUNCTION_DEFINITION:    generator.visit(static_cast<Function_Definition&>(*this));    return;
+        default:
+            break;
+    }
+    throw std::logic_error("Node of unknown kind.");
+}
+
+
+// Work_List - member function definitions
+
+template <typename Generator>
+void Work_List::generate (Generator& generator, const std::shared_ptr<Instruction>& node) {
+    Node* instruction = node.get();
+    then([instruction, &generator] { instruction->visit_(generator); });
+}
+
+
+// Expression - member function definitions
+
+template <typename Generator>
+void Expression::emit_code (Generator& generator) const {
+    // Leaves, the most common expressions, need no stack.
+    switch (kind()) {
+        case Kind::VARIABLE:
+        case Kind::CONST_INTEGER:
+        case Kind::CONST_STRING:
+            generator.enter(*this);
+            visit_(generator);
+            return;
+        default:
+            break;
+    }
+
+    // Expressions to visit, and whether their operands have been pushed
+    // (above them) yet. The store may grow during the visits: only indices
+    // are kept. The stack is kept from one call to the next, so that it is
+    // only allocated once per thread; a visit may start a walk of its own
+    // above `bottom`.
+    struct Pending {
+        std::uint32_t id;
+        bool          entered;
+    };
+    static thread_local std::vector<Pending> stack;
+    const std::size_t bottom = stack.size();
+    struct Unwind {
+        std::size_t bottom;
+        ~Unwind () { stack.resize(bottom); }
+    } unwind {bottom};
+
+    stack.push_back(Pending {id_, false});
+    while (stack.size() > bottom) {
+        Expression node (store_, stack.back().id);
+        if (stack.back().entered) {
+            stack.pop_back();
+            node.visit_(generator);
+            continue;
+        }
+        stack.back().entered = true;
+        generator.enter(node);
+
+        // Pushed last to first, to be visited first to last. The variable
+        // assigned to is not an operand: it is not evaluated.
+        switch (node.kind()) {
+            case Kind::UNARY_EXPRESSION:
+            case Kind::ASSIGNMENT:
+                stack.push_back(Pending {node.rhs_(), false});
+                break;
+            case Kind::BINARY_EXPRESSION:
+            case Kind::CONDITION:
+                stack.push_back(Pending {node.rhs_(), false});
+                stack.push_back(Pending {node.lhs_(), false});
+                break;
+            case Kind::FUNCTION_CALL: {
+                const std::uint32_t* arguments = &store_->arguments_[node.rhs_()];
+                for (std::uint32_t i = arguments[0]; i > 0; --i) {
+                    stack.push_back(Pending {arguments[i], false});
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+template <typename Generator>
+void Expression::visit_ (Generator& generator) const {
+    switch (kind()) {
+        case Kind::VARIABLE:          { Variable          node (*this); generator.visit(node); return; }
+        case Kind::CONST_INTEGER:     { Const_Integer     node (*this); generator.visit(node); return; }
+        case Kind::CONST_STRING:      { Const_String      node (*this); generator.visit(node); return; }
+        case Kind::UNARY_EXPRESSION:  { Unary_Expression  node (*this); generator.visit(node); return; }
+        case Kind::BINARY_EXPRESSION: { Binary_Expression node (*this); generator.visit(node); return; }
+        case Kind::CONDITION:         { Condition         node (*this); generator.visit(node); return; }
+        case Kind::ASSIGNMENT:        { Assignment        node (*this); generator.visit(node); return; }
+        case Kind::FUNCTION_CALL:     { Function_Call     node (*this); generator.visit(node); return; }
+        default:
+            break;
+    }
+    throw std::logic_error("Expression of unknown kind.");
+}
+
+
+// Function_Call - member function definitions
+
+template <typename Expression_List>
+Function_Call Function_Call::add (
+    Expression_Store& store,
+    const parser::Function::Ptr& function,
+    const Expression_List& argument_list
+) {
+    return add_(store, function, std::begin(argument_list), std::end(argument_list));
+}
+
+template <typename Iterator>
+Function_Call Function_Call::add_ (
+    Expression_Store& store,
+    const parser::Function::Ptr& function,
+    Iterator first,
+    Iterator last
+) {
+    // `function` may be that of another call of the store.
+    parser::Type type = function->type();
+    std::uint32_t functions = static_cast<std::uint32_t>(store.functions_.size());
+    store.functions_.push_back(function);
+
+    std::uint32_t arguments = static_cast<std::uint32_t>(store.arguments_.size());
+    store.arguments_.push_back(static_cast<std::uint32_t>(std::distance(first, last)));
+    for (; first != last; ++first) {
+        store.arguments_.push_back(store.operand_(*first));
+    }
+
+    return Function_Call(Expression(&store, store.add_(kKind, type, 0, functions, arguments)));
+}
+
+
+// A shared_ptr to a node visited by reference.
+template <typename T>
+std::shared_ptr<T> shared (T& node) {
+    return std::static_pointer_cast<T>(node.shared_from_this());
+}
+
+
+// Collects the top level nodes of a translation unit, in source order, instead
+// of generating code for them. The parser hands them over one by one as it
+// reduces them; code can then be generated for the whole module at once.
+class Module : public Code_Generator {
+  public:
+    typedef List<Node::Ptr> Node_List;
+
+    void visit (Declaration_List&     node) override { nodes_.push_back(node.shared_from_this()); }
+    void visit (Function_Declaration& node) override { nodes_.push_back(node.shared_from_this()); }
+    void visit (Function_Definition&  node) override { nodes_.push_back(node.shared_from_this()); }
+
+    const Node_List& nodes () const { return nodes_; }
+
+  private:
+    Node_List nodes_;
+};
+
+
+// Creates a node, counting it and charging its memory to the AST in the
+// current stats::Report. Inside a function definition, the node (with its
+// shared_ptr control block) is placed in the function's arena::Arena.
+template <typename T, typename... Args>
+typename std::enable_if<not std::is_base_of<Expression, T>::value, std::shared_ptr<T>>::type
+make (Args&&... args) {
+    stats::count_node(T::kKind);
+    return std::allocate_shared<T>(
+        arena::Allocator<T, stats::Pool::AST>(), std::forward<Args>(args)...);
+}
+
+// Adds an expression to the current Expression_Store, and returns a view of
+// it.
+template <typename T, typename... Args>
+typename std::enable_if<std::is_base_of<Expression, T>::value, T>::type
+make (Args&&... args) {
+    stats::count_node(T::kKind);
+    return T::add(*Expression_Store::current(), std::forward<Args>(args)...);
+}
+
 }  // namespace ast
 
 
@@ -0,0 +1,930 @@
+#include "ast_image.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.hpp"
+#include "ast.hpp"
+#include "atom.hpp"
+#include "location.hh"
+#include "symbol.hpp"
+#include "symbol_table.hpp"
+
+
+namespace ast_image {
+
+
+static const char          kMagic[8]  = {'C', 'S', 'T', 'R', '-', 'A', 'S', 'T'};
+static const std::uint32_t kByteOrder = 0x01020304;
+
+// In the nodes section, the kind of an absent instruction.
+static const std::uint32_t kNull = static_cast<std::uint32_t>(ast::Kind::kSize);
+
+// Bound of the offsets and indices of an image.
+static const std::size_t kMaxIndex = std::numeric_limits<std::uint32_t>::max();
+
+
+enum Section : std::size_t {
+    STRINGS,
+    SYMBOLS,
+    PARAMETERS,
+    STORES,
+    COLUMNS,
+    NODES,
+    TOP_LEVEL,
+    GLOBALS,
+    kSections
+};
+
+// Offset from the start of the image, and size, in bytes.
+struct Section_Entry {
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+struct Header {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t size;
+    Section_Entry sections[kSections];
+};
+
+// A range of the strings section.
+struct String_Ref {
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+struct Symbol_Record {
+    String_Ref    name;
+    std::int32_t  access_count;
+    std::uint8_t  type;
+    std::uint8_t  attributes;   // Bit i: Symbol::Attribute i.
+    std::uint8_t  is_function;
+    std::uint8_t  unused;
+    std::uint32_t first_parameter;  // In the parameters section.
+    std::uint32_t parameters;
+};
+
+// The columns of a store follow each other, each padded to 8 bytes, in the
+// order of column_offsets().
+struct Store_Record {
+    std::uint32_t size;       // Rows.
+    std::uint32_t arguments;  // Elements of each of the other columns...
+    std::uint32_t symbols;    // ... as symbol indices
+    std::uint32_t functions;  // ... as symbol indices
+    std::uint32_t strings;    // ... as String_Refs
+    std::uint32_t unused;
+    std::uint64_t columns;    // Offset of the first column in the columns section.
+};
+
+struct Top_Level_Record {
+    std::uint32_t kind;
+    std::uint32_t type;        // Declarations and definitions: the return type.
+    std::uint32_t function;    // Declarations and definitions: the symbol index.
+    std::uint32_t store;       // Definitions.
+    std::uint32_t first_word;  // Range of the nodes section: a declaration
+    std::uint32_t words;       // list, or the body of a definition.
+    String_Ref    cache_key;   // Definitions.
+};
+
+static_assert(sizeof(Header)           == 24 + 16 * kSections, "Header is padded");
+static_assert(sizeof(Symbol_Record)    == 24,                  "Symbol_Record is padded");
+static_assert(sizeof(Store_Record)     == 32,                  "Store_Record is padded");
+static_assert(sizeof(Top_Level_Record) == 32,                  "Top_Level_Record is padded");
+
+
+static std::size_t pad (std::size_t size) {
+    return (size + 7) / 8 * 8;
+}
+
+// Offsets of the columns of `store` from its first one, followed by their end.
+enum Column {
+    KINDS,
+    TYPES,
+    OPS,
+    LHS,
+    RHS,
+    ARGUMENTS,
+    SYMBOL_INDICES,
+    FUNCTION_INDICES,
+    STRING_REFS,
+    kColumns
+};
+
+static void column_offsets (const Store_Record& store, std::uint64_t (&offsets)[kColumns + 1]) {
+    const std::uint64_t sizes[kColumns] = {
+        store.size, store.size, store.size,
+        4ull * store.size, 4ull * store.size,
+        4ull * store.arguments, 4ull * store.symbols, 4ull * store.functions,
+        sizeof(String_Ref) * std::uint64_t(store.strings),
+    };
+    offsets[0] = 0;
+    for (std::size_t i = 0; i < kColumns; ++i) {
+        offsets[i + 1] = offsets[i] + pad(sizes[i]);
+    }
+}
+
+
+bool is_image (const char* data, std::size_t size) {
+    return size >= sizeof(kMagic) and std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+
+// Writer
+
+class Writer {
+  public:
+    void write (const ast::Module& module, const parser::Symbol_Table& symbol_table,
+                std::ostream& out);
+
+  private:
+    std::string                   strings_;
+    std::vector<Symbol_Record>    symbols_;
+    std::vector<std::uint32_t>    parameters_;
+    std::vector<Store_Record>     stores_;
+    std::string                   columns_;
+    std::vector<std::uint32_t>    nodes_;
+    std::vector<Top_Level_Record> top_level_;
+    std::vector<std::uint32_t>    globals_;
+
+    std::unordered_map<const parser::Symbol*, std::uint32_t> symbol_indices_;
+    std::unordered_map<std::uint32_t, String_Ref>            names_;  // By atom id.
+
+    String_Ref    string_ (const std::string& s);
+    std::uint32_t symbol_ (const parser::Symbol::Ptr& symbol);
+    std::uint32_t store_  (const ast::Expression_Store& store);
+
+    void column_ (const void* data, std::size_t size);
+
+    // Writes the instructions of the tree of `root`, children first. Their
+    // expressions must be in `store`.
+    void instructions_ (const ast::Node* root, const ast::Expression_Store* store);
+    void instruction_  (const ast::Node& node, const ast::Expression_Store* store);
+
+    std::uint32_t expression_ (const ast::Expression& node, const ast::Expression_Store* store);
+};
+
+String_Ref Writer::string_ (const std::string& s) {
+    if (strings_.size() + s.size() > kMaxIndex) {
+        throw std::runtime_error("AST image: too many strings");
+    }
+    String_Ref ref {static_cast<std::uint32_t>(strings_.size()), static_cast<std::uint32_t>(s.size())};
+    strings_ += s;
+    return ref;
+}
+
+std::uint32_t Writer::symbol_ (const parser::Symbol::Ptr& symbol) {
+    auto result = symbol_indices_.emplace(symbol.get(), static_cast<std::uint32_t>(symbols_.size()));
+    if (not result.second) {
+        return result.first->second;
+    }
+    std::uint32_t index = result.first->second;
+
+    // Names are shared by the symbols of the same name.
+    auto name = names_.find(symbol->atom().id());
+    if (name == std::end(names_)) {
+        name = names_.emplace(symbol->atom().id(), string_(symbol->name())).first;
+    }
+
+    Symbol_Record record {};
+    record.name         = name->second;
+    record.access_count = symbol->access_count();
+    record.type         = static_cast<std::uint8_t>(symbol->type());
+    for (std::size_t i = 0; i < static_cast<std::size_t>(parser::Symbol::Attribute::kSize); ++i) {
+        if (symbol->get(static_cast<parser::Symbol::Attribute>(i))) {
+            record.attributes |= static_cast<std::uint8_t>(1u << i);
+        }
+    }
+    symbols_.push_back(record);
+
+    auto function = std::dynamic_pointer_cast<parser::Function>(symbol);
+    if (function) {
+        std::vector<std::uint32_t> parameters;
+        for (auto& parameter : function->argument_list()) {
+            parameters.push_back(symbol_(parameter));
+        }
+        Symbol_Record& function_record = symbols_[index];
+        function_record.is_function     = 1;
+        function_record.first_parameter = static_cast<std::uint32_t>(parameters_.size());
+        function_record.parameters      = static_cast<std::uint32_t>(parameters.size());
+        parameters_.insert(std::end(parameters_), std::begin(parameters), std::end(parameters));
+    }
+    return index;
+}
+
+void Writer::column_ (const void* data, std::size_t size) {
+    columns_.append(static_cast<const char*>(data), size);
+    columns_.append(pad(size) - size, '\0');
+}
+
+std::uint32_t Writer::store_ (const ast::Expression_Store& store) {
+    // In memory, each variable and call has an entry of its own in symbols_
+    // or functions_; in the image, each symbol has one per store, which the
+    // rows refer to.
+    std::vector<std::uint32_t> lhs (std::begin(store.lhs_), std::end(store.lhs_));
+    std::vector<std::uint32_t> symbols;
+    std::vector<std::uint32_t> functions;
+    std::unordered_map<std::uint32_t, std::uint32_t> positions;  // By symbol index.
+    auto position = [&] (std::vector<std::uint32_t>& column, const parser::Symbol::Ptr& symbol) {
+        auto result = positions.emplace(symbol_(symbol), static_cast<std::uint32_t>(column.size()));
+        if (result.second) {
+            column.push_back(result.first->first);
+        }
+        return result.first->second;
+    };
+    for (std::uint32_t id = 0; id < store.size(); ++id) {
+        switch (static_cast<ast::Kind>(store.kinds_[id])) {
+            case ast::Kind::VARIABLE:
+                lhs[id] = position(symbols, store.symbols_[lhs[id]]);
+                break;
+            case ast::Kind::FUNCTION_CALL:
+                lhs[id] = position(functions, store.functions_[lhs[id]]);
+                break;
+            default:
+                break;
+        }
+    }
+
+    std::vector<String_Ref> strings;
+    for (auto& s : store.strings_) {
+        strings.push_back(string_(s));
+    }
+
+    Store_Record record {};
+    record.size      = store.size();
+    record.arguments = static_cast<std::uint32_t>(store.arguments_.size());
+    record.symbols   = static_cast<std::uint32_t>(symbols.size());
+    record.functions = static_cast<std::uint32_t>(functions.size());
+    record.strings   = static_cast<std::uint32_t>(strings.size());
+    record.columns   = columns_.size();
+
+    column_(store.kinds_.data(),     store.kinds_.size());
+    column_(store.types_.data(),     store.types_.size());
+    column_(store.ops_.data(),       store.ops_.size());
+    column_(lhs.data(),              4 * lhs.size());
+    column_(store.rhs_.data(),       4 * store.rhs_.size());
+    column_(store.arguments_.data(), 4 * store.arguments_.size());
+    column_(symbols.data(),          4 * symbols.size());
+    column_(functions.data(),        4 * functions.size());
+    column_(strings.data(),          sizeof(String_Ref) * strings.size());
+
+    stores_.push_back(record);
+    return static_cast<std::uint32_t>(stores_.size() - 1);
+}
+
+// The parser leaves no expression out, and the code generators do not expect
+// any to be.
+std::uint32_t Writer::expression_ (const ast::Expression& node, const ast::Expression_Store* store) {
+    if (not node) {
+        throw std::runtime_error("AST image: missing expression");
+    }
+    if (not store) {
+        throw std::runtime_error("AST image: expression outside of a function definition");
+    }
+    return store->operand_(node);
+}
+
+void Writer::instructions_ (const ast::Node* root, const ast::Expression_Store* store) {
+    // Instructions to write, and whether their children have been pushed
+    // (above them) yet.
+    struct Pending {
+        const ast::Node* node;
+        bool             expanded;
+    };
+    std::vector<Pending> stack {Pending {root, false}};
+
+    while (not stack.empty()) {
+        const ast::Node* node = stack.back().node;
+        if (not node) {
+            nodes_.push_back(kNull);
+            stack.pop_back();
+            continue;
+        }
+        if (stack.back().expanded) {
+            stack.pop_back();
+            instruction_(*node, store);
+            continue;
+        }
+        stack.back().expanded = true;
+
+        // Pushed last to first, to be written first to last.
+        switch (node->kind()) {
+            case ast::Kind::COND_INSTRUCTION: {
+                auto& cond = static_cast<const ast::Cond_Instruction&>(*node);
+                if (cond.else_instruction()) {
+                    stack.push_back(Pending {cond.else_instruction().get(), false});
+                }
+                stack.push_back(Pending {cond.instruction().get(), false});
+                break;
+            }
+            case ast::Kind::WHILE_INSTRUCTION:
+                stack.push_back(Pending {static_cast<const ast::While_Instruction&>(*node).instruction().get(), false});
+                break;
+            case ast::Kind::DO_INSTRUCTION:
+                stack.push_back(Pending {static_cast<const ast::Do_Instruction&>(*node).instruction().get(), false});
+                break;
+            case ast::Kind::FOR_INSTRUCTION:
+                stack.push_back(Pending {static_cast<const ast::For_Instruction&>(*node).instruction().get(), false});
+                break;
+            case ast::Kind::COMPOUND_INSTRUCTION: {
+                auto& list = static_cast<const ast::Compound_Instruction&>(*node).instruction_list();
+                for (auto iter = list.rbegin(); iter != list.rend(); ++iter) {
+                    stack.push_back(Pending {iter->get(), false});
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+// Each instruction is its kind, followed by:
+//   Instruction             -
+//   Expression_Instruction,
+//   Return_Instruction      expression
+//   Cond_Instruction        condition, whether there is an else instruction
+//   While_Instruction,
+//   Do_Instruction          condition
+//   For_Instruction         initialization, condition, increment
+//   Compound_Instruction    number of instructions
+//   Declaration_List        number of symbols, symbols
+// after the instructions nested in it, in order.
+void Writer::instruction_ (const ast::Node& node, const ast::Expression_Store* store) {
+    nodes_.push_back(static_cast<std::uint32_t>(node.kind()));
+    switch (node.kind()) {
+        case ast::Kind::INSTRUCTION:
+            return;
+        case ast::Kind::EXPRESSION_INSTRUCTION:
+            nodes_.push_back(expression_(static_cast<const ast::Expression_Instruction&>(node).expression(), store));
+            return;
+        case ast::Kind::RETURN_INSTRUCTION:
+            nodes_.push_back(expression_(static_cast<const ast::Return_Instruction&>(node).expression(), store));
+            return;
+        case ast::Kind::COND_INSTRUCTION: {
+            auto& cond = static_cast<const ast::Cond_Instruction&>(node);
+            nodes_.push_back(expression_(cond.condition(), store));
+            nodes_.push_back(cond.else_instruction() ? 1 : 0);
+            return;
+        }
+        case ast::Kind::WHILE_INSTRUCTION:
+            nodes_.push_back(expression_(static_cast<const ast::While_Instruction&>(node).condition(), store));
+            return;
+        case ast::Kind::DO_INSTRUCTION:
+            nodes_.push_back(expression_(static_cast<const ast::Do_Instruction&>(node).condition(), store));
+            return;
+        case ast::Kind::FOR_INSTRUCTION: {
+            auto& loop = static_cast<const ast::For_Instruction&>(node);
+            nodes_.push_back(expression_(loop.initialization(), store));
+            nodes_.push_back(expression_(loop.condition(), store));
+            nodes_.push_back(expression_(loop.increment(), store));
+            return;
+        }
+        case ast::Kind::COMPOUND_INSTRUCTION:
+            nodes_.push_back(static_cast<std::uint32_t>(
+                static_cast<const ast::Compound_Instruction&>(node).instruction_list().size()));
+            return;
+        case ast::Kind::DECLARATION_LIST: {
+            auto& list = static_cast<const ast::Declaration_List&>(node).symbol_list();
+            nodes_.push_back(static_cast<std::uint32_t>(list.size()));
+            for (auto& symbol : list) {
+                nodes_.push_back(symbol_(symbol));
+            }
+            return;
+        }
+        default:
+            break;
+    }
+    throw std::runtime_error(std::string("AST image: unexpected ") + ast::kind_name(node.kind()));
+}
+
+void Writer::write (const ast::Module& module, const parser::Symbol_Table& symbol_table,
+                    std::ostream& out) {
+    for (auto& node : module.nodes()) {
+        Top_Level_Record record {};
+        record.kind = static_cast<std::uint32_t>(node->kind());
+        record.first_word = static_cast<std::uint32_t>(nodes_.size());
+
+        switch (node->kind()) {
+            case ast::Kind::DECLARATION_LIST:
+                instructions_(node.get(), nullptr);
+                break;
+            case ast::Kind::FUNCTION_DECLARATION: {
+                auto& declaration = static_cast<const ast::Function_Declaration&>(*node);
+                record.type     = static_cast<std::uint32_t>(declaration.type());
+                record.function = symbol_(declaration.function_declarator());
+                break;
+            }
+            case ast::Kind::FUNCTION_DEFINITION: {
+                auto& definition = static_cast<const ast::Function_Definition&>(*node);
+                record.type      = static_cast<std::uint32_t>(definition.type());
+                record.function  = symbol_(definition.function_declarator());
+                record.store     = store_(*definition.expressions());
+                record.cache_key = string_(definition.cache_key());
+                instructions_(definition.body().get(), definition.expressions().get());
+                break;
+            }
+            default:
+                throw std::runtime_error(std::string("AST image: unexpected top level ") +
+                    ast::kind_name(node->kind()));
+        }
+
+        if (nodes_.size() > kMaxIndex) {
+            throw std::runtime_error("AST image: too many nodes");
+        }
+        record.words = static_cast<std::uint32_t>(nodes_.size() - record.first_word);
+        top_level_.push_back(record);
+    }
+
+    symbol_table.for_each_global([this] (const parser::Symbol::Ptr& symbol) {
+        globals_.push_back(symbol_(symbol));
+    });
+
+    const std::pair<const void*, std::size_t> sections[kSections] = {
+        {strings_.data(),    strings_.size()},
+        {symbols_.data(),    sizeof(Symbol_Record) * symbols_.size()},
+        {parameters_.data(), 4 * parameters_.size()},
+        {stores_.data(),     sizeof(Store_Record) * stores_.size()},
+        {columns_.data(),    columns_.size()},
+        {nodes_.data(),      4 * nodes_.size()},
+        {top_level_.data(),  sizeof(Top_Level_Record) * top_level_.size()},
+        {globals_.data(),    4 * globals_.size()},
+    };
+
+    Header header {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version    = kVersion;
+    header.byte_order = kByteOrder;
+    std::uint64_t offset = pad(sizeof(Header));
+    for (std::size_t i = 0; i < kSections; ++i) {
+        header.sections[i] = Section_Entry {offset, sections[i].second};
+        offset += pad(sections[i].second);
+    }
+    header.size = offset;
+
+    static const char kZeros[8] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    out.write(kZeros, pad(sizeof(Header)) - sizeof(Header));
+    for (auto& section : sections) {
+        out.write(static_cast<const char*>(section.first), section.second);
+        out.write(kZeros, pad(section.second) - section.second);
+    }
+}
+
+
+void write (const ast::Module& module, const parser::Symbol_Table& symbol_table,
+            std::ostream& out) {
+    Writer().write(module, symbol_table, out);
+}
+
+
+// Reader
+
+class Reader {
+  public:
+    Reader (const char* data, std::size_t size);
+
+    parser::Symbol_Table::Ptr load (ast::Module& module);
+
+  private:
+    const char*   data_;
+    const Header* header_;
+
+    const char*             strings_;
+    std::size_t             string_bytes_;
+    const Symbol_Record*    symbol_records_;
+    std::size_t             symbol_count_;
+    const std::uint32_t*    parameters_;
+    std::size_t             parameter_count_;
+    const Store_Record*     stores_;
+    std::size_t             store_count_;
+    const char*             columns_;
+    std::size_t             column_bytes_;
+    const std::uint32_t*    nodes_;
+    std::size_t             node_count_;
+    const Top_Level_Record* top_level_;
+    std::size_t             top_level_count_;
+    const std::uint32_t*    globals_;
+    std::size_t             global_count_;
+
+    // Created the first time they are referred to, from the arena current
+    // then: the symbols of a function definition go in its arena.
+    std::vector<parser::Symbol::Ptr> symbols_;
+
+    [[noreturn]] static void corrupt_ (const char* what);
+
+    template <typename T>
+    const T* section_ (Section section, std::size_t& count) const;
+
+    const char*           text_     (const String_Ref& ref) const;
+    atom::Atom            name_     (const String_Ref& ref) const;
+    const parser::Symbol::Ptr& symbol_ (std::uint32_t index);
+    parser::Function::Ptr function_ (std::uint32_t index);
+    parser::Type          type_     (std::uint32_t value) const;
+
+    // Fills the current store with the store `index`.
+    void store_ (std::uint32_t index);
+
+    // The tree in `words` words of the nodes section from `first`.
+    ast::Node::Ptr instructions_ (std::uint32_t first, std::uint32_t words,
+                                  ast::Expression_Store* store);
+};
+
+void Reader::corrupt_ (const char* what) {
+    throw std::runtime_error(std::string("corrupt AST image: ") + what);
+}
+
+Reader::Reader (const char* data, std::size_t size) : data_(data) {
+    if (not is_image(data, size)) {
+        throw std::runtime_error("not an AST image");
+    }
+    if (size < sizeof(Header)) {
+        corrupt_("truncated header");
+    }
+    if (reinterpret_cast<std::uintptr_t>(data) % 8 != 0) {
+        throw std::runtime_error("AST image not aligned in memory");
+    }
+    header_ = reinterpret_cast<const Header*>(data);
+    if (header_->byte_order != kByteOrder) {
+        throw std::runtime_error("AST image of another byte order");
+    }
+    if (header_->version != kVersion) {
+        throw std::runtime_error("AST image of version " + std::to_string(header_->version) +
+            ", expected " + std::to_string(kVersion));
+    }
+    if (header_->size > size) {
+        corrupt_("truncated");
+    }
+
+    strings_        = section_<char>            (STRINGS,    string_bytes_);
+    symbol_records_ = section_<Symbol_Record>   (SYMBOLS,    symbol_count_);
+    parameters_     = section_<std::uint32_t>   (PARAMETERS, parameter_count_);
+    stores_         = section_<Store_Record>    (STORES,     store_count_);
+    columns_        = section_<char>            (COLUMNS,    column_bytes_);
+    nodes_          = section_<std::uint32_t>   (NODES,      node_count_);
+    top_level_      = section_<Top_Level_Record>(TOP_LEVEL,  top_level_count_);
+    globals_        = section_<std::uint32_t>   (GLOBALS,    global_count_);
+
+    symbols_.resize(symbol_count_);
+}
+
+template <typename T>
+const T* Reader::section_ (Section section, std::size_t& count) const {
+    const Section_Entry& entry = header_->sections[section];
+    if (entry.offset % 8 != 0 or entry.offset > header_->size or
+        entry.size > header_->size - entry.offset or entry.size % sizeof(T) != 0) {
+        corrupt_("section out of bounds");
+    }
+    count = entry.size / sizeof(T);
+    return reinterpret_cast<const T*>(data_ + entry.offset);
+}
+
+const char* Reader::text_ (const String_Ref& ref) const {
+    if (ref.offset > string_bytes_ or ref.size > string_bytes_ - ref.offset) {
+        corrupt_("string out of bounds");
+    }
+    return strings_ + ref.offset;
+}
+
+atom::Atom Reader::name_ (const String_Ref& ref) const {
+    return atom::intern(text_(ref), ref.size);
+}
+
+parser::Type Reader::type_ (std::uint32_t value) const {
+    if (value > static_cast<std::uint32_t>(parser::Type::STRING)) {
+        corrupt_("unknown type");
+    }
+    return static_cast<parser::Type>(value);
+}
+
+const parser::Symbol::Ptr& Reader::symbol_ (std::uint32_t index) {
+    if (index >= symbol_count_) {
+        corrupt_("symbol out of bounds");
+    }
+    parser::Symbol::Ptr& symbol = symbols_[index];
+    if (symbol) {
+        return symbol;
+    }
+
+    const Symbol_Record& record = symbol_records_[index];
+    atom::Atom name = name_(record.name);
+    if (record.is_function) {
+        if (record.first_parameter > parameter_count_ or
+            record.parameters > parameter_count_ - record.first_parameter) {
+            corrupt_("parameters out of bounds");
+        }
+        auto function = parser::make_symbol<parser::Function>(name);
+        for (std::uint32_t i = 0; i < record.parameters; ++i) {
+            std::uint32_t parameter = parameters_[record.first_parameter + i];
+            if (parameter >= symbol_count_ or symbol_records_[parameter].is_function) {
+                corrupt_("parameter is not a variable");
+            }
+            function->argument_list().push_back(symbol_(parameter));
+        }
+        symbol = function;
+    } else {
+        symbol = parser::make_symbol<parser::Symbol>(name);
+    }
+
+    symbol->type(type_(record.type));
+    symbol->access_count(record.access_count);
+    for (std::size_t i = 0; i < static_cast<std::size_t>(parser::Symbol::Attribute::kSize); ++i) {
+        if (record.attributes & (1u << i)) {
+            symbol->set(static_cast<parser::Symbol::Attribute>(i));
+        }
+    }
+    return symbol;
+}
+
+parser::Function::Ptr Reader::function_ (std::uint32_t index) {
+    auto function = std::dynamic_pointer_cast<parser::Function>(symbol_(index));
+    if (not function) {
+        corrupt_("symbol is not a function");
+    }
+    return function;
+}
+
+void Reader::store_ (std::uint32_t index) {
+    if (index >= store_count_) {
+        corrupt_("store out of bounds");
+    }
+    const Store_Record& record = stores_[index];
+    std::uint64_t offsets[kColumns + 1];
+    column_offsets(record, offsets);
+    if (record.columns > column_bytes_ or offsets[kColumns] > column_bytes_ - record.columns) {
+        corrupt_("store out of bounds");
+    }
+    const char* base = columns_ + record.columns;
+    auto column = [&] (Column c) { return base + offsets[c]; };
+    auto words = [&] (Column c) { return reinterpret_cast<const std::uint32_t*>(column(c)); };
+
+    ast::Expression_Store& store = *ast::Expression_Store::current();
+    std::uint32_t n = record.size;
+    store.kinds_.assign(reinterpret_cast<const std::uint8_t*>(column(KINDS)),
+                        reinterpret_cast<const std::uint8_t*>(column(KINDS)) + n);
+    store.types_.assign(reinterpret_cast<const std::uint8_t*>(column(TYPES)),
+                        reinterpret_cast<const std::uint8_t*>(column(TYPES)) + n);
+    store.ops_.assign(reinterpret_cast<const std::uint8_t*>(column(OPS)),
+                      reinterpret_cast<const std::uint8_t*>(column(OPS)) + n);
+    store.lhs_.assign(words(LHS), words(LHS) + n);
+    store.rhs_.assign(words(RHS), words(RHS) + n);
+    store.arguments_.assign(words(ARGUMENTS), words(ARGUMENTS) + record.arguments);
+
+    store.symbols_.reserve(record.symbols);
+    for (std::uint32_t i = 0; i < record.symbols; ++i) {
+        store.symbols_.push_back(symbol_(words(SYMBOL_INDICES)[i]));
+    }
+    store.functions_.reserve(record.functions);
+    for (std::uint32_t i = 0; i < record.functions; ++i) {
+        store.functions_.push_back(function_(words(FUNCTION_INDICES)[i]));
+    }
+    const String_Ref* strings = reinterpret_cast<const String_Ref*>(column(STRING_REFS));
+    store.strings_.reserve(record.strings);
+    for (std::uint32_t i = 0; i < record.strings; ++i) {
+        store.strings_.emplace_back(text_(strings[i]), strings[i].size);
+    }
+
+    // Code generation trusts the rows: check that each refers to rows before
+    // it (so that a tree has no cycle), and to operands that exist.
+    for (std::uint32_t id = 0; id < n; ++id) {
+        std::uint32_t lhs = store.lhs_[id];
+        std::uint32_t rhs = store.rhs_[id];
+        ast::Kind kind = static_cast<ast::Kind>(store.kinds_[id]);
+        type_(store.types_[id]);
+        switch (kind) {
+            case ast::Kind::VARIABLE:
+                if (lhs >= record.symbols) {
+                    corrupt_("variable out of bounds");
+                }
+                break;
+            case ast::Kind::CONST_INTEGER:
+                break;
+            case ast::Kind::CONST_STRING:
+                if (lhs >= record.strings) {
+                    corrupt_("string constant out of bounds");
+                }
+                break;
+            case ast::Kind::UNARY_EXPRESSION:
+                if (rhs >= id or store.ops_[id] > static_cast<std::uint8_t>(ast::Operation::RIGHT_SHIFT)) {
+                    corrupt_("bad unary expression");
+                }
+                break;
+            case ast::Kind::BINARY_EXPRESSION:
+                if (lhs >= id or rhs >= id or
+                    store.ops_[id] > static_cast<std::uint8_t>(ast::Operation::RIGHT_SHIFT)) {
+                    corrupt_("bad binary expression");
+                }
+                break;
+            case ast::Kind::CONDITION:
+                if (lhs >= id or rhs >= id or store.ops_[id] >
+                    static_cast<std::uint8_t>(ast::Comparison_Operation::GREATER_THAN_OR_EQUAL)) {
+                    corrupt_("bad condition");
+                }
+                break;
+            case ast::Kind::ASSIGNMENT:
+                if (lhs >= id or rhs >= id or
+                    store.kinds_[lhs] != static_cast<std::uint8_t>(ast::Kind::VARIABLE)) {
+                    corrupt_("bad assignment");
+                }
+                break;
+            case ast::Kind::FUNCTION_CALL: {
+                if (lhs >= record.functions or rhs >= record.arguments or
+                    store.arguments_[rhs] > record.arguments - rhs - 1) {
+                    corrupt_("bad function call");
+                }
+                for (std::uint32_t i = 1; i <= store.arguments_[rhs]; ++i) {
+                    if (store.arguments_[rhs + i] >= id) {
+                        corrupt_("bad function call");
+                    }
+                }
+                break;
+            }
+            default:
+                corrupt_("unknown expression");
+        }
+        stats::count_node(kind);
+    }
+}
+
+ast::Node::Ptr Reader::instructions_ (std::uint32_t first, std::uint32_t words,
+                                      ast::Expression_Store* store) {
+    if (first > node_count_ or words > node_count_ - first) {
+        corrupt_("nodes out of bounds");
+    }
+    const std::uint32_t* word = nodes_ + first;
+    const std::uint32_t* end  = word + words;
+
+    auto next = [&] () {
+        if (word == end) {
+            corrupt_("truncated instruction");
+        }
+        return *word++;
+    };
+    auto expression = [&] () {
+        std::uint32_t id = next();
+        if (not store or id >= store->size()) {
+            corrupt_("expression out of bounds");
+        }
+        return ast::Expression(store, id);
+    };
+    auto condition = [&] () {
+        ast::Expression node = expression();
+        if (node.kind() != ast::Kind::CONDITION) {
+            corrupt_("condition expected");
+        }
+        return ast::Condition(node);
+    };
+
+    // The instructions read, whose parent has not been yet.
+    std::vector<ast::Instruction::Ptr> stack;
+    auto pop = [&] (std::size_t count) {
+        if (count > stack.size()) {
+            corrupt_("missing instruction");
+        }
+        std::vector<ast::Instruction::Ptr> children (
+            std::make_move_iterator(std::end(stack) - count),
+            std::make_move_iterator(std::end(stack)));
+        stack.resize(stack.size() - count);
+        return children;
+    };
+
+    while (word != end) {
+        std::uint32_t kind = next();
+        if (kind == kNull) {
+            stack.push_back(nullptr);
+            continue;
+        }
+
+        ast::Instruction::Ptr node;
+        switch (static_cast<ast::Kind>(kind)) {
+            case ast::Kind::INSTRUCTION:
+                node = ast::make<ast::Instruction>();
+                break;
+            case ast::Kind::EXPRESSION_INSTRUCTION:
+                node = ast::make<ast::Expression_Instruction>(expression());
+                break;
+            case ast::Kind::RETURN_INSTRUCTION:
+                node = ast::make<ast::Return_Instruction>(expression());
+                break;
+            case ast::Kind::COND_INSTRUCTION: {
+                ast::Condition test = condition();
+                if (next()) {
+                    auto children = pop(2);
+                    node = ast::make<ast::Cond_Instruction>(test, children[0], children[1]);
+                } else {
+                    auto children = pop(1);
+                    node = ast::make<ast::Cond_Instruction>(test, children[0]);
+                }
+                break;
+            }
+            case ast::Kind::WHILE_INSTRUCTION: {
+                ast::Condition test = condition();
+                node = ast::make<ast::While_Instruction>(test, pop(1)[0]);
+                break;
+            }
+            case ast::Kind::DO_INSTRUCTION: {
+                ast::Condition test = condition();
+                node = ast::make<ast::Do_Instruction>(test, pop(1)[0]);
+                break;
+            }
+            case ast::Kind::FOR_INSTRUCTION: {
+                ast::Expression initialization = expression();
+                ast::Condition  test           = condition();
+                ast::Expression increment      = expression();
+                node = ast::make<ast::For_Instruction>(initialization, test, increment, pop(1)[0]);
+                break;
+            }
+            case ast::Kind::COMPOUND_INSTRUCTION:
+                node = ast::make<ast::Compound_Instruction>(pop(next()));
+                break;
+            case ast::Kind::DECLARATION_LIST: {
+                auto list = ast::make<ast::Declaration_List>();
+                for (std::uint32_t i = next(); i > 0; --i) {
+                    list->push_back(symbol_(next()));
+                }
+                node = list;
+                break;
+            }
+            default:
+                corrupt_("unknown instruction");
+        }
+        stack.push_back(std::move(node));
+    }
+
+    if (stack.size() != 1) {
+        corrupt_("not a single tree");
+    }
+    return std::move(stack.back());
+}
+
+parser::Symbol_Table::Ptr Reader::load (ast::Module& module) {
+    for (std::size_t i = 0; i < top_level_count_; ++i) {
+        const Top_Level_Record& record = top_level_[i];
+        switch (static_cast<ast::Kind>(record.kind)) {
+            case ast::Kind::DECLARATION_LIST: {
+                ast::Node::Ptr node = instructions_(record.first_word, record.words, nullptr);
+                if (not node or node->kind() != ast::Kind::DECLARATION_LIST) {
+                    corrupt_("declaration list expected");
+                }
+                module.visit(static_cast<ast::Declaration_List&>(*node));
+                break;
+            }
+            case ast::Kind::FUNCTION_DECLARATION: {
+                parser::Function::Ptr function = function_(record.function);
+                auto node = ast::make<ast::Function_Declaration>(type_(record.type), function);
+                module.visit(*node);
+                break;
+            }
+            case ast::Kind::FUNCTION_DEFINITION: {
+                // The signature is resident; what is created from here to the
+                // end of the definition goes in its arena.
+                parser::Function::Ptr function = function_(record.function);
+                arena::Scope function_arena;
+                ast::Store_Scope function_expressions;
+                function_arena.open();
+                function_expressions.open();
+
+                store_(record.store);
+                ast::Node::Ptr body = instructions_(record.first_word, record.words,
+                    ast::Expression_Store::current().get());
+                if (body and body->kind() != ast::Kind::COMPOUND_INSTRUCTION) {
+                    corrupt_("function body expected");
+                }
+                auto node = ast::make<ast::Function_Definition>(type_(record.type), function,
+                    std::static_pointer_cast<ast::Compound_Instruction>(body));
+                node->cache_key(std::string(text_(record.cache_key), record.cache_key.size));
+                module.visit(*node);
+                break;
+            }
+            default:
+                corrupt_("unknown top level node");
+        }
+    }
+
+    parser::Symbol_Table::Ptr symbol_table = parser::Symbol_Table::construct(
+        "global scope", parser::location());
+    for (std::size_t i = 0; i < global_count_; ++i) {
+        const parser::Symbol::Ptr& symbol = symbol_(globals_[i]);
+        symbol_table->add(symbol->atom(), symbol);
+    }
+    return symbol_table;
+}
+
+
+parser::Symbol_Table::Ptr load (const char* data, std::size_t size, ast::Module& module) {
+    return Reader(data, size).load(module);
+}
+
+
+}  // namespace ast_image
@@ -0,0 +1,67 @@
+#ifndef __CSTR_COMPILER__AST_IMAGE_HPP
+#define __CSTR_COMPILER__AST_IMAGE_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <iostream>
+
+#include "ast.hpp"
+#include "symbol_table.hpp"
+
+
+namespace ast_image {
+
+
+// A parsed translation unit (the top level nodes of an ast::Module, and the
+// symbols of the global scope) as a flat binary image, which can be written
+// after parsing and loaded back later, or by another process, instead of
+// parsing the source again:
+//
+//     header      magic, version, byte order, size, and a table of sections
+//     strings     every name, string constant and IR cache key, unterminated
+//     symbols     one fixed size record per parser::Symbol, with its name,
+//                 type, attributes and, for a parser::Function, a range of
+//                 `parameters`
+//     parameters  symbol indices
+//     stores      one record per ast::Expression_Store, locating its columns
+//     columns     the arrays of every store, as they are in memory
+//     nodes       the instructions of each top level node, as 32-bit words,
+//                 children first
+//     top level   one record per top level node, in source order
+//     globals     the symbols of the global scope, in declaration order
+//
+// Every section starts on an 8-byte boundary, and everything is in the byte
+// order of the machine that wrote the image: an image mapped into memory
+// (e.g. by input::Mapped_File) is read in place, and the columns of an
+// expression store are copied with one memcpy each. Symbols are numbered in
+// the order the nodes refer to them; two references to the same symbol (e.g.
+// the variable of a declaration and of its uses) load as one.
+//
+// The version is bumped whenever the layout or the meaning of a field
+// changes; an image of another version is rejected rather than converted.
+static const std::uint32_t kVersion = 1;
+
+// Whether the `size` bytes at `data` start like an image (of any version).
+bool is_image (const char* data, std::size_t size);
+
+// Writes `module`, and the global scope of `symbol_table`, to `out`. Throws
+// std::runtime_error if the expressions of a function definition are not in
+// its store.
+void write (const ast::Module& module, const parser::Symbol_Table& symbol_table,
+            std::ostream& out);
+
+// Adds the top level nodes of the image at `data` to `module`, and returns a
+// symbol table whose global scope holds the globals of the image. `data` must
+// be 8-byte aligned, and may be released once this returns. The nodes, local
+// symbols and expressions of each function definition are placed in an
+// arena::Arena of their own, as by the parser. Throws std::runtime_error if
+// the image is truncated, of another version or byte order, or inconsistent.
+parser::Symbol_Table::Ptr load (const char* data, std::size_t size, ast::Module& module);
+
+
+}  // namespace ast_image
+
+
+#endif  // __CSTR_COMPILER__AST_IMAGE_HPP
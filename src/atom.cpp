@@ -0,0 +1,138 @@
+#include "atom.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace atom {
+
+
+// The entry of the empty name, interned before anything else.
+static const Entry kEmpty = {std::string(), std::hash<std::string>()(std::string()), 0, 0};
+
+// Names recently interned or found by this thread, by the low bits of their
+// key hash. A hit needs no lock.
+static const std::size_t kCacheSize = 1024;
+static thread_local const Entry* cache[kCacheSize];
+
+
+// FNV-1a.
+static std::uint64_t key_hash (const char* text, std::size_t size) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static bool matches (const Entry* entry, std::uint64_t hash, const char* text, std::size_t size) {
+    return entry->key_hash == hash
+        and entry->name.size() == size
+        and std::memcmp(entry->name.data(), text, size) == 0;
+}
+
+
+// Open addressing over pointers to the entries, which live in a deque so that
+// adding one never moves the others.
+class Table {
+  public:
+    Table () : slots_(1024, nullptr), size_(0) {}
+
+    const Entry* find_or_add (std::uint64_t hash, const char* text, std::size_t size) {
+        std::lock_guard<std::mutex> lock (mutex_);
+        std::size_t mask = slots_.size() - 1;
+        for (std::size_t i = hash & mask; ; i = (i + 1) & mask) {
+            const Entry* entry = slots_[i];
+            if (not entry) {
+                break;
+            }
+            if (matches(entry, hash, text, size)) {
+                return entry;
+            }
+        }
+
+        std::string name (text, size);
+        std::size_t name_hash = std::hash<std::string>()(name);
+        entries_.push_back(Entry {
+            std::move(name), name_hash, hash, static_cast<std::uint32_t>(entries_.size() + 1)});
+        const Entry* entry = &entries_.back();
+        if (2 * (size_ + 1) > slots_.size()) {
+            grow_();
+        }
+        insert_(entry);
+        ++size_;
+        return entry;
+    }
+
+    std::size_t size () {
+        std::lock_guard<std::mutex> lock (mutex_);
+        return size_;
+    }
+
+  private:
+    std::mutex                mutex_;
+    std::deque<Entry>         entries_;
+    std::vector<const Entry*> slots_;
+    std::size_t               size_;
+
+    void insert_ (const Entry* entry) {
+        std::size_t mask = slots_.size() - 1;
+        std::size_t i = entry->key_hash & mask;
+        while (slots_[i]) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = entry;
+    }
+
+    void grow_ () {
+        std::vector<const Entry*> old (2 * slots_.size(), nullptr);
+        old.swap(slots_);
+        for (const Entry* entry : old) {
+            if (entry) {
+                insert_(entry);
+            }
+        }
+    }
+};
+
+// Never destroyed: atoms may be used by the destructors of other statics.
+static Table& table () {
+    static Table* table = new Table();
+    return *table;
+}
+
+
+// Atom - member function definitions
+
+Atom::Atom () : entry_(&kEmpty) {}
+
+
+Atom intern (const char* text, std::size_t size) {
+    if (size == 0) {
+        return Atom();
+    }
+
+    std::uint64_t hash = key_hash(text, size);
+    const Entry*& cached = cache[hash & (kCacheSize - 1)];
+    if (cached and matches(cached, hash, text, size)) {
+        return Atom(cached);
+    }
+
+    cached = table().find_or_add(hash, text, size);
+    return Atom(cached);
+}
+
+std::size_t count () {
+    return table().size() + 1;
+}
+
+
+}  // namespace atom
@@ -0,0 +1,80 @@
+#ifndef __CSTR_COMPILER__ATOM_HPP
+#define __CSTR_COMPILER__ATOM_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
+#include <string>
+
+
+namespace atom {
+
+
+// What the table keeps of an interned name. Entries are never freed nor
+// moved, so they can be read from any thread without locking.
+struct Entry {
+    std::string   name;
+    std::size_t   hash;      // std::hash<std::string> of the name.
+    std::uint64_t key_hash;  // Of the table's own probing.
+    std::uint32_t id;
+};
+
+
+// An identifier, interned: each distinct name is stored once, in a table
+// shared by all the threads of the process, so comparing two atoms is
+// comparing two pointers, and their hash is computed once per name. The
+// default atom is the empty name, whose id is 0.
+//
+// The table only grows: a resident server keeps the names of every program
+// it has compiled.
+class Atom {
+  public:
+    Atom ();
+
+    const std::string& str  () const { return entry_->name; }
+    std::uint32_t      id   () const { return entry_->id;   }
+    std::size_t        hash () const { return entry_->hash; }
+
+    bool operator == (Atom other) const { return entry_ == other.entry_; }
+    bool operator != (Atom other) const { return entry_ != other.entry_; }
+
+  private:
+    friend Atom intern (const char* text, std::size_t size);
+
+    explicit Atom (const Entry* entry) : entry_(entry) {}
+
+    const Entry* entry_;
+};
+
+// The atom of the `size` bytes at `text`, added to the table the first time.
+// Names seen recently on the calling thread are found without locking.
+Atom intern (const char* text, std::size_t size);
+
+inline Atom intern (const std::string& name) { return intern(name.data(), name.size()); }
+
+// Number of distinct names interned so far.
+std::size_t count ();
+
+
+// Orders atoms by name, for the containers whose order shows in the output.
+struct By_Name {
+    bool operator () (Atom a, Atom b) const { return a.str() < b.str(); }
+};
+
+
+}  // namespace atom
+
+
+namespace std {
+
+template <>
+struct hash<atom::Atom> {
+    std::size_t operator () (atom::Atom atom) const { return atom.hash(); }
+};
+
+}  // namespace std
+
+
+#endif  // __CSTR_COMPILER__ATOM_HPP
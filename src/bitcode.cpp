@@ -0,0 +1,932 @@
+#include "bitcode.hpp"
+
+#include <cctype>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "ast.hpp"
+#include "stats.hpp"
+#include "symbol.hpp"
+
+
+namespace bitcode {
+
+
+// Block IDs, record codes and encodings of the format, as read by LLVM
+// (llvm/Bitcode/LLVMBitCodes.h).
+
+enum Abbrev_Id : unsigned {
+    END_BLOCK       = 0,
+    ENTER_SUBBLOCK  = 1,
+    DEFINE_ABBREV   = 2,
+    UNABBREV_RECORD = 3,
+};
+
+enum Block_Id : unsigned {
+    MODULE_BLOCK    = 8,
+    CONSTANTS_BLOCK = 11,
+    FUNCTION_BLOCK  = 12,
+    TYPE_BLOCK      = 17,
+    STRTAB_BLOCK    = 23,
+};
+
+enum Module_Code : unsigned {
+    MODULE_CODE_VERSION   = 1,
+    MODULE_CODE_GLOBALVAR = 7,
+    MODULE_CODE_FUNCTION  = 8,
+};
+
+enum Type_Code : unsigned {
+    TYPE_CODE_NUMENTRY = 1,
+    TYPE_CODE_VOID     = 2,
+    TYPE_CODE_INTEGER  = 7,
+    TYPE_CODE_POINTER  = 8,
+    TYPE_CODE_ARRAY    = 11,
+    TYPE_CODE_FUNCTION = 21,
+};
+
+enum Constant_Code : unsigned {
+    CST_CODE_SETTYPE = 1,
+    CST_CODE_NULL    = 2,
+    CST_CODE_INTEGER = 4,
+    CST_CODE_STRING  = 8,
+};
+
+enum Function_Code : unsigned {
+    FUNC_CODE_DECLAREBLOCKS    = 1,
+    FUNC_CODE_INST_BINOP       = 2,
+    FUNC_CODE_INST_RET         = 10,
+    FUNC_CODE_INST_BR          = 11,
+    FUNC_CODE_INST_UNREACHABLE = 15,
+    FUNC_CODE_INST_ALLOCA      = 19,
+    FUNC_CODE_INST_LOAD        = 20,
+    FUNC_CODE_INST_CMP2        = 28,
+    FUNC_CODE_INST_CALL        = 34,
+    FUNC_CODE_INST_GEP         = 43,
+    FUNC_CODE_INST_STORE       = 44,
+};
+
+enum Binary_Opcode : unsigned {
+    BINOP_ADD  = 0,
+    BINOP_SUB  = 1,
+    BINOP_MUL  = 2,
+    BINOP_UDIV = 3,
+    BINOP_SREM = 6,
+    BINOP_SHL  = 7,
+    BINOP_ASHR = 9,
+};
+
+enum Predicate : unsigned {
+    ICMP_EQ  = 32,
+    ICMP_NE  = 33,
+    ICMP_SGT = 38,
+    ICMP_SGE = 39,
+    ICMP_SLT = 40,
+    ICMP_SLE = 41,
+};
+
+enum Linkage : unsigned {
+    LINKAGE_EXTERNAL = 0,
+    LINKAGE_PRIVATE  = 9,
+};
+
+const unsigned STRTAB_BLOB = 1;
+
+// Calls carry their function type explicitly.
+const std::uint64_t CALL_EXPLICIT_TYPE = std::uint64_t(1) << 15;
+
+// Alloca records carry the allocated type (not its pointer type).
+const std::uint64_t ALLOCA_EXPLICIT_TYPE = std::uint64_t(1) << 6;
+
+// Global variable records carry the value type (not its pointer type).
+const std::uint64_t GLOBALVAR_EXPLICIT_TYPE = 2;
+
+// Alignments are stored as log2(alignment) + 1, 0 meaning none.
+static std::uint64_t encode_alignment (unsigned alignment) {
+    std::uint64_t encoded = 0;
+    for (; alignment > 0; alignment >>= 1) {
+        ++encoded;
+    }
+    return encoded;
+}
+
+static std::uint64_t encode_signed (std::int64_t value) {
+    return value >= 0
+        ? static_cast<std::uint64_t>(value) << 1
+        : (static_cast<std::uint64_t>(-value) << 1) | 1;
+}
+
+
+// The bytes of a string constant, with the escape sequences that
+// llvm::LLVM_Generator understands resolved, and a terminating NUL.
+static std::string string_bytes (const std::string& value) {
+    std::string bytes;
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        char c = value[i];
+        if (c == '\\' and i + 1 < value.size()) {
+            char escaped = '\0';
+            switch (value[i + 1]) {
+                case '0': escaped = '\0'; break;
+                case 'n': escaped = '\n'; break;
+                case 'r': escaped = '\r'; break;
+                case 't': escaped = '\t'; break;
+                case 'v': escaped = '\v'; break;
+                default:  escaped = c;    break;
+            }
+            if (escaped != c) {
+                ++i;
+            }
+            bytes += escaped;
+        } else {
+            bytes += c;
+        }
+    }
+    bytes += '\0';
+    return bytes;
+}
+
+
+// Bitstream - member function definitions
+
+void Bitstream::emit (std::uint64_t value, unsigned width) {
+    if (width > 32) {
+        emit(value & 0xffffffff, 32);
+        emit(value >> 32, width - 32);
+        return;
+    }
+    current_ |= value << bits_;
+    bits_ += width;
+    if (bits_ >= 32) {
+        for (int i = 0; i < 4; ++i) {
+            bytes_ += static_cast<char>((current_ >> (8 * i)) & 0xff);
+        }
+        current_ >>= 32;
+        bits_ -= 32;
+    }
+}
+
+void Bitstream::emit_vbr (std::uint64_t value, unsigned width) {
+    const std::uint64_t continuation = std::uint64_t(1) << (width - 1);
+    while (value >= continuation) {
+        emit((value & (continuation - 1)) | continuation, width);
+        value >>= width - 1;
+    }
+    emit(value, width);
+}
+
+void Bitstream::align_32 () {
+    if (bits_ > 0) {
+        emit(0, 32 - bits_);
+    }
+}
+
+void Bitstream::enter_block (unsigned id, unsigned abbrev_width) {
+    emit(ENTER_SUBBLOCK, abbrev_width_);
+    emit_vbr(id, 8);
+    emit_vbr(abbrev_width, 4);
+    align_32();
+
+    // The length of the block, in words, is patched in by end_block().
+    blocks_.push_back(Block {abbrev_width_, next_abbrev_, bytes_.size()});
+    emit(0, 32);
+
+    abbrev_width_ = abbrev_width;
+    next_abbrev_ = 4;
+}
+
+void Bitstream::end_block () {
+    emit(END_BLOCK, abbrev_width_);
+    align_32();
+
+    Block block = blocks_.back();
+    blocks_.pop_back();
+
+    std::size_t length = (bytes_.size() - block.length_offset - 4) / 4;
+    for (int i = 0; i < 4; ++i) {
+        bytes_[block.length_offset + i] = static_cast<char>((length >> (8 * i)) & 0xff);
+    }
+
+    abbrev_width_ = block.abbrev_width;
+    next_abbrev_ = block.next_abbrev;
+}
+
+void Bitstream::record (unsigned code, const std::vector<std::uint64_t>& operands) {
+    emit(UNABBREV_RECORD, abbrev_width_);
+    emit_vbr(code, 6);
+    emit_vbr(operands.size(), 6);
+    for (auto operand : operands) {
+        emit_vbr(operand, 6);
+    }
+}
+
+void Bitstream::blob_record (unsigned code, const std::string& blob) {
+    // [literal code, blob]
+    emit(DEFINE_ABBREV, abbrev_width_);
+    emit_vbr(2, 5);
+    emit(1, 1);
+    emit_vbr(code, 8);
+    emit(0, 1);
+    emit(5, 3);
+
+    emit(next_abbrev_++, abbrev_width_);
+    emit_vbr(blob.size(), 6);
+    align_32();
+    for (char c : blob) {
+        emit(static_cast<unsigned char>(c), 8);
+    }
+    align_32();
+}
+
+
+// Bitcode_Generator - member function definitions
+
+void Bitcode_Generator::visit (ast::Declaration_List&       node) {
+    stats::Phase_Timer timer (ast::Kind::DECLARATION_LIST);
+    for (auto& symbol : node.symbol_list()) {
+        // Declare global variable.
+        if (symbol->get(parser::Symbol::Attribute::GLOBAL)) {
+            global_(symbol->name(), symbol->type());
+        }
+
+        // Declare local variable.
+        else {
+            unsigned alignment = symbol->type() == parser::Type::INT ? 4 : 8;
+            variables_[symbol] = emit_(FUNC_CODE_INST_ALLOCA, {
+                literal_(type_(symbol->type())),
+                literal_(int_type_(32)),
+                absolute_(constant_(1)),
+                literal_(encode_alignment(alignment) | ALLOCA_EXPLICIT_TYPE),
+            }, true);
+        }
+    }
+}
+void Bitcode_Generator::visit (ast::Variable&               node) {
+    stats::Phase_Timer timer (ast::Kind::VARIABLE);
+    values_[node] = emit_(FUNC_CODE_INST_LOAD, {
+        relative_(variable_(node.symbol())),
+        literal_(type_(node.type())),
+        literal_(0),
+        literal_(0),
+    }, true);
+}
+void Bitcode_Generator::visit (ast::Const_Integer&          node) {
+    stats::Phase_Timer timer (ast::Kind::CONST_INTEGER);
+    values_[node] = constant_(node.value());
+}
+void Bitcode_Generator::visit (ast::Const_String&           node) {
+    stats::Phase_Timer timer (ast::Kind::CONST_STRING);
+    std::string bytes = string_bytes(node.value());
+    unsigned array = array_type_(bytes.size(), int_type_(8));
+
+    Constant initializer {array, CST_CODE_STRING, Record(bytes.begin(), bytes.end())};
+    for (auto& byte : initializer.operands) {
+        byte &= 0xff;
+    }
+    constants_.push_back(std::move(initializer));
+
+    std::string name = "str." + function_name_ + '.' + std::to_string(next_string_++);
+    global_ids_[name] = globals_.size();
+    globals_.push_back(Global {
+        name, array, true, LINKAGE_PRIVATE, 0, true, constants_.size() - 1});
+
+    values_[node] = emit_(FUNC_CODE_INST_GEP, {
+        literal_(1),  // inbounds
+        literal_(array),
+        relative_(Value {Value::Kind::GLOBAL, globals_.size() - 1}),
+        relative_(constant_(0)),
+        relative_(constant_(0)),
+    }, true);
+}
+void Bitcode_Generator::visit (ast::Unary_Expression&       node) {
+    stats::Phase_Timer timer (ast::Kind::UNARY_EXPRESSION);
+    values_[node] = emit_(FUNC_CODE_INST_BINOP, {
+        relative_(constant_(0)),
+        relative_(value_(node.rhs())),
+        literal_(BINOP_SUB),
+    }, true);
+}
+void Bitcode_Generator::visit (ast::Binary_Expression&      node) {
+    stats::Phase_Timer timer (ast::Kind::BINARY_EXPRESSION);
+    switch (node.type()) {
+        case parser::Type::INT: {
+            unsigned opcode = BINOP_ADD;
+            switch (node.op()) {
+                case ast::Operation::ADDITION:       opcode = BINOP_ADD;  break;
+                case ast::Operation::SUBTRACTION:    opcode = BINOP_SUB;  break;
+                case ast::Operation::MULTIPLICATION: opcode = BINOP_MUL;  break;
+                case ast::Operation::DIVISION:       opcode = BINOP_UDIV; break;
+                case ast::Operation::MODULUS:        opcode = BINOP_SREM; break;
+                case ast::Operation::LEFT_SHIFT:     opcode = BINOP_SHL;  break;
+                case ast::Operation::RIGHT_SHIFT:    opcode = BINOP_ASHR; break;
+            }
+            values_[node] = emit_(FUNC_CODE_INST_BINOP, {
+                relative_(value_(node.lhs())),
+                relative_(value_(node.rhs())),
+                literal_(opcode),
+            }, true);
+            break;
+        }
+
+        case parser::Type::STRING: {
+            // '+' is the only operation allowed between strings.
+            Value concat = string_function_("__string_concat__");
+            Value result = emit_call_(concat, functions_[concat.index].type,
+                {value_(node.lhs()), value_(node.rhs())}, true);
+            values_[node] = result;
+            strings_to_free_.push_back(result);
+            break;
+        }
+    }
+}
+void Bitcode_Generator::visit (ast::Condition&              node) {
+    stats::Phase_Timer timer (ast::Kind::CONDITION);
+    switch (node.type()) {
+        case parser::Type::INT: {
+            unsigned predicate = ICMP_EQ;
+            switch (node.op()) {
+                case ast::Comparison_Operation::EQUAL:                 predicate = ICMP_EQ;  break;
+                case ast::Comparison_Operation::NOT_EQUAL:             predicate = ICMP_NE;  break;
+                case ast::Comparison_Operation::LESS_THAN:             predicate = ICMP_SLT; break;
+                case ast::Comparison_Operation::GREATER_THAN:          predicate = ICMP_SGT; break;
+                case ast::Comparison_Operation::LESS_THAN_OR_EQUAL:    predicate = ICMP_SLE; break;
+                case ast::Comparison_Operation::GREATER_THAN_OR_EQUAL: predicate = ICMP_SGE; break;
+            }
+            values_[node] = emit_(FUNC_CODE_INST_CMP2, {
+                relative_(value_(node.lhs())),
+                relative_(value_(node.rhs())),
+                literal_(predicate),
+            }, true);
+            break;
+        }
+
+        case parser::Type::STRING: {
+            const char* name = nullptr;
+            switch (node.op()) {
+                case ast::Comparison_Operation::EQUAL:
+                    name = "__string_equal__";
+                    break;
+                case ast::Comparison_Operation::NOT_EQUAL:
+                    name = "__string_not_equal__";
+                    break;
+                default:
+                    throw std::runtime_error("Operation not supported for strings.");
+            }
+            Value function = string_function_(name);
+            values_[node] = emit_call_(function, functions_[function.index].type,
+                {value_(node.lhs()), value_(node.rhs())}, true);
+            break;
+        }
+    }
+}
+void Bitcode_Generator::visit (ast::Assignment&             node) {
+    stats::Phase_Timer timer (ast::Kind::ASSIGNMENT);
+    emit_(FUNC_CODE_INST_STORE, {
+        relative_(variable_(node.lhs().symbol())),
+        relative_(value_(node.rhs())),
+        literal_(0),
+        literal_(0),
+    }, false);
+
+    // The value of an assignment is the value assigned.
+    values_[node] = value_(node.rhs());
+}
+void Bitcode_Generator::visit (ast::Function_Call&          node) {
+    stats::Phase_Timer timer (ast::Kind::FUNCTION_CALL);
+    auto& function = node.function();
+
+    Vector<Value> arguments;
+    for (auto argument : node.argument_list()) {
+        arguments.push_back(value_(argument));
+    }
+
+    unsigned type = function_type_(function, function->type());
+    values_[node] = emit_call_(function_(function->name(), type), type, arguments, true);
+}
+void Bitcode_Generator::visit (ast::Instruction&            node) {
+    // This is an empty instruction. Do nothing.
+}
+void Bitcode_Generator::visit (ast::Expression_Instruction& node) {
+    stats::Phase_Timer timer (ast::Kind::EXPRESSION_INSTRUCTION);
+    node.expression().emit_code(*this);
+}
+void Bitcode_Generator::visit (ast::Cond_Instruction&       node) {
+    stats::Phase_Timer timer (ast::Kind::COND_INSTRUCTION);
+    std::size_t label_0 = new_label_();
+    std::size_t label_1 = new_label_();
+    std::size_t label_2 = new_label_();
+
+    node.condition().emit_code(*this);
+    emit_branch_(value_(node.condition()), label_0, label_1);
+
+    place_label_(label_0);
+    work_.generate(*this, node.instruction());
+    work_.then([this, label_1, label_2] {
+        emit_branch_(label_2);
+        place_label_(label_1);
+    });
+    if (const auto& else_instruction = node.else_instruction()) {
+        work_.generate(*this, else_instruction);
+    }
+    work_.then([this, label_2] {
+        emit_branch_(label_2);
+        place_label_(label_2);
+    });
+}
+void Bitcode_Generator::visit (ast::While_Instruction&      node) {
+    stats::Phase_Timer timer (ast::Kind::WHILE_INSTRUCTION);
+    std::size_t label_0 = new_label_();
+    std::size_t label_1 = new_label_();
+    std::size_t label_2 = new_label_();
+
+    emit_branch_(label_0);
+
+    place_label_(label_0);
+    node.condition().emit_code(*this);
+    emit_branch_(value_(node.condition()), label_1, label_2);
+
+    place_label_(label_1);
+    work_.generate(*this, node.instruction());
+    work_.then([this, label_0, label_2] {
+        emit_branch_(label_0);
+        place_label_(label_2);
+    });
+}
+void Bitcode_Generator::visit (ast::Do_Instruction&         node) {
+    stats::Phase_Timer timer (ast::Kind::DO_INSTRUCTION);
+    std::size_t label_0 = new_label_();
+    std::size_t label_1 = new_label_();
+    std::size_t label_2 = new_label_();
+
+    emit_branch_(label_0);
+
+    place_label_(label_0);
+    work_.generate(*this, node.instruction());
+    work_.then([this, &node, label_0, label_1, label_2] {
+        emit_branch_(label_1);
+
+        place_label_(label_1);
+        node.condition().emit_code(*this);
+        emit_branch_(value_(node.condition()), label_0, label_2);
+
+        place_label_(label_2);
+    });
+}
+void Bitcode_Generator::visit (ast::For_Instruction&        node) {
+    stats::Phase_Timer timer (ast::Kind::FOR_INSTRUCTION);
+    std::size_t label_0 = new_label_();
+    std::size_t label_1 = new_label_();
+    std::size_t label_2 = new_label_();
+    std::size_t label_3 = new_label_();
+
+    node.initialization().emit_code(*this);
+    emit_branch_(label_0);
+
+    place_label_(label_0);
+    node.condition().emit_code(*this);
+    emit_branch_(value_(node.condition()), label_1, label_3);
+
+    place_label_(label_1);
+    work_.generate(*this, node.instruction());
+    work_.then([this, &node, label_0, label_2, label_3] {
+        emit_branch_(label_2);
+
+        place_label_(label_2);
+        node.increment().emit_code(*this);
+        emit_branch_(label_0);
+
+        place_label_(label_3);
+    });
+}
+void Bitcode_Generator::visit (ast::Return_Instruction&     node) {
+    stats::Phase_Timer timer (ast::Kind::RETURN_INSTRUCTION);
+    node.expression().emit_code(*this);
+
+    Value result = value_(node.expression());
+
+    // A string built in this function is freed below: return a copy of it,
+    // which the caller can free later.
+    if (node.expression().type() == parser::Type::STRING) {
+        for (auto& value : strings_to_free_) {
+            if (value.kind == result.kind and value.index == result.index) {
+                Value copy = string_function_("__string_copy__");
+                result = emit_call_(copy, functions_[copy.index].type, {result}, true);
+                break;
+            }
+        }
+    }
+
+    // Free any strings created in this function
+    for (auto& value : strings_to_free_) {
+        Value free = string_function_("__string_free__");
+        emit_call_(free, functions_[free.index].type, {value}, false);
+    }
+    strings_to_free_.clear();
+
+    emit_(FUNC_CODE_INST_RET, {relative_(result)}, false);
+    terminated_ = true;
+}
+void Bitcode_Generator::visit (ast::Compound_Instruction&   node) {
+    stats::Phase_Timer timer (ast::Kind::COMPOUND_INSTRUCTION);
+    for (auto& instruction : node.instruction_list()) {
+        work_.generate(*this, instruction);
+    }
+}
+void Bitcode_Generator::visit (ast::Function_Declaration&   node) {
+    stats::Phase_Timer timer (ast::Kind::FUNCTION_DECLARATION);
+    auto& declarator = node.function_declarator();
+    function_(declarator->name(), function_type_(declarator, node.type()));
+}
+void Bitcode_Generator::visit (ast::Function_Definition&    node) {
+    stats::Phase_Timer timer (ast::Kind::FUNCTION_DEFINITION);
+    auto& declarator = node.function_declarator();
+
+    Value function = function_(declarator->name(), function_type_(declarator, node.type()));
+    if (functions_[function.index].body != kNoBody) {
+        throw std::runtime_error("Function '" + declarator->name() + "' is defined twice.");
+    }
+
+    bodies_.emplace_back(new Function_Body());
+    functions_[function.index].body = bodies_.size() - 1;
+
+    body_ = bodies_.back().get();
+    function_name_ = declarator->name();
+    values_.reset(node.expression_count());
+    variables_.clear();
+    constant_ids_.clear();
+    strings_to_free_.clear();
+    next_label_ = 0;
+    next_string_ = 0;
+    terminated_ = false;
+
+    // alloca argument variables
+    body_->arguments = declarator->argument_list().size();
+    std::size_t argument = 0;
+    for (auto& symbol : declarator->argument_list()) {
+        Value pointer = emit_(FUNC_CODE_INST_ALLOCA, {
+            literal_(type_(symbol->type())),
+            literal_(int_type_(32)),
+            absolute_(constant_(1)),
+            literal_(ALLOCA_EXPLICIT_TYPE),
+        }, true);
+        emit_(FUNC_CODE_INST_STORE, {
+            relative_(pointer),
+            relative_(Value {Value::Kind::ARGUMENT, argument++}),
+            literal_(0),
+            literal_(0),
+        }, false);
+        variables_[symbol] = pointer;
+    }
+
+    // function body
+    node.body()->emit_code(*this);
+
+    // Every block needs a terminator. The textual IR would be rejected here.
+    if (not terminated_) {
+        emit_(FUNC_CODE_INST_UNREACHABLE, {}, false);
+    }
+
+    body_ = nullptr;
+}
+
+void Bitcode_Generator::finish () {
+    Bitstream stream;
+    std::string strtab;
+
+    // Magic number: 'BC' 0xC0DE.
+    stream.emit('B', 8);
+    stream.emit('C', 8);
+    stream.emit(0x0, 4);
+    stream.emit(0xC, 4);
+    stream.emit(0xE, 4);
+    stream.emit(0xD, 4);
+
+    write_module_(stream, strtab);
+
+    // Names of the globals and functions, referred to by offset and size.
+    stream.enter_block(STRTAB_BLOCK, 3);
+    stream.blob_record(STRTAB_BLOB, strtab);
+    stream.end_block();
+
+    out_.write(stream.bytes().data(), stream.bytes().size());
+    out_.flush();
+}
+
+
+// Types are uniqued by their record.
+unsigned Bitcode_Generator::type_ (Record&& record) {
+    auto iter = type_ids_.find(record);
+    if (iter != std::end(type_ids_)) {
+        return iter->second;
+    }
+    unsigned id = types_.size();
+    type_ids_.emplace(record, id);
+    types_.push_back(std::move(record));
+    return id;
+}
+
+unsigned Bitcode_Generator::void_type_ () {
+    return type_(Record {TYPE_CODE_VOID});
+}
+
+unsigned Bitcode_Generator::int_type_ (unsigned width) {
+    return type_(Record {TYPE_CODE_INTEGER, width});
+}
+
+unsigned Bitcode_Generator::pointer_type_ (unsigned pointee) {
+    return type_(Record {TYPE_CODE_POINTER, pointee, 0});
+}
+
+unsigned Bitcode_Generator::array_type_ (std::size_t size, unsigned element) {
+    return type_(Record {TYPE_CODE_ARRAY, size, element});
+}
+
+unsigned Bitcode_Generator::function_type_ (unsigned result, const Vector<unsigned>& parameters) {
+    Record record {TYPE_CODE_FUNCTION, 0, result};
+    record.insert(std::end(record), std::begin(parameters), std::end(parameters));
+    return type_(std::move(record));
+}
+
+unsigned Bitcode_Generator::type_ (parser::Type type) {
+    switch (type) {
+        case parser::Type::INT:
+            return int_type_(32);
+        case parser::Type::STRING:
+            return pointer_type_(int_type_(8));
+    }
+    throw std::logic_error("unknown type");
+}
+
+unsigned Bitcode_Generator::function_type_ (const parser::Function::Ptr& function, parser::Type result) {
+    Vector<unsigned> parameters;
+    for (auto& symbol : function->argument_list()) {
+        parameters.push_back(type_(symbol->type()));
+    }
+    return function_type_(type_(result), parameters);
+}
+
+
+Bitcode_Generator::Value Bitcode_Generator::global_ (const std::string& name, parser::Type type) {
+    auto iter = global_ids_.find(name);
+    if (iter != std::end(global_ids_)) {
+        return Value {Value::Kind::GLOBAL, iter->second};
+    }
+
+    constants_.push_back(Constant {type_(type), CST_CODE_NULL, Record()});
+    global_ids_[name] = globals_.size();
+    globals_.push_back(Global {
+        name, type_(type), false, LINKAGE_EXTERNAL, 0, false, constants_.size() - 1});
+    return Value {Value::Kind::GLOBAL, globals_.size() - 1};
+}
+
+// Declares a function, unless it already was.
+Bitcode_Generator::Value Bitcode_Generator::function_ (const std::string& name, unsigned type) {
+    auto iter = function_ids_.find(name);
+    if (iter != std::end(function_ids_)) {
+        return Value {Value::Kind::FUNCTION, iter->second};
+    }
+
+    function_ids_[name] = functions_.size();
+    functions_.push_back(Function {name, type, kNoBody});
+    return Value {Value::Kind::FUNCTION, functions_.size() - 1};
+}
+
+// The string runtime (string_lib.ll).
+Bitcode_Generator::Value Bitcode_Generator::string_function_ (const char* name) {
+    unsigned string = type_(parser::Type::STRING);
+    std::string function (name);
+
+    unsigned type;
+    if (function == "__string_equal__" or function == "__string_not_equal__") {
+        type = function_type_(int_type_(1), {string, string});
+    } else if (function == "__string_copy__") {
+        type = function_type_(string, {string});
+    } else if (function == "__string_concat__") {
+        type = function_type_(string, {string, string});
+    } else {
+        type = function_type_(void_type_(), {string});
+    }
+    return function_(function, type);
+}
+
+
+Bitcode_Generator::Value Bitcode_Generator::constant_ (int value) {
+    auto iter = constant_ids_.find(value);
+    if (iter != std::end(constant_ids_)) {
+        return Value {Value::Kind::CONSTANT, iter->second};
+    }
+
+    constant_ids_[value] = body_->constants.size();
+    body_->constants.push_back(value);
+    return Value {Value::Kind::CONSTANT, body_->constants.size() - 1};
+}
+
+// The pointer to a variable: its alloca, or the global.
+Bitcode_Generator::Value Bitcode_Generator::variable_ (const parser::Symbol::Ptr& symbol) {
+    if (symbol->get(parser::Symbol::Attribute::GLOBAL)) {
+        return global_(symbol->name(), symbol->type());
+    }
+    auto iter = variables_.find(symbol);
+    if (iter == std::end(variables_)) {
+        throw std::runtime_error("Variable '" + symbol->name() + "' is not declared.");
+    }
+    return iter->second;
+}
+
+
+Bitcode_Generator::Value Bitcode_Generator::emit_ (
+    unsigned code,
+    std::initializer_list<Field> fields,
+    bool has_value
+) {
+    // Code after a terminator (e.g. after a return in the middle of a block)
+    // goes into a block of its own, which nothing branches to.
+    if (terminated_) {
+        ++body_->blocks;
+        terminated_ = false;
+    }
+
+    body_->instructions.push_back(Instruction {code, Vector<Field>(fields), has_value});
+    return Value {Value::Kind::INSTRUCTION, has_value ? body_->values++ : body_->values};
+}
+
+Bitcode_Generator::Value Bitcode_Generator::emit_call_ (
+    Value function,
+    unsigned type,
+    const Vector<Value>& arguments,
+    bool has_value
+) {
+    Vector<Field> fields {
+        literal_(0),  // no attributes
+        literal_(CALL_EXPLICIT_TYPE),
+        literal_(type),
+        relative_(function),
+    };
+    for (auto& argument : arguments) {
+        fields.push_back(relative_(argument));
+    }
+
+    Value result = emit_(FUNC_CODE_INST_CALL, {}, has_value);
+    body_->instructions.back().fields = std::move(fields);
+    return result;
+}
+
+void Bitcode_Generator::emit_branch_ (std::size_t label) {
+    emit_(FUNC_CODE_INST_BR, {block_(label)}, false);
+    terminated_ = true;
+}
+
+void Bitcode_Generator::emit_branch_ (Value condition, std::size_t if_true, std::size_t if_false) {
+    emit_(FUNC_CODE_INST_BR, {block_(if_true), block_(if_false), relative_(condition)}, false);
+    terminated_ = true;
+}
+
+// Starts the block of `label`.
+void Bitcode_Generator::place_label_ (std::size_t label) {
+    if (not terminated_) {
+        emit_branch_(label);
+    }
+    body_->label_blocks[label] = body_->blocks++;
+    terminated_ = false;
+}
+
+
+void Bitcode_Generator::write_module_ (Bitstream& stream, std::string& strtab) const {
+    stream.enter_block(MODULE_BLOCK, 3);
+
+    // Version 2: relative value numbers, and names in the string table.
+    stream.record(MODULE_CODE_VERSION, {2});
+
+    stream.enter_block(TYPE_BLOCK, 4);
+    stream.record(TYPE_CODE_NUMENTRY, {types_.size()});
+    for (auto& type : types_) {
+        stream.record(type[0], std::vector<std::uint64_t>(std::begin(type) + 1, std::end(type)));
+    }
+    stream.end_block();
+
+    // Values are numbered in the order they are defined: global variables,
+    // functions, then module constants.
+    std::size_t constants_base = globals_.size() + functions_.size();
+
+    // [strtab offset, strtab size, type, explicit type | constant,
+    //  initializer + 1, linkage, alignment, section, visibility, thread
+    //  local, unnamed_addr]
+    for (auto& global : globals_) {
+        stream.record(MODULE_CODE_GLOBALVAR, {
+            strtab.size(), global.name.size(),
+            global.type,
+            GLOBALVAR_EXPLICIT_TYPE | (global.constant ? 1 : 0),
+            constants_base + global.initializer + 1,
+            global.linkage,
+            encode_alignment(global.alignment),
+            0, 0, 0,
+            global.unnamed_addr ? 1u : 0u,
+        });
+        strtab += global.name;
+    }
+
+    // [strtab offset, strtab size, type, calling convention, is prototype,
+    //  linkage, attributes, alignment, section, visibility]
+    for (auto& function : functions_) {
+        stream.record(MODULE_CODE_FUNCTION, {
+            strtab.size(), function.name.size(),
+            function.type,
+            0,
+            function.body == kNoBody ? 1u : 0u,
+            LINKAGE_EXTERNAL,
+            0, 0, 0, 0,
+        });
+        strtab += function.name;
+    }
+
+    if (not constants_.empty()) {
+        stream.enter_block(CONSTANTS_BLOCK, 4);
+        std::size_t type = static_cast<std::size_t>(-1);
+        for (auto& constant : constants_) {
+            if (constant.type != type) {
+                type = constant.type;
+                stream.record(CST_CODE_SETTYPE, {type});
+            }
+            stream.record(constant.code,
+                std::vector<std::uint64_t>(std::begin(constant.operands), std::end(constant.operands)));
+        }
+        stream.end_block();
+    }
+
+    // Function bodies, in the order of their prototypes.
+    std::size_t module_values = constants_base + constants_.size();
+    for (auto& function : functions_) {
+        if (function.body != kNoBody) {
+            write_function_(stream, *bodies_[function.body], module_values);
+        }
+    }
+
+    stream.end_block();
+}
+
+void Bitcode_Generator::write_function_ (
+    Bitstream& stream,
+    const Function_Body& body,
+    std::size_t module_values
+) const {
+    // Function values are numbered after the module's: arguments, constants,
+    // then instructions.
+    std::size_t arguments_base    = module_values;
+    std::size_t constants_base    = arguments_base + body.arguments;
+    std::size_t instructions_base = constants_base + body.constants.size();
+
+    auto number = [&] (const Value& value) -> std::size_t {
+        switch (value.kind) {
+            case Value::Kind::GLOBAL:          return value.index;
+            case Value::Kind::FUNCTION:        return globals_.size() + value.index;
+            case Value::Kind::MODULE_CONSTANT: return globals_.size() + functions_.size() + value.index;
+            case Value::Kind::ARGUMENT:        return arguments_base + value.index;
+            case Value::Kind::CONSTANT:        return constants_base + value.index;
+            case Value::Kind::INSTRUCTION:     return instructions_base + value.index;
+        }
+        throw std::logic_error("unknown value kind");
+    };
+
+    stream.enter_block(FUNCTION_BLOCK, 4);
+    stream.record(FUNC_CODE_DECLAREBLOCKS, {body.blocks});
+
+    if (not body.constants.empty()) {
+        stream.enter_block(CONSTANTS_BLOCK, 4);
+        stream.record(CST_CODE_SETTYPE, {
+            type_ids_.at(Record {TYPE_CODE_INTEGER, 32})});
+        for (int constant : body.constants) {
+            stream.record(CST_CODE_INTEGER, {encode_signed(constant)});
+        }
+        stream.end_block();
+    }
+
+    std::size_t next_value = instructions_base;
+    std::vector<std::uint64_t> operands;
+    for (auto& instruction : body.instructions) {
+        operands.clear();
+        for (auto& field : instruction.fields) {
+            switch (field.kind) {
+                case Field::Kind::LITERAL:
+                    operands.push_back(field.literal);
+                    break;
+                case Field::Kind::RELATIVE:
+                    operands.push_back(next_value - number(field.value));
+                    break;
+                case Field::Kind::ABSOLUTE:
+                    operands.push_back(number(field.value));
+                    break;
+                case Field::Kind::BLOCK:
+                    operands.push_back(body.label_blocks[field.literal]);
+                    break;
+            }
+        }
+        stream.record(instruction.code, operands);
+        next_value += instruction.has_value;
+    }
+
+    stream.end_block();
+}
+
+
+}  // namespace bitcode
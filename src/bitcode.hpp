@@ -0,0 +1,241 @@
+#ifndef __CSTR_COMPILER__BITCODE_HPP
+#define __CSTR_COMPILER__BITCODE_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ast.hpp"
+#include "output_buffer.hpp"
+#include "stats.hpp"
+#include "symbol.hpp"
+
+
+namespace bitcode {
+
+
+// Writes the LLVM bitstream container format: fields of any width packed
+// into little-endian 32-bit words, nested blocks whose length is patched in
+// when they end, and records. Records are written unabbreviated, except for
+// blobs, which have to be abbreviated.
+class Bitstream {
+  public:
+    void emit     (std::uint64_t value, unsigned width);
+    void emit_vbr (std::uint64_t value, unsigned width);
+    void align_32 ();
+
+    void enter_block (unsigned id, unsigned abbrev_width);
+    void end_block   ();
+
+    void record (unsigned code, const std::vector<std::uint64_t>& operands);
+
+    // A record of `code` holding `blob`, through an abbreviation defined in
+    // the current block just for it.
+    void blob_record (unsigned code, const std::string& blob);
+
+    // Everything emitted so far. Only complete once every block has ended.
+    const std::string& bytes () const { return bytes_; }
+
+  private:
+    std::string   bytes_;
+    std::uint64_t current_ = 0;  // Bits not yet in a complete word.
+    unsigned      bits_    = 0;
+
+    unsigned abbrev_width_ = 2;
+    unsigned next_abbrev_  = 4;
+
+    struct Block {
+        unsigned    abbrev_width;
+        unsigned    next_abbrev;
+        std::size_t length_offset;  // Byte offset of the length word.
+    };
+    std::vector<Block> blocks_;
+};
+
+
+// Code generator writing LLVM bitcode (the format llc and opt read besides
+// assembly), without going through libLLVM. It generates the same code as
+// llvm::LLVM_Generator, with the same node set.
+//
+// Bitcode is laid out by module rather than by function: the types, globals
+// and function prototypes of the whole module come first, and instructions
+// refer to values by number. So the module is only written by finish(), once
+// every top level declaration has been visited. Until then each function is
+// kept as a list of records whose operands are resolved to value numbers when
+// they are written.
+class Bitcode_Generator final : public ast::Code_Generator {
+  public:
+    explicit Bitcode_Generator (std::ostream& out)
+          : out_(out, output::Flush_Policy::EXPLICIT) {}
+
+    // Write the module to the output stream.
+    void finish ();
+
+    const output::Output_Buffer& output () const { return out_; }
+    std::size_t bytes_written () const { return out_.bytes_written(); }
+
+    void visit (ast::Declaration_List&       node) override;
+    void visit (ast::Variable&               node) override;
+    void visit (ast::Const_Integer&          node) override;
+    void visit (ast::Const_String&           node) override;
+    void visit (ast::Unary_Expression&       node) override;
+    void visit (ast::Binary_Expression&      node) override;
+    void visit (ast::Condition&              node) override;
+    void visit (ast::Assignment&             node) override;
+    void visit (ast::Function_Call&          node) override;
+    void visit (ast::Instruction&            node) override;
+    void visit (ast::Expression_Instruction& node) override;
+    void visit (ast::Cond_Instruction&       node) override;
+    void visit (ast::While_Instruction&      node) override;
+    void visit (ast::Do_Instruction&         node) override;
+    void visit (ast::For_Instruction&        node) override;
+    void visit (ast::Return_Instruction&     node) override;
+    void visit (ast::Compound_Instruction&   node) override;
+    void visit (ast::Function_Declaration&   node) override;
+    void visit (ast::Function_Definition&    node) override;
+
+  private:
+    output::Output_Buffer out_;
+
+    // Containers of the generator state, charged to code generation in
+    // --mem-report.
+    template <typename Key, typename Value>
+    using Map = stats::Map<Key, Value, stats::Pool::CODEGEN>;
+    template <typename T>
+    using Vector = stats::Vector<T, stats::Pool::CODEGEN>;
+
+    typedef Vector<std::uint64_t> Record;
+
+    // A value, by what defines it. Value numbers depend on how many values
+    // the module has in total, so they are only computed by finish().
+    struct Value {
+        enum class Kind { GLOBAL, FUNCTION, MODULE_CONSTANT, ARGUMENT, CONSTANT, INSTRUCTION };
+
+        Kind        kind;
+        std::size_t index;
+    };
+
+    // An operand of an instruction record.
+    struct Field {
+        enum class Kind {
+            LITERAL,   // `literal` as is
+            RELATIVE,  // the number of `value`, relative to the instruction's
+            ABSOLUTE,  // the number of `value`
+            BLOCK,     // the basic block where label `literal` was placed
+        };
+
+        Kind          kind;
+        std::uint64_t literal;
+        Value         value;
+    };
+
+    struct Instruction {
+        unsigned      code;
+        Vector<Field> fields;
+        bool          has_value;  // Whether it defines a value.
+    };
+
+    struct Function_Body {
+        std::size_t                arguments = 0;
+        Vector<int>                constants;  // i32 constants
+        Vector<Instruction>        instructions;
+        std::size_t                values = 0;  // defined by instructions
+        std::size_t                blocks = 1;
+        Vector<std::size_t>        label_blocks;
+    };
+
+    struct Global {
+        std::string name;
+        unsigned    type;
+        bool        constant;
+        unsigned    linkage;
+        unsigned    alignment;
+        bool        unnamed_addr;
+        std::size_t initializer;  // Index of a module constant.
+    };
+
+    struct Function {
+        std::string name;
+        unsigned    type;
+        std::size_t body;  // Index in bodies_, or kNoBody for a prototype.
+    };
+    static const std::size_t kNoBody = static_cast<std::size_t>(-1);
+
+    struct Constant {
+        unsigned type;
+        unsigned code;
+        Record   operands;
+    };
+
+    // Module.
+    std::map<Record, unsigned>             type_ids_;
+    Vector<Record>                         types_;
+    Vector<Global>                         globals_;
+    Map<std::string, std::size_t>          global_ids_;
+    Vector<Function>                       functions_;
+    Map<std::string, std::size_t>          function_ids_;
+    Vector<Constant>                       constants_;
+    Vector<std::unique_ptr<Function_Body>> bodies_;
+
+    // Function being defined.
+    Function_Body*                     body_ = nullptr;
+    std::string                        function_name_;
+    ast::Value_Table<Value>            values_;
+    Map<parser::Symbol::Ptr, Value>    variables_;
+    Map<int, std::size_t>              constant_ids_;
+    Vector<Value>                      strings_to_free_;
+    std::size_t                        next_label_  = 0;
+    std::size_t                        next_string_ = 0;
+    bool                               terminated_  = false;  // Whether the current block ended.
+
+    // Types.
+    unsigned type_ (Record&& record);
+    unsigned void_type_ ();
+    unsigned int_type_ (unsigned width);
+    unsigned pointer_type_ (unsigned pointee);
+    unsigned array_type_ (std::size_t size, unsigned element);
+    unsigned function_type_ (unsigned result, const Vector<unsigned>& parameters);
+    unsigned type_ (parser::Type type);
+    unsigned function_type_ (const parser::Function::Ptr& function, parser::Type result);
+
+    // Module values.
+    Value global_ (const std::string& name, parser::Type type);
+    Value function_ (const std::string& name, unsigned type);
+    Value string_function_ (const char* name);
+
+    // Function values and instructions.
+    Value constant_ (int value);
+    Value variable_ (const parser::Symbol::Ptr& symbol);
+    Value value_ (const ast::Expression& node) { return values_.at(node); }
+
+    static Field literal_  (std::uint64_t value) { return Field {Field::Kind::LITERAL, value, Value()}; }
+    static Field relative_ (Value value) { return Field {Field::Kind::RELATIVE, 0, value}; }
+    static Field absolute_ (Value value) { return Field {Field::Kind::ABSOLUTE, 0, value}; }
+    static Field block_    (std::size_t label) { return Field {Field::Kind::BLOCK, label, Value()}; }
+
+    Value emit_ (unsigned code, std::initializer_list<Field> fields, bool has_value);
+    Value emit_call_ (Value function, unsigned type, const Vector<Value>& arguments, bool has_value);
+    void emit_branch_ (std::size_t label);
+    void emit_branch_ (Value condition, std::size_t if_true, std::size_t if_false);
+
+    std::size_t new_label_ () { body_->label_blocks.push_back(0); return next_label_++; }
+    void place_label_ (std::size_t label);
+
+    // Writing.
+    void write_module_ (Bitstream& stream, std::string& strtab) const;
+    void write_function_ (Bitstream& stream, const Function_Body& body, std::size_t module_values) const;
+};
+
+
+}  // namespace bitcode
+
+
+#endif  // __CSTR_COMPILER__BITCODE_HPP
@@ -0,0 +1,784 @@
+#include "bytecode.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "ast.hpp"
+#include "jit.hpp"
+#include "stats.hpp"
+#include "symbol.hpp"
+#include "x86_64.hpp"
+
+
+namespace bytecode {
+
+
+// Bytecode_Generator - member function definitions
+
+void Bytecode_Generator::visit (ast::Declaration_List&       node) {
+    stats::Phase_Timer timer (ast::Kind::DECLARATION_LIST);
+    for (auto& symbol : node.symbol_list()) {
+        // Declare global variable, zero-initialized.
+        if (symbol->get(parser::Symbol::Attribute::GLOBAL)) {
+            globals_[symbol->name()] = static_cast<std::int32_t>(program_.globals++);
+        }
+
+        // Declare local variable.
+        else {
+            variables_[symbol] = variable_();
+        }
+    }
+}
+void Bytecode_Generator::visit (ast::Variable&               node) {
+    stats::Phase_Timer timer (ast::Kind::VARIABLE);
+    const parser::Symbol::Ptr& symbol = node.symbol();
+    if (symbol->get(parser::Symbol::Attribute::GLOBAL)) {
+        auto iter = globals_.find(symbol->name());
+        if (iter == std::end(globals_)) {
+            throw std::runtime_error("Variable '" + symbol->name() + "' is not declared.");
+        }
+        std::int32_t value = allocate_();
+        emit_(Opcode::LOAD_GLOBAL, {value, iter->second});
+        values_[node] = value;
+        return;
+    }
+
+    // Whatever the expression using it does, a local variable can only change
+    // in an assignment, and C leaves a read of a variable unsequenced with an
+    // assignment to it undefined: the expression can read its register.
+    auto iter = variables_.find(symbol);
+    if (iter == std::end(variables_)) {
+        throw std::runtime_error("Variable '" + symbol->name() + "' is not declared.");
+    }
+    values_[node] = iter->second;
+}
+void Bytecode_Generator::visit (ast::Const_Integer&          node) {
+    stats::Phase_Timer timer (ast::Kind::CONST_INTEGER);
+    std::int32_t value = allocate_();
+    emit_(Opcode::LOAD_INT, {value, node.value()});
+    values_[node] = value;
+}
+void Bytecode_Generator::visit (ast::Const_String&           node) {
+    stats::Phase_Timer timer (ast::Kind::CONST_STRING);
+    std::int32_t index = static_cast<std::int32_t>(program_.strings.size());
+    program_.strings.push_back(x86_64::string_bytes(node.value()));
+
+    std::int32_t value = allocate_();
+    emit_(Opcode::LOAD_STRING, {value, index});
+    values_[node] = value;
+}
+void Bytecode_Generator::visit (ast::Unary_Expression&       node) {
+    stats::Phase_Timer timer (ast::Kind::UNARY_EXPRESSION);
+    std::int32_t rhs = take_(node.rhs());
+    release_(rhs);
+    std::int32_t value = allocate_();
+    emit_(Opcode::NEGATE, {value, rhs});
+    values_[node] = value;
+}
+void Bytecode_Generator::visit (ast::Binary_Expression&      node) {
+    stats::Phase_Timer timer (ast::Kind::BINARY_EXPRESSION);
+    switch (node.type()) {
+        case parser::Type::INT: {
+            // The opcode, and its _K form.
+            Opcode opcodes[2] = {Opcode::ADD, Opcode::ADD_K};
+            switch (node.op()) {
+                case ast::Operation::ADDITION:
+                    opcodes[0] = Opcode::ADD; opcodes[1] = Opcode::ADD_K; break;
+                case ast::Operation::SUBTRACTION:
+                    opcodes[0] = Opcode::SUB; opcodes[1] = Opcode::SUB_K; break;
+                case ast::Operation::MULTIPLICATION:
+                    opcodes[0] = Opcode::MUL; opcodes[1] = Opcode::MUL_K; break;
+                case ast::Operation::DIVISION:
+                    opcodes[0] = Opcode::DIV; opcodes[1] = Opcode::DIV_K; break;
+                case ast::Operation::MODULUS:
+                    opcodes[0] = Opcode::MOD; opcodes[1] = Opcode::MOD_K; break;
+                case ast::Operation::LEFT_SHIFT:
+                    opcodes[0] = Opcode::SHL; opcodes[1] = Opcode::SHL_K; break;
+                case ast::Operation::RIGHT_SHIFT:
+                    opcodes[0] = Opcode::SHR; opcodes[1] = Opcode::SHR_K; break;
+            }
+
+            std::int32_t constant;
+            bool is_constant = constant_(node.rhs(), constant);
+
+            std::int32_t lhs = take_(node.lhs());
+            std::int32_t rhs = take_(node.rhs());
+            if (is_constant) {
+                // Visited right before this, the constant was the last code
+                // emitted: an operand of the _K form, it needs no register.
+                program_.code.resize(static_cast<std::size_t>(last_value_));
+                last_value_ = -1;
+                release_(rhs);
+                rhs = constant;
+            }
+            release_(lhs);
+            if (not is_constant) {
+                release_(rhs);
+            }
+
+            std::int32_t value = allocate_();
+            emit_(opcodes[is_constant ? 1 : 0], {value, lhs, rhs});
+            values_[node] = value;
+            break;
+        }
+
+        case parser::Type::STRING: {
+            std::int32_t lhs = take_(node.lhs());
+            std::int32_t rhs = take_(node.rhs());
+            release_(lhs);
+            release_(rhs);
+
+            // '+' is the only operation allowed between strings. The result
+            // is freed when the function returns, from a register of its own.
+            std::int32_t value = variable_();
+            emit_(Opcode::CONCAT, {value, lhs, rhs});
+            strings_to_free_.push_back(value);
+            values_[node] = value;
+            break;
+        }
+    }
+}
+void Bytecode_Generator::visit (ast::Condition&              node) {
+    stats::Phase_Timer timer (ast::Kind::CONDITION);
+    std::int32_t lhs = take_(node.lhs());
+    std::int32_t rhs = take_(node.rhs());
+    release_(lhs);
+    release_(rhs);
+
+    Opcode opcode = Opcode::EQ;
+    switch (node.type()) {
+        case parser::Type::INT:
+            switch (node.op()) {
+                case ast::Comparison_Operation::EQUAL:                 opcode = Opcode::EQ; break;
+                case ast::Comparison_Operation::NOT_EQUAL:             opcode = Opcode::NE; break;
+                case ast::Comparison_Operation::LESS_THAN:             opcode = Opcode::LT; break;
+                case ast::Comparison_Operation::GREATER_THAN:          opcode = Opcode::GT; break;
+                case ast::Comparison_Operation::LESS_THAN_OR_EQUAL:    opcode = Opcode::LE; break;
+                case ast::Comparison_Operation::GREATER_THAN_OR_EQUAL: opcode = Opcode::GE; break;
+            }
+            break;
+
+        case parser::Type::STRING:
+            switch (node.op()) {
+                case ast::Comparison_Operation::EQUAL:
+                    opcode = Opcode::STRING_EQ;
+                    break;
+                case ast::Comparison_Operation::NOT_EQUAL:
+                    opcode = Opcode::STRING_NE;
+                    break;
+                default:
+                    throw std::runtime_error("Operation not supported for strings.");
+            }
+            break;
+    }
+
+    std::int32_t value = allocate_();
+    emit_(opcode, {value, lhs, rhs});
+    values_[node] = value;
+}
+void Bytecode_Generator::visit (ast::Assignment&             node) {
+    stats::Phase_Timer timer (ast::Kind::ASSIGNMENT);
+    // The value of an assignment is the value assigned.
+    std::int32_t value = take_(node.rhs());
+    const parser::Symbol::Ptr& symbol = node.lhs().symbol();
+    if (symbol->get(parser::Symbol::Attribute::GLOBAL)) {
+        auto iter = globals_.find(symbol->name());
+        if (iter == std::end(globals_)) {
+            throw std::runtime_error("Variable '" + symbol->name() + "' is not declared.");
+        }
+        emit_(Opcode::STORE_GLOBAL, {iter->second, value});
+        values_[node] = value;
+        return;
+    }
+
+    auto iter = variables_.find(symbol);
+    if (iter == std::end(variables_)) {
+        throw std::runtime_error("Variable '" + symbol->name() + "' is not declared.");
+    }
+    if (value != iter->second) {
+        // Compute the value into the variable, if it was just computed.
+        if (temporary_[value] and last_value_ != -1 and program_.code[last_value_ + 1] == value) {
+            program_.code[last_value_ + 1] = iter->second;
+        } else {
+            emit_(Opcode::MOVE, {iter->second, value});
+        }
+        release_(value);
+    }
+    values_[node] = iter->second;
+}
+void Bytecode_Generator::visit (ast::Function_Call&          node) {
+    stats::Phase_Timer timer (ast::Kind::FUNCTION_CALL);
+    Vector<std::int32_t> arguments;
+    for (auto argument : node.argument_list()) {
+        arguments.push_back(take_(argument));
+    }
+    for (std::int32_t argument : arguments) {
+        release_(argument);
+    }
+
+    std::int32_t value = allocate_();
+    std::size_t function = function_index_(node.function()->name(), node.type());
+
+    last_value_ = static_cast<std::int64_t>(program_.code.size());
+    program_.calls.push_back(program_.code.size());
+    program_.code.push_back(static_cast<std::int32_t>(Opcode::CALL));
+    program_.code.push_back(value);
+    program_.code.push_back(static_cast<std::int32_t>(function));
+    program_.code.push_back(static_cast<std::int32_t>(arguments.size()));
+    program_.code.insert(std::end(program_.code), std::begin(arguments), std::end(arguments));
+    values_[node] = value;
+}
+void Bytecode_Generator::visit (ast::Instruction&            node) {
+    // This is an empty instruction. Do nothing.
+}
+void Bytecode_Generator::visit (ast::Expression_Instruction& node) {
+    stats::Phase_Timer timer (ast::Kind::EXPRESSION_INSTRUCTION);
+    node.expression().emit_code(*this);
+    release_(take_(node.expression()));
+}
+void Bytecode_Generator::visit (ast::Cond_Instruction&       node) {
+    stats::Phase_Timer timer (ast::Kind::COND_INSTRUCTION);
+    std::int32_t label_else = new_label_();
+    std::int32_t label_end  = new_label_();
+
+    branch_(node.condition(), false, label_else);
+    work_.generate(*this, node.instruction());
+
+    if (const auto& else_instruction = node.else_instruction()) {
+        work_.then([this, label_else, label_end] {
+            emit_jump_(Opcode::JUMP, {}, label_end);
+            place_(label_else);
+        });
+        work_.generate(*this, else_instruction);
+    } else {
+        work_.then([this, label_else] { place_(label_else); });
+    }
+
+    work_.then([this, label_end] { place_(label_end); });
+}
+
+// Loops test their condition after the body, so that each iteration only
+// takes one jump.
+void Bytecode_Generator::visit (ast::While_Instruction&      node) {
+    stats::Phase_Timer timer (ast::Kind::WHILE_INSTRUCTION);
+    std::int32_t label_body      = new_label_();
+    std::int32_t label_condition = new_label_();
+
+    emit_jump_(Opcode::JUMP, {}, label_condition);
+    place_(label_body);
+    work_.generate(*this, node.instruction());
+
+    work_.then([this, &node, label_body, label_condition] {
+        place_(label_condition);
+        branch_(node.condition(), true, label_body);
+    });
+}
+void Bytecode_Generator::visit (ast::Do_Instruction&         node) {
+    stats::Phase_Timer timer (ast::Kind::DO_INSTRUCTION);
+    std::int32_t label_body = new_label_();
+
+    place_(label_body);
+    work_.generate(*this, node.instruction());
+    work_.then([this, &node, label_body] { branch_(node.condition(), true, label_body); });
+}
+void Bytecode_Generator::visit (ast::For_Instruction&        node) {
+    stats::Phase_Timer timer (ast::Kind::FOR_INSTRUCTION);
+    std::int32_t label_body      = new_label_();
+    std::int32_t label_condition = new_label_();
+
+    node.initialization().emit_code(*this);
+    release_(take_(node.initialization()));
+    emit_jump_(Opcode::JUMP, {}, label_condition);
+
+    place_(label_body);
+    work_.generate(*this, node.instruction());
+    work_.then([this, &node, label_body, label_condition] {
+        node.increment().emit_code(*this);
+        release_(take_(node.increment()));
+
+        place_(label_condition);
+        branch_(node.condition(), true, label_body);
+    });
+}
+void Bytecode_Generator::visit (ast::Return_Instruction&     node) {
+    stats::Phase_Timer timer (ast::Kind::RETURN_INSTRUCTION);
+    node.expression().emit_code(*this);
+
+    std::int32_t value = take_(node.expression());
+
+    // A string built in this function is freed below: return a copy of it,
+    // which the caller can free later.
+    if (std::find(std::begin(strings_to_free_), std::end(strings_to_free_), value)
+            != std::end(strings_to_free_)) {
+        std::int32_t copy = allocate_();
+        emit_(Opcode::COPY, {copy, value});
+        value = copy;
+    }
+
+    // Free any strings created in this function
+    for (std::int32_t string : strings_to_free_) {
+        emit_(Opcode::FREE, {string});
+    }
+
+    emit_(Opcode::RETURN, {value});
+    release_(value);
+}
+void Bytecode_Generator::visit (ast::Compound_Instruction&   node) {
+    stats::Phase_Timer timer (ast::Kind::COMPOUND_INSTRUCTION);
+    for (auto& instruction : node.instruction_list()) {
+        work_.generate(*this, instruction);
+    }
+}
+void Bytecode_Generator::visit (ast::Function_Declaration&   node) {
+    stats::Phase_Timer timer (ast::Kind::FUNCTION_DECLARATION);
+    function_index_(node.function_declarator()->name(), node.type());
+}
+void Bytecode_Generator::visit (ast::Function_Definition&    node) {
+    stats::Phase_Timer timer (ast::Kind::FUNCTION_DEFINITION);
+    auto& declarator = node.function_declarator();
+
+    values_.reset(node.expression_count());
+    variables_.clear();
+    registers_ = 0;
+    temporary_.clear();
+    free_temporaries_.clear();
+    strings_to_free_.clear();
+    labels_.clear();
+    label_operands_.clear();
+
+    std::size_t index = function_index_(declarator->name(), node.type());
+    program_.functions[index].entry = static_cast<std::int32_t>(program_.code.size());
+
+    // The arguments are the first registers.
+    for (auto& symbol : declarator->argument_list()) {
+        variables_[symbol] = variable_();
+    }
+
+    // function body
+    node.body()->emit_code(*this);
+
+    // Falling off the end returns 0.
+    std::int32_t zero = allocate_();
+    emit_(Opcode::LOAD_INT, {zero, 0});
+    emit_(Opcode::RETURN, {zero});
+
+    for (auto& operand : label_operands_) {
+        program_.code[operand.first] = labels_[operand.second];
+    }
+    program_.functions[index].registers = registers_;
+}
+
+
+// A temporary register, for the value of an expression.
+std::int32_t Bytecode_Generator::allocate_ () {
+    if (not free_temporaries_.empty()) {
+        std::int32_t value = free_temporaries_.back();
+        free_temporaries_.pop_back();
+        return value;
+    }
+    temporary_.push_back(true);
+    return registers_++;
+}
+
+// A register of its own, for a variable.
+std::int32_t Bytecode_Generator::variable_ () {
+    temporary_.push_back(false);
+    return registers_++;
+}
+
+// Gives back a register once the value in it is no longer needed. Does
+// nothing for the registers of variables.
+void Bytecode_Generator::release_ (std::int32_t value) {
+    if (temporary_[value]) {
+        free_temporaries_.push_back(value);
+    }
+}
+
+// The register holding the value of a node already compiled, which is then
+// forgotten.
+std::int32_t Bytecode_Generator::take_ (const ast::Expression& node) {
+    std::int32_t* iter = values_.find(node);
+    if (not iter) {
+        throw std::runtime_error("Expression has no value.");
+    }
+    std::int32_t value = *iter;
+    values_.erase(node);
+    return value;
+}
+
+void Bytecode_Generator::emit_ (Opcode opcode, std::initializer_list<std::int32_t> operands) {
+    bool produces_value = opcode < Opcode::FREE and opcode != Opcode::STORE_GLOBAL;
+    last_value_ = produces_value ? static_cast<std::int64_t>(program_.code.size()) : -1;
+
+    program_.code.push_back(static_cast<std::int32_t>(opcode));
+    program_.code.insert(std::end(program_.code), operands);
+}
+
+void Bytecode_Generator::emit_jump_ (
+    Opcode opcode,
+    std::initializer_list<std::int32_t> operands,
+    std::int32_t label
+) {
+    emit_(opcode, operands);
+    label_operands_.emplace_back(program_.code.size(), label);
+    program_.code.push_back(-1);
+}
+
+void Bytecode_Generator::branch_ (const ast::Condition& condition, bool when, std::int32_t label) {
+    if (condition.type() == parser::Type::STRING) {
+        condition.emit_code(*this);
+        std::int32_t value = take_(condition);
+        release_(value);
+        emit_jump_(when ? Opcode::JUMP_IF_NOT_ZERO : Opcode::JUMP_IF_ZERO, {value}, label);
+        return;
+    }
+
+    std::int32_t constant;
+    bool is_constant = constant_(condition.rhs(), constant);
+
+    condition.lhs().emit_code(*this);
+    if (not is_constant) {
+        condition.rhs().emit_code(*this);
+    }
+    std::int32_t lhs = take_(condition.lhs());
+    std::int32_t rhs = is_constant ? constant : take_(condition.rhs());
+    release_(lhs);
+    if (not is_constant) {
+        release_(rhs);
+    }
+
+    // The opcode jumping if the comparison holds, and the one jumping if not.
+    Opcode opcodes[2] = {Opcode::JUMP_IF_EQ, Opcode::JUMP_IF_NE};
+    switch (condition.op()) {
+        case ast::Comparison_Operation::EQUAL:
+            opcodes[0] = Opcode::JUMP_IF_EQ; opcodes[1] = Opcode::JUMP_IF_NE; break;
+        case ast::Comparison_Operation::NOT_EQUAL:
+            opcodes[0] = Opcode::JUMP_IF_NE; opcodes[1] = Opcode::JUMP_IF_EQ; break;
+        case ast::Comparison_Operation::LESS_THAN:
+            opcodes[0] = Opcode::JUMP_IF_LT; opcodes[1] = Opcode::JUMP_IF_GE; break;
+        case ast::Comparison_Operation::GREATER_THAN:
+            opcodes[0] = Opcode::JUMP_IF_GT; opcodes[1] = Opcode::JUMP_IF_LE; break;
+        case ast::Comparison_Operation::LESS_THAN_OR_EQUAL:
+            opcodes[0] = Opcode::JUMP_IF_LE; opcodes[1] = Opcode::JUMP_IF_GT; break;
+        case ast::Comparison_Operation::GREATER_THAN_OR_EQUAL:
+            opcodes[0] = Opcode::JUMP_IF_GE; opcodes[1] = Opcode::JUMP_IF_LT; break;
+    }
+    Opcode opcode = opcodes[when ? 0 : 1];
+
+    // The _K forms come in the same order, after JUMP_IF_GE.
+    if (is_constant) {
+        opcode = static_cast<Opcode>(static_cast<std::int32_t>(opcode)
+            - static_cast<std::int32_t>(Opcode::JUMP_IF_EQ)
+            + static_cast<std::int32_t>(Opcode::JUMP_IF_EQ_K));
+    }
+    emit_jump_(opcode, {lhs, rhs}, label);
+}
+
+std::int32_t Bytecode_Generator::new_label_ () {
+    labels_.push_back(-1);
+    return static_cast<std::int32_t>(labels_.size() - 1);
+}
+
+void Bytecode_Generator::place_ (std::int32_t label) {
+    labels_[label] = static_cast<std::int32_t>(program_.code.size());
+    last_value_ = -1;
+}
+
+// Whether `node` is an integer constant, and which.
+bool Bytecode_Generator::constant_ (const ast::Expression& node, std::int32_t& value) {
+    if (node.kind() == ast::Kind::CONST_INTEGER) {
+        value = ast::Const_Integer(node).value();
+        return true;
+    }
+    return false;
+}
+
+std::size_t Bytecode_Generator::function_index_ (const std::string& name, parser::Type type) {
+    auto iter = program_.function_indices.find(name);
+    if (iter != std::end(program_.function_indices)) {
+        return iter->second;
+    }
+    Program::Function function;
+    function.name = name;
+    function.type = type;
+    program_.functions.push_back(function);
+    program_.function_indices[name] = program_.functions.size() - 1;
+    return program_.functions.size() - 1;
+}
+
+
+// Interpreter - member function definitions
+
+Interpreter::Interpreter (Program& program)
+      : program_(program),
+        host_functions_(program.functions.size(), nullptr),
+        globals_(program.globals, 0) {
+    for (std::size_t call : program_.calls) {
+        std::int32_t* instruction = &program_.code[call];
+        std::size_t function = static_cast<std::size_t>(instruction[2]);
+        if (program_.functions[function].entry != -1) {
+            continue;
+        }
+
+        const std::string& name = program_.functions[function].name;
+        if (not host_functions_[function]) {
+            host_functions_[function] = jit::host_symbol(name);
+            if (not host_functions_[function]) {
+                throw std::runtime_error("undefined function '" + name + "'");
+            }
+        }
+        if (instruction[3] > 6) {
+            throw std::runtime_error("too many arguments for host function '" + name + "'");
+        }
+        instruction[0] = static_cast<std::int32_t>(Opcode::CALL_HOST);
+    }
+}
+
+Value Interpreter::call_host_ (std::size_t function, const Value* arguments, std::int32_t count) const {
+    // All the arguments are of the INTEGER class of the System V calling
+    // convention: whatever the signature, they go in the same registers.
+    typedef Value (*F) (Value, Value, Value, Value, Value, Value);
+    Value a[6] = {0, 0, 0, 0, 0, 0};
+    std::copy(arguments, arguments + count, a);
+    Value result = reinterpret_cast<F>(host_functions_[function])(a[0], a[1], a[2], a[3], a[4], a[5]);
+    if (program_.functions[function].type == parser::Type::INT) {
+        result = static_cast<std::int32_t>(result);
+    }
+    return result;
+}
+
+namespace {
+
+// A function being run, below the one running.
+struct Frame {
+    const std::int32_t* return_address;
+    std::size_t         base;    // of its registers on the stack
+    std::size_t         top;     // base + its number of registers
+    std::int32_t        result;  // register receiving the result of the call
+};
+
+inline std::int32_t integer (Value value) { return static_cast<std::int32_t>(value); }
+
+// Arithmetic wraps around, like in the LLVM IR.
+inline Value wrap (std::uint32_t value) { return static_cast<std::int32_t>(value); }
+
+// Unsigned, like the udiv of the LLVM IR.
+inline Value divide (Value lhs, Value rhs) {
+    std::uint32_t divisor = static_cast<std::uint32_t>(rhs);
+    if (divisor == 0) {
+        throw std::runtime_error("division by zero");
+    }
+    return wrap(static_cast<std::uint32_t>(lhs) / divisor);
+}
+
+inline Value remainder (Value lhs, Value rhs) {
+    std::int32_t divisor = integer(rhs);
+    if (divisor == 0) {
+        throw std::runtime_error("division by zero");
+    }
+    return divisor == -1 ? 0 : integer(lhs) % divisor;
+}
+
+inline const char* string (Value value) { return reinterpret_cast<const char*>(value); }
+
+inline Value new_string (std::size_t size) {
+    return reinterpret_cast<Value>(static_cast<char*>(std::malloc(size + 1)));
+}
+
+}  // namespace
+
+#if defined(__GNUC__)
+#define BYTECODE_THREADED
+#endif
+
+#ifdef BYTECODE_THREADED
+#define INSTRUCTION(opcode) op_##opcode:
+#define DISPATCH() goto *kTargets[*pc]
+#else
+#define INSTRUCTION(opcode) case Opcode::opcode:
+#define DISPATCH() continue
+#endif
+
+int Interpreter::run_main () {
+    auto main = program_.function_indices.find("main");
+    if (main == std::end(program_.function_indices) or
+        program_.functions[main->second].entry == -1) {
+        throw std::runtime_error("no main function");
+    }
+    const Program::Function& function = program_.functions[main->second];
+
+    std::vector<Frame> frames;
+    std::size_t base = 0;
+    std::size_t top = function.registers;
+    stack_.assign(std::max<std::size_t>(top, 1024), 0);
+
+    Value* r = stack_.data();
+    Value* globals = globals_.data();
+    const std::int32_t* code = program_.code.data();
+    const std::int32_t* pc = code + function.entry;
+    Value result;
+
+#ifdef BYTECODE_THREADED
+    // In the order of Opcode.
+    static const void* const kTargets[] = {
+        &&op_MOVE, &&op_LOAD_INT, &&op_LOAD_STRING, &&op_LOAD_GLOBAL,
+        &&op_STORE_GLOBAL, &&op_NEGATE,
+        &&op_ADD, &&op_SUB, &&op_MUL, &&op_DIV, &&op_MOD, &&op_SHL, &&op_SHR,
+        &&op_ADD_K, &&op_SUB_K, &&op_MUL_K, &&op_DIV_K, &&op_MOD_K, &&op_SHL_K, &&op_SHR_K,
+        &&op_EQ, &&op_NE, &&op_LT, &&op_GT, &&op_LE, &&op_GE,
+        &&op_STRING_EQ, &&op_STRING_NE, &&op_CONCAT, &&op_COPY, &&op_FREE,
+        &&op_JUMP, &&op_JUMP_IF_ZERO, &&op_JUMP_IF_NOT_ZERO,
+        &&op_JUMP_IF_EQ, &&op_JUMP_IF_NE, &&op_JUMP_IF_LT, &&op_JUMP_IF_GT,
+        &&op_JUMP_IF_LE, &&op_JUMP_IF_GE,
+        &&op_JUMP_IF_EQ_K, &&op_JUMP_IF_NE_K, &&op_JUMP_IF_LT_K, &&op_JUMP_IF_GT_K,
+        &&op_JUMP_IF_LE_K, &&op_JUMP_IF_GE_K,
+        &&op_CALL, &&op_CALL_HOST, &&op_RETURN,
+    };
+    static_assert(sizeof kTargets / sizeof kTargets[0] == static_cast<std::size_t>(Opcode::kSize),
+        "kTargets does not match Opcode");
+
+    DISPATCH();
+#else
+    for (;;) switch (static_cast<Opcode>(*pc)) {
+#endif
+
+    INSTRUCTION(MOVE)         { r[pc[1]] = r[pc[2]];                         pc += 3; DISPATCH(); }
+    INSTRUCTION(LOAD_INT)     { r[pc[1]] = pc[2];                            pc += 3; DISPATCH(); }
+    INSTRUCTION(LOAD_STRING)  { r[pc[1]] = reinterpret_cast<Value>(&program_.strings[pc[2]][0]); pc += 3; DISPATCH(); }
+    INSTRUCTION(LOAD_GLOBAL)  { r[pc[1]] = globals[pc[2]];                   pc += 3; DISPATCH(); }
+    INSTRUCTION(STORE_GLOBAL) { globals[pc[1]] = r[pc[2]];                   pc += 3; DISPATCH(); }
+    INSTRUCTION(NEGATE)       { r[pc[1]] = wrap(0u - static_cast<std::uint32_t>(r[pc[2]])); pc += 3; DISPATCH(); }
+
+    INSTRUCTION(ADD) { r[pc[1]] = wrap(static_cast<std::uint32_t>(r[pc[2]]) + static_cast<std::uint32_t>(r[pc[3]])); pc += 4; DISPATCH(); }
+    INSTRUCTION(SUB) { r[pc[1]] = wrap(static_cast<std::uint32_t>(r[pc[2]]) - static_cast<std::uint32_t>(r[pc[3]])); pc += 4; DISPATCH(); }
+    INSTRUCTION(MUL) { r[pc[1]] = wrap(static_cast<std::uint32_t>(r[pc[2]]) * static_cast<std::uint32_t>(r[pc[3]])); pc += 4; DISPATCH(); }
+    INSTRUCTION(DIV) { r[pc[1]] = divide(r[pc[2]], r[pc[3]]);    pc += 4; DISPATCH(); }
+    INSTRUCTION(MOD) { r[pc[1]] = remainder(r[pc[2]], r[pc[3]]); pc += 4; DISPATCH(); }
+    // The count is masked, like x86-64 does.
+    INSTRUCTION(SHL) { r[pc[1]] = wrap(static_cast<std::uint32_t>(r[pc[2]]) << (r[pc[3]] & 31)); pc += 4; DISPATCH(); }
+    INSTRUCTION(SHR) { r[pc[1]] = integer(r[pc[2]]) >> (r[pc[3]] & 31);                       pc += 4; DISPATCH(); }
+
+    INSTRUCTION(ADD_K) { r[pc[1]] = wrap(static_cast<std::uint32_t>(r[pc[2]]) + static_cast<std::uint32_t>(pc[3])); pc += 4; DISPATCH(); }
+    INSTRUCTION(SUB_K) { r[pc[1]] = wrap(static_cast<std::uint32_t>(r[pc[2]]) - static_cast<std::uint32_t>(pc[3])); pc += 4; DISPATCH(); }
+    INSTRUCTION(MUL_K) { r[pc[1]] = wrap(static_cast<std::uint32_t>(r[pc[2]]) * static_cast<std::uint32_t>(pc[3])); pc += 4; DISPATCH(); }
+    INSTRUCTION(DIV_K) { r[pc[1]] = divide(r[pc[2]], pc[3]);                                       pc += 4; DISPATCH(); }
+    INSTRUCTION(MOD_K) { r[pc[1]] = remainder(r[pc[2]], pc[3]);                                    pc += 4; DISPATCH(); }
+    INSTRUCTION(SHL_K) { r[pc[1]] = wrap(static_cast<std::uint32_t>(r[pc[2]]) << (pc[3] & 31));    pc += 4; DISPATCH(); }
+    INSTRUCTION(SHR_K) { r[pc[1]] = integer(r[pc[2]]) >> (pc[3] & 31);                            pc += 4; DISPATCH(); }
+
+    INSTRUCTION(EQ) { r[pc[1]] = integer(r[pc[2]]) == integer(r[pc[3]]); pc += 4; DISPATCH(); }
+    INSTRUCTION(NE) { r[pc[1]] = integer(r[pc[2]]) != integer(r[pc[3]]); pc += 4; DISPATCH(); }
+    INSTRUCTION(LT) { r[pc[1]] = integer(r[pc[2]]) <  integer(r[pc[3]]); pc += 4; DISPATCH(); }
+    INSTRUCTION(GT) { r[pc[1]] = integer(r[pc[2]]) >  integer(r[pc[3]]); pc += 4; DISPATCH(); }
+    INSTRUCTION(LE) { r[pc[1]] = integer(r[pc[2]]) <= integer(r[pc[3]]); pc += 4; DISPATCH(); }
+    INSTRUCTION(GE) { r[pc[1]] = integer(r[pc[2]]) >= integer(r[pc[3]]); pc += 4; DISPATCH(); }
+
+    INSTRUCTION(STRING_EQ) { r[pc[1]] = std::strcmp(string(r[pc[2]]), string(r[pc[3]])) == 0; pc += 4; DISPATCH(); }
+    INSTRUCTION(STRING_NE) { r[pc[1]] = std::strcmp(string(r[pc[2]]), string(r[pc[3]])) != 0; pc += 4; DISPATCH(); }
+    INSTRUCTION(CONCAT) {
+        const char* lhs = string(r[pc[2]]);
+        const char* rhs = string(r[pc[3]]);
+        std::size_t lhs_size = std::strlen(lhs);
+        std::size_t rhs_size = std::strlen(rhs);
+        Value value = new_string(lhs_size + rhs_size);
+        std::memcpy(reinterpret_cast<char*>(value), lhs, lhs_size);
+        std::memcpy(reinterpret_cast<char*>(value) + lhs_size, rhs, rhs_size + 1);
+        r[pc[1]] = value;
+        pc += 4; DISPATCH();
+    }
+    INSTRUCTION(COPY) {
+        const char* source = string(r[pc[2]]);
+        std::size_t size = std::strlen(source);
+        Value value = new_string(size);
+        std::memcpy(reinterpret_cast<char*>(value), source, size + 1);
+        r[pc[1]] = value;
+        pc += 3; DISPATCH();
+    }
+    INSTRUCTION(FREE) { std::free(reinterpret_cast<char*>(r[pc[1]])); pc += 2; DISPATCH(); }
+
+    INSTRUCTION(JUMP)             { pc = code + pc[1];                                     DISPATCH(); }
+    INSTRUCTION(JUMP_IF_ZERO)     { pc = integer(r[pc[1]]) == 0 ? code + pc[2] : pc + 3; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_NOT_ZERO) { pc = integer(r[pc[1]]) != 0 ? code + pc[2] : pc + 3; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_EQ) { pc = integer(r[pc[1]]) == integer(r[pc[2]]) ? code + pc[3] : pc + 4; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_NE) { pc = integer(r[pc[1]]) != integer(r[pc[2]]) ? code + pc[3] : pc + 4; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_LT) { pc = integer(r[pc[1]]) <  integer(r[pc[2]]) ? code + pc[3] : pc + 4; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_GT) { pc = integer(r[pc[1]]) >  integer(r[pc[2]]) ? code + pc[3] : pc + 4; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_LE) { pc = integer(r[pc[1]]) <= integer(r[pc[2]]) ? code + pc[3] : pc + 4; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_GE) { pc = integer(r[pc[1]]) >= integer(r[pc[2]]) ? code + pc[3] : pc + 4; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_EQ_K) { pc = integer(r[pc[1]]) == pc[2] ? code + pc[3] : pc + 4; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_NE_K) { pc = integer(r[pc[1]]) != pc[2] ? code + pc[3] : pc + 4; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_LT_K) { pc = integer(r[pc[1]]) <  pc[2] ? code + pc[3] : pc + 4; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_GT_K) { pc = integer(r[pc[1]]) >  pc[2] ? code + pc[3] : pc + 4; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_LE_K) { pc = integer(r[pc[1]]) <= pc[2] ? code + pc[3] : pc + 4; DISPATCH(); }
+    INSTRUCTION(JUMP_IF_GE_K) { pc = integer(r[pc[1]]) >= pc[2] ? code + pc[3] : pc + 4; DISPATCH(); }
+
+    INSTRUCTION(CALL) {
+        const Program::Function& callee = program_.functions[pc[2]];
+        std::int32_t count = pc[3];
+
+        std::size_t callee_top = top + callee.registers;
+        if (stack_.size() < callee_top) {
+            stack_.resize(std::max(callee_top, 2 * stack_.size()));
+            r = stack_.data() + base;
+        }
+        Value* callee_r = stack_.data() + top;
+        std::fill(callee_r, callee_r + callee.registers, 0);
+        for (std::int32_t i = 0; i < count; ++i) {
+            callee_r[i] = r[pc[4 + i]];
+        }
+
+        frames.push_back(Frame {pc + 4 + count, base, top, pc[1]});
+        base = top;
+        top = callee_top;
+        r = callee_r;
+        pc = code + callee.entry;
+        DISPATCH();
+    }
+    INSTRUCTION(CALL_HOST) {
+        std::int32_t count = pc[3];
+        Value arguments[6];
+        for (std::int32_t i = 0; i < count; ++i) {
+            arguments[i] = r[pc[4 + i]];
+        }
+        r[pc[1]] = call_host_(static_cast<std::size_t>(pc[2]), arguments, count);
+        pc += 4 + count;
+        DISPATCH();
+    }
+    INSTRUCTION(RETURN) {
+        Value value = r[pc[1]];
+        if (frames.empty()) {
+            result = value;
+            goto done;
+        }
+        const Frame& frame = frames.back();
+        pc = frame.return_address;
+        base = frame.base;
+        top = frame.top;
+        r = stack_.data() + base;
+        r[frame.result] = value;
+        frames.pop_back();
+        DISPATCH();
+    }
+
+#ifndef BYTECODE_THREADED
+        case Opcode::kSize:
+            throw std::logic_error("invalid opcode");
+    }
+#endif
+
+done:
+    std::fflush(stdout);
+    return integer(result);
+}
+
+#undef INSTRUCTION
+#undef DISPATCH
+#undef BYTECODE_THREADED
+
+
+}  // namespace bytecode
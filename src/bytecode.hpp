@@ -0,0 +1,227 @@
+#ifndef __CSTR_COMPILER__BYTECODE_HPP
+#define __CSTR_COMPILER__BYTECODE_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ast.hpp"
+#include "stats.hpp"
+#include "symbol.hpp"
+
+
+namespace bytecode {
+
+
+// Instructions of the register machine run by Interpreter. Each is one opcode
+// word followed by its operands: d is the register written, a, b and s are
+// registers read, k an integer, t the offset of an instruction in the code.
+// The value-producing instructions write d first, and read their operands
+// before writing it. The _K forms take an integer constant instead of b.
+enum class Opcode : std::int32_t {
+    MOVE,              // d s
+    LOAD_INT,          // d k
+    LOAD_STRING,       // d k     (Program::strings[k])
+    LOAD_GLOBAL,       // d k
+    STORE_GLOBAL,      // k s
+    NEGATE,            // d s
+    ADD,               // d a b
+    SUB,               // d a b
+    MUL,               // d a b
+    DIV,               // d a b   (unsigned, like the udiv of the LLVM IR)
+    MOD,               // d a b
+    SHL,               // d a b
+    SHR,               // d a b   (arithmetic)
+    ADD_K,             // d a k
+    SUB_K,             // d a k
+    MUL_K,             // d a k
+    DIV_K,             // d a k
+    MOD_K,             // d a k
+    SHL_K,             // d a k
+    SHR_K,             // d a k
+    EQ,                // d a b
+    NE,                // d a b
+    LT,                // d a b
+    GT,                // d a b
+    LE,                // d a b
+    GE,                // d a b
+    STRING_EQ,         // d a b
+    STRING_NE,         // d a b
+    CONCAT,            // d a b   (a new string, to be freed)
+    COPY,              // d s     (a new string, to be freed)
+    FREE,              // s
+    JUMP,              // t
+    JUMP_IF_ZERO,      // s t
+    JUMP_IF_NOT_ZERO,  // s t
+    JUMP_IF_EQ,        // a b t
+    JUMP_IF_NE,        // a b t
+    JUMP_IF_LT,        // a b t
+    JUMP_IF_GT,        // a b t
+    JUMP_IF_LE,        // a b t
+    JUMP_IF_GE,        // a b t
+    JUMP_IF_EQ_K,      // a k t
+    JUMP_IF_NE_K,      // a k t
+    JUMP_IF_LT_K,      // a k t
+    JUMP_IF_GT_K,      // a k t
+    JUMP_IF_LE_K,      // a k t
+    JUMP_IF_GE_K,      // a k t
+    CALL,              // d k n s1 ... sn   (Program::functions[k])
+    CALL_HOST,         // d k n s1 ... sn   (set by Interpreter for functions
+                       //                    the program does not define)
+    RETURN,            // s
+    kSize
+};
+
+// A register: an int (sign-extended) or a string (char*).
+typedef std::intptr_t Value;
+
+
+// A translation unit compiled by Bytecode_Generator.
+struct Program {
+    struct Function {
+        std::string  name;
+        parser::Type type;
+        std::int32_t entry     = -1;  // Offset in `code`, -1 if not defined.
+        std::int32_t registers = 0;   // Arguments first, then locals and temporaries.
+    };
+
+    std::vector<std::int32_t>                    code;
+    std::vector<Function>                        functions;
+    std::unordered_map<std::string, std::size_t> function_indices;
+    std::vector<std::string>                     strings;  // Constants.
+    std::size_t                                  globals = 0;
+
+    // Offsets of the CALL instructions in `code`.
+    std::vector<std::size_t> calls;
+};
+
+
+// Code generator compiling to bytecode, for the same node set as
+// llvm::LLVM_Generator, into a Program that Interpreter runs straight away.
+//
+// Arguments and local variables live in registers of their own, and
+// expressions read the registers of the local variables they use directly.
+// The values of the other expressions take a temporary register, given back
+// when the expression using it is compiled, unless they are assigned to a
+// local variable straight away: then they are computed into its register.
+// Integer constants on the right of an operator are operands of the
+// instruction, and conditions of control flow instructions compile to
+// compare-and-branch instructions.
+class Bytecode_Generator final : public ast::Code_Generator {
+  public:
+    explicit Bytecode_Generator (Program& program) : program_(program) {}
+
+    void visit (ast::Declaration_List&       node) override;
+    void visit (ast::Variable&               node) override;
+    void visit (ast::Const_Integer&          node) override;
+    void visit (ast::Const_String&           node) override;
+    void visit (ast::Unary_Expression&       node) override;
+    void visit (ast::Binary_Expression&      node) override;
+    void visit (ast::Condition&              node) override;
+    void visit (ast::Assignment&             node) override;
+    void visit (ast::Function_Call&          node) override;
+    void visit (ast::Instruction&            node) override;
+    void visit (ast::Expression_Instruction& node) override;
+    void visit (ast::Cond_Instruction&       node) override;
+    void visit (ast::While_Instruction&      node) override;
+    void visit (ast::Do_Instruction&         node) override;
+    void visit (ast::For_Instruction&        node) override;
+    void visit (ast::Return_Instruction&     node) override;
+    void visit (ast::Compound_Instruction&   node) override;
+    void visit (ast::Function_Declaration&   node) override;
+    void visit (ast::Function_Definition&    node) override;
+
+    // For driver::generate_while_parsing(): the program is complete as soon
+    // as parsing is.
+    void finish () {}
+    std::size_t bytes_written () const { return program_.code.size() * sizeof (std::int32_t); }
+
+  private:
+    Program& program_;
+
+    // Containers of the generator state, charged to code generation in
+    // --mem-report.
+    template <typename Key, typename Value>
+    using Map = stats::Map<Key, Value, stats::Pool::CODEGEN>;
+    template <typename T>
+    using Vector = stats::Vector<T, stats::Pool::CODEGEN>;
+
+    Map<std::string, std::int32_t>            globals_;    // index, by name
+    Map<parser::Symbol::Ptr, std::int32_t>    variables_;  // register
+    ast::Value_Table<std::int32_t>            values_;     // register
+
+    // Registers of the function being defined.
+    std::int32_t         registers_ = 0;
+    Vector<bool>         temporary_;        // by register
+    Vector<std::int32_t> free_temporaries_;
+    Vector<std::int32_t> strings_to_free_;  // Hold the strings built here.
+
+    // Labels of the function being defined: their offsets (-1 until
+    // placed), and the operands to set to them.
+    Vector<std::int32_t>                         labels_;
+    Vector<std::pair<std::size_t, std::int32_t>> label_operands_;
+
+    // Registers.
+    std::int32_t allocate_ ();
+    std::int32_t variable_ ();
+    void         release_  (std::int32_t value);
+    std::int32_t take_     (const ast::Expression& node);
+
+    // Code. `last_value_` is the offset of the last instruction emitted if it
+    // produces a value, or -1.
+    std::int64_t last_value_ = -1;
+
+    void emit_ (Opcode opcode, std::initializer_list<std::int32_t> operands);
+    void emit_jump_ (Opcode opcode, std::initializer_list<std::int32_t> operands, std::int32_t label);
+
+    // Jumps to `label` if `condition` is `when`.
+    void branch_ (const ast::Condition& condition, bool when, std::int32_t label);
+
+    std::int32_t new_label_ ();
+    void place_ (std::int32_t label);
+
+    static bool constant_ (const ast::Expression& node, std::int32_t& value);
+
+    std::size_t function_index_ (const std::string& name, parser::Type type);
+};
+
+
+// Runs a Program.
+//
+// Registers live on one stack, and calls push a frame on it instead of
+// recursing, so that the depth of recursion of the program is only bound by
+// memory. Functions the program calls without defining are host functions
+// (see jit::host_symbol()) with at most six arguments; the string runtime is
+// built into the instruction set. Instructions are dispatched with computed
+// gotos where the compiler supports them (GCC, Clang), and with a switch
+// elsewhere.
+class Interpreter {
+  public:
+    // Binds the host functions. Throws std::runtime_error if one is not
+    // found.
+    explicit Interpreter (Program& program);
+
+    // Calls `int main()`, and returns what it returns. Throws
+    // std::runtime_error on a division by zero.
+    int run_main ();
+
+  private:
+    Program&           program_;
+    std::vector<void*> host_functions_;  // by function index
+    std::vector<Value> globals_;
+    std::vector<Value> stack_;
+
+    Value call_host_ (std::size_t function, const Value* arguments, std::int32_t count) const;
+};
+
+
+}  // namespace bytecode
+
+
+#endif  // __CSTR_COMPILER__BYTECODE_HPP
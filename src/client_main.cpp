@@ -0,0 +1,106 @@
+// Thin client for `compiler --serve`: sends stdin to the server and writes the
+// IR it gets back to stdout. Deliberately does not use iostreams, so that it
+// starts faster than the compiler itself.
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <string>
+
+#include "protocol.hpp"
+
+
+static void usage (const char* program) {
+    std::fprintf(stderr,
+        "usage: %s [--socket PATH] [--preprocess] < input.c > output.ll\n"
+        "       %s [--socket PATH] --shutdown\n",
+        program, program);
+}
+
+static int fail (const char* what) {
+    std::fprintf(stderr, "client: %s: %s\n", what, std::strerror(errno));
+    return 1;
+}
+
+int main (int argc, char** argv) {
+    std::string socket_path = protocol::default_socket_path();
+    const char* command = protocol::kCompile;
+    bool shutdown_server = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--socket") == 0 and i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--preprocess") == 0) {
+            command = protocol::kCompilePreprocess;
+        } else if (std::strcmp(argv[i], "--shutdown") == 0) {
+            command = protocol::kShutdown;
+            shutdown_server = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        std::fprintf(stderr, "client: socket path too long: %s\n", socket_path.c_str());
+        return 1;
+    }
+    std::strcpy(address.sun_path, socket_path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return fail("socket");
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        return fail(socket_path.c_str());
+    }
+
+    // Send the request, then signal its end by shutting down our side.
+    std::string request = std::string(protocol::kMagic) + ' ' + command + '\n';
+    if (not shutdown_server and not protocol::read_all(STDIN_FILENO, request)) {
+        return fail("stdin");
+    }
+    if (not protocol::write_all(fd, request.data(), request.size())) {
+        return fail("send");
+    }
+    shutdown(fd, SHUT_WR);
+
+    std::string response;
+    if (not protocol::read_all(fd, response)) {
+        return fail("receive");
+    }
+    close(fd);
+
+    if (shutdown_server) {
+        return 0;
+    }
+
+    // "<status> <diagnostics length>\n" <diagnostics> <IR>
+    int status;
+    std::size_t diagnostics_size;
+    std::string::size_type end_of_header = response.find('\n');
+    if (end_of_header == std::string::npos or
+        std::sscanf(response.c_str(), "%d %zu", &status, &diagnostics_size) != 2 or
+        end_of_header + 1 + diagnostics_size > response.size()) {
+        std::fprintf(stderr, "client: malformed response from server\n");
+        return 1;
+    }
+
+    const char* diagnostics = response.data() + end_of_header + 1;
+    const char* ir = diagnostics + diagnostics_size;
+    protocol::write_all(STDERR_FILENO, diagnostics, diagnostics_size);
+    if (not protocol::write_all(STDOUT_FILENO, ir, response.data() + response.size() - ir)) {
+        return fail("stdout");
+    }
+
+    return status;
+}
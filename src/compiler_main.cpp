@@ -1,26 +1,166 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
+#include <exception>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
-// NOTE: These two files must be included in this order.
-#include "scanner.hpp"
-#include "symbol_table.hpp"
+#include "driver.hpp"
+#include "mapped_file.hpp"
+#include "output_buffer.hpp"
+#include "passes.hpp"
+#include "protocol.hpp"
+#include "server.hpp"
 
-#include "ast.hpp"
-#include "llvm.hpp"
-#include "parser.tab.hpp"
+
+void usage (const char* program) {
+    std::cerr
+        << "usage: " << program << " [options] < input.c > output.ll" << std::endl
+        << "       " << program << " [options] [-j N] input.c... (writes input.ll...)" << std::endl
+        << "       " << program << " [options] --serve[=SOCKET]  (compile requests from bin/client)" << std::endl
+        << "       " << program << " [options] --run[=vm] [input.c]  (run main in-process, exit with its result)" << std::endl
+        << std::endl
+        << "  --preprocess      run the preprocessor in-process on the input first" << std::endl
+        << "  --flush=function  buffer the IR and write it once per function (default)" << std::endl
+        << "  --flush=line      write and flush the IR after every line" << std::endl
+        << "  -j N              compile up to N input files at the same time" << std::endl
+        << "  --time-report     print the time spent in each phase to stderr" << std::endl
+        << "  --mem-report      print the heap usage of each part of the compiler to stderr" << std::endl
+        << "  --cache=DIR       reuse the IR of unchanged functions from, and store it in, DIR" << std::endl
+        << "  --whole-module[=N] parse the whole input first, then generate functions on N threads" << std::endl
+        << "  --emit=bc         write LLVM bitcode (.bc) instead of textual IR (.ll)" << std::endl
+        << "  --emit=asm        write x86-64 assembly (.s), for gcc or as instead of llc" << std::endl
+        << "  --emit=ll         write textual IR (default)" << std::endl
+        << "  --emit=ast        write the parsed input (.ast), to compile instead of the source later" << std::endl
+        << "  --run             compile to machine code in memory and run it instead" << std::endl
+        << "  --run=vm          compile to bytecode and interpret it instead" << std::endl
+        << "  -O0, -O1, -O2     optimization level: the AST passes run before code generation" << std::endl
+        << "  --print-after=PASS print each function to stderr after pass PASS" << std::endl
+        ;
+}
 
 int main (int argc, char** argv) {
-    scanner::Scanner scanner;
-    parser::Symbol_Table::Ptr symbol_table =
-        parser::Symbol_Table::construct("global scope", parser::location());
-    llvm::LLVM_Generator llvm_generator(std::cout);
-    llvm_generator.indentation("  ");
-    parser::Parser parser(scanner, symbol_table, llvm_generator);
+    driver::Options options;
+    std::vector<std::string> input_files;
+    bool serve = false;
+    std::string socket_path = protocol::default_socket_path();
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--preprocess") == 0) {
+            options.preprocess = true;
+        } else if (std::strcmp(argv[i], "--flush=function") == 0) {
+            options.flush_policy = output::Flush_Policy::EXPLICIT;
+        } else if (std::strcmp(argv[i], "--flush=line") == 0) {
+            options.flush_policy = output::Flush_Policy::LINE;
+        } else if (std::strcmp(argv[i], "--time-report") == 0) {
+            options.time_report = true;
+        } else if (std::strcmp(argv[i], "--mem-report") == 0) {
+            options.mem_report = true;
+        } else if (std::strncmp(argv[i], "--cache=", 8) == 0) {
+            options.cache_directory = &argv[i][8];
+        } else if (std::strcmp(argv[i], "--whole-module") == 0) {
+            options.codegen_jobs = std::max(1u, std::thread::hardware_concurrency());
+        } else if (std::strncmp(argv[i], "--whole-module=", 15) == 0) {
+            int jobs = std::atoi(&argv[i][15]);
+            if (jobs < 1) {
+                usage(argv[0]);
+                return 1;
+            }
+            options.codegen_jobs = static_cast<std::size_t>(jobs);
+        } else if (std::strcmp(argv[i], "--emit=bc") == 0) {
+            options.output_format = driver::Output_Format::BITCODE;
+        } else if (std::strcmp(argv[i], "--emit=asm") == 0) {
+            options.output_format = driver::Output_Format::ASSEMBLY;
+        } else if (std::strcmp(argv[i], "--emit=ll") == 0) {
+            options.output_format = driver::Output_Format::LLVM_IR;
+        } else if (std::strcmp(argv[i], "--emit=ast") == 0) {
+            options.output_format = driver::Output_Format::AST;
+        } else if (std::strcmp(argv[i], "--run") == 0) {
+            options.run = driver::Engine::MACHINE_CODE;
+        } else if (std::strcmp(argv[i], "--run=vm") == 0) {
+            options.run = driver::Engine::BYTECODE;
+        } else if (std::strcmp(argv[i], "-O0") == 0 or std::strcmp(argv[i], "-O1") == 0 or
+                   std::strcmp(argv[i], "-O2") == 0) {
+            options.optimization_level = argv[i][2] - '0';
+        } else if (std::strncmp(argv[i], "--print-after=", 14) == 0) {
+            options.print_after = &argv[i][14];
+            std::vector<std::string> names = passes::pass_names();
+            if (std::find(names.begin(), names.end(), options.print_after) == names.end()) {
+                std::cerr << argv[0] << ": unknown pass '" << options.print_after << "'" << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--serve") == 0) {
+            serve = true;
+        } else if (std::strncmp(argv[i], "--serve=", 8) == 0) {
+            serve = true;
+            socket_path = &argv[i][8];
+        } else if (std::strncmp(argv[i], "-j", 2) == 0) {
+            // Accept both "-j N" and "-jN".
+            const char* value = argv[i][2] != '\0' ? &argv[i][2]
+                : (i + 1 < argc ? argv[++i] : "");
+            int jobs = std::atoi(value);
+            if (jobs < 1) {
+                usage(argv[0]);
+                return 1;
+            }
+            options.jobs = static_cast<std::size_t>(jobs);
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            input_files.push_back(argv[i]);
+        }
+    }
+
+    // The IR is written through output::Output_Buffer in large blocks. Without
+    // stdio synchronisation each of those blocks reaches stdout in one write.
+    std::ios::sync_with_stdio(false);
+
+    if (options.run != driver::Engine::NONE) {
+        if (serve or input_files.size() > 1) {
+            usage(argv[0]);
+            return 1;
+        }
+        try {
+            if (input_files.empty()) {
+                return driver::compile(std::cin, std::cout, options);
+            }
+            // Mapped if possible, which an AST image has to be.
+            std::unique_ptr<input::Mapped_File> file;
+            if (input::Mapped_File::can_map(input_files[0])) {
+                try {
+                    file.reset(new input::Mapped_File(input_files[0], driver::input_slack(options)));
+                } catch (const std::exception&) {
+                }
+            }
+            if (file) {
+                return driver::compile(*file, std::cout, options, input_files[0]);
+            }
+            std::ifstream in (input_files[0]);
+            if (not in) {
+                std::cerr << input_files[0] << ": cannot open input file" << std::endl;
+                return 1;
+            }
+            return driver::compile(in, std::cout, options, input_files[0]);
+        } catch (const std::exception& e) {
+            std::cerr << argv[0] << ": " << e.what() << std::endl;
+            return 1;
+        }
+    }
 
-    parser.parse();
+    if (serve) {
+        return server::serve(socket_path, options);
+    }
 
-    // std::cout << std::endl << "SYMBOL TABLES" << std::endl << std::endl;
-    // parser::Symbol_Table::print_tables();
+    if (not input_files.empty()) {
+        return driver::compile_files(input_files, options);
+    }
 
-    return 0;
+    return driver::compile(std::cin, std::cout, options);
 }
@@ -0,0 +1,445 @@
+#include "driver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// NOTE: These two files must be included in this order.
+#include "scanner.hpp"
+#include "symbol_table.hpp"
+
+#include "ast.hpp"
+#include "ast_image.hpp"
+#include "bitcode.hpp"
+#include "bytecode.hpp"
+#include "ir_cache.hpp"
+#include "jit.hpp"
+#include "llvm.hpp"
+#include "mapped_file.hpp"
+#include "parser.tab.hpp"
+#include "passes.hpp"
+#include "preprocessor.hpp"
+#include "stats.hpp"
+#include "x86_64.hpp"
+
+
+namespace driver {
+
+
+// Generates the code of a module parsed as a whole. The function definitions
+// are handed out to `jobs` threads, each with a generator of its own; their IR
+// is then written by `generator` in source order, together with the other top
+// level declarations. Each function is numbered on its own (see
+// llvm::LLVM_Generator), so the output does not depend on which thread
+// generated it.
+static void generate_module (
+    const ast::Module& module,
+    llvm::LLVM_Generator& generator,
+    ir_cache::Cache* cache,
+    std::size_t jobs
+) {
+    stats::Phase_Timer timer (stats::Phase::CODE_GENERATION);
+
+    std::vector<ast::Function_Definition::Ptr> functions;
+    std::vector<bool> is_function;
+    for (auto& node : module.nodes()) {
+        auto function = std::dynamic_pointer_cast<ast::Function_Definition>(node);
+        if (function) {
+            functions.push_back(function);
+        }
+        is_function.push_back(function != nullptr);
+    }
+
+    std::vector<ir_cache::Entry> results (functions.size());
+    std::atomic<std::size_t> next_function (0);
+    std::exception_ptr error;
+    std::mutex mutex;
+
+    // Each worker counts into a report of its own, which is added to the
+    // current one when it is done. Only the time spent in the whole of code
+    // generation is reported, not its breakdown by node kind.
+    stats::Report* report = stats::current();
+
+    auto worker = [&] () {
+        stats::Report worker_report;
+        stats::Scope report_scope (report ? &worker_report : nullptr);
+
+        std::ostringstream unused;
+        llvm::LLVM_Generator function_generator (unused, output::Flush_Policy::EXPLICIT);
+        function_generator.indentation(std::string(generator.indentation()));
+        function_generator.cache(cache);
+
+        for (
+            std::size_t i = next_function++;
+            i < functions.size();
+            i = next_function++
+        ) {
+            try {
+                results[i] = function_generator.function_ir(*functions[i]);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock (mutex);
+                if (not error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+
+        if (report) {
+            std::lock_guard<std::mutex> lock (mutex);
+            report->add_counters(worker_report);
+        }
+    };
+
+    jobs = std::max<std::size_t>(1, std::min(jobs, functions.size()));
+    std::vector<std::thread> pool;
+    for (std::size_t i = 1; i < jobs; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < module.nodes().size(); ++i) {
+        if (is_function[i]) {
+            generator.append_function(results[k++]);
+        } else {
+            module.nodes()[i]->emit_code(generator);
+        }
+    }
+}
+
+
+// Hands each top level node of the translation unit to a code generator as
+// soon as it is parsed (or loaded), and returns the exit status of the parse.
+typedef std::function<int (ast::Code_Generator&)> Parse;
+
+// Parses with `generator` generating the code of each top level declaration
+// as soon as it is reduced, then finishes the output through `writer` (which
+// may be the generator itself). For the generators other than
+// llvm::LLVM_Generator, which neither cache functions nor generate them in
+// parallel.
+template <typename Writer>
+static int generate_while_parsing (
+    ast::Code_Generator& generator,
+    Writer& writer,
+    const Parse& parse,
+    stats::Report& report,
+    const Options& options,
+    const std::string& name
+) {
+    int status = parse(generator);
+    writer.finish();
+
+    if (options.time_report) {
+        stats::count(stats::Counter::BYTES_EMITTED, writer.bytes_written());
+        report.print_times(std::cerr, name);
+    }
+    if (options.mem_report) {
+        report.print_memory(std::cerr, name);
+    }
+    return status;
+}
+
+
+// Compiles the translation unit read from `in`, or, if `file` is not nullptr,
+// scanned in place from `file`.
+static int compile_ (
+    std::istream* in,
+    input::Mapped_File* file,
+    std::ostream& out,
+    const Options& options,
+    const std::string& name
+) {
+    stats::Report report;
+    stats::Scope report_scope (
+        options.time_report or options.mem_report ? &report : nullptr);
+
+    // A translation unit parsed before and written by --emit=ast is loaded
+    // instead of parsed: the input is neither preprocessed nor scanned.
+    ast::Module image;
+    parser::Symbol_Table::Ptr symbol_table;
+    bool is_image = file and ast_image::is_image(file->text(), file->size());
+    if (is_image) {
+        stats::Phase_Timer timer (stats::Phase::LOADING);
+        symbol_table = ast_image::load(file->text(), file->size(), image);
+    } else {
+        symbol_table = parser::Symbol_Table::construct("global scope", parser::location());
+    }
+
+    // The preprocessor's output is collected in one string, which the scanner
+    // then scans in place.
+    std::string preprocessed;
+    if (options.preprocess and not is_image) {
+        stats::Phase_Timer timer (stats::Phase::PREPROCESSING);
+        std::ostringstream preprocessor_output;
+        preprocessor::Preprocessor preprocessor(in, &preprocessor_output);
+        if (file) {
+            preprocessor.scan_in_place(file->text(), file->size(), file->slack());
+        }
+        preprocessor.yylex();
+        preprocessed = preprocessor_output.str();
+        preprocessed.append(2, '\0');
+    }
+
+    // Everything below is owned by this compilation.
+    parser::Parse_State parse_state;
+
+    scanner::Scanner scanner(in);
+    if (is_image) {
+        // Not scanned.
+    } else if (options.preprocess) {
+        scanner.scan_in_place(&preprocessed[0], preprocessed.size() - 2);
+    } else if (file) {
+        scanner.scan_in_place(file->text(), file->size());
+    }
+
+    // An image holds the tree as parsed: the passes run when it is compiled.
+    bool writes_image = options.output_format == Output_Format::AST and options.run == Engine::NONE;
+    int optimization_level = writes_image ? 0 : options.optimization_level;
+    if (writes_image) {
+        // So that the image can be compiled with --cache.
+        parse_state.hash_functions = true;
+    }
+
+    Parse parse = [&] (ast::Code_Generator& code_generator) {
+        passes::Pass_Manager pass_manager(code_generator, optimization_level, options.print_after);
+        if (is_image) {
+            ast::Code_Generator& generator = pass_manager;
+            for (auto& node : image.nodes()) {
+                node->emit_code(generator);
+            }
+            return 0;
+        }
+        parser::Parser parser(scanner, symbol_table, pass_manager, parse_state);
+        stats::Phase_Timer timer (stats::Phase::PARSING);
+        return parser.parse();
+    };
+
+    switch (options.run) {
+        case Engine::MACHINE_CODE: {
+            jit::Machine_Code_Assembler assembler;
+            x86_64::X86_64_Generator generator(assembler);
+            int status = generate_while_parsing(generator, assembler, parse,
+                report, options, name);
+            if (status != 0) {
+                return status;
+            }
+            jit::Program program(assembler);
+            return program.run_main();
+        }
+        case Engine::BYTECODE: {
+            bytecode::Program program;
+            bytecode::Bytecode_Generator generator(program);
+            int status = generate_while_parsing(generator, generator, parse,
+                report, options, name);
+            if (status != 0) {
+                return status;
+            }
+            bytecode::Interpreter interpreter(program);
+            return interpreter.run_main();
+        }
+        case Engine::NONE:
+            break;
+    }
+
+    switch (options.output_format) {
+        case Output_Format::BITCODE: {
+            bitcode::Bitcode_Generator generator(out);
+            return generate_while_parsing(generator, generator, parse,
+                report, options, name);
+        }
+        case Output_Format::ASSEMBLY: {
+            x86_64::Text_Assembler assembler(out, options.flush_policy);
+            x86_64::X86_64_Generator generator(assembler);
+            return generate_while_parsing(generator, assembler, parse,
+                report, options, name);
+        }
+        case Output_Format::AST: {
+            // Only a translation unit parsed without errors is written.
+            ast::Module module;
+            int status = parse(module);
+            if (status == 0) {
+                ast_image::write(module, *symbol_table, out);
+            }
+            if (options.time_report) {
+                report.print_times(std::cerr, name);
+            }
+            if (options.mem_report) {
+                report.print_memory(std::cerr, name);
+            }
+            return status;
+        }
+        case Output_Format::LLVM_IR:
+            break;
+    }
+
+    llvm::LLVM_Generator llvm_generator(out, options.flush_policy);
+    llvm_generator.indentation("  ");
+
+    std::unique_ptr<ir_cache::Cache> cache;
+    if (not options.cache_directory.empty()) {
+        cache.reset(new ir_cache::Cache(options.cache_directory));
+        llvm_generator.cache(cache.get());
+        parse_state.hash_functions = true;
+    }
+    // In whole-module mode the parser only collects the top level nodes.
+    ast::Module module;
+    ast::Code_Generator& code_generator = options.codegen_jobs > 0
+        ? static_cast<ast::Code_Generator&>(module)
+        : llvm_generator;
+    int status = parse(code_generator);
+
+    // Code for what was parsed before an error is still generated, as it
+    // would have been while parsing.
+    if (options.codegen_jobs > 0) {
+        generate_module(module, llvm_generator, cache.get(), options.codegen_jobs);
+    }
+
+    // std::cout << std::endl << "SYMBOL TABLES" << std::endl << std::endl;
+    // symbol_table->print(std::cout);
+
+    if (options.time_report) {
+        llvm_generator.flush();
+        stats::count(stats::Counter::BYTES_EMITTED, llvm_generator.output().bytes_written());
+        report.print_times(std::cerr, name);
+    }
+    if (options.mem_report) {
+        report.print_memory(std::cerr, name);
+    }
+
+    return status;
+}
+
+
+int compile (
+    std::istream& in,
+    std::ostream& out,
+    const Options& options,
+    const std::string& name
+) {
+    return compile_(&in, nullptr, out, options, name);
+}
+
+int compile (
+    input::Mapped_File& file,
+    std::ostream& out,
+    const Options& options,
+    const std::string& name
+) {
+    return compile_(nullptr, &file, out, options, name);
+}
+
+
+std::size_t input_slack (const Options& options) {
+    return options.preprocess ? preprocessor::Preprocessor::kSlack : 0;
+}
+
+
+std::string output_file_name (const std::string& input_file, Output_Format format) {
+    const char* suffix = ".ll";
+    switch (format) {
+        case Output_Format::LLVM_IR:  suffix = ".ll"; break;
+        case Output_Format::BITCODE:  suffix = ".bc"; break;
+        case Output_Format::ASSEMBLY: suffix = ".s";  break;
+        case Output_Format::AST:      suffix = ".ast"; break;
+    }
+    std::string::size_type extension = input_file.rfind('.');
+    std::string::size_type directory = input_file.rfind('/');
+    if (extension == std::string::npos or
+        (directory != std::string::npos and extension < directory)) {
+        return input_file + suffix;
+    }
+    return input_file.substr(0, extension) + suffix;
+}
+
+
+int compile_files (const std::vector<std::string>& input_files, const Options& options) {
+    std::atomic<std::size_t> next_file (0);
+    std::atomic<int> failures (0);
+    std::mutex error_mutex;
+
+    auto report = [&] (const std::string& file, const std::string& message) {
+        std::lock_guard<std::mutex> lock (error_mutex);
+        std::cerr << file << ": " << message << std::endl;
+    };
+
+    // Each worker keeps taking the next file that nobody has claimed yet.
+    auto worker = [&] () {
+        for (
+            std::size_t i = next_file++;
+            i < input_files.size();
+            i = next_file++
+        ) {
+            const std::string& input_file = input_files[i];
+            std::string output_file = output_file_name(input_file, options.output_format);
+
+            // Mapped if possible. Pipes and other files that cannot be mapped
+            // (e.g. /dev/stdin, or <(...) in the shell) are read as a stream.
+            std::unique_ptr<input::Mapped_File> mapped;
+            if (input::Mapped_File::can_map(input_file)) {
+                try {
+                    mapped.reset(new input::Mapped_File(input_file, input_slack(options)));
+                } catch (const std::exception&) {
+                }
+            }
+            std::ifstream stream;
+            if (not mapped) {
+                stream.open(input_file, std::ios::binary);
+                if (not stream) {
+                    report(input_file, "cannot open input file");
+                    ++failures;
+                    continue;
+                }
+            }
+            std::ofstream out (output_file, std::ios::binary);
+            if (not out) {
+                report(output_file, "cannot open output file");
+                ++failures;
+                continue;
+            }
+
+            try {
+                int status = mapped
+                    ? compile(*mapped, out, options, input_file)
+                    : compile(stream, out, options, input_file);
+                if (status != 0) {
+                    report(input_file, "compilation failed");
+                    ++failures;
+                }
+            } catch (const std::exception& e) {
+                report(input_file, e.what());
+                ++failures;
+            }
+        }
+    };
+
+    std::size_t jobs = std::max<std::size_t>(1, std::min(options.jobs, input_files.size()));
+    std::vector<std::thread> pool;
+    for (std::size_t i = 1; i < jobs; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+
+}  // namespace driver
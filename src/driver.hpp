@@ -0,0 +1,128 @@
+#ifndef __CSTR_COMPILER__DRIVER_HPP
+#define __CSTR_COMPILER__DRIVER_HPP
+
+
+#include <cstddef>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "output_buffer.hpp"
+
+
+namespace driver {
+
+
+enum class Output_Format {
+    LLVM_IR,   // textual IR (.ll), see llvm::LLVM_Generator
+    BITCODE,   // bitcode (.bc), see bitcode::Bitcode_Generator
+    ASSEMBLY,  // x86-64 assembly (.s), see x86_64::X86_64_Generator
+    AST,       // the parsed translation unit (.ast), see ast_image
+};
+
+// How Options::run runs a program.
+enum class Engine {
+    NONE,          // Don't: write the output.
+    MACHINE_CODE,  // see jit::Program
+    BYTECODE,      // see bytecode::Interpreter
+};
+
+
+struct Options {
+    // Run the preprocessor in-process and feed its output straight to the
+    // scanner, instead of expecting already preprocessed input.
+    bool preprocess = false;
+
+    output::Flush_Policy flush_policy = output::Flush_Policy::EXPLICIT;
+
+    // Number of translation units compiled at the same time by
+    // compile_files().
+    std::size_t jobs = 1;
+
+    // Print the time spent in each phase and a few counters to std::cerr
+    // after each compilation.
+    bool time_report = false;
+
+    // Print the live and peak heap usage of the AST, the symbol tables, the
+    // code generator and the parser's semantic values to std::cerr after each
+    // compilation.
+    bool mem_report = false;
+
+    // Number of threads generating the code of function definitions. 0 to
+    // generate the code of each top level declaration as soon as the parser
+    // reduces it; otherwise the whole translation unit is parsed first (see
+    // ast::Module), and the output is the same either way.
+    std::size_t codegen_jobs = 0;
+
+    // Directory of the on-disk cache of function IR (see ir_cache::Cache).
+    // Empty to disable the cache.
+    std::string cache_directory;
+
+    // Bitcode and assembly are always generated while parsing, and go
+    // neither through the cache nor through codegen_jobs threads.
+    Output_Format output_format = Output_Format::LLVM_IR;
+
+    // Instead of writing any output, compile to machine code or to bytecode
+    // in memory and run the program's main, whose result becomes the exit
+    // status of the compilation. Ignores output_format.
+    Engine run = Engine::NONE;
+
+    // Optimization level, 0 to 2: the pipeline of AST passes run on each
+    // function definition before code generation (see passes::pipeline()).
+    int optimization_level = 0;
+
+    // Name of a pass after which each function definition is printed to
+    // std::cerr, as source code. Empty not to print anything.
+    std::string print_after;
+};
+
+
+// Compile one translation unit read from `in` and write its LLVM IR (or
+// bitcode, or assembly, see Options::output_format) to `out`, or run it (see
+// Options::run).
+// `name` identifies the translation unit in reports. Returns the exit status
+// of the compilation (0 on success).
+int compile (
+    std::istream& in,
+    std::ostream& out,
+    const Options& options,
+    const std::string& name = "<stdin>"
+);
+
+// Same, for a translation unit mapped into memory. The scanner (and the
+// preprocessor) scan `file` in place. If `file` is an AST image (see
+// Output_Format::AST), it is loaded instead, and its code generated as if it
+// had just been parsed.
+int compile (
+    input::Mapped_File& file,
+    std::ostream& out,
+    const Options& options,
+    const std::string& name
+);
+
+// The slack to map an input file with (see input::Mapped_File) for compile().
+std::size_t input_slack (const Options& options);
+
+// Name of the IR file written for `input_file`: "foo.c" becomes "foo.ll", or
+// "foo.bc" for bitcode, or "foo.s" for assembly, or "foo.ast" for an AST
+// image.
+std::string output_file_name (
+    const std::string& input_file,
+    Output_Format format = Output_Format::LLVM_IR
+);
+
+// Compile every file in `input_files` on a pool of `options.jobs` threads,
+// writing one .ll (or .bc, or .s) file next to each input. Regular input
+// files are mapped into memory (see input::Mapped_File), and the others
+// (pipes, devices) read as streams. All state of a compilation is local
+// to it, so translation units do not share anything. Returns 0 if every file
+// compiled successfully.
+int compile_files (const std::vector<std::string>& input_files, const Options& options);
+
+
+}  // namespace driver
+
+
+#endif  // __CSTR_COMPILER__DRIVER_HPP
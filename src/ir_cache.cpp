@@ -0,0 +1,116 @@
+#include "ir_cache.hpp"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+
+namespace ir_cache {
+
+
+// Bumped whenever the IR emitted for the same source changes, so that stale
+// entries are never used.
+static const char kFormat[] = "cstr-ir-cache 1";
+
+
+// Hasher - member function definitions
+
+static const unsigned __int128 kOffsetBasis =
+    (static_cast<unsigned __int128>(0x6c62272e07bb0142ull) << 64) | 0x62b821756295c58dull;
+static const unsigned __int128 kPrime =
+    (static_cast<unsigned __int128>(0x0000000001000000ull) << 64) | 0x000000000000013bull;
+
+Hasher::Hasher () : state_(kOffsetBasis) {}
+
+Hasher& Hasher::add (const void* data, std::size_t size) {
+    auto bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        state_ ^= bytes[i];
+        state_ *= kPrime;
+    }
+    return *this;
+}
+
+Hasher& Hasher::add (const std::string& s) {
+    // Include the size so that ("ab", "c") and ("a", "bc") differ.
+    add(static_cast<std::uint64_t>(s.size()));
+    return add(s.data(), s.size());
+}
+
+Hasher& Hasher::add (std::uint64_t value) {
+    return add(&value, sizeof(value));
+}
+
+std::string Hasher::hex () const {
+    char buffer[33];
+    std::snprintf(buffer, sizeof(buffer), "%016llx%016llx",
+        static_cast<unsigned long long>(state_ >> 64),
+        static_cast<unsigned long long>(state_));
+    return buffer;
+}
+
+
+// Cache - member function definitions
+
+Cache::Cache (const std::string& directory) : directory_(directory) {
+    mkdir(directory_.c_str(), 0777);
+}
+
+std::string Cache::path_ (const std::string& key) const {
+    return directory_ + '/' + key + ".ll";
+}
+
+bool Cache::lookup (const std::string& key, Entry& entry) const {
+    std::ifstream in (path_(key), std::ios::binary);
+    if (not in) {
+        return false;
+    }
+
+    std::string format;
+    int needs_string_functions;
+    if (not std::getline(in, format) or format != kFormat or
+        not (in >> needs_string_functions) or in.get() != '\n') {
+        return false;
+    }
+
+    std::ostringstream ir;
+    ir << in.rdbuf();
+    entry.ir = ir.str();
+    entry.needs_string_functions = needs_string_functions != 0;
+    return true;
+}
+
+void Cache::store (const std::string& key, const Entry& entry) const {
+    // Unique among the threads and processes that may be storing the same
+    // key at the same time.
+    static std::atomic<unsigned> counter (0);
+    std::string path = path_(key);
+    std::string temporary = path + ".tmp." + std::to_string(getpid())
+        + '.' + std::to_string(counter++);
+
+    {
+        std::ofstream out (temporary, std::ios::binary);
+        if (not out) {
+            return;
+        }
+        out << kFormat << '\n' << (entry.needs_string_functions ? 1 : 0) << '\n' << entry.ir;
+        if (not out.flush()) {
+            std::remove(temporary.c_str());
+            return;
+        }
+    }
+
+    // A cache that cannot be written to only costs speed.
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+    }
+}
+
+
+}  // namespace ir_cache
@@ -0,0 +1,67 @@
+#ifndef __CSTR_COMPILER__IR_CACHE_HPP
+#define __CSTR_COMPILER__IR_CACHE_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+
+
+namespace ir_cache {
+
+
+// 128-bit FNV-1a. Cache keys are used as file names, so they have to be wide
+// enough that two different functions never share one in practice.
+class Hasher {
+  public:
+    Hasher ();
+
+    Hasher& add (const void* data, std::size_t size);
+    Hasher& add (const std::string& s);
+    Hasher& add (std::uint64_t value);
+
+    // The hash, as 32 hexadecimal digits.
+    std::string hex () const;
+
+    // A 64-bit digest (the low half of the hash).
+    std::uint64_t digest () const { return static_cast<std::uint64_t>(state_); }
+
+  private:
+    unsigned __int128 state_;
+};
+
+
+// The IR of one function definition, as emitted by llvm::LLVM_Generator.
+struct Entry {
+    std::string ir;
+
+    // The function calls the string runtime, which has to be declared in the
+    // module.
+    bool needs_string_functions = false;
+};
+
+
+// Content addressed store of function IR, one file per key under
+// `directory`. Several compilations (or processes) may share a directory:
+// entries are written to a temporary file and renamed into place.
+class Cache {
+  public:
+    explicit Cache (const std::string& directory);
+
+    const std::string& directory () const { return directory_; }
+
+    bool lookup (const std::string& key, Entry& entry) const;
+    void store  (const std::string& key, const Entry& entry) const;
+
+  private:
+    std::string directory_;
+
+    std::string path_ (const std::string& key) const;
+};
+
+
+}  // namespace ir_cache
+
+
+#endif  // __CSTR_COMPILER__IR_CACHE_HPP
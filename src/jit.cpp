@@ -0,0 +1,465 @@
+#include "jit.hpp"
+
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+
+namespace jit {
+
+
+using x86_64::Operand;
+using x86_64::Register;
+
+
+// Hardware numbers of x86_64::Register.
+static const unsigned kHardware[] = {
+    3, 12, 13, 14, 15,       // RBX, R12 - R15
+    0, 1, 2, 6, 7, 8, 9, 11  // RAX, RCX, RDX, RSI, RDI, R8, R9, R11
+};
+const unsigned HW_RSP = 4;
+const unsigned HW_RBP = 5;
+
+// Condition codes of Jcc and SETcc, by x86_64::Condition_Code.
+static const unsigned kConditions[] = {0x4, 0x5, 0xC, 0xF, 0xE, 0xD};
+
+
+static void patch_32 (std::vector<std::uint8_t>& bytes, std::size_t offset, long value) {
+    if (value < std::numeric_limits<std::int32_t>::min() or
+        value > std::numeric_limits<std::int32_t>::max()) {
+        throw std::runtime_error("displacement out of range");
+    }
+    std::uint32_t word = static_cast<std::uint32_t>(value);
+    for (int i = 0; i < 4; ++i) {
+        bytes[offset + i] = static_cast<std::uint8_t>(word >> (8 * i));
+    }
+}
+
+
+// Machine_Code_Assembler - member function definitions
+
+void Machine_Code_Assembler::global_variable (const std::string& name, int size) {
+    std::size_t offset = align_data_(size);
+    data_.resize(data_.size() + size, 0);
+    symbols_[name] = Symbol {Section::DATA, offset};
+}
+
+void Machine_Code_Assembler::string_constant (const std::string& label, const std::string& bytes) {
+    symbols_[label] = Symbol {Section::DATA, data_.size()};
+    data_.insert(std::end(data_), std::begin(bytes), std::end(bytes));
+    data_.push_back('\0');
+}
+
+void Machine_Code_Assembler::begin_function (const std::string& name) {
+    body_.clear();
+    body_fixups_.clear();
+    labels_.clear();
+}
+
+void Machine_Code_Assembler::end_function (const x86_64::Frame& frame) {
+    labels_[frame.epilogue] = body_.size();
+
+    long size = frame.size + 8 * static_cast<long>(frame.saved.size());
+    size = (size + 15) / 16 * 16;
+
+    symbols_[frame.name] = Symbol {Section::CODE, code_.size()};
+
+    // pushq %rbp; movq %rsp, %rbp; subq $size, %rsp
+    byte_(code_, 0x55);
+    byte_(code_, 0x48); byte_(code_, 0x89); byte_(code_, 0xE5);
+    if (size > 0) {
+        byte_(code_, 0x48); byte_(code_, 0x81); byte_(code_, 0xC0 | 5 << 3 | HW_RSP);
+        immediate_(code_, size);
+    }
+    for (std::size_t i = 0; i < frame.saved.size(); ++i) {
+        Operand save (Operand::Kind::FRAME, -frame.size - 8 * static_cast<long>(i + 1));
+        encode_(code_, fixups_, {0x89}, true, kHardware[frame.saved[i]], save);
+    }
+    for (long slot : frame.zeroed_slots) {
+        encode_(code_, fixups_, {0xC7}, true, 0, Operand (Operand::Kind::FRAME, slot), true, 0);
+    }
+
+    // The body, with its jumps resolved. Other references are resolved by
+    // Program.
+    std::size_t base = code_.size();
+    code_.insert(std::end(code_), std::begin(body_), std::end(body_));
+    for (auto& fixup : body_fixups_) {
+        auto label = labels_.find(fixup.symbol);
+        if (label != std::end(labels_)) {
+            patch_32(code_, base + fixup.offset,
+                static_cast<long>(label->second) - static_cast<long>(fixup.offset) + fixup.addend);
+        } else {
+            fixups_.push_back(Fixup {base + fixup.offset, fixup.symbol, fixup.addend});
+        }
+    }
+
+    for (std::size_t i = 0; i < frame.saved.size(); ++i) {
+        Operand save (Operand::Kind::FRAME, -frame.size - 8 * static_cast<long>(i + 1));
+        encode_(code_, fixups_, {0x8B}, true, kHardware[frame.saved[i]], save);
+    }
+    byte_(code_, 0xC9);  // leave
+    byte_(code_, 0xC3);  // ret
+}
+
+void Machine_Code_Assembler::move (const Operand& from, const Operand& to) {
+    bool wide = to.type == parser::Type::STRING;
+    if (from.kind == Operand::Kind::IMMEDIATE) {
+        instruction_({0xC7}, wide, 0, to, true, from.value);
+    } else if (to.kind == Operand::Kind::REGISTER) {
+        instruction_({0x8B}, wide, kHardware[to.value], from);
+    } else {
+        instruction_({0x89}, wide, kHardware[from.value], to);
+    }
+}
+
+void Machine_Code_Assembler::load_address (const std::string& label, Register to) {
+    instruction_({0x8D}, true, kHardware[to],
+        Operand (Operand::Kind::SYMBOL, 0, parser::Type::STRING, label));
+}
+
+void Machine_Code_Assembler::arithmetic (
+    x86_64::Operation operation,
+    const Operand& source,
+    const Operand& destination
+) {
+    if (source.kind == Operand::Kind::IMMEDIATE) {
+        switch (operation) {
+            case x86_64::Operation::ADD:
+                instruction_({0x81}, false, 0, destination, true, source.value);
+                break;
+            case x86_64::Operation::SUB:
+                instruction_({0x81}, false, 5, destination, true, source.value);
+                break;
+            case x86_64::Operation::CMP:
+                instruction_({0x81}, false, 7, destination, true, source.value);
+                break;
+            case x86_64::Operation::IMUL:
+                instruction_({0x69}, false, kHardware[destination.value], destination, true, source.value);
+                break;
+        }
+        return;
+    }
+
+    unsigned reg = kHardware[destination.value];
+    switch (operation) {
+        case x86_64::Operation::ADD:  instruction_({0x03},       false, reg, source); break;
+        case x86_64::Operation::SUB:  instruction_({0x2B},       false, reg, source); break;
+        case x86_64::Operation::CMP:  instruction_({0x3B},       false, reg, source); break;
+        case x86_64::Operation::IMUL: instruction_({0x0F, 0xAF}, false, reg, source); break;
+    }
+}
+
+void Machine_Code_Assembler::negate (Register value) {
+    instruction_({0xF7}, false, 3, Operand (Operand::Kind::REGISTER, value));
+}
+
+void Machine_Code_Assembler::divide (Register divisor, bool is_signed) {
+    Operand operand (Operand::Kind::REGISTER, divisor);
+    if (is_signed) {
+        byte_(body_, 0x99);  // cltd
+        instruction_({0xF7}, false, 7, operand);
+    } else {
+        byte_(body_, 0x31); byte_(body_, 0xD2);  // xorl %edx, %edx
+        instruction_({0xF7}, false, 6, operand);
+    }
+}
+
+void Machine_Code_Assembler::shift (x86_64::Shift shift, Register value) {
+    instruction_({0xD3}, false, shift == x86_64::Shift::LEFT ? 4 : 7,
+        Operand (Operand::Kind::REGISTER, value));
+}
+
+void Machine_Code_Assembler::set (x86_64::Condition_Code condition) {
+    byte_(body_, 0x0F);
+    byte_(body_, 0x90 | kConditions[static_cast<int>(condition)]);
+    byte_(body_, 0xC0);  // %al
+}
+
+void Machine_Code_Assembler::zero_extend () {
+    byte_(body_, 0x0F); byte_(body_, 0xB6); byte_(body_, 0xC0);  // movzbl %al, %eax
+}
+
+void Machine_Code_Assembler::push (const Operand& value) {
+    switch (value.kind) {
+        case Operand::Kind::IMMEDIATE:
+            byte_(body_, 0x68);
+            immediate_(body_, value.value);
+            break;
+        case Operand::Kind::REGISTER: {
+            unsigned hardware = kHardware[value.value];
+            if (hardware >= 8) {
+                byte_(body_, 0x41);
+            }
+            byte_(body_, 0x50 | (hardware & 7));
+            break;
+        }
+        default:
+            instruction_({0xFF}, false, 6, value);
+            break;
+    }
+}
+
+void Machine_Code_Assembler::adjust_stack (long bytes) {
+    byte_(body_, 0x48);
+    byte_(body_, 0x81);
+    byte_(body_, 0xC0 | (bytes < 0 ? 5 : 0) << 3 | HW_RSP);
+    immediate_(body_, bytes < 0 ? -bytes : bytes);
+}
+
+void Machine_Code_Assembler::call (const std::string& function) {
+    std::string slot = '@' + function;
+    if (symbols_.find(slot) == std::end(symbols_)) {
+        std::size_t offset = align_data_(8);
+        data_.resize(data_.size() + 8, 0);
+        symbols_[slot] = Symbol {Section::DATA, offset};
+        call_slots_.emplace_back(offset, function);
+    }
+
+    // callq *slot(%rip)
+    instruction_({0xFF}, false, 2,
+        Operand (Operand::Kind::SYMBOL, 0, parser::Type::STRING, slot));
+}
+
+void Machine_Code_Assembler::jump (const std::string& label) {
+    relative_jump_({0xE9}, label);
+}
+
+void Machine_Code_Assembler::jump_if (x86_64::Condition_Code condition, const std::string& label) {
+    relative_jump_({0x0F, 0x80 | kConditions[static_cast<int>(condition)]}, label);
+}
+
+void Machine_Code_Assembler::place (const std::string& label) {
+    labels_[label] = body_.size();
+}
+
+void Machine_Code_Assembler::immediate_ (Bytes& out, long value) {
+    std::size_t offset = out.size();
+    out.resize(offset + 4);
+    patch_32(out, offset, value);
+}
+
+void Machine_Code_Assembler::encode_ (
+    Bytes& out,
+    std::vector<Fixup>& fixups,
+    std::initializer_list<unsigned> opcode,
+    bool wide,
+    unsigned reg,
+    const Operand& rm,
+    bool has_immediate,
+    long immediate
+) {
+    unsigned rm_hardware = rm.kind == Operand::Kind::REGISTER ? kHardware[rm.value] : 0;
+
+    unsigned rex = (wide ? 8 : 0) | (reg >= 8 ? 4 : 0) | (rm_hardware >= 8 ? 1 : 0);
+    if (rex != 0) {
+        byte_(out, 0x40 | rex);
+    }
+    for (unsigned byte : opcode) {
+        byte_(out, byte);
+    }
+
+    switch (rm.kind) {
+        case Operand::Kind::REGISTER:
+            byte_(out, 0xC0 | (reg & 7) << 3 | (rm_hardware & 7));
+            break;
+
+        // disp8 or disp32 (%rbp)
+        case Operand::Kind::FRAME:
+            if (rm.value >= -128 and rm.value <= 127) {
+                byte_(out, 0x40 | (reg & 7) << 3 | HW_RBP);
+                byte_(out, static_cast<unsigned>(rm.value) & 0xFF);
+            } else {
+                byte_(out, 0x80 | (reg & 7) << 3 | HW_RBP);
+                immediate_(out, rm.value);
+            }
+            break;
+
+        // disp32 (%rip), relative to the end of the instruction.
+        case Operand::Kind::SYMBOL:
+            byte_(out, (reg & 7) << 3 | 5);
+            fixups.push_back(Fixup {out.size(), rm.symbol, has_immediate ? -8 : -4});
+            immediate_(out, 0);
+            break;
+
+        case Operand::Kind::IMMEDIATE:
+            throw std::logic_error("immediate operand where a register or memory is needed");
+    }
+
+    if (has_immediate) {
+        immediate_(out, immediate);
+    }
+}
+
+void Machine_Code_Assembler::relative_jump_ (std::initializer_list<unsigned> opcode, const std::string& label) {
+    for (unsigned byte : opcode) {
+        byte_(body_, byte);
+    }
+    body_fixups_.push_back(Fixup {body_.size(), label, -4});
+    immediate_(body_, 0);
+}
+
+std::size_t Machine_Code_Assembler::align_data_ (std::size_t alignment) {
+    data_.resize((data_.size() + alignment - 1) / alignment * alignment, 0);
+    return data_.size();
+}
+
+
+// The string runtime (src/string_lib.ll) and the library of test/lib.
+
+static bool string_equal (const char* lhs, const char* rhs) {
+    return std::strcmp(lhs, rhs) == 0;
+}
+
+static bool string_not_equal (const char* lhs, const char* rhs) {
+    return std::strcmp(lhs, rhs) != 0;
+}
+
+static char* string_copy (const char* lhs) {
+    std::size_t size = std::strlen(lhs);
+    char* result = static_cast<char*>(std::malloc(size + 1));
+    std::memcpy(result, lhs, size + 1);
+    return result;
+}
+
+static char* string_concat (const char* lhs, const char* rhs) {
+    std::size_t lhs_size = std::strlen(lhs);
+    std::size_t rhs_size = std::strlen(rhs);
+    char* result = static_cast<char*>(std::malloc(lhs_size + rhs_size + 1));
+    std::memcpy(result, lhs, lhs_size);
+    std::memcpy(result + lhs_size, rhs, rhs_size + 1);
+    return result;
+}
+
+static void string_free (char* string) {
+    std::free(string);
+}
+
+static int printd (int d) {
+    return std::printf("%d", d);
+}
+
+static int get_char_at (char* s, int i) {
+    return s[i];
+}
+
+static int put_char_at (char* s, int i, int c) {
+    s[i] = c;
+    return c;
+}
+
+void* host_symbol (const std::string& name) {
+    static const std::unordered_map<std::string, void*> runtime {
+        {"__string_equal__",     reinterpret_cast<void*>(&string_equal)},
+        {"__string_not_equal__", reinterpret_cast<void*>(&string_not_equal)},
+        {"__string_copy__",      reinterpret_cast<void*>(&string_copy)},
+        {"__string_concat__",    reinterpret_cast<void*>(&string_concat)},
+        {"__string_free__",      reinterpret_cast<void*>(&string_free)},
+        {"printd",               reinterpret_cast<void*>(&printd)},
+        {"get_char_at",          reinterpret_cast<void*>(&get_char_at)},
+        {"put_char_at",          reinterpret_cast<void*>(&put_char_at)},
+    };
+
+    auto iter = runtime.find(name);
+    if (iter != std::end(runtime)) {
+        return iter->second;
+    }
+    return dlsym(RTLD_DEFAULT, name.c_str());
+}
+
+
+// Program - member function definitions
+
+Program::Program (const Machine_Code_Assembler& assembler)
+      : symbols_(assembler.symbols()) {
+    std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto round_up = [page_size] (std::size_t size) {
+        return (size + page_size - 1) / page_size * page_size;
+    };
+
+    code_size_ = round_up(assembler.code().size());
+    region_size_ = code_size_ + round_up(assembler.data().size() + 1);
+
+    void* region = mmap(nullptr, region_size_, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        throw std::runtime_error(std::string("cannot map program: ") + std::strerror(errno));
+    }
+    region_ = static_cast<std::uint8_t*>(region);
+
+    std::memcpy(region_, assembler.code().data(), assembler.code().size());
+    std::memcpy(region_ + code_size_, assembler.data().data(), assembler.data().size());
+
+    try {
+        for (auto& slot : assembler.call_slots()) {
+            void* function = symbol(slot.second);
+            if (not function) {
+                function = host_symbol(slot.second);
+            }
+            if (not function) {
+                throw std::runtime_error("undefined function '" + slot.second + "'");
+            }
+            std::memcpy(region_ + code_size_ + slot.first, &function, sizeof function);
+        }
+
+        std::vector<std::uint8_t> field (4);
+        for (auto& fixup : assembler.fixups()) {
+            auto iter = symbols_.find(fixup.symbol);
+            if (iter == std::end(symbols_)) {
+                throw std::runtime_error("undefined symbol '" + fixup.symbol + "'");
+            }
+            long value = address_(iter->second) - (region_ + fixup.offset) + fixup.addend;
+            patch_32(field, 0, value);
+            std::memcpy(region_ + fixup.offset, field.data(), 4);
+        }
+    } catch (...) {
+        munmap(region_, region_size_);
+        throw;
+    }
+
+    // The code is never written again.
+    if (code_size_ > 0 and mprotect(region_, code_size_, PROT_READ | PROT_EXEC) != 0) {
+        int saved_errno = errno;
+        munmap(region_, region_size_);
+        throw std::runtime_error(std::string("cannot map program: ") + std::strerror(saved_errno));
+    }
+}
+
+Program::~Program () {
+    munmap(region_, region_size_);
+}
+
+void* Program::symbol (const std::string& name) const {
+    auto iter = symbols_.find(name);
+    if (iter == std::end(symbols_)) {
+        return nullptr;
+    }
+    return address_(iter->second);
+}
+
+int Program::run_main () {
+    void* main = symbol("main");
+    if (not main) {
+        throw std::runtime_error("no main function");
+    }
+    int status = reinterpret_cast<int (*) ()>(main)();
+    std::fflush(stdout);
+    return status;
+}
+
+std::uint8_t* Program::address_ (const Machine_Code_Assembler::Symbol& symbol) const {
+    return region_
+        + (symbol.section == Machine_Code_Assembler::Section::CODE ? 0 : code_size_)
+        + symbol.offset;
+}
+
+
+}  // namespace jit
@@ -0,0 +1,163 @@
+#ifndef __CSTR_COMPILER__JIT_HPP
+#define __CSTR_COMPILER__JIT_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <initializer_list>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "x86_64.hpp"
+
+
+namespace jit {
+
+
+// Assembler encoding the instructions of x86_64::X86_64_Generator into x86-64
+// machine code, for a Program to run in-process.
+//
+// Functions go into one code section and string constants, global variables
+// and call slots into one data section. References between them are 32-bit
+// displacements relative to %rip, patched by Program once the sections have an
+// address. Calls go through the call slot of the function called, which
+// Program fills with the address of the function: the program's own, or a
+// host symbol (see Program).
+class Machine_Code_Assembler : public x86_64::Assembler {
+  public:
+    enum class Section { CODE, DATA };
+
+    struct Symbol {
+        Section     section;
+        std::size_t offset;
+    };
+
+    // A 32-bit field at `offset` in the code section, to be set to the
+    // address of `symbol` + `addend` - the address of the field.
+    struct Fixup {
+        std::size_t offset;
+        std::string symbol;
+        long        addend;
+    };
+
+    std::size_t bytes_written () const { return code_.size() + data_.size(); }
+
+    const std::vector<std::uint8_t>&                 code    () const { return code_;    }
+    const std::vector<std::uint8_t>&                 data    () const { return data_;    }
+    const std::unordered_map<std::string, Symbol>&   symbols () const { return symbols_; }
+    const std::vector<Fixup>&                        fixups  () const { return fixups_;  }
+
+    // Call slots: the offset of each in the data section, and the function
+    // whose address it holds.
+    const std::vector<std::pair<std::size_t, std::string>>& call_slots () const { return call_slots_; }
+
+    void global_variable (const std::string& name, int size) override;
+    void string_constant (const std::string& label, const std::string& bytes) override;
+    void begin_function  (const std::string& name) override;
+    void end_function    (const x86_64::Frame& frame) override;
+    void finish          () override {}
+
+    void move         (const x86_64::Operand& from, const x86_64::Operand& to) override;
+    void load_address (const std::string& label, x86_64::Register to) override;
+    void arithmetic   (x86_64::Operation operation, const x86_64::Operand& source, const x86_64::Operand& destination) override;
+    void negate       (x86_64::Register value) override;
+    void divide       (x86_64::Register divisor, bool is_signed) override;
+    void shift        (x86_64::Shift shift, x86_64::Register value) override;
+    void set          (x86_64::Condition_Code condition) override;
+    void zero_extend  () override;
+    void push         (const x86_64::Operand& value) override;
+    void adjust_stack (long bytes) override;
+    void call         (const std::string& function) override;
+    void jump         (const std::string& label) override;
+    void jump_if      (x86_64::Condition_Code condition, const std::string& label) override;
+    void place        (const std::string& label) override;
+
+  private:
+    std::vector<std::uint8_t>               code_;
+    std::vector<std::uint8_t>               data_;
+    std::unordered_map<std::string, Symbol> symbols_;
+    std::vector<Fixup>                      fixups_;
+    std::vector<std::pair<std::size_t, std::string>> call_slots_;
+
+    // The function being defined. Offsets are relative to the body.
+    std::vector<std::uint8_t>                    body_;
+    std::vector<Fixup>                           body_fixups_;
+    std::unordered_map<std::string, std::size_t> labels_;
+
+    // Encoding, into `out`.
+    typedef std::vector<std::uint8_t> Bytes;
+
+    static void byte_      (Bytes& out, unsigned value) { out.push_back(static_cast<std::uint8_t>(value)); }
+    static void immediate_ (Bytes& out, long value);
+
+    // An instruction with a ModRM byte: [REX] opcode ModRM [disp] [imm32].
+    // `reg` is the hardware number of a register or an opcode extension, `rm`
+    // a register or memory operand. `fixups` receives the relocation of a
+    // %rip-relative `rm`.
+    static void encode_ (
+        Bytes& out, std::vector<Fixup>& fixups,
+        std::initializer_list<unsigned> opcode, bool wide,
+        unsigned reg, const x86_64::Operand& rm,
+        bool has_immediate = false, long immediate = 0
+    );
+
+    // Same, in the body of the function being defined.
+    void instruction_ (
+        std::initializer_list<unsigned> opcode, bool wide,
+        unsigned reg, const x86_64::Operand& rm,
+        bool has_immediate = false, long immediate = 0
+    ) {
+        encode_(body_, body_fixups_, opcode, wide, reg, rm, has_immediate, immediate);
+    }
+
+    void relative_jump_ (std::initializer_list<unsigned> opcode, const std::string& label);
+    std::size_t align_data_ (std::size_t alignment);
+};
+
+
+// The address of the host function `name`: one of the string runtime (the
+// functions of src/string_lib.ll) or of the library of test/lib (printd, ...),
+// built into the compiler, or else any function of the compiler process (e.g.
+// of the C library). nullptr if there is none.
+void* host_symbol (const std::string& name);
+
+
+// A program assembled by a Machine_Code_Assembler, loaded into memory: its
+// code in executable pages, and its data in writable pages after them.
+//
+// Functions the program calls without defining bind to host functions (see
+// host_symbol()). Throws std::runtime_error if one is not found.
+class Program {
+  public:
+    explicit Program (const Machine_Code_Assembler& assembler);
+    ~Program ();
+
+    Program             (const Program&) = delete;
+    Program& operator = (const Program&) = delete;
+
+    // The address of a function or global variable of the program, or
+    // nullptr.
+    void* symbol (const std::string& name) const;
+
+    // Calls `int main()`, and returns what it returns.
+    int run_main ();
+
+  private:
+    std::uint8_t* region_;
+    std::size_t   region_size_;
+    std::size_t   code_size_;  // Page-aligned: the data starts there.
+
+    std::unordered_map<std::string, Machine_Code_Assembler::Symbol> symbols_;
+
+    std::uint8_t* address_ (const Machine_Code_Assembler::Symbol& symbol) const;
+};
+
+
+}  // namespace jit
+
+
+#endif  // __CSTR_COMPILER__JIT_HPP
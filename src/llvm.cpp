@@ -6,50 +6,73 @@
 #include <string>
 
 #include "ast.hpp"
+#include "atom.hpp"
+#include "stats.hpp"
 #include "symbol.hpp"
 
 
 namespace llvm {
 
 
-std::string type (parser::Type t) {
-    switch (t) {
-        case parser::Type::INT:
-            return "i32";
-        case parser::Type::STRING:
-            return "i8*";
-    }
-}
-
-
 // The align 4 ensures that the address will be a multiple of 4
-std::string alignment (parser::Type type) {
-  switch (type) {
-    case parser::Type::INT:
-      return "align 4";
-    case parser::Type::STRING:
-      return "align 8";
-  }
+constexpr const char* alignment (parser::Type type) {
+    return type == parser::Type::INT ? "align 4" : "align 8";
 }
 
 
-template <typename C, typename Op>
-void infix (std::ostream& out, const char* delim, const C& container, Op op) {
+// Writes each element of `container` with `write`, separated by `delim`.
+template <typename Out, typename C, typename Write>
+void infix (Out& out, const char* delim, const C& container, Write write) {
     auto iter = std::begin(container);
     if (iter != std::end(container)) {
-        out << op(*iter);
+        write(*iter);
         for (++iter; iter != std::end(container); ++iter) {
-            out << delim << op(*iter);
+            out << delim;
+            write(*iter);
         }
     }
 }
 
 
-// void LLVM_Generator::visit (ast::Node::Ptr                   node) {}
-// void LLVM_Generator::visit (ast::Expression::Ptr             node) {}
-// void LLVM_Generator::visit (ast::Terminal::Ptr               node) {}
-void LLVM_Generator::visit (ast::Declaration_List::Ptr       node) {
-    for (auto& symbol : node->symbol_list()) {
+output::Output_Buffer& operator << (output::Output_Buffer& out, const Label& label) {
+    return out << "label %Label_" << label.id();
+}
+
+output::Output_Buffer& operator << (output::Output_Buffer& out, const Value& value) {
+    switch (value.kind) {
+        case Value::Kind::CONSTANT:
+            break;
+        case Value::Kind::TEMPORARY:
+            out << "%tmp.";
+            break;
+        case Value::Kind::VARIABLE:
+            out << '%' << *value.name << '.';
+            break;
+        case Value::Kind::STRING:
+            out << '%' << *value.name;
+            break;
+    }
+    return out << value.number;
+}
+
+std::string to_string (const Value& value) {
+    switch (value.kind) {
+        case Value::Kind::CONSTANT:
+            return std::to_string(value.number);
+        case Value::Kind::TEMPORARY:
+            return "%tmp." + std::to_string(value.number);
+        case Value::Kind::VARIABLE:
+            return '%' + *value.name + '.' + std::to_string(value.number);
+        case Value::Kind::STRING:
+            return '%' + *value.name + std::to_string(value.number);
+    }
+    return std::string();
+}
+
+
+void LLVM_Generator::visit (ast::Declaration_List&       node) {
+    stats::Phase_Timer timer (ast::Kind::DECLARATION_LIST);
+    for (auto& symbol : node.symbol_list()) {
         apply_indent_();
 
         // Declare global variable.
@@ -57,7 +80,7 @@ void LLVM_Generator::visit (ast::Declaration_List::Ptr       node) {
             out_
                 << '@' << symbol->name() << " = global "
                 << type(symbol->type()) << " null"
-                << std::endl
+                << '\n'
                 ;
         }
 
@@ -66,50 +89,65 @@ void LLVM_Generator::visit (ast::Declaration_List::Ptr       node) {
             out_
                 << '%' << symbol->name() << " = alloca " << type(symbol->type())
                 << ", " << alignment(symbol->type())
-                << std::endl
+                << '\n'
                 ;
         }
     }
 }
-void LLVM_Generator::visit (ast::Variable::Ptr               node) {
-    const auto& symbol = node->symbol();
-
-    std::string register_reference = '%' + symbol->name();
-    register_reference += "." + to_string(increment_var_count_(symbol));
+void LLVM_Generator::enter (const ast::Expression& node) {
+    // The values computed from operands are numbered before them.
+    switch (node.kind()) {
+        case ast::Kind::VARIABLE:
+        case ast::Kind::CONST_INTEGER:
+        case ast::Kind::CONST_STRING:
+            break;
+        default: {
+            long number = register_reference_.size();
+            register_reference_[node] = Value(Value::Kind::TEMPORARY, number);
+            break;
+        }
+    }
+}
+void LLVM_Generator::visit (ast::Variable&               node) {
+    stats::Phase_Timer timer (ast::Kind::VARIABLE);
+    const auto& symbol = node.symbol();
 
-    register_reference_[node] = register_reference;
+    const Value& register_reference = register_reference_[node] = Value(
+        Value::Kind::VARIABLE, increment_var_count_(symbol), &symbol->name());
 
     apply_indent_();
-    switch (node->type()) {
+    switch (node.type()) {
         case parser::Type::INT:
             out_
                 << register_reference << " = load i32, i32* "
-                << (node->symbol()->get(parser::Symbol::Attribute::GLOBAL) ? '@' : '%')
+                << (node.symbol()->get(parser::Symbol::Attribute::GLOBAL) ? '@' : '%')
                 << symbol->name()
-                << std::endl;
+                << '\n';
             break;
         case parser::Type::STRING:
             // TODO
             out_
                 << register_reference << " = load i8*, i8** "
-                << (node->symbol()->get(parser::Symbol::Attribute::GLOBAL) ? '@' : '%')
+                << (node.symbol()->get(parser::Symbol::Attribute::GLOBAL) ? '@' : '%')
                 << symbol->name()
-                << std::endl;
+                << '\n';
             break;
     }
 }
-void LLVM_Generator::visit (ast::Const_Integer::Ptr          node) {
-    register_reference_[node] = to_string(node->value());
+void LLVM_Generator::visit (ast::Const_Integer&          node) {
+    stats::Phase_Timer timer (ast::Kind::CONST_INTEGER);
+    register_reference_[node] = Value(Value::Kind::CONSTANT, node.value());
 }
-void LLVM_Generator::visit (ast::Const_String::Ptr           node) {
-    std::string id = "str." + to_string(const_string_next_id_++);
-    const_strings_.emplace_back(id, node->value());
+void LLVM_Generator::visit (ast::Const_String&           node) {
+    stats::Phase_Timer timer (ast::Kind::CONST_STRING);
+    std::size_t id = const_string_next_id_++;
+    const_strings_.emplace_back(id, &node.value());
 
-    register_reference_[node] = '%' + id;
+    register_reference_[node] = Value(Value::Kind::STRING, id, &const_string_prefix_);
 
     // Allow for escape characters.
-    std::size_t size = node->value().size();
-    for (auto& c : node->value()) {
+    std::size_t size = node.value().size();
+    for (auto& c : node.value()) {
         if (c == '\\') {
             --size;
         }
@@ -118,36 +156,31 @@ void LLVM_Generator::visit (ast::Const_String::Ptr           node) {
     // TODO: improve getelementptr
     apply_indent_();
     out_
-        << '%' << id << " = getelementptr inbounds ["
+        << '%' << const_string_prefix_ << id << " = getelementptr inbounds ["
         << size + 1 << " x i8], ["
-        << size + 1 << " x i8]* @" << id << ", i32 0, i32 0"
-        << std::endl
+        << size + 1 << " x i8]* @" << const_string_prefix_ << id << ", i32 0, i32 0"
+        << '\n'
         ;
 }
-void LLVM_Generator::visit (ast::Unary_Expression::Ptr       node) {
-    std::string register_ref = "%tmp." + to_string(register_reference_.size());
-    register_reference_[node] = register_ref;
-
-    node->rhs()->emit_code(*this);
+void LLVM_Generator::visit (ast::Unary_Expression&       node) {
+    stats::Phase_Timer timer (ast::Kind::UNARY_EXPRESSION);
+    const Value& register_ref = register_reference_[node];
 
     apply_indent_();
     out_
-        << register_ref << " = sub " << type(node->type()) << " 0, "
-        << register_reference_[node->rhs()] << std::endl
+        << register_ref << " = sub " << type(node.type()) << " 0, "
+        << register_reference_[node.rhs()] << '\n'
         ;
 }
-void LLVM_Generator::visit (ast::Binary_Expression::Ptr      node) {
-    std::string register_ref = "%tmp." + to_string(register_reference_.size());
-    register_reference_[node] = register_ref;
-
-    node->lhs()->emit_code(*this);
-    node->rhs()->emit_code(*this);
+void LLVM_Generator::visit (ast::Binary_Expression&      node) {
+    stats::Phase_Timer timer (ast::Kind::BINARY_EXPRESSION);
+    const Value& register_ref = register_reference_[node];
 
     apply_indent_();
     out_ << register_ref << " = ";
-    switch (node->type()) {
+    switch (node.type()) {
         case parser::Type::INT:
-            switch (node->op()) {
+            switch (node.op()) {
                 case ast::Operation::ADDITION:
                     out_ << "add ";
                     break;
@@ -172,10 +205,10 @@ void LLVM_Generator::visit (ast::Binary_Expression::Ptr      node) {
             }
 
             out_
-                << type(node->type()) << ' '
-                << register_reference_[node->lhs()] << ", "
-                << register_reference_[node->rhs()]
-                << std::endl
+                << type(node.type()) << ' '
+                << register_reference_[node.lhs()] << ", "
+                << register_reference_[node.rhs()]
+                << '\n'
                 ;
 
             break;
@@ -184,21 +217,18 @@ void LLVM_Generator::visit (ast::Binary_Expression::Ptr      node) {
             // '+' is the only operation allowed between strings.
             out_
                 << "call i8* @__string_concat__(i8* "
-                << register_reference_[node->lhs()] << ", i8* "
-                << register_reference_[node->rhs()] << ")"
-                << std::endl
+                << register_reference_[node.lhs()] << ", i8* "
+                << register_reference_[node.rhs()] << ")"
+                << '\n'
                 ;
             need_string_functions_ = true;
-            strings_to_free_.insert(register_ref);
+            strings_to_free_.insert(to_string(register_ref));
             break;
     }
 }
-void LLVM_Generator::visit (ast::Condition::Ptr              node) {
-    std::string register_ref = "%tmp." + to_string(register_reference_.size());
-    register_reference_[node] = register_ref;
-
-    node->lhs()->emit_code(*this);
-    node->rhs()->emit_code(*this);
+void LLVM_Generator::visit (ast::Condition&              node) {
+    stats::Phase_Timer timer (ast::Kind::CONDITION);
+    const Value& register_ref = register_reference_[node];
 
     apply_indent_();
     out_ << register_ref << " = ";
@@ -214,11 +244,11 @@ void LLVM_Generator::visit (ast::Condition::Ptr              node) {
     // slt: signed less than
     // sle: signed less or equal
 
-    switch (node->type()) {
+    switch (node.type()) {
         case parser::Type::INT:
             out_ << "icmp ";
 
-            switch (node->op()) {
+            switch (node.op()) {
                 case ast::Comparison_Operation::EQUAL:
                     out_ << "eq ";
                     break;
@@ -240,10 +270,10 @@ void LLVM_Generator::visit (ast::Condition::Ptr              node) {
             }
 
             out_
-                << type(node->type()) << ' '
-                << register_reference_[node->lhs()] << ", "
-                << register_reference_[node->rhs()]
-                << std::endl
+                << type(node.type()) << ' '
+                << register_reference_[node.lhs()] << ", "
+                << register_reference_[node.rhs()]
+                << '\n'
                 ;
 
             break;
@@ -251,7 +281,7 @@ void LLVM_Generator::visit (ast::Condition::Ptr              node) {
         case parser::Type::STRING:
             out_ << "call i1 @";
 
-            switch (node->op()) {
+            switch (node.op()) {
                 case ast::Comparison_Operation::EQUAL:
                     out_ << "__string_equal__";
                     break;
@@ -265,54 +295,48 @@ void LLVM_Generator::visit (ast::Condition::Ptr              node) {
             }
 
             out_
-                <<  "(i8* " << register_reference_[node->lhs()]
-                << ", i8* " << register_reference_[node->rhs()]
+                <<  "(i8* " << register_reference_[node.lhs()]
+                << ", i8* " << register_reference_[node.rhs()]
                 << ")"
-                << std::endl
+                << '\n'
                 ;
 
             need_string_functions_ = true;
             break;
     }
 }
-void LLVM_Generator::visit (ast::Assignment::Ptr             node) {
-    std::string register_ref = "%tmp." + to_string(register_reference_.size());
-    register_reference_[node] = register_ref;
-
-    node->rhs()->emit_code(*this);
+void LLVM_Generator::visit (ast::Assignment&             node) {
+    stats::Phase_Timer timer (ast::Kind::ASSIGNMENT);
 
     apply_indent_();
-    switch (node->type()) {
+    switch (node.type()) {
         case parser::Type::INT:
             out_
-                << "store i32 " << register_reference_[node->rhs()] << ", i32* "
-                << (node->lhs()->symbol()->get(parser::Symbol::Attribute::GLOBAL) ? '@' : '%')
-                << node->lhs()->symbol()->name()
-                << std::endl;
+                << "store i32 " << register_reference_[node.rhs()] << ", i32* "
+                << (node.lhs().symbol()->get(parser::Symbol::Attribute::GLOBAL) ? '@' : '%')
+                << node.lhs().symbol()->name()
+                << '\n';
                 ;
             break;
         case parser::Type::STRING:
             // TODO
              out_
-                << "store i8* " << register_reference_[node->rhs()] << ", i8** "
-                << (node->lhs()->symbol()->get(parser::Symbol::Attribute::GLOBAL) ? '@' : '%')
-                << node->lhs()->symbol()->name()
-                << std::endl;
+                << "store i8* " << register_reference_[node.rhs()] << ", i8** "
+                << (node.lhs().symbol()->get(parser::Symbol::Attribute::GLOBAL) ? '@' : '%')
+                << node.lhs().symbol()->name()
+                << '\n';
                 ;
             break;
     }
 }
-void LLVM_Generator::visit (ast::Function_Call::Ptr          node) {
-    std::string register_ref = "%tmp." + to_string(register_reference_.size());
-    register_reference_[node] = register_ref;
+void LLVM_Generator::visit (ast::Function_Call&          node) {
+    stats::Phase_Timer timer (ast::Kind::FUNCTION_CALL);
+    const Value& register_ref = register_reference_[node];
 
-    auto& function  = node->function();
-    auto& arguments = node->argument_list();
+    auto& function  = node.function();
+    auto  arguments = node.argument_list();
 
-    // Step 1: Prepare arguments
-    for (auto& argument : node->argument_list()) {
-        argument->emit_code(*this);
-    }
+    // Step 1: the arguments have been computed by now.
 
     // // Step 2: call the function
     // apply_indent_();
@@ -323,8 +347,8 @@ void LLVM_Generator::visit (ast::Function_Call::Ptr          node) {
     // out_ << ")* @" << function->name() << "(";
     // infix(out_, ", ", arguments,
     //     [&] (ast::Expression::Ptr expr) {
-    //         std::string tmp = type(expr->type()) + " " + register_reference_[expr];
-    //         return tmp;// register_reference_[expr];
+    //         std::string tmp = type(expr->type()) + " " + register_reference_[expr.get()];
+    //         return tmp;// register_reference_[expr.get()];
     // });
 
     // Step 2: call the function
@@ -333,158 +357,176 @@ void LLVM_Generator::visit (ast::Function_Call::Ptr          node) {
 
     out_ << " @" << function->name() << "(";
     infix(out_, ", ", arguments,
-        [&] (ast::Expression::Ptr expr) {
-            std::string tmp = type(expr->type()) + " " + register_reference_[expr];
-            return tmp;// register_reference_[expr];
+        [&] (const ast::Expression& expr) {
+            out_ << type(expr.type()) << ' ' << register_reference_[expr];
         });
 
-    out_ << ')' << std::endl;
+    out_ << ')' << '\n';
 }
-void LLVM_Generator::visit (ast::Instruction::Ptr            node) {
+void LLVM_Generator::visit (ast::Instruction&            node) {
     // This is an empty instruction. Do nothing.
 }
-void LLVM_Generator::visit (ast::Expression_Instruction::Ptr node) {
-    node->expression()->emit_code(*this);
+void LLVM_Generator::visit (ast::Expression_Instruction& node) {
+    stats::Phase_Timer timer (ast::Kind::EXPRESSION_INSTRUCTION);
+    node.expression().emit_code(*this);
 }
-void LLVM_Generator::visit (ast::Cond_Instruction::Ptr       node) {
+void LLVM_Generator::visit (ast::Cond_Instruction&       node) {
+    stats::Phase_Timer timer (ast::Kind::COND_INSTRUCTION);
     --indent_level_;
-    out_ << std::endl << "; Cond_Instruction" << std::endl << std::endl;
+    out_ << '\n' << "; Cond_Instruction" << '\n' << '\n';
     ++indent_level_;
 
-    llvm::Label label_0;
-    llvm::Label label_1;
-    llvm::Label label_2;
+    llvm::Label label_0(label_ids_);
+    llvm::Label label_1(label_ids_);
+    llvm::Label label_2(label_ids_);
 
     // Step 1: condition
-    node->condition()->emit_code(*this);
+    node.condition().emit_code(*this);
     apply_indent_();
-    out_ << llvm::br_instruction(register_reference_[node->condition()],
+    llvm::br_instruction(out_, register_reference_[node.condition()],
         label_0, label_1);
 
     // Step 2: instruction
-    out_ << std::endl;
+    out_ << '\n';
     emit_label_(label_0);
-    node->instruction()->emit_code(*this);
-    apply_indent_();
-    out_ << llvm::br_instruction(label_2);
-
-    // Step 3: else_instruction
-    out_ << std::endl;
-    emit_label_(label_1);
-    if (const auto& else_instruction = node->else_instruction()) {
-        else_instruction->emit_code(*this);
+    work_.generate(*this, node.instruction());
+    work_.then([this, label_1, label_2] {
+        apply_indent_();
+        llvm::br_instruction(out_, label_2);
+
+        // Step 3: else_instruction
+        out_ << '\n';
+        emit_label_(label_1);
+    });
+    if (const auto& else_instruction = node.else_instruction()) {
+        work_.generate(*this, else_instruction);
     }
-    apply_indent_();
-    out_ << llvm::br_instruction(label_2);
+    work_.then([this, label_2] {
+        apply_indent_();
+        llvm::br_instruction(out_, label_2);
 
-    // Step 4: the end
-    out_ << std::endl;
-    emit_label_(label_2);
+        // Step 4: the end
+        out_ << '\n';
+        emit_label_(label_2);
+    });
 }
-void LLVM_Generator::visit (ast::While_Instruction::Ptr      node) {
-    out_ << std::endl << "; While_Instruction" << std::endl << std::endl;
+void LLVM_Generator::visit (ast::While_Instruction&      node) {
+    stats::Phase_Timer timer (ast::Kind::WHILE_INSTRUCTION);
+    out_ << '\n' << "; While_Instruction" << '\n' << '\n';
 
-    llvm::Label label_0;
-    llvm::Label label_1;
-    llvm::Label label_2;
+    llvm::Label label_0(label_ids_);
+    llvm::Label label_1(label_ids_);
+    llvm::Label label_2(label_ids_);
 
     apply_indent_();
-    out_ << llvm::br_instruction(label_0);
+    llvm::br_instruction(out_, label_0);
 
     // Step 1: condition
-    out_ << std::endl;
+    out_ << '\n';
     emit_label_(label_0);
-    node->condition()->emit_code(*this);
+    node.condition().emit_code(*this);
     apply_indent_();
-    out_ << llvm::br_instruction(register_reference_[node->condition()],
+    llvm::br_instruction(out_, register_reference_[node.condition()],
         label_1, label_2);
 
     // Step 2: instruction
-    out_ << std::endl;
+    out_ << '\n';
     emit_label_(label_1);
-    node->instruction()->emit_code(*this);
-    apply_indent_();
-    out_ << llvm::br_instruction(label_0);
+    work_.generate(*this, node.instruction());
+    work_.then([this, label_0, label_2] {
+        apply_indent_();
+        llvm::br_instruction(out_, label_0);
 
-    // Step 3: the end
-    out_ << std::endl;
-    emit_label_(label_2);
+        // Step 3: the end
+        out_ << '\n';
+        emit_label_(label_2);
+    });
 }
-void LLVM_Generator::visit (ast::Do_Instruction::Ptr         node) {
-    out_ << std::endl << "; Do_Instruction" << std::endl << std::endl;
+void LLVM_Generator::visit (ast::Do_Instruction&         node) {
+    stats::Phase_Timer timer (ast::Kind::DO_INSTRUCTION);
+    out_ << '\n' << "; Do_Instruction" << '\n' << '\n';
 
-    llvm::Label label_0;
-    llvm::Label label_1;
-    llvm::Label label_2;
+    llvm::Label label_0(label_ids_);
+    llvm::Label label_1(label_ids_);
+    llvm::Label label_2(label_ids_);
 
     apply_indent_();
-    out_ << llvm::br_instruction(label_0);
+    llvm::br_instruction(out_, label_0);
 
     // Step 1: instruction
-    out_ << std::endl;
+    out_ << '\n';
     emit_label_(label_0);
-    node->instruction()->emit_code(*this);
-    apply_indent_();
-    out_ << llvm::br_instruction(label_1);
+    work_.generate(*this, node.instruction());
+    work_.then([this, &node, label_0, label_1, label_2] {
+        apply_indent_();
+        llvm::br_instruction(out_, label_1);
 
-    // Step 2: condition
-    out_ << std::endl;
-    emit_label_(label_1);
-    node->condition()->emit_code(*this);
-    apply_indent_();
-    out_ << llvm::br_instruction(register_reference_[node->condition()],
-        label_0, label_2);
+        // Step 2: condition
+        out_ << '\n';
+        emit_label_(label_1);
+        node.condition().emit_code(*this);
+        apply_indent_();
+        llvm::br_instruction(out_, register_reference_[node.condition()],
+            label_0, label_2);
 
-    // Step 3: the end
-    out_ << std::endl;
-    apply_indent_();
-    emit_label_(label_2);
+        // Step 3: the end
+        out_ << '\n';
+        apply_indent_();
+        emit_label_(label_2);
+    });
 }
-void LLVM_Generator::visit (ast::For_Instruction::Ptr        node) {
+void LLVM_Generator::visit (ast::For_Instruction&        node) {
+    stats::Phase_Timer timer (ast::Kind::FOR_INSTRUCTION);
     out_ << "\n; For_Instruction\n\n";
 
-    llvm::Label label_0;
-    llvm::Label label_1;
-    llvm::Label label_2;
-    llvm::Label label_3;
+    llvm::Label label_0(label_ids_);
+    llvm::Label label_1(label_ids_);
+    llvm::Label label_2(label_ids_);
+    llvm::Label label_3(label_ids_);
 
     // Step 1: initialization
-    node->initialization()->emit_code(*this);
+    node.initialization().emit_code(*this);
     apply_indent_();
-    out_ << llvm::br_instruction(label_0);
+    llvm::br_instruction(out_, label_0);
 
     // Step 2: condition
-    out_ << std::endl;
+    out_ << '\n';
     emit_label_(label_0);
-    node->condition()->emit_code(*this);
+    node.condition().emit_code(*this);
     apply_indent_();
-    out_ << llvm::br_instruction(register_reference_[node->condition()],
+    llvm::br_instruction(out_, register_reference_[node.condition()],
         label_1, label_3);
 
     // Step 3: instruction, the body of the for instruction
-    out_ << std::endl;
+    out_ << '\n';
     emit_label_(label_1);
-    node->instruction()->emit_code(*this);
-    apply_indent_();
-    out_ << llvm::br_instruction(label_2);
+    work_.generate(*this, node.instruction());
+    work_.then([this, &node, label_0, label_2, label_3] {
+        apply_indent_();
+        llvm::br_instruction(out_, label_2);
 
-    // Step 4: increment
-    out_ << std::endl;
-    emit_label_(label_2);
-    node->increment()->emit_code(*this);
-    apply_indent_();
-    out_ << llvm::br_instruction(label_0);
+        // Step 4: increment
+        out_ << '\n';
+        emit_label_(label_2);
+        node.increment().emit_code(*this);
+        apply_indent_();
+        llvm::br_instruction(out_, label_0);
 
-    // Step 5: the end
-    out_ << std::endl;
-    emit_label_(label_3);
+        // Step 5: the end
+        out_ << '\n';
+        emit_label_(label_3);
+    });
 }
-void LLVM_Generator::visit (ast::Return_Instruction::Ptr     node) {
-    node->expression()->emit_code(*this);
+void LLVM_Generator::visit (ast::Return_Instruction&     node) {
+    stats::Phase_Timer timer (ast::Kind::RETURN_INSTRUCTION);
+    node.expression().emit_code(*this);
 
-    std::string reg = register_reference_[node->expression()];
+    const Value& value = register_reference_[node.expression()];
+    bool copied = false;
+
+    if (node.expression().type() == parser::Type::STRING) {
+        std::string reg = to_string(value);
 
-    if (node->expression()->type() == parser::Type::STRING) {
         // If this register is slated for free-ing, cancel it. We need to return
         // a copy.
         if (strings_to_free_.find(reg) == std::end(strings_to_free_)) {
@@ -494,12 +536,12 @@ void LLVM_Generator::visit (ast::Return_Instruction::Ptr     node) {
         // If not, make a copy of the string so we can guarantee that the caller
         // can free it later.
         else {
-            reg = "%tmp.return";
+            copied = true;
             apply_indent_();
             out_
-                << reg << " = call i8* @__string_copy__(i8* "
-                << register_reference_[node->expression()] << ")"
-                << std::endl
+                << "%tmp.return = call i8* @__string_copy__(i8* "
+                << value << ")"
+                << '\n'
                 ;
         }
     }
@@ -507,30 +549,36 @@ void LLVM_Generator::visit (ast::Return_Instruction::Ptr     node) {
     // Free any strings created in this function
     for (auto& reg : strings_to_free_) {
         apply_indent_();
-        out_ << "call void @__string_free__ (i8* " << reg << ")" << std::endl;
+        out_ << "call void @__string_free__ (i8* " << reg << ")" << '\n';
     }
     strings_to_free_.clear();
 
     apply_indent_();
     out_ << "ret ";
-    out_ << type(node->expression()->type()) << ' ';
-    out_ << reg;
-    out_ << std::endl;
+    out_ << type(node.expression().type()) << ' ';
+    if (copied) {
+        out_ << "%tmp.return";
+    } else {
+        out_ << value;
+    }
+    out_ << '\n';
 }
-void LLVM_Generator::visit (ast::Compound_Instruction::Ptr   node) {
-    for (auto& instruction : node->instruction_list()) {
-        instruction->emit_code(*this);
+void LLVM_Generator::visit (ast::Compound_Instruction&   node) {
+    stats::Phase_Timer timer (ast::Kind::COMPOUND_INSTRUCTION);
+    for (auto& instruction : node.instruction_list()) {
+        work_.generate(*this, instruction);
     }
 }
-void LLVM_Generator::visit (ast::Function_Declaration::Ptr   node) {
-    auto& declarator = node->function_declarator();
+void LLVM_Generator::visit (ast::Function_Declaration&   node) {
+    stats::Phase_Timer timer (ast::Kind::FUNCTION_DECLARATION);
+    auto& declarator = node.function_declarator();
 
     // step 1
     apply_indent_();
     out_ << "declare ";
 
     // step 2: function return type
-    out_ << type(node->type());
+    out_ << type(node.type());
 
     // step 3: function name
     out_ << " @" << declarator->name();
@@ -538,20 +586,122 @@ void LLVM_Generator::visit (ast::Function_Declaration::Ptr   node) {
     // step 4: function argument list
     out_ << "(";
     infix(out_, ", ", declarator->argument_list(),
-        [] (parser::Symbol::Ptr symbol) { return type(symbol->type()); });
+        [this] (const parser::Symbol::Ptr& symbol) { out_ << type(symbol->type()); });
     out_ << ")";
 
     // step 5
-    out_ << std::endl;
+    out_ << '\n';
+}
+void LLVM_Generator::visit (ast::Function_Definition&    node) {
+    stats::Phase_Timer timer (ast::Kind::FUNCTION_DEFINITION);
+    emit_function_(node, nullptr);
+    end_function_();
+}
+
+ir_cache::Entry LLVM_Generator::function_ir (const ast::Function_Definition& node) {
+    ir_cache::Entry entry;
+    emit_function_(node, &entry);
+    out_.discard();
+    return entry;
+}
+
+void LLVM_Generator::append_function (const ir_cache::Entry& ir) {
+    out_ << ir.ir;
+    need_string_functions_ = need_string_functions_ or ir.needs_string_functions;
+    end_function_();
 }
-void LLVM_Generator::visit (ast::Function_Definition::Ptr    node) {
-    auto& declarator = node->function_declarator();
+
+// Writes the IR of a function definition, from the cache if possible. Also
+// copies it into `capture`, if not nullptr.
+void LLVM_Generator::emit_function_ (
+    const ast::Function_Definition& node,
+    ir_cache::Entry* capture
+) {
+    begin_function_(node);
+
+    bool cacheable = cache_ and not node.cache_key().empty();
+    ir_cache::Entry entry;
+
+    if (cacheable and cache_->lookup(node.cache_key(), entry)) {
+        stats::count(stats::Counter::CACHE_HITS);
+        out_ << entry.ir;
+        need_string_functions_ = need_string_functions_ or entry.needs_string_functions;
+        if (capture) {
+            *capture = std::move(entry);
+        }
+        return;
+    }
+
+    // Find out whether this function on its own needs the string functions.
+    bool needed_string_functions = need_string_functions_;
+    need_string_functions_ = false;
+
+    if (cacheable or capture) {
+        out_.begin_capture(entry.ir);
+    }
+    emit_function_definition_(node);
+    if (cacheable or capture) {
+        out_.end_capture();
+        entry.needs_string_functions = need_string_functions_;
+    }
+    if (cacheable) {
+        cache_->store(node.cache_key(), entry);
+        stats::count(stats::Counter::CACHE_MISSES);
+    }
+    if (capture) {
+        *capture = std::move(entry);
+    }
+
+    need_string_functions_ = need_string_functions_ or needed_string_functions;
+}
+
+// Writes what follows a function definition in the module, then flushes.
+void LLVM_Generator::end_function_ () {
+    // declare string functions if needed
+    if (need_string_functions_ and not string_functions_declared_) {
+        apply_indent_();
+        out_ << "declare i1 @__string_equal__(i8*, i8*)" << '\n';
+        apply_indent_();
+        out_ << "declare i1 @__string_not_equal__(i8*, i8*)" << '\n';
+        apply_indent_();
+        out_ << "declare i8* @__string_copy__(i8*)" << '\n';
+        apply_indent_();
+        out_ << "declare i8* @__string_concat__(i8*, i8*)" << '\n';
+        apply_indent_();
+        out_ << "declare void @__string_free__(i8*)" << '\n';
+
+        out_ << '\n';
+        string_functions_declared_ = true;
+    }
+
+    // Function boundaries are the flush points for buffered output.
+    out_.flush();
+}
+
+// Everything numbered in the IR of a function (registers, labels, string
+// constants) is numbered from zero again in each function, so that the IR of
+// a function only depends on the function itself. String constants are
+// module globals, so theirs carry the name of the function.
+void LLVM_Generator::begin_function_ (const ast::Function_Definition& node) {
+    const std::string& name = node.function_declarator()->name();
+    register_reference_.reset(node.expression_count());
+    variable_counts_.clear();
+    strings_to_free_.clear();
+    label_ids_.reset();
+    const_string_prefix_.assign("str.").append(name).append(1, '.');
+    const_string_next_id_ = 0;
+}
+
+void LLVM_Generator::emit_function_definition_ (const ast::Function_Definition& node) {
+    auto& declarator = node.function_declarator();
+
+    out_ << "; Define function '" << declarator->name() << "'\n";
 
     apply_indent_();
     out_ << "define ";
 
     // function return type
-    out_ << type(node->type());
+    out_ << type(node.type());
 
     // function name
     out_ << " @" << declarator->name();
@@ -559,49 +709,50 @@ void LLVM_Generator::visit (ast::Function_Definition::Ptr    node) {
     // function argument list
     out_ << "(";
     infix(out_, ", ", declarator->argument_list(),
-        [] (parser::Symbol::Ptr symbol) {
-            return type(symbol->type()) + " %" + symbol->name();
+        [this] (const parser::Symbol::Ptr& symbol) {
+            out_ << type(symbol->type()) << " %" << symbol->name();
         });
 
     out_ << ")";
 
     // entry block
-    out_ << " {" << std::endl;
+    out_ << " {" << '\n';
     apply_indent_();
-    out_ << "entry:" << std::endl;
+    out_ << "entry:" << '\n';
     ++indent_level_;
 
     // alloca argument variables
     for (auto& symbol : declarator->argument_list()) {
-        std::string tmp_type = type(symbol->type());
+        const char* tmp_type = type(symbol->type());
 
         apply_indent_();
-        out_<< "%" << symbol->name() << ".pointer" << " = alloca " << tmp_type << std::endl;
+        out_<< "%" << symbol->name() << ".pointer" << " = alloca " << tmp_type << '\n';
 
         apply_indent_();
         out_<< "store " << tmp_type << " %" << symbol->name() << ", ";
-        out_<< tmp_type << "* %" << symbol->name() << ".pointer" << std::endl;
+        out_<< tmp_type << "* %" << symbol->name() << ".pointer" << '\n';
 
         // Simply change the name to .pointer
-        symbol->name(symbol->name() + ".pointer");
+        symbol->name(atom::intern(symbol->name() + ".pointer"));
     }
 
     // function body
-    node->body()->emit_code(*this);
+    node.body()->emit_code(*this);
 
     // close function
     --indent_level_;
     apply_indent_();
-    out_ << "}" << std::endl;
+    out_ << "}" << '\n';
 
     // const strings
     for (auto& pair : const_strings_) {
-        auto& str_id = pair.first;
-        auto& str_value = pair.second;
+        auto  str_id = pair.first;
+        auto& str_value = *pair.second;
         // @.str_7 = private constant [18 x i8] c"hello, world! %i\0A\00"
         apply_indent_();
 
-        std::ostringstream str_builder;
+        std::string& str_builder = const_string_text_;
+        str_builder.clear();
         std::size_t str_size = 0;
         for (std::size_t i = 0; i < str_value.size(); ++i) {
             char c = str_value[i];
@@ -609,7 +760,7 @@ void LLVM_Generator::visit (ast::Function_Definition::Ptr    node) {
                 char buf[3];
                 buf[2] = '\0';
                 snprintf(buf, 3, "%02x", c & 0xff);
-                str_builder << '\\' << buf;
+                str_builder.append(1, '\\').append(buf);
                 ++str_size;
             } else if (c == '\\') {
                 bool found_cntrl_token = false;
@@ -617,23 +768,23 @@ void LLVM_Generator::visit (ast::Function_Definition::Ptr    node) {
                     switch (str_value[i + 1]) {
                         case '0':
                             found_cntrl_token = true;
-                            str_builder << "\\00";
+                            str_builder += "\\00";
                             break;
                         case 'n':
                             found_cntrl_token = true;
-                            str_builder << "\\0A";
+                            str_builder += "\\0A";
                             break;
                         case 'r':
                             found_cntrl_token = true;
-                            str_builder << "\\0D";
+                            str_builder += "\\0D";
                             break;
                         case 't':
                             found_cntrl_token = true;
-                            str_builder << "\\09";
+                            str_builder += "\\09";
                             break;
                         case 'v':
                             found_cntrl_token = true;
-                            str_builder << "\\0B";
+                            str_builder += "\\0B";
                             break;
                     }
                 }
@@ -641,45 +792,27 @@ void LLVM_Generator::visit (ast::Function_Definition::Ptr    node) {
                 if (found_cntrl_token) {
                     ++i;
                 } else {
-                    str_builder << c;
+                    str_builder += c;
                 }
                 ++str_size;
             } else {
-                str_builder << c;
+                str_builder += c;
                 ++str_size;
             }
         }
 
         out_
-            << '@' << str_id << " = private unnamed_addr constant ["
-            << str_size + 1 << " x i8] c\"" << str_builder.str()
+            << '@' << const_string_prefix_ << str_id << " = private unnamed_addr constant ["
+            << str_size + 1 << " x i8] c\"" << str_builder
             << "\\00\""
-            << std::endl
+            << '\n'
             ;
     }
     const_strings_.clear();
-    out_ << std::endl;
-
-    // declare string functions if needed
-    if (need_string_functions_ and not string_functions_declared_) {
-        apply_indent_();
-        out_ << "declare i1 @__string_equal__(i8*, i8*)" << std::endl;
-        apply_indent_();
-        out_ << "declare i1 @__string_not_equal__(i8*, i8*)" << std::endl;
-        apply_indent_();
-        out_ << "declare i8* @__string_copy__(i8*)" << std::endl;
-        apply_indent_();
-        out_ << "declare i8* @__string_concat__(i8*, i8*)" << std::endl;
-        apply_indent_();
-        out_ << "declare void @__string_free__(i8*)" << std::endl;
-
-        out_ << std::endl;
-        string_functions_declared_ = true;
-    }
+    out_ << '\n';
 }
 
 
-ID_Factory Label::id_factory_;
 // ID_Factory Register::id_factory_;
 // ID_Factory String::id_factory_;
 
@@ -688,13 +821,13 @@ ID_Factory Label::id_factory_;
 
 // br instruction
 // br label <dest>
-std::string br_instruction (const Label& label_1) {
-  return std::string("br ") + label_1.name_llvm_ir() + '\n';
-};
+void br_instruction (output::Output_Buffer& out, const Label& label_1) {
+    out << "br " << label_1 << '\n';
+}
 
 // br i1 <cond>, label <iftrue>, label<iffailure>
-std::string br_instruction (const std::string& cond, const Label& label_1, const Label& label_2) {
-   return "br i1 " + cond + ", " + label_1.name_llvm_ir() + ", " + label_2.name_llvm_ir() + '\n';
-};
+void br_instruction (output::Output_Buffer& out, const Value& cond, const Label& label_1, const Label& label_2) {
+    out << "br i1 " << cond << ", " << label_1 << ", " << label_2 << '\n';
+}
 
 }  // namespace llvm
@@ -2,27 +2,25 @@
 #ifndef __CSTR_COMPILER__LLVM_HPP
 #define __CSTR_COMPILER__LLVM_HPP
 
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <memory>
-#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "ast.hpp"
+#include "ir_cache.hpp"
+#include "output_buffer.hpp"
+#include "stats.hpp"
 #include "symbol.hpp"
 
 
-template <typename T>
-std::string to_string (T t) {
-    std::ostringstream oss;
-    oss << t;
-    return oss.str();
-}
-
-
 namespace llvm {
 
 
@@ -30,11 +28,11 @@ class ID_Factory {
   public:
     ID_Factory () : next_id_(0) {}
 
-    std::string get_id () { return to_string(next_id_++); }
+    std::size_t get_id () { return next_id_++; }
     void reset () { next_id_ = 0; }
 
   private:
-    int next_id_;
+    std::size_t next_id_;
 };
 
 // class String {
@@ -86,75 +84,132 @@ class Label {
   public:
     typedef std::shared_ptr<Label> Ptr;
 
-    Label ()
-          : id_("Label_" + id_factory_.get_id()) {}
+    // Labels are numbered by the factory of the generator that emits them.
+    Label (ID_Factory& id_factory)
+          : id_(id_factory.get_id()) {}
 
-    // for br
-    const std::string name_llvm_ir () const {
-      std::string str;
-      str = std::string("label %") + id_;
-      return str;
-    }
+    std::size_t id () const { return id_; }
 
-    // the destination label for the jump instruction
-    const std::string destination_llvm_ir () const {
-      std::string str;
-      str = id_ + ":" + "\n";
-      return str;
-    }
+  private:
+    std::size_t id_;
+};
 
-  protected:
-    static ID_Factory id_factory_;
+// for br: label %Label_<id>
+output::Output_Buffer& operator << (output::Output_Buffer& out, const Label& label);
 
-  private:
-    const std::string id_;
+
+// An operand of an instruction. It keeps the parts of the name of its
+// register instead of the name itself, so that naming the value of an
+// expression allocates nothing; writing it out gives the name.
+struct Value {
+    enum class Kind : std::uint8_t {
+        CONSTANT,   // <number>
+        TEMPORARY,  // %tmp.<number>
+        VARIABLE,   // %<name>.<number>, the number-th load of the variable
+        STRING,     // %<name><number>, with the prefix of the function's strings
+    };
+
+    Kind               kind   = Kind::CONSTANT;
+    long               number = 0;
+    const std::string* name   = nullptr;
+
+    Value () {}
+    Value (Kind kind, long number, const std::string* name = nullptr)
+          : kind(kind), number(number), name(name) {}
 };
 
+output::Output_Buffer& operator << (output::Output_Buffer& out, const Value& value);
+
+// The name of `value`, for the strings the generator has to free.
+std::string to_string (const Value& value);
+
 
-class LLVM_Generator : public ast::Code_Generator {
+class LLVM_Generator final : public ast::Code_Generator {
   public:
-    LLVM_Generator (std::ostream& out) : out_(out), const_string_next_id_(0) {}
+    // The generated IR is collected in an output::Output_Buffer on its way to
+    // `out`. With Flush_Policy::EXPLICIT it is only written at the end of each
+    // function definition (and when the generator is destroyed).
+    LLVM_Generator (
+        std::ostream& out,
+        output::Flush_Policy policy = output::Flush_Policy::LINE
+    ) : out_(out, policy), const_string_next_id_(0) {}
 
     void indentation (std::string&& value) { indentation_ = std::move(value); }
-
-    // void visit (ast::Node::Ptr                   node) override;
-    // void visit (ast::Expression::Ptr             node) override;
-    // void visit (ast::Terminal::Ptr               node) override;
-    void visit (ast::Declaration_List::Ptr       node) override;
-    void visit (ast::Variable::Ptr               node) override;
-    void visit (ast::Const_Integer::Ptr          node) override;
-    void visit (ast::Const_String::Ptr           node) override;
-    void visit (ast::Unary_Expression::Ptr       node) override;
-    void visit (ast::Binary_Expression::Ptr      node) override;
-    void visit (ast::Condition::Ptr              node) override;
-    void visit (ast::Assignment::Ptr             node) override;
-    void visit (ast::Function_Call::Ptr          node) override;
-    void visit (ast::Instruction::Ptr            node) override;
-    void visit (ast::Expression_Instruction::Ptr node) override;
-    void visit (ast::Cond_Instruction::Ptr       node) override;
-    void visit (ast::While_Instruction::Ptr      node) override;
-    void visit (ast::Do_Instruction::Ptr         node) override;
-    void visit (ast::For_Instruction::Ptr        node) override;
-    void visit (ast::Return_Instruction::Ptr     node) override;
-    void visit (ast::Compound_Instruction::Ptr   node) override;
-    void visit (ast::Function_Declaration::Ptr   node) override;
-    void visit (ast::Function_Definition::Ptr    node) override;
+    const std::string& indentation () const { return indentation_; }
+
+    const output::Output_Buffer& output () const { return out_; }
+    void flush () { out_.flush(); }
+
+    // Reuse the IR of function definitions from `cache`, and store it there,
+    // when their cache key is set. nullptr disables caching.
+    void cache (ir_cache::Cache* value) { cache_ = value; }
+
+    // Generating the functions of a module in parallel: function_ir() returns
+    // the IR of one function definition without writing it, and
+    // append_function() writes it out the way visit() would have. Since the
+    // IR of a function only depends on the function, function_ir() can run on
+    // another generator (one per thread), as long as append_function() is
+    // called in source order.
+    ir_cache::Entry function_ir     (const ast::Function_Definition& node);
+    void            append_function (const ir_cache::Entry& ir);
+
+    void enter (const ast::Expression&       node) override;
+    void visit (ast::Declaration_List&       node) override;
+    void visit (ast::Variable&               node) override;
+    void visit (ast::Const_Integer&          node) override;
+    void visit (ast::Const_String&           node) override;
+    void visit (ast::Unary_Expression&       node) override;
+    void visit (ast::Binary_Expression&      node) override;
+    void visit (ast::Condition&              node) override;
+    void visit (ast::Assignment&             node) override;
+    void visit (ast::Function_Call&          node) override;
+    void visit (ast::Instruction&            node) override;
+    void visit (ast::Expression_Instruction& node) override;
+    void visit (ast::Cond_Instruction&       node) override;
+    void visit (ast::While_Instruction&      node) override;
+    void visit (ast::Do_Instruction&         node) override;
+    void visit (ast::For_Instruction&        node) override;
+    void visit (ast::Return_Instruction&     node) override;
+    void visit (ast::Compound_Instruction&   node) override;
+    void visit (ast::Function_Declaration&   node) override;
+    void visit (ast::Function_Definition&    node) override;
 
   private:
-    std::ostream& out_;
-
-    std::unordered_map<ast::Expression::Ptr, std::string> register_reference_;
-    std::unordered_map<parser::Symbol::Ptr, std::size_t>  variable_counts_;
-
-    std::vector<std::pair<std::string, std::string>> const_strings_;
+    output::Output_Buffer out_;
+
+    // Containers of the generator state, charged to code generation in
+    // --mem-report.
+    template <typename Key, typename Value>
+    using Map = stats::Map<Key, Value, stats::Pool::CODEGEN>;
+    template <typename Key>
+    using Set = stats::Set<Key, stats::Pool::CODEGEN>;
+    template <typename T>
+    using Vector = stats::Vector<T, stats::Pool::CODEGEN>;
+
+    ast::Value_Table<Value>                register_reference_;
+    Map<parser::Symbol::Ptr, std::size_t>  variable_counts_;
+
+    ID_Factory label_ids_;
+
+    // Numbers and values of the string constants of the function.
+    Vector<std::pair<std::size_t, const std::string*>> const_strings_;
+    std::string const_string_text_;  // Reused to escape them.
+    std::string const_string_prefix_ = "str.";
     std::size_t const_string_next_id_;
     bool need_string_functions_ = false;
     bool string_functions_declared_ = false;
-    std::unordered_set<std::string> strings_to_free_;
+    Set<std::string> strings_to_free_;
 
     std::size_t indent_level_ = 0;
     std::string indentation_;
 
+    ir_cache::Cache* cache_ = nullptr;
+
+    void begin_function_ (const ast::Function_Definition& node);
+    void emit_function_ (const ast::Function_Definition& node, ir_cache::Entry* capture);
+    void emit_function_definition_ (const ast::Function_Definition& node);
+    void end_function_ ();
+
     std::size_t increment_var_count_ (parser::Symbol::Ptr symbol) {
         auto iter = variable_counts_.find(symbol);
         if (iter == std::end(variable_counts_)) {
@@ -174,16 +229,16 @@ class LLVM_Generator : public ast::Code_Generator {
         if (indent_level_ > 0) {
             --indent_level_;
             apply_indent_();
-            out_ << label.destination_llvm_ir();
             ++indent_level_;
-        } else {
-            out_ << label.destination_llvm_ir();
         }
+        out_ << "Label_" << label.id() << ":\n";
     }
 };
 
 
-std::string type (parser::Type t);
+constexpr const char* type (parser::Type t) {
+    return t == parser::Type::INT ? "i32" : "i8*";
+}
 
 // class Register {
 //   public:
@@ -281,10 +336,10 @@ std::string type (parser::Type t);
 
 // br instruction
 // br label <dest>
-std::string br_instruction (const Label& label_1);
+void br_instruction (output::Output_Buffer& out, const Label& label_1);
 
 // br i1 <cond>, label <iftrue>, label<iffailure>
-std::string br_instruction (const std::string& cond, const Label& label_1, const Label& label_2);
+void br_instruction (output::Output_Buffer& out, const Value& cond, const Label& label_1, const Label& label_2);
 
 }
 
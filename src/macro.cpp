@@ -6,6 +6,8 @@
 
 #include "macro.hpp"
 
+#include "atom.hpp"
+
 
 namespace preprocessor {
 
@@ -13,7 +15,7 @@ namespace preprocessor {
 // Macro - member function definitions
 
 
-Macro::Macro (std::string&& name) : name_(std::move(name)) {}
+Macro::Macro (atom::Atom name) : name_(name) {}
 
 void Macro::body (std::string&& val) {
     body_ = std::move(val);
@@ -22,7 +24,7 @@ void Macro::body (std::string&& val) {
 
 // Macro_Function - member function definitions
 
-Macro_Function::Macro_Function (std::string&& name) : Macro(std::move(name)) {}
+Macro_Function::Macro_Function (atom::Atom name) : Macro(name) {}
 
 std::string Macro_Function::resolve (const Argument_List& args) const {
     assert(args.size() == argument_names_.size());
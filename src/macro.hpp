@@ -7,24 +7,27 @@
 #include <string>
 #include <vector>
 
+#include "atom.hpp"
+
 
 namespace preprocessor {
 
 
 class Macro {
   public:
-    Macro (std::string&& name);
+    Macro (atom::Atom name);
     virtual ~Macro () {}
 
     typedef std::shared_ptr<Macro> Ptr;
 
-    const std::string& name () const { return name_; }
+    const std::string& name () const { return name_.str(); }
+    atom::Atom         atom () const { return name_; }
     const std::string& body () const { return body_; }
 
     void body (std::string&& val);
 
   protected:
-    std::string name_;
+    atom::Atom  name_;
     std::string body_;
 };
 
@@ -33,7 +36,7 @@ class Macro_Function : public Macro {
   public:
     typedef std::vector<std::string> Argument_List;
 
-    Macro_Function (std::string&& name);
+    Macro_Function (atom::Atom name);
 
     Argument_List& argument_names () { return argument_names_; }
 
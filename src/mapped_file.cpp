@@ -0,0 +1,95 @@
+#include "mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <stdexcept>
+#include <string>
+
+
+namespace input {
+
+
+static std::runtime_error error (const char* what) {
+    return std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+}
+
+static std::size_t round_up (std::size_t size, std::size_t page_size) {
+    return (size + page_size - 1) / page_size * page_size;
+}
+
+
+// Mapped_File - member function definitions
+
+bool Mapped_File::can_map (const std::string& path) {
+    struct stat status;
+    return stat(path.c_str(), &status) == 0 and S_ISREG(status.st_mode);
+}
+
+Mapped_File::Mapped_File (const std::string& path, std::size_t slack) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw error("cannot open input file");
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        int saved_errno = errno;
+        close(fd);
+        errno = saved_errno;
+        throw error("cannot read input file");
+    }
+    if (not S_ISREG(status.st_mode)) {
+        close(fd);
+        throw std::runtime_error("not a regular file");
+    }
+
+    std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    size_  = static_cast<std::size_t>(status.st_size);
+    slack_ = round_up(slack, page_size);
+
+    // Reserve zeroed memory for the slack, the text and the two NULs first,
+    // then map the file over the middle of it. Past the end of the file, the
+    // last page of the file reads as zeros, and so do the pages after it.
+    region_size_ = slack_ + round_up(size_ + 2, page_size);
+    void* region = mmap(nullptr, region_size_, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        int saved_errno = errno;
+        close(fd);
+        errno = saved_errno;
+        throw error("cannot map input file");
+    }
+    region_ = static_cast<char*>(region);
+    text_ = region_ + slack_;
+
+    if (size_ > 0) {
+        void* text = mmap(text_, size_, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (text == MAP_FAILED) {
+            int saved_errno = errno;
+            munmap(region_, region_size_);
+            close(fd);
+            errno = saved_errno;
+            throw error("cannot map input file");
+        }
+
+        // The scanners read the text once, from start to end.
+        madvise(text_, size_, MADV_SEQUENTIAL);
+    }
+
+    // The mapping stays valid without the file descriptor.
+    close(fd);
+}
+
+Mapped_File::~Mapped_File () {
+    munmap(region_, region_size_);
+}
+
+
+}  // namespace input
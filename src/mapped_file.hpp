@@ -0,0 +1,54 @@
+#ifndef __CSTR_COMPILER__MAPPED_FILE_HPP
+#define __CSTR_COMPILER__MAPPED_FILE_HPP
+
+
+#include <cstddef>
+
+#include <string>
+
+
+namespace input {
+
+
+// A source file mapped into memory, laid out so that a Flex scanner can scan
+// it in place (see scanner::Scanner::scan_in_place):
+//
+//     [ slack() zero bytes ][ size() bytes of the file ][ '\0' '\0' ]
+//                           ^ text()
+//
+// The mapping is private and writable. Flex writes into the text while it
+// scans (it terminates each token with a NUL), which only copies the pages
+// it touches and never changes the file.
+class Mapped_File {
+  public:
+    // `slack` is rounded up to a multiple of the page size. Throws
+    // std::runtime_error (whose message does not repeat `path`) if the file
+    // cannot be opened or mapped.
+    explicit Mapped_File (const std::string& path, std::size_t slack = 0);
+    ~Mapped_File ();
+
+    // Whether `path` is a regular file, the only kind that can be mapped.
+    // Checked without opening it: opening a FIFO would wait for a writer,
+    // and take what it writes away from whoever reads the FIFO next.
+    static bool can_map (const std::string& path);
+
+    Mapped_File             (const Mapped_File&) = delete;
+    Mapped_File& operator = (const Mapped_File&) = delete;
+
+    char*       text  () const { return text_; }
+    std::size_t size  () const { return size_; }
+    std::size_t slack () const { return slack_; }
+
+  private:
+    char*       region_;
+    std::size_t region_size_;
+    char*       text_;
+    std::size_t size_;
+    std::size_t slack_;
+};
+
+
+}  // namespace input
+
+
+#endif  // __CSTR_COMPILER__MAPPED_FILE_HPP
@@ -0,0 +1,133 @@
+#include "output_buffer.hpp"
+
+#include <cstring>
+
+#include <iostream>
+#include <string>
+
+
+namespace output {
+
+
+// Initial capacity of the buffer. It grows as needed, so this only avoids the
+// first few reallocations for typical functions.
+static const std::size_t kInitialCapacity = 64 * 1024;
+
+// "00" to "99", for write_unsigned_().
+static const char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+
+Output_Buffer::Output_Buffer (std::ostream& target, Flush_Policy policy)
+      : target_(target), policy_(policy) {
+    buffer_.reserve(kInitialCapacity);
+}
+
+Output_Buffer::~Output_Buffer () {
+    flush();
+}
+
+Output_Buffer& Output_Buffer::operator << (char c) {
+    buffer_.push_back(c);
+    if (capture_) {
+        capture_->push_back(c);
+    }
+    if (c == '\n' and policy_ == Flush_Policy::LINE) {
+        flush();
+    }
+    return *this;
+}
+
+Output_Buffer& Output_Buffer::operator << (const char* s) {
+    write(s, std::strlen(s));
+    return *this;
+}
+
+Output_Buffer& Output_Buffer::operator << (const std::string& s) {
+    write(s.data(), s.size());
+    return *this;
+}
+
+Output_Buffer& Output_Buffer::operator << (int value) {
+    return *this << static_cast<long>(value);
+}
+
+Output_Buffer& Output_Buffer::operator << (long value) {
+    // Negate in unsigned arithmetic so that LONG_MIN does not overflow.
+    if (value < 0) {
+        write_unsigned_(0ul - static_cast<unsigned long>(value), true);
+    } else {
+        write_unsigned_(static_cast<unsigned long>(value), false);
+    }
+    return *this;
+}
+
+Output_Buffer& Output_Buffer::operator << (unsigned value) {
+    write_unsigned_(value, false);
+    return *this;
+}
+
+Output_Buffer& Output_Buffer::operator << (unsigned long value) {
+    write_unsigned_(value, false);
+    return *this;
+}
+
+void Output_Buffer::write (const char* data, std::size_t size) {
+    buffer_.insert(buffer_.end(), data, data + size);
+    if (capture_) {
+        capture_->append(data, size);
+    }
+    if (policy_ == Flush_Policy::LINE and std::memchr(data, '\n', size)) {
+        flush();
+    }
+}
+
+void Output_Buffer::flush () {
+    if (not buffer_.empty()) {
+        target_.write(buffer_.data(), buffer_.size());
+        bytes_written_ += buffer_.size();
+        buffer_.clear();
+    }
+    target_.flush();
+    ++flush_count_;
+}
+
+void Output_Buffer::write_unsigned_ (unsigned long value, bool negative) {
+    // Digits are produced least significant first, so fill from the back,
+    // two at a time (one division per pair).
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* begin = end;
+    while (value >= 100) {
+        const char* pair = kDigitPairs + 2 * (value % 100);
+        value /= 100;
+        *--begin = pair[1];
+        *--begin = pair[0];
+    }
+    if (value >= 10) {
+        const char* pair = kDigitPairs + 2 * value;
+        *--begin = pair[1];
+        *--begin = pair[0];
+    } else {
+        *--begin = static_cast<char>('0' + value);
+    }
+    if (negative) {
+        *--begin = '-';
+    }
+    buffer_.insert(buffer_.end(), begin, end);
+    if (capture_) {
+        capture_->append(begin, end);
+    }
+}
+
+
+}  // namespace output
@@ -0,0 +1,85 @@
+#ifndef __CSTR_COMPILER__OUTPUT_BUFFER_HPP
+#define __CSTR_COMPILER__OUTPUT_BUFFER_HPP
+
+
+#include <cstddef>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace output {
+
+
+// When the bytes collected by an Output_Buffer are handed to its target
+// stream.
+enum class Flush_Policy {
+    // Write through and flush the target at the end of every line. This is
+    // what the code generators did when every line ended in std::endl.
+    LINE,
+
+    // Only at explicit flush points (the code generators flush at function
+    // boundaries) and when the buffer is destroyed.
+    EXPLICIT,
+};
+
+
+// Growable byte buffer that the code generators write their output into. It
+// stands in for a std::ostream, but never formats through a locale and never
+// touches the target stream until a flush point is reached.
+class Output_Buffer {
+  public:
+    Output_Buffer (std::ostream& target, Flush_Policy policy = Flush_Policy::LINE);
+    ~Output_Buffer ();
+
+    // Delete all default constructors/assignment operators.
+    Output_Buffer             (const Output_Buffer&) = delete;
+    Output_Buffer             (Output_Buffer&&)      = delete;
+    Output_Buffer& operator = (const Output_Buffer&) = delete;
+    Output_Buffer& operator = (Output_Buffer&&)      = delete;
+
+    Output_Buffer& operator << (char c);
+    Output_Buffer& operator << (const char* s);
+    Output_Buffer& operator << (const std::string& s);
+    Output_Buffer& operator << (int value);
+    Output_Buffer& operator << (long value);
+    Output_Buffer& operator << (unsigned value);
+    Output_Buffer& operator << (unsigned long value);
+
+    void write (const char* data, std::size_t size);
+
+    // Hand everything buffered so far to the target stream and flush it.
+    void flush ();
+
+    // Drop everything buffered so far without writing it.
+    void discard () { buffer_.clear(); }
+
+    // Also append everything written from now on to `capture`, until
+    // end_capture(). Flushing does not interrupt a capture.
+    void begin_capture (std::string& capture) { capture_ = &capture; }
+    void end_capture   ()                     { capture_ = nullptr;  }
+
+    Flush_Policy policy () const { return policy_; }
+
+    // Statistics.
+    std::size_t bytes_written () const { return bytes_written_; }
+    std::size_t flush_count   () const { return flush_count_;   }
+
+  private:
+    std::ostream& target_;
+    Flush_Policy policy_;
+    std::vector<char> buffer_;
+    std::string* capture_ = nullptr;
+
+    std::size_t bytes_written_ = 0;
+    std::size_t flush_count_   = 0;
+
+    void write_unsigned_ (unsigned long value, bool negative);
+};
+
+
+}  // namespace output
+
+
+#endif  // __CSTR_COMPILER__OUTPUT_BUFFER_HPP
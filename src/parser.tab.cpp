@@ -0,0 +1,2710 @@
+// A Bison parser, made by GNU Bison 3.8.2.
+
+// Skeleton implementation for Bison LALR(1) parsers in C++
+
+// Copyright (C) 2002-2015, 2018-2021 Free Software Foundation, Inc.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// As a special exception, you may create a larger work that contains
+// part or all of the Bison parser skeleton and distribute that work
+// under terms of your choice, so long as that work isn't itself a
+// parser generator using the skeleton or a modified version thereof
+// as a parser skeleton.  Alternatively, if you modify or redistribute
+// the parser skeleton itself, you may (at your option) remove this
+// special exception, which will cause the skeleton and the resulting
+// Bison output files to be licensed under the GNU General Public
+// License without this special exception.
+
+// This special exception was added by the Free Software Foundation in
+// version 2.2 of Bison.
+
+// DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+// especially those whose name start with YY_ or yy_.  They are
+// private implementation details that can be changed or removed.
+
+
+
+// First part of user prologue.
+#line 1 "src/parser.yy"
+
+
+#include "scanner.hpp"
+
+#include <cctype>
+#include <cstdint>
+
+#include <algorithm>
+#include <stack>
+#include <string>
+
+#include "ir_cache.hpp"
+
+
+std::string type_str (const parser::Type& type) {
+    switch (type) {
+        case parser::Type::INT:
+            return "int";
+        case parser::Type::STRING:
+            return "string";
+        default:
+            return "(undef)";
+    }
+}
+
+
+// WARNING: USE OF A DIRTY MACRO
+//          The parser will by default try to use a global yylex function. We
+//          want it to use the lex function of its member reference "scanner".
+//          So #define yylex to refer to this.
+#define yylex(yylval, yylloc) lex_token(scanner, state, yylval, yylloc)
+
+
+// Calls the scanner, charging the time to the scanning phase of --time-report.
+// Records the token for the cache keys of function definitions if needed.
+static parser::Parser::token_type lex_token (
+    scanner::Scanner& scanner,
+    parser::Parse_State& state,
+    parser::Parser::semantic_type* yylval,
+    parser::Parser::location_type* yylloc
+) {
+    stats::Phase_Timer timer (stats::Phase::SCANNING);
+    stats::count(stats::Counter::TOKENS);
+    parser::Parser::token_type token = scanner.lex(yylval, yylloc);
+
+    if (state.hash_functions) {
+        ir_cache::Hasher hasher;
+        hasher.add(static_cast<std::uint64_t>(token));
+        switch (token) {
+            case parser::Parser::token::IDENT:
+                hasher.add(yylval->as<atom::Atom>().str());
+                break;
+            case parser::Parser::token::CONST_STRING:
+                hasher.add(yylval->as<std::string>());
+                break;
+            case parser::Parser::token::CONST_INT:
+                hasher.add(static_cast<std::uint64_t>(yylval->as<int>()));
+                break;
+            default:
+                break;
+        }
+        state.tokens.push_back(
+            parser::Parse_State::Token {yylloc->begin, yylloc->end, hasher.digest()});
+    }
+
+    return token;
+}
+
+
+static bool before (const parser::position& a, const parser::position& b) {
+    return a.line < b.line or (a.line == b.line and a.column < b.column);
+}
+
+// Forget the tokens of the external declaration that ends at `end`. Tokens
+// after it have already been read ahead, and belong to the next one.
+static void forget_tokens (parser::Parse_State& state, const parser::position& end) {
+    auto first_kept = std::find_if(
+        std::begin(state.tokens), std::end(state.tokens),
+        [&] (const parser::Parse_State::Token& token) { return not before(token.begin, end); });
+    state.tokens.erase(std::begin(state.tokens), first_kept);
+}
+
+// Record that the function being defined refers to a symbol declared outside
+// of it. Its IR depends on that symbol's signature, not just on its tokens.
+static void reference (parser::Parse_State& state, const parser::Symbol::Ptr& symbol) {
+    if (not state.hash_functions) {
+        return;
+    }
+
+    if (auto function = std::dynamic_pointer_cast<parser::Function>(symbol)) {
+        state.referenced_signatures.insert(
+            "function " + function->name() + ' '
+            + type_str(function->type()) + ' ' + function->type_str());
+    } else if (symbol->get(parser::Symbol::Attribute::GLOBAL)) {
+        state.referenced_signatures.insert(
+            "global " + symbol->name() + ' ' + symbol->type_str());
+    }
+}
+
+// Cache key of the function definition at `location`: a hash of its tokens
+// and of the signatures of the globals and functions it refers to.
+static std::string cache_key (parser::Parse_State& state, const parser::location& location) {
+    ir_cache::Hasher hasher;
+    for (auto& token : state.tokens) {
+        if (before(token.begin, location.begin)) {
+            continue;
+        }
+        if (not before(token.begin, location.end)) {
+            break;
+        }
+        hasher.add(token.hash);
+    }
+    for (auto& signature : state.referenced_signatures) {
+        hasher.add(signature);
+    }
+    return hasher.hex();
+}
+
+
+#line 161 "src/parser.tab.cpp"
+
+
+#include "parser.tab.hpp"
+
+
+
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> // FIXME: INFRINGES ON USER NAME SPACE.
+#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(msgid) msgid
+# endif
+#endif
+
+
+// Whether we are compiled with exception support.
+#ifndef YY_EXCEPTIONS
+# if defined __GNUC__ && !defined __EXCEPTIONS
+#  define YY_EXCEPTIONS 0
+# else
+#  define YY_EXCEPTIONS 1
+# endif
+#endif
+
+#define YYRHSLOC(Rhs, K) ((Rhs)[K].location)
+/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
+   If N is 0, then set CURRENT to the empty location which ends
+   the previous symbol: RHS[0] (always defined).  */
+
+# ifndef YYLLOC_DEFAULT
+#  define YYLLOC_DEFAULT(Current, Rhs, N)                               \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).begin  = YYRHSLOC (Rhs, 1).begin;                   \
+          (Current).end    = YYRHSLOC (Rhs, N).end;                     \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).begin = (Current).end = YYRHSLOC (Rhs, 0).end;      \
+        }                                                               \
+    while (false)
+# endif
+
+
+// Enable debugging if requested.
+#if YYDEBUG
+
+// A pseudo ostream that takes yydebug_ into account.
+# define YYCDEBUG if (yydebug_) (*yycdebug_)
+
+# define YY_SYMBOL_PRINT(Title, Symbol)         \
+  do {                                          \
+    if (yydebug_)                               \
+    {                                           \
+      *yycdebug_ << Title << ' ';               \
+      yy_print_ (*yycdebug_, Symbol);           \
+      *yycdebug_ << '\n';                       \
+    }                                           \
+  } while (false)
+
+# define YY_REDUCE_PRINT(Rule)          \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_reduce_print_ (Rule);          \
+  } while (false)
+
+# define YY_STACK_PRINT()               \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_stack_print_ ();                \
+  } while (false)
+
+#else // !YYDEBUG
+
+# define YYCDEBUG if (false) std::cerr
+# define YY_SYMBOL_PRINT(Title, Symbol)  YY_USE (Symbol)
+# define YY_REDUCE_PRINT(Rule)           static_cast<void> (0)
+# define YY_STACK_PRINT()                static_cast<void> (0)
+
+#endif // !YYDEBUG
+
+#define yyerrok         (yyerrstatus_ = 0)
+#define yyclearin       (yyla.clear ())
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYRECOVERING()  (!!yyerrstatus_)
+
+#line 132 "src/parser.yy"
+namespace parser {
+#line 259 "src/parser.tab.cpp"
+
+  /// Build a parser object.
+  Parser::Parser (scanner::Scanner& scanner_yyarg, Symbol_Table::Ptr symbol_table_yyarg, ast::Code_Generator& code_generator_yyarg, Parse_State& state_yyarg)
+#if YYDEBUG
+    : yydebug_ (false),
+      yycdebug_ (&std::cerr),
+#else
+    :
+#endif
+      scanner (scanner_yyarg),
+      symbol_table (symbol_table_yyarg),
+      code_generator (code_generator_yyarg),
+      state (state_yyarg)
+  {}
+
+  Parser::~Parser ()
+  {}
+
+  Parser::syntax_error::~syntax_error () YY_NOEXCEPT YY_NOTHROW
+  {}
+
+  /*---------.
+  | symbol.  |
+  `---------*/
+
+  // basic_symbol.
+  template <typename Base>
+  Parser::basic_symbol<Base>::basic_symbol (const basic_symbol& that)
+    : Base (that)
+    , value ()
+    , location (that.location)
+  {
+    switch (this->kind ())
+    {
+      case symbol_kind::S_argument_expression_list: // argument_expression_list
+        value.copy< Expression_List > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_function_declarator: // function_declarator
+        value.copy< Function::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_instruction_list: // instruction_list
+        value.copy< Instruction_List > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_declarator: // declarator
+      case symbol_kind::S_parameter_declaration: // parameter_declaration
+        value.copy< Symbol::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+      case symbol_kind::S_declarator_list: // declarator_list
+      case symbol_kind::S_declaration_list: // declaration_list
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.copy< Symbol_List > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_type: // type
+        value.copy< Type > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_comparison_operator: // comparison_operator
+        value.copy< ast::Comparison_Operation > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_compound_instruction: // compound_instruction
+        value.copy< ast::Compound_Instruction::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_cond_instruction: // cond_instruction
+      case symbol_kind::S_condition: // condition
+        value.copy< ast::Condition > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_assignment: // assignment
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_unary_expression: // unary_expression
+      case symbol_kind::S_postfix_expression: // postfix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.copy< ast::Expression > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_function_definition: // function_definition
+        value.copy< ast::Function_Definition::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_instruction: // instruction
+      case symbol_kind::S_expression_instruction: // expression_instruction
+      case symbol_kind::S_select_instruction: // select_instruction
+      case symbol_kind::S_iteration_instruction: // iteration_instruction
+      case symbol_kind::S_jump_instruction: // jump_instruction
+        value.copy< ast::Instruction::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.copy< atom::Atom > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_CONST_INT: // CONST_INT
+        value.copy< int > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_CONST_STRING: // CONST_STRING
+        value.copy< std::string > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+  }
+
+
+
+
+  template <typename Base>
+  Parser::symbol_kind_type
+  Parser::basic_symbol<Base>::type_get () const YY_NOEXCEPT
+  {
+    return this->kind ();
+  }
+
+
+  template <typename Base>
+  bool
+  Parser::basic_symbol<Base>::empty () const YY_NOEXCEPT
+  {
+    return this->kind () == symbol_kind::S_YYEMPTY;
+  }
+
+  template <typename Base>
+  void
+  Parser::basic_symbol<Base>::move (basic_symbol& s)
+  {
+    super_type::move (s);
+    switch (this->kind ())
+    {
+      case symbol_kind::S_argument_expression_list: // argument_expression_list
+        value.move< Expression_List > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_function_declarator: // function_declarator
+        value.move< Function::Ptr > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_instruction_list: // instruction_list
+        value.move< Instruction_List > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_declarator: // declarator
+      case symbol_kind::S_parameter_declaration: // parameter_declaration
+        value.move< Symbol::Ptr > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+      case symbol_kind::S_declarator_list: // declarator_list
+      case symbol_kind::S_declaration_list: // declaration_list
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.move< Symbol_List > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_type: // type
+        value.move< Type > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_comparison_operator: // comparison_operator
+        value.move< ast::Comparison_Operation > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_compound_instruction: // compound_instruction
+        value.move< ast::Compound_Instruction::Ptr > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_cond_instruction: // cond_instruction
+      case symbol_kind::S_condition: // condition
+        value.move< ast::Condition > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_assignment: // assignment
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_unary_expression: // unary_expression
+      case symbol_kind::S_postfix_expression: // postfix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.move< ast::Expression > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_function_definition: // function_definition
+        value.move< ast::Function_Definition::Ptr > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_instruction: // instruction
+      case symbol_kind::S_expression_instruction: // expression_instruction
+      case symbol_kind::S_select_instruction: // select_instruction
+      case symbol_kind::S_iteration_instruction: // iteration_instruction
+      case symbol_kind::S_jump_instruction: // jump_instruction
+        value.move< ast::Instruction::Ptr > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.move< atom::Atom > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_CONST_INT: // CONST_INT
+        value.move< int > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_CONST_STRING: // CONST_STRING
+        value.move< std::string > (YY_MOVE (s.value));
+        break;
+
+      default:
+        break;
+    }
+
+    location = YY_MOVE (s.location);
+  }
+
+  // by_kind.
+  Parser::by_kind::by_kind () YY_NOEXCEPT
+    : kind_ (symbol_kind::S_YYEMPTY)
+  {}
+
+#if 201103L <= YY_CPLUSPLUS
+  Parser::by_kind::by_kind (by_kind&& that) YY_NOEXCEPT
+    : kind_ (that.kind_)
+  {
+    that.clear ();
+  }
+#endif
+
+  Parser::by_kind::by_kind (const by_kind& that) YY_NOEXCEPT
+    : kind_ (that.kind_)
+  {}
+
+  Parser::by_kind::by_kind (token_kind_type t) YY_NOEXCEPT
+    : kind_ (yytranslate_ (t))
+  {}
+
+
+
+  void
+  Parser::by_kind::clear () YY_NOEXCEPT
+  {
+    kind_ = symbol_kind::S_YYEMPTY;
+  }
+
+  void
+  Parser::by_kind::move (by_kind& that)
+  {
+    kind_ = that.kind_;
+    that.clear ();
+  }
+
+  Parser::symbol_kind_type
+  Parser::by_kind::kind () const YY_NOEXCEPT
+  {
+    return kind_;
+  }
+
+
+  Parser::symbol_kind_type
+  Parser::by_kind::type_get () const YY_NOEXCEPT
+  {
+    return this->kind ();
+  }
+
+
+
+  // by_state.
+  Parser::by_state::by_state () YY_NOEXCEPT
+    : state (empty_state)
+  {}
+
+  Parser::by_state::by_state (const by_state& that) YY_NOEXCEPT
+    : state (that.state)
+  {}
+
+  void
+  Parser::by_state::clear () YY_NOEXCEPT
+  {
+    state = empty_state;
+  }
+
+  void
+  Parser::by_state::move (by_state& that)
+  {
+    state = that.state;
+    that.clear ();
+  }
+
+  Parser::by_state::by_state (state_type s) YY_NOEXCEPT
+    : state (s)
+  {}
+
+  Parser::symbol_kind_type
+  Parser::by_state::kind () const YY_NOEXCEPT
+  {
+    if (state == empty_state)
+      return symbol_kind::S_YYEMPTY;
+    else
+      return YY_CAST (symbol_kind_type, yystos_[+state]);
+  }
+
+  Parser::stack_symbol_type::stack_symbol_type ()
+  {}
+
+  Parser::stack_symbol_type::stack_symbol_type (YY_RVREF (stack_symbol_type) that)
+    : super_type (YY_MOVE (that.state), YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_argument_expression_list: // argument_expression_list
+        value.YY_MOVE_OR_COPY< Expression_List > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_function_declarator: // function_declarator
+        value.YY_MOVE_OR_COPY< Function::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_instruction_list: // instruction_list
+        value.YY_MOVE_OR_COPY< Instruction_List > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_declarator: // declarator
+      case symbol_kind::S_parameter_declaration: // parameter_declaration
+        value.YY_MOVE_OR_COPY< Symbol::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+      case symbol_kind::S_declarator_list: // declarator_list
+      case symbol_kind::S_declaration_list: // declaration_list
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.YY_MOVE_OR_COPY< Symbol_List > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_type: // type
+        value.YY_MOVE_OR_COPY< Type > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_comparison_operator: // comparison_operator
+        value.YY_MOVE_OR_COPY< ast::Comparison_Operation > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_compound_instruction: // compound_instruction
+        value.YY_MOVE_OR_COPY< ast::Compound_Instruction::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_cond_instruction: // cond_instruction
+      case symbol_kind::S_condition: // condition
+        value.YY_MOVE_OR_COPY< ast::Condition > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_assignment: // assignment
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_unary_expression: // unary_expression
+      case symbol_kind::S_postfix_expression: // postfix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.YY_MOVE_OR_COPY< ast::Expression > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_function_definition: // function_definition
+        value.YY_MOVE_OR_COPY< ast::Function_Definition::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_instruction: // instruction
+      case symbol_kind::S_expression_instruction: // expression_instruction
+      case symbol_kind::S_select_instruction: // select_instruction
+      case symbol_kind::S_iteration_instruction: // iteration_instruction
+      case symbol_kind::S_jump_instruction: // jump_instruction
+        value.YY_MOVE_OR_COPY< ast::Instruction::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.YY_MOVE_OR_COPY< atom::Atom > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_CONST_INT: // CONST_INT
+        value.YY_MOVE_OR_COPY< int > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_CONST_STRING: // CONST_STRING
+        value.YY_MOVE_OR_COPY< std::string > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+#if 201103L <= YY_CPLUSPLUS
+    // that is emptied.
+    that.state = empty_state;
+#endif
+  }
+
+  Parser::stack_symbol_type::stack_symbol_type (state_type s, YY_MOVE_REF (symbol_type) that)
+    : super_type (s, YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_argument_expression_list: // argument_expression_list
+        value.move< Expression_List > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_function_declarator: // function_declarator
+        value.move< Function::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_instruction_list: // instruction_list
+        value.move< Instruction_List > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_declarator: // declarator
+      case symbol_kind::S_parameter_declaration: // parameter_declaration
+        value.move< Symbol::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+      case symbol_kind::S_declarator_list: // declarator_list
+      case symbol_kind::S_declaration_list: // declaration_list
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.move< Symbol_List > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_type: // type
+        value.move< Type > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_comparison_operator: // comparison_operator
+        value.move< ast::Comparison_Operation > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_compound_instruction: // compound_instruction
+        value.move< ast::Compound_Instruction::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_cond_instruction: // cond_instruction
+      case symbol_kind::S_condition: // condition
+        value.move< ast::Condition > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_assignment: // assignment
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_unary_expression: // unary_expression
+      case symbol_kind::S_postfix_expression: // postfix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.move< ast::Expression > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_function_definition: // function_definition
+        value.move< ast::Function_Definition::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_instruction: // instruction
+      case symbol_kind::S_expression_instruction: // expression_instruction
+      case symbol_kind::S_select_instruction: // select_instruction
+      case symbol_kind::S_iteration_instruction: // iteration_instruction
+      case symbol_kind::S_jump_instruction: // jump_instruction
+        value.move< ast::Instruction::Ptr > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.move< atom::Atom > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_CONST_INT: // CONST_INT
+        value.move< int > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_CONST_STRING: // CONST_STRING
+        value.move< std::string > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+    // that is emptied.
+    that.kind_ = symbol_kind::S_YYEMPTY;
+  }
+
+#if YY_CPLUSPLUS < 201103L
+  Parser::stack_symbol_type&
+  Parser::stack_symbol_type::operator= (const stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_argument_expression_list: // argument_expression_list
+        value.copy< Expression_List > (that.value);
+        break;
+
+      case symbol_kind::S_function_declarator: // function_declarator
+        value.copy< Function::Ptr > (that.value);
+        break;
+
+      case symbol_kind::S_instruction_list: // instruction_list
+        value.copy< Instruction_List > (that.value);
+        break;
+
+      case symbol_kind::S_declarator: // declarator
+      case symbol_kind::S_parameter_declaration: // parameter_declaration
+        value.copy< Symbol::Ptr > (that.value);
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+      case symbol_kind::S_declarator_list: // declarator_list
+      case symbol_kind::S_declaration_list: // declaration_list
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.copy< Symbol_List > (that.value);
+        break;
+
+      case symbol_kind::S_type: // type
+        value.copy< Type > (that.value);
+        break;
+
+      case symbol_kind::S_comparison_operator: // comparison_operator
+        value.copy< ast::Comparison_Operation > (that.value);
+        break;
+
+      case symbol_kind::S_compound_instruction: // compound_instruction
+        value.copy< ast::Compound_Instruction::Ptr > (that.value);
+        break;
+
+      case symbol_kind::S_cond_instruction: // cond_instruction
+      case symbol_kind::S_condition: // condition
+        value.copy< ast::Condition > (that.value);
+        break;
+
+      case symbol_kind::S_assignment: // assignment
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_unary_expression: // unary_expression
+      case symbol_kind::S_postfix_expression: // postfix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.copy< ast::Expression > (that.value);
+        break;
+
+      case symbol_kind::S_function_definition: // function_definition
+        value.copy< ast::Function_Definition::Ptr > (that.value);
+        break;
+
+      case symbol_kind::S_instruction: // instruction
+      case symbol_kind::S_expression_instruction: // expression_instruction
+      case symbol_kind::S_select_instruction: // select_instruction
+      case symbol_kind::S_iteration_instruction: // iteration_instruction
+      case symbol_kind::S_jump_instruction: // jump_instruction
+        value.copy< ast::Instruction::Ptr > (that.value);
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.copy< atom::Atom > (that.value);
+        break;
+
+      case symbol_kind::S_CONST_INT: // CONST_INT
+        value.copy< int > (that.value);
+        break;
+
+      case symbol_kind::S_CONST_STRING: // CONST_STRING
+        value.copy< std::string > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    return *this;
+  }
+
+  Parser::stack_symbol_type&
+  Parser::stack_symbol_type::operator= (stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_argument_expression_list: // argument_expression_list
+        value.move< Expression_List > (that.value);
+        break;
+
+      case symbol_kind::S_function_declarator: // function_declarator
+        value.move< Function::Ptr > (that.value);
+        break;
+
+      case symbol_kind::S_instruction_list: // instruction_list
+        value.move< Instruction_List > (that.value);
+        break;
+
+      case symbol_kind::S_declarator: // declarator
+      case symbol_kind::S_parameter_declaration: // parameter_declaration
+        value.move< Symbol::Ptr > (that.value);
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+      case symbol_kind::S_declarator_list: // declarator_list
+      case symbol_kind::S_declaration_list: // declaration_list
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.move< Symbol_List > (that.value);
+        break;
+
+      case symbol_kind::S_type: // type
+        value.move< Type > (that.value);
+        break;
+
+      case symbol_kind::S_comparison_operator: // comparison_operator
+        value.move< ast::Comparison_Operation > (that.value);
+        break;
+
+      case symbol_kind::S_compound_instruction: // compound_instruction
+        value.move< ast::Compound_Instruction::Ptr > (that.value);
+        break;
+
+      case symbol_kind::S_cond_instruction: // cond_instruction
+      case symbol_kind::S_condition: // condition
+        value.move< ast::Condition > (that.value);
+        break;
+
+      case symbol_kind::S_assignment: // assignment
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_unary_expression: // unary_expression
+      case symbol_kind::S_postfix_expression: // postfix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        value.move< ast::Expression > (that.value);
+        break;
+
+      case symbol_kind::S_function_definition: // function_definition
+        value.move< ast::Function_Definition::Ptr > (that.value);
+        break;
+
+      case symbol_kind::S_instruction: // instruction
+      case symbol_kind::S_expression_instruction: // expression_instruction
+      case symbol_kind::S_select_instruction: // select_instruction
+      case symbol_kind::S_iteration_instruction: // iteration_instruction
+      case symbol_kind::S_jump_instruction: // jump_instruction
+        value.move< ast::Instruction::Ptr > (that.value);
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        value.move< atom::Atom > (that.value);
+        break;
+
+      case symbol_kind::S_CONST_INT: // CONST_INT
+        value.move< int > (that.value);
+        break;
+
+      case symbol_kind::S_CONST_STRING: // CONST_STRING
+        value.move< std::string > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    // that is emptied.
+    that.state = empty_state;
+    return *this;
+  }
+#endif
+
+  template <typename Base>
+  void
+  Parser::yy_destroy_ (const char* yymsg, basic_symbol<Base>& yysym) const
+  {
+    if (yymsg)
+      YY_SYMBOL_PRINT (yymsg, yysym);
+  }
+
+#if YYDEBUG
+  template <typename Base>
+  void
+  Parser::yy_print_ (std::ostream& yyo, const basic_symbol<Base>& yysym) const
+  {
+    std::ostream& yyoutput = yyo;
+    YY_USE (yyoutput);
+    if (yysym.empty ())
+      yyo << "empty symbol";
+    else
+      {
+        symbol_kind_type yykind = yysym.kind ();
+        yyo << (yykind < YYNTOKENS ? "token" : "nterm")
+            << ' ' << yysym.name () << " ("
+            << yysym.location << ": ";
+        YY_USE (yykind);
+        yyo << ')';
+      }
+  }
+#endif
+
+  void
+  Parser::yypush_ (const char* m, YY_MOVE_REF (stack_symbol_type) sym)
+  {
+    if (m)
+      YY_SYMBOL_PRINT (m, sym);
+    yystack_.push (YY_MOVE (sym));
+  }
+
+  void
+  Parser::yypush_ (const char* m, state_type s, YY_MOVE_REF (symbol_type) sym)
+  {
+#if 201103L <= YY_CPLUSPLUS
+    yypush_ (m, stack_symbol_type (s, std::move (sym)));
+#else
+    stack_symbol_type ss (s, sym);
+    yypush_ (m, ss);
+#endif
+  }
+
+  void
+  Parser::yypop_ (int n) YY_NOEXCEPT
+  {
+    yystack_.pop (n);
+  }
+
+#if YYDEBUG
+  std::ostream&
+  Parser::debug_stream () const
+  {
+    return *yycdebug_;
+  }
+
+  void
+  Parser::set_debug_stream (std::ostream& o)
+  {
+    yycdebug_ = &o;
+  }
+
+
+  Parser::debug_level_type
+  Parser::debug_level () const
+  {
+    return yydebug_;
+  }
+
+  void
+  Parser::set_debug_level (debug_level_type l)
+  {
+    yydebug_ = l;
+  }
+#endif // YYDEBUG
+
+  Parser::state_type
+  Parser::yy_lr_goto_state_ (state_type yystate, int yysym)
+  {
+    int yyr = yypgoto_[yysym - YYNTOKENS] + yystate;
+    if (0 <= yyr && yyr <= yylast_ && yycheck_[yyr] == yystate)
+      return yytable_[yyr];
+    else
+      return yydefgoto_[yysym - YYNTOKENS];
+  }
+
+  bool
+  Parser::yy_pact_value_is_default_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yypact_ninf_;
+  }
+
+  bool
+  Parser::yy_table_value_is_error_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yytable_ninf_;
+  }
+
+  int
+  Parser::operator() ()
+  {
+    return parse ();
+  }
+
+  int
+  Parser::parse ()
+  {
+    int yyn;
+    /// Length of the RHS of the rule being reduced.
+    int yylen = 0;
+
+    // Error handling.
+    int yynerrs_ = 0;
+    int yyerrstatus_ = 0;
+
+    /// The lookahead symbol.
+    symbol_type yyla;
+
+    /// The locations where the error started and ended.
+    stack_symbol_type yyerror_range[3];
+
+    /// The return value of parse ().
+    int yyresult;
+
+#if YY_EXCEPTIONS
+    try
+#endif // YY_EXCEPTIONS
+      {
+    YYCDEBUG << "Starting parse\n";
+
+
+    // User initialization code.
+#line 201 "src/parser.yy"
+{
+    yyla.location.begin.filename = yyla.location.end.filename = new std::string("<stdin>");
+}
+
+#line 1073 "src/parser.tab.cpp"
+
+
+    /* Initialize the stack.  The initial state will be set in
+       yynewstate, since the latter expects the semantical and the
+       location values to have been already stored, initialize these
+       stacks with a primary value.  */
+    yystack_.clear ();
+    yypush_ (YY_NULLPTR, 0, YY_MOVE (yyla));
+
+  /*-----------------------------------------------.
+  | yynewstate -- push a new symbol on the stack.  |
+  `-----------------------------------------------*/
+  yynewstate:
+    YYCDEBUG << "Entering state " << int (yystack_[0].state) << '\n';
+    YY_STACK_PRINT ();
+
+    // Accept?
+    if (yystack_[0].state == yyfinal_)
+      YYACCEPT;
+
+    goto yybackup;
+
+
+  /*-----------.
+  | yybackup.  |
+  `-----------*/
+  yybackup:
+    // Try to take a decision without lookahead.
+    yyn = yypact_[+yystack_[0].state];
+    if (yy_pact_value_is_default_ (yyn))
+      goto yydefault;
+
+    // Read a lookahead token.
+    if (yyla.empty ())
+      {
+        YYCDEBUG << "Reading a token\n";
+#if YY_EXCEPTIONS
+        try
+#endif // YY_EXCEPTIONS
+          {
+            yyla.kind_ = yytranslate_ (yylex (&yyla.value, &yyla.location));
+          }
+#if YY_EXCEPTIONS
+        catch (const syntax_error& yyexc)
+          {
+            YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+            error (yyexc);
+            goto yyerrlab1;
+          }
+#endif // YY_EXCEPTIONS
+      }
+    YY_SYMBOL_PRINT ("Next token is", yyla);
+
+    if (yyla.kind () == symbol_kind::S_YYerror)
+    {
+      // The scanner already issued an error message, process directly
+      // to error recovery.  But do not keep the error token as
+      // lookahead, it is too special and may lead us to an endless
+      // loop in error recovery. */
+      yyla.kind_ = symbol_kind::S_YYUNDEF;
+      goto yyerrlab1;
+    }
+
+    /* If the proper action on seeing token YYLA.TYPE is to reduce or
+       to detect an error, take that action.  */
+    yyn += yyla.kind ();
+    if (yyn < 0 || yylast_ < yyn || yycheck_[yyn] != yyla.kind ())
+      {
+        goto yydefault;
+      }
+
+    // Reduce or error.
+    yyn = yytable_[yyn];
+    if (yyn <= 0)
+      {
+        if (yy_table_value_is_error_ (yyn))
+          goto yyerrlab;
+        yyn = -yyn;
+        goto yyreduce;
+      }
+
+    // Count tokens shifted since error; after three, turn off error status.
+    if (yyerrstatus_)
+      --yyerrstatus_;
+
+    // Shift the lookahead token.
+    yypush_ ("Shifting", state_type (yyn), YY_MOVE (yyla));
+    goto yynewstate;
+
+
+  /*-----------------------------------------------------------.
+  | yydefault -- do the default action for the current state.  |
+  `-----------------------------------------------------------*/
+  yydefault:
+    yyn = yydefact_[+yystack_[0].state];
+    if (yyn == 0)
+      goto yyerrlab;
+    goto yyreduce;
+
+
+  /*-----------------------------.
+  | yyreduce -- do a reduction.  |
+  `-----------------------------*/
+  yyreduce:
+    yylen = yyr2_[yyn];
+    {
+      stack_symbol_type yylhs;
+      yylhs.state = yy_lr_goto_state_ (yystack_[yylen].state, yyr1_[yyn]);
+      /* Variants are always initialized to an empty instance of the
+         correct type. The default '$$ = $1' action is NOT applied
+         when using variants.  */
+      switch (yyr1_[yyn])
+    {
+      case symbol_kind::S_argument_expression_list: // argument_expression_list
+        yylhs.value.emplace< Expression_List > ();
+        break;
+
+      case symbol_kind::S_function_declarator: // function_declarator
+        yylhs.value.emplace< Function::Ptr > ();
+        break;
+
+      case symbol_kind::S_instruction_list: // instruction_list
+        yylhs.value.emplace< Instruction_List > ();
+        break;
+
+      case symbol_kind::S_declarator: // declarator
+      case symbol_kind::S_parameter_declaration: // parameter_declaration
+        yylhs.value.emplace< Symbol::Ptr > ();
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+      case symbol_kind::S_declarator_list: // declarator_list
+      case symbol_kind::S_declaration_list: // declaration_list
+      case symbol_kind::S_parameter_list: // parameter_list
+        yylhs.value.emplace< Symbol_List > ();
+        break;
+
+      case symbol_kind::S_type: // type
+        yylhs.value.emplace< Type > ();
+        break;
+
+      case symbol_kind::S_comparison_operator: // comparison_operator
+        yylhs.value.emplace< ast::Comparison_Operation > ();
+        break;
+
+      case symbol_kind::S_compound_instruction: // compound_instruction
+        yylhs.value.emplace< ast::Compound_Instruction::Ptr > ();
+        break;
+
+      case symbol_kind::S_cond_instruction: // cond_instruction
+      case symbol_kind::S_condition: // condition
+        yylhs.value.emplace< ast::Condition > ();
+        break;
+
+      case symbol_kind::S_assignment: // assignment
+      case symbol_kind::S_expression: // expression
+      case symbol_kind::S_additive_expression: // additive_expression
+      case symbol_kind::S_multiplicative_expression: // multiplicative_expression
+      case symbol_kind::S_unary_expression: // unary_expression
+      case symbol_kind::S_postfix_expression: // postfix_expression
+      case symbol_kind::S_primary_expression: // primary_expression
+        yylhs.value.emplace< ast::Expression > ();
+        break;
+
+      case symbol_kind::S_function_definition: // function_definition
+        yylhs.value.emplace< ast::Function_Definition::Ptr > ();
+        break;
+
+      case symbol_kind::S_instruction: // instruction
+      case symbol_kind::S_expression_instruction: // expression_instruction
+      case symbol_kind::S_select_instruction: // select_instruction
+      case symbol_kind::S_iteration_instruction: // iteration_instruction
+      case symbol_kind::S_jump_instruction: // jump_instruction
+        yylhs.value.emplace< ast::Instruction::Ptr > ();
+        break;
+
+      case symbol_kind::S_IDENT: // IDENT
+        yylhs.value.emplace< atom::Atom > ();
+        break;
+
+      case symbol_kind::S_CONST_INT: // CONST_INT
+        yylhs.value.emplace< int > ();
+        break;
+
+      case symbol_kind::S_CONST_STRING: // CONST_STRING
+        yylhs.value.emplace< std::string > ();
+        break;
+
+      default:
+        break;
+    }
+
+
+      // Default location.
+      {
+        stack_type::slice range (yystack_, yylen);
+        YYLLOC_DEFAULT (yylhs.location, range, yylen);
+        yyerror_range[1].location = yylhs.location;
+      }
+
+      // Perform the reduction.
+      YY_REDUCE_PRINT (yyn);
+#if YY_EXCEPTIONS
+      try
+#endif // YY_EXCEPTIONS
+        {
+          switch (yyn)
+            {
+  case 2: // program: external_declaration
+#line 283 "src/parser.yy"
+                                 {
+        /* std::cout << "program: external_declaration" << std::endl; */
+    }
+#line 1287 "src/parser.tab.cpp"
+    break;
+
+  case 3: // program: program external_declaration
+#line 286 "src/parser.yy"
+                                 {
+        /* std::cout << "program: program external_declaration" << std::endl; */
+    }
+#line 1295 "src/parser.tab.cpp"
+    break;
+
+  case 4: // external_declaration: declaration
+#line 292 "src/parser.yy"
+                        {
+        auto declaration_list = ast::make<ast::Declaration_List>();
+
+        for (auto& symbol : yystack_[0].value.as < Symbol_List > ()) {
+            symbol->set(Symbol::Attribute::GLOBAL);
+
+            // Emit function declarations.
+            if (auto function = std::dynamic_pointer_cast<Function>(symbol)) {
+                auto func_decl = ast::make<ast::Function_Declaration>(function->type(), function);
+                func_decl->emit_code(code_generator);
+            } else {
+                declaration_list->push_back(symbol);
+            }
+        }
+
+        declaration_list->emit_code(code_generator);
+        forget_tokens(state, yylhs.location.end);
+    }
+#line 1318 "src/parser.tab.cpp"
+    break;
+
+  case 5: // external_declaration: EXTERN declaration
+#line 310 "src/parser.yy"
+                        {
+        auto declaration_list = ast::make<ast::Declaration_List>();
+
+        for (auto& symbol : yystack_[0].value.as < Symbol_List > ()) {
+            symbol->set(Symbol::Attribute::GLOBAL);
+            symbol->set(Symbol::Attribute::EXTERN);
+
+            if (auto function = std::dynamic_pointer_cast<Function>(symbol)) {
+                auto func_decl = ast::make<ast::Function_Declaration>(function->type(), function);
+                func_decl->emit_code(code_generator);
+            } else {
+                declaration_list->push_back(symbol);
+            }
+        }
+
+        declaration_list->emit_code(code_generator);
+        forget_tokens(state, yylhs.location.end);
+    }
+#line 1341 "src/parser.tab.cpp"
+    break;
+
+  case 6: // external_declaration: function_definition
+#line 328 "src/parser.yy"
+                        {
+        /* std::cout << "external_declaration: function_definition" << std::endl; */
+
+        // emit function definition
+        yystack_[0].value.as < ast::Function_Definition::Ptr > ()->emit_code(code_generator);
+        forget_tokens(state, yylhs.location.end);
+
+        // The function's nodes, local symbols and scopes are released all at
+        // once, as soon as nothing refers to them anymore.
+        state.function_arena.close();
+        state.function_expressions.close();
+    }
+#line 1358 "src/parser.tab.cpp"
+    break;
+
+  case 7: // function_definition: type function_declarator decl_glb_fct compound_instruction
+#line 343 "src/parser.yy"
+                                                               {
+        // Verify the function return type. (Should have been set when
+        // processing `function_declarator`.)
+        auto function = yystack_[2].value.as < Function::Ptr > ();
+        state.unclaimed_types.pop();
+        if (function->type() != yystack_[3].value.as < Type > ()) {
+            throw std::runtime_error("INTERNAL ERROR: Type mismatch.");
+        }
+
+        // Type checking is done when processing `decl_glb_fct`.
+
+        yylhs.value.as < ast::Function_Definition::Ptr > () = ast::make<ast::Function_Definition>(yystack_[3].value.as < Type > (), function, yystack_[0].value.as < ast::Compound_Instruction::Ptr > ());
+        if (state.hash_functions) {
+            yylhs.value.as < ast::Function_Definition::Ptr > ()->cache_key(cache_key(state, yylhs.location));
+        }
+    }
+#line 1379 "src/parser.tab.cpp"
+    break;
+
+  case 8: // decl_glb_fct: %empty
+#line 361 "src/parser.yy"
+               {
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
+
+        Function::Ptr function = state.last_function;
+
+        // A function can be declared before it is defined.
+        if (auto declared = symbol_table->lookup(function->atom())) {
+            // Retrieve previously declared function.
+            auto declared_func = std::dynamic_pointer_cast<Function>(declared);
+
+            // Verify that previously declared identifier is a function.
+            if (not declared_func) {
+                throw syntax_error(yylhs.location, "Attempt to define function with name of "
+                    "variable '" + function->name() + "'.");
+            }
+
+            // Verify the return type. (type-checking)
+            if (function->type() != declared_func->type()) {
+                std::ostringstream oss;
+                oss
+                    << "Return type of function definition, "
+                    << (function->type() == Type::INT ? "int" : "string")
+                    << ", does not match declaration, "
+                    << (declared_func->type() == Type::INT ? "int" : "string")
+                    << "."
+                    ;
+                throw syntax_error(yylhs.location, oss.str());
+            }
+
+            // Verify the argument list. (type-checking)
+            if (function->argument_list().size() != declared_func->argument_list().size()) {
+                throw syntax_error(yylhs.location, "Signature mismatch between function definition and declaration.");
+            }
+            auto pair = std::mismatch(
+                std::begin(function->argument_list()), std::end(function->argument_list()),
+                std::begin(declared_func->argument_list()),
+                [] (Symbol::Ptr a, Symbol::Ptr b) { return a->type() == b->type(); }
+            );
+            if (pair.first != std::end(function->argument_list())) {
+                throw syntax_error(yylhs.location, "Signature mismatch between function definition and declaration.");
+            }
+        }
+
+        // If function is not yet declared, add it to the symbol table before we
+        // attempt to define it. This enables recursion.
+        else {
+            symbol_table->add(function->atom(), Symbol::Ptr(function));
+            // $2->print_semantic_action();
+        }
+
+        // Raise a flag to let "block_start" know that the symbol-table has
+        // already been created.
+        state.new_function_definition = true;
+
+        state.referenced_signatures.clear();
+
+        // Everything created from here to the end of the definition goes in
+        // the function's arena.
+        state.function_arena.open();
+        state.function_expressions.open();
+
+        // Open the scope of this function.
+        symbol_table->push("function scope - " + function->name(), yylhs.location);
+
+        // NOTE: compound_instruction will have not yet already taken care of
+        //       opening a new scope in the symbol-table. However, it will
+        //       not add the function parameters to this scope. We must do that
+        //       here.
+        for (auto& symbol : function->argument_list()) {
+            symbol_table->add(symbol->atom(), symbol);
+        }
+    }
+#line 1456 "src/parser.tab.cpp"
+    break;
+
+  case 9: // declaration: type declarator_list ';'
+#line 436 "src/parser.yy"
+                             {
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
+
+        yylhs.value.as < Symbol_List > () = yystack_[1].value.as < Symbol_List > ();
+        state.unclaimed_types.pop();
+
+        for (auto& symbol : yylhs.value.as < Symbol_List > ()) {
+            symbol->type(yystack_[2].value.as < Type > ());
+
+            if (symbol_table->is_in_this_scope(symbol->atom())) {
+                throw syntax_error(yylhs.location, "Duplicate declaration of symbol '" +
+                    symbol->name() + "'");
+            }
+
+            symbol_table->add(symbol->atom(), symbol);
+            // symbol->print_semantic_action();  // TODO: Remove for Part 3.
+        }
+    }
+#line 1479 "src/parser.tab.cpp"
+    break;
+
+  case 10: // type: INT
+#line 457 "src/parser.yy"
+           {
+        state.unclaimed_types.push(Type::INT);
+        yylhs.value.as < Type > () = Type::INT;
+    }
+#line 1488 "src/parser.tab.cpp"
+    break;
+
+  case 11: // type: STRING
+#line 461 "src/parser.yy"
+           {
+        state.unclaimed_types.push(Type::STRING);
+        yylhs.value.as < Type > () = Type::STRING;
+    }
+#line 1497 "src/parser.tab.cpp"
+    break;
+
+  case 12: // declarator_list: declarator
+#line 468 "src/parser.yy"
+                                   {
+        yylhs.value.as < Symbol_List > ().push_back(yystack_[0].value.as < Symbol::Ptr > ());
+    }
+#line 1505 "src/parser.tab.cpp"
+    break;
+
+  case 13: // declarator_list: declarator_list ',' declarator
+#line 471 "src/parser.yy"
+                                   {
+        yylhs.value.as < Symbol_List > () = std::move(yystack_[2].value.as < Symbol_List > ());
+        yylhs.value.as < Symbol_List > ().push_back(yystack_[0].value.as < Symbol::Ptr > ());
+    }
+#line 1514 "src/parser.tab.cpp"
+    break;
+
+  case 14: // declaration_list: declaration
+#line 478 "src/parser.yy"
+                                  {
+        // Nothing to do. Semantic action of "declaration" handles symbol creation.
+        yylhs.value.as < Symbol_List > () = yystack_[0].value.as < Symbol_List > ();
+    }
+#line 1523 "src/parser.tab.cpp"
+    break;
+
+  case 15: // declaration_list: declaration_list declaration
+#line 482 "src/parser.yy"
+                                  {
+        // Nothing to do. Semantic action of "declaration" handles symbol creation.
+        yylhs.value.as < Symbol_List > () = std::move(yystack_[1].value.as < Symbol_List > ());
+        for (auto& symbol : yystack_[0].value.as < Symbol_List > ()) {
+            yylhs.value.as < Symbol_List > ().push_back(symbol);
+        }
+
+        // $$.push_back($2);
+    }
+#line 1537 "src/parser.tab.cpp"
+    break;
+
+  case 16: // declarator: IDENT
+#line 494 "src/parser.yy"
+                        {
+        yylhs.value.as < Symbol::Ptr > () = make_symbol<Symbol>(yystack_[0].value.as < atom::Atom > ());
+    }
+#line 1545 "src/parser.tab.cpp"
+    break;
+
+  case 17: // declarator: function_declarator
+#line 497 "src/parser.yy"
+                        {
+        yylhs.value.as < Symbol::Ptr > () = yystack_[0].value.as < Function::Ptr > ();
+    }
+#line 1553 "src/parser.tab.cpp"
+    break;
+
+  case 18: // function_declarator: IDENT '(' ')'
+#line 503 "src/parser.yy"
+                                  {
+        // Create function and set return type.
+        yylhs.value.as < Function::Ptr > () = make_symbol<Function>(yystack_[2].value.as < atom::Atom > ());
+        yylhs.value.as < Function::Ptr > ()->type(state.unclaimed_types.top());
+
+        state.last_function = yylhs.value.as < Function::Ptr > ();
+    }
+#line 1565 "src/parser.tab.cpp"
+    break;
+
+  case 19: // function_declarator: IDENT '(' parameter_list ')'
+#line 510 "src/parser.yy"
+                                  {
+        // Create function and set return type.
+        yylhs.value.as < Function::Ptr > () = make_symbol<Function>(yystack_[3].value.as < atom::Atom > ());
+        yylhs.value.as < Function::Ptr > ()->type(state.unclaimed_types.top());
+
+        state.last_function = yylhs.value.as < Function::Ptr > ();
+        for (auto& symbol : yystack_[1].value.as < Symbol_List > ()) {
+            symbol->set(Symbol::Attribute::FUNCTION_PARAM);
+            std::static_pointer_cast<Function>(yylhs.value.as < Function::Ptr > ())->argument_list().push_back(symbol);
+        }
+    }
+#line 1581 "src/parser.tab.cpp"
+    break;
+
+  case 20: // parameter_list: parameter_declaration
+#line 524 "src/parser.yy"
+                                             {
+        yylhs.value.as < Symbol_List > ().push_back(yystack_[0].value.as < Symbol::Ptr > ());
+    }
+#line 1589 "src/parser.tab.cpp"
+    break;
+
+  case 21: // parameter_list: parameter_list ',' parameter_declaration
+#line 527 "src/parser.yy"
+                                             {
+        yylhs.value.as < Symbol_List > () = std::move(yystack_[2].value.as < Symbol_List > ());
+        yylhs.value.as < Symbol_List > ().push_back(yystack_[0].value.as < Symbol::Ptr > ());
+    }
+#line 1598 "src/parser.tab.cpp"
+    break;
+
+  case 22: // parameter_declaration: type IDENT
+#line 534 "src/parser.yy"
+               {
+        yylhs.value.as < Symbol::Ptr > () = make_symbol<Symbol>(yystack_[0].value.as < atom::Atom > ());
+        state.unclaimed_types.pop();
+        yylhs.value.as < Symbol::Ptr > ()->type(yystack_[1].value.as < Type > ());
+    }
+#line 1608 "src/parser.tab.cpp"
+    break;
+
+  case 23: // instruction: ';'
+#line 542 "src/parser.yy"
+                           {
+        /* std::cout << "instruction: ';'"                    << std::endl; */
+        // No instruction to forward up. Nothing to do.
+    }
+#line 1617 "src/parser.tab.cpp"
+    break;
+
+  case 24: // instruction: compound_instruction
+#line 546 "src/parser.yy"
+                           {
+        /* std::cout << "instruction: compound_instruction"   << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = yystack_[0].value.as < ast::Compound_Instruction::Ptr > ();
+    }
+#line 1626 "src/parser.tab.cpp"
+    break;
+
+  case 25: // instruction: expression_instruction
+#line 550 "src/parser.yy"
+                           {
+        /* std::cout << "instruction: expression_instruction" << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = yystack_[0].value.as < ast::Instruction::Ptr > ();
+    }
+#line 1635 "src/parser.tab.cpp"
+    break;
+
+  case 26: // instruction: iteration_instruction
+#line 554 "src/parser.yy"
+                           {
+        /* std::cout << "instruction: iteration_instruction"  << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = yystack_[0].value.as < ast::Instruction::Ptr > ();
+    }
+#line 1644 "src/parser.tab.cpp"
+    break;
+
+  case 27: // instruction: select_instruction
+#line 558 "src/parser.yy"
+                           {
+        /* std::cout << "instruction: select_instruction"     << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = yystack_[0].value.as < ast::Instruction::Ptr > ();
+    }
+#line 1653 "src/parser.tab.cpp"
+    break;
+
+  case 28: // instruction: jump_instruction
+#line 562 "src/parser.yy"
+                           {
+        /* std::cout << "instruction: jump_instruction"       << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = yystack_[0].value.as < ast::Instruction::Ptr > ();
+    }
+#line 1662 "src/parser.tab.cpp"
+    break;
+
+  case 29: // expression_instruction: expression ';'
+#line 569 "src/parser.yy"
+                   {
+        /* std::cout << "expression_instruction: expression ';'" << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = ast::make<ast::Expression_Instruction>(yystack_[1].value.as < ast::Expression > ());
+    }
+#line 1671 "src/parser.tab.cpp"
+    break;
+
+  case 30: // expression_instruction: assignment ';'
+#line 573 "src/parser.yy"
+                   {
+        /* std::cout << "expression_instruction: assignment ';'" << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = ast::make<ast::Expression_Instruction>(yystack_[1].value.as < ast::Expression > ());
+    }
+#line 1680 "src/parser.tab.cpp"
+    break;
+
+  case 31: // assignment: IDENT '=' expression
+#line 580 "src/parser.yy"
+                         {
+        /* std::cout << "assignment: IDENT '=' expression" << std::endl; */
+        // std::cout << "- assignment " << $1 << std::endl;
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
+
+        Symbol::Ptr symbol = symbol_table->lookup(yystack_[2].value.as < atom::Atom > ());
+        if (not symbol) {
+            throw syntax_error(yylhs.location, yystack_[2].value.as < atom::Atom > ().str() + " is not defined.");
+        }
+        reference(state, symbol);
+        if (symbol->type() != yystack_[0].value.as < ast::Expression > ().type()) {
+            std::string expression_str;
+            if (yystack_[0].value.as < ast::Expression > ().type() == Type::INT) {
+                expression_str = "int";
+            } else if (yystack_[0].value.as < ast::Expression > ().type() == Type::STRING) {
+                expression_str = "string";
+            } else {
+                expression_str = "expression is not defined.";
+            }
+            throw syntax_error(yylhs.location, "Type checking error. Assign " + symbol->type_str() + " to " + expression_str + ".");
+        }
+
+        auto variable = ast::make<ast::Variable>(symbol);
+        yylhs.value.as < ast::Expression > () = ast::make<ast::Assignment>(variable, yystack_[0].value.as < ast::Expression > ());
+    }
+#line 1710 "src/parser.tab.cpp"
+    break;
+
+  case 32: // compound_instruction: block_start declaration_list instruction_list block_end
+#line 608 "src/parser.yy"
+                                                            {
+        /* std::cout << "compound_instruction: block_start declaration_list instruction_list block_end" << std::endl; */
+        ast::Declaration_List::Ptr ast_declaration_list = ast::make<ast::Declaration_List>(std::move(yystack_[2].value.as < Symbol_List > ()));
+        yystack_[1].value.as < Instruction_List > ().insert(yystack_[1].value.as < Instruction_List > ().begin()+0, ast_declaration_list);
+
+        yylhs.value.as < ast::Compound_Instruction::Ptr > () = ast::make<ast::Compound_Instruction>(std::move(yystack_[1].value.as < Instruction_List > ()));
+    }
+#line 1722 "src/parser.tab.cpp"
+    break;
+
+  case 33: // compound_instruction: block_start declaration_list block_end
+#line 615 "src/parser.yy"
+                                           {
+        /* std::cout << "compound_instruction: block_start declaration_list block_end" << std::endl; */
+        // No instructions to foward up. Nothing to do.
+    }
+#line 1731 "src/parser.tab.cpp"
+    break;
+
+  case 34: // compound_instruction: block_start instruction_list block_end
+#line 619 "src/parser.yy"
+                                           {
+        /* std::cout << "compound_instruction: block_start instruction_list block_end" << std::endl; */
+        yylhs.value.as < ast::Compound_Instruction::Ptr > () = ast::make<ast::Compound_Instruction>(std::move(yystack_[1].value.as < Instruction_List > ()));
+    }
+#line 1740 "src/parser.tab.cpp"
+    break;
+
+  case 35: // compound_instruction: block_start block_end
+#line 623 "src/parser.yy"
+                          {
+        /* std::cout << "compound_instruction: block_start block_end" << std::endl; */
+        // No instructions to forward up. Nothing to do.
+    }
+#line 1749 "src/parser.tab.cpp"
+    break;
+
+  case 36: // block_start: '{'
+#line 631 "src/parser.yy"
+        {
+        if (not state.new_function_definition) {
+            symbol_table->push("anonymous block", yylhs.location);
+        } else {
+            state.new_function_definition = false;
+        }
+    }
+#line 1761 "src/parser.tab.cpp"
+    break;
+
+  case 37: // block_end: '}'
+#line 641 "src/parser.yy"
+        {
+        symbol_table->pop();
+    }
+#line 1769 "src/parser.tab.cpp"
+    break;
+
+  case 38: // instruction_list: instruction
+#line 647 "src/parser.yy"
+                                 {
+        /* std::cout << "instruction_list: instruction" << std::endl; */
+        yylhs.value.as < Instruction_List > ().push_back(yystack_[0].value.as < ast::Instruction::Ptr > ());
+    }
+#line 1778 "src/parser.tab.cpp"
+    break;
+
+  case 39: // instruction_list: instruction_list instruction
+#line 651 "src/parser.yy"
+                                 {
+        /* std::cout << "instruction_list: instruction_list instruction" << std::endl; */
+        yylhs.value.as < Instruction_List > () = std::move(yystack_[1].value.as < Instruction_List > ());
+        yylhs.value.as < Instruction_List > ().push_back(yystack_[0].value.as < ast::Instruction::Ptr > ());
+    }
+#line 1788 "src/parser.tab.cpp"
+    break;
+
+  case 40: // select_instruction: cond_instruction instruction
+#line 659 "src/parser.yy"
+                                                  {
+        /* std::cout << "select_instruction: cond_instruction instruction" << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = ast::make<ast::Cond_Instruction>(yystack_[1].value.as < ast::Condition > (), yystack_[0].value.as < ast::Instruction::Ptr > ());
+    }
+#line 1797 "src/parser.tab.cpp"
+    break;
+
+  case 41: // select_instruction: cond_instruction instruction ELSE instruction
+#line 663 "src/parser.yy"
+                                                  {
+        /* std::cout << "select_instruction: cond_instruction instruction ELSE instruction" << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = ast::make<ast::Cond_Instruction>(yystack_[3].value.as < ast::Condition > (), yystack_[2].value.as < ast::Instruction::Ptr > (), yystack_[0].value.as < ast::Instruction::Ptr > ());
+    }
+#line 1806 "src/parser.tab.cpp"
+    break;
+
+  case 42: // cond_instruction: IF '(' condition ')'
+#line 670 "src/parser.yy"
+                         {
+        /* std::cout << "cond_instruction: IF '(' condition ')'" << std::endl; */
+        yylhs.value.as < ast::Condition > () = yystack_[1].value.as < ast::Condition > ();
+    }
+#line 1815 "src/parser.tab.cpp"
+    break;
+
+  case 43: // iteration_instruction: WHILE '(' condition ')' instruction
+#line 677 "src/parser.yy"
+                                                                    {
+        /* std::cout << "iteration_instruction: WHILE '(' condition ')' instruction" << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = ast::make<ast::While_Instruction>(yystack_[2].value.as < ast::Condition > (), yystack_[0].value.as < ast::Instruction::Ptr > ());
+    }
+#line 1824 "src/parser.tab.cpp"
+    break;
+
+  case 44: // iteration_instruction: DO instruction WHILE '(' condition ')'
+#line 681 "src/parser.yy"
+                                                                    {
+        /* std::cout << "iteration_instruction: DO instruction WHILE '(' condition ')'" << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = ast::make<ast::Do_Instruction>(yystack_[1].value.as < ast::Condition > (), yystack_[4].value.as < ast::Instruction::Ptr > ());
+    }
+#line 1833 "src/parser.tab.cpp"
+    break;
+
+  case 45: // iteration_instruction: FOR '(' assignment ';' condition ';' assignment ')' instruction
+#line 685 "src/parser.yy"
+                                                                    {
+        /* std::cout << "iteration_instruction: FOR '(' assignment ';' condition ';' assignment ')' instruction" << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = ast::make<ast::For_Instruction>(yystack_[6].value.as < ast::Expression > (), yystack_[4].value.as < ast::Condition > (), yystack_[2].value.as < ast::Expression > (), yystack_[0].value.as < ast::Instruction::Ptr > ());
+
+    }
+#line 1843 "src/parser.tab.cpp"
+    break;
+
+  case 46: // jump_instruction: RETURN expression ';'
+#line 693 "src/parser.yy"
+                          {
+        /* std::cout << "jump_instruction: RETURN expression ';'" << std::endl; */
+        yylhs.value.as < ast::Instruction::Ptr > () = ast::make<ast::Return_Instruction>(yystack_[1].value.as < ast::Expression > ());
+    }
+#line 1852 "src/parser.tab.cpp"
+    break;
+
+  case 47: // condition: expression comparison_operator expression
+#line 700 "src/parser.yy"
+                                              {
+        /* std::cout << "condition: expression comparison_operator expression" << std::endl; */
+        yylhs.value.as < ast::Condition > () = ast::make<ast::Condition>(yystack_[1].value.as < ast::Comparison_Operation > (), yystack_[2].value.as < ast::Expression > (), yystack_[0].value.as < ast::Expression > ());
+    }
+#line 1861 "src/parser.tab.cpp"
+    break;
+
+  case 48: // comparison_operator: EQUAL
+#line 707 "src/parser.yy"
+                 { /* std::cout << "comparison_operator: EQUAL"        << std::endl; */ yylhs.value.as < ast::Comparison_Operation > () = ast::Comparison_Operation::EQUAL;                 }
+#line 1867 "src/parser.tab.cpp"
+    break;
+
+  case 49: // comparison_operator: NEQUAL
+#line 708 "src/parser.yy"
+                 { /* std::cout << "comparison_operator: NEQUAL"       << std::endl; */ yylhs.value.as < ast::Comparison_Operation > () = ast::Comparison_Operation::NOT_EQUAL;             }
+#line 1873 "src/parser.tab.cpp"
+    break;
+
+  case 50: // comparison_operator: LESS
+#line 709 "src/parser.yy"
+                 { /* std::cout << "comparison_operator: LESS"         << std::endl; */ yylhs.value.as < ast::Comparison_Operation > () = ast::Comparison_Operation::LESS_THAN;             }
+#line 1879 "src/parser.tab.cpp"
+    break;
+
+  case 51: // comparison_operator: GREATER
+#line 710 "src/parser.yy"
+                 { /* std::cout << "comparison_operator: GREATER"      << std::endl; */ yylhs.value.as < ast::Comparison_Operation > () = ast::Comparison_Operation::GREATER_THAN;          }
+#line 1885 "src/parser.tab.cpp"
+    break;
+
+  case 52: // comparison_operator: LESSEQUAL
+#line 711 "src/parser.yy"
+                 { /* std::cout << "comparison_operator: LESSEQUAL"    << std::endl; */ yylhs.value.as < ast::Comparison_Operation > () = ast::Comparison_Operation::LESS_THAN_OR_EQUAL;    }
+#line 1891 "src/parser.tab.cpp"
+    break;
+
+  case 53: // comparison_operator: GREATEREQUAL
+#line 712 "src/parser.yy"
+                 { /* std::cout << "comparison_operator: GREATEREQUAL" << std::endl; */ yylhs.value.as < ast::Comparison_Operation > () = ast::Comparison_Operation::GREATER_THAN_OR_EQUAL; }
+#line 1897 "src/parser.tab.cpp"
+    break;
+
+  case 54: // expression: additive_expression
+#line 716 "src/parser.yy"
+                                              {
+        /* std::cout << "expression: additive_expression" << std::endl; */
+        yylhs.value.as < ast::Expression > () = yystack_[0].value.as < ast::Expression > ();
+    }
+#line 1906 "src/parser.tab.cpp"
+    break;
+
+  case 55: // expression: expression SHIFTLEFT additive_expression
+#line 720 "src/parser.yy"
+                                              {
+        /* std::cout << "expression: expression SHIFTLEFT additive_expression" << std::endl; */
+        if (yystack_[2].value.as < ast::Expression > ().type() == Type::INT and yystack_[0].value.as < ast::Expression > ().type() == Type::INT) {
+            yylhs.value.as < ast::Expression > () = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::LEFT_SHIFT, yystack_[2].value.as < ast::Expression > (), yystack_[0].value.as < ast::Expression > ());
+        } else {
+            std::ostringstream oss;
+            oss
+                << "Cannot do '<<' operation between types '"
+                << type_str(yystack_[2].value.as < ast::Expression > ().type()) << "' and '" << type_str(yystack_[0].value.as < ast::Expression > ().type())
+                << "'."
+                ;
+            throw syntax_error(yylhs.location, oss.str());
+        }
+    }
+#line 1925 "src/parser.tab.cpp"
+    break;
+
+  case 56: // expression: expression SHIFTRIGHT additive_expression
+#line 734 "src/parser.yy"
+                                              {
+        /* std::cout << "expression: expression SHIFTRIGHT additive_expression" << std::endl; */
+        if (yystack_[2].value.as < ast::Expression > ().type() == Type::INT and yystack_[0].value.as < ast::Expression > ().type() == Type::INT) {
+            yylhs.value.as < ast::Expression > () = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::RIGHT_SHIFT, yystack_[2].value.as < ast::Expression > (), yystack_[0].value.as < ast::Expression > ());
+        } else {
+            std::ostringstream oss;
+            oss
+                << "Cannot do '>>' operation between types '"
+                << type_str(yystack_[2].value.as < ast::Expression > ().type()) << "' and '" << type_str(yystack_[0].value.as < ast::Expression > ().type())
+                << "'."
+                ;
+            throw syntax_error(yylhs.location, oss.str());
+        }
+    }
+#line 1944 "src/parser.tab.cpp"
+    break;
+
+  case 57: // additive_expression: multiplicative_expression
+#line 751 "src/parser.yy"
+                                                        {
+        /* std::cout << "additive_expression: multiplicative_expression" << std::endl; */
+        yylhs.value.as < ast::Expression > () = yystack_[0].value.as < ast::Expression > ();
+    }
+#line 1953 "src/parser.tab.cpp"
+    break;
+
+  case 58: // additive_expression: additive_expression PLUS multiplicative_expression
+#line 755 "src/parser.yy"
+                                                        {
+        /* std::cout << "additive_expression: additive_expression PLUS multiplicative_expression" << std::endl; */
+        if (yystack_[2].value.as < ast::Expression > ().type() == yystack_[0].value.as < ast::Expression > ().type()) {
+            switch (yystack_[2].value.as < ast::Expression > ().type()) {
+                case Type::INT:
+                    yylhs.value.as < ast::Expression > () = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::ADDITION, yystack_[2].value.as < ast::Expression > (), yystack_[0].value.as < ast::Expression > ());
+                    break;
+                case Type::STRING:
+                    yylhs.value.as < ast::Expression > () = ast::make<ast::Binary_Expression>(Type::STRING, ast::Operation::ADDITION, yystack_[2].value.as < ast::Expression > (), yystack_[0].value.as < ast::Expression > ());
+                    break;
+            }
+        } else {
+            // throw syntax_error(@$, "Addition can only be done between arguments of the same type. (`INT + INT` or `STRING + STRING`)");
+            std::ostringstream oss;
+            oss
+                << "Cannot do '+' operation between types '"
+                << type_str(yystack_[2].value.as < ast::Expression > ().type()) << "' and '" << type_str(yystack_[0].value.as < ast::Expression > ().type())
+                << "'."
+                ;
+            throw syntax_error(yylhs.location, oss.str());
+        }
+    }
+#line 1980 "src/parser.tab.cpp"
+    break;
+
+  case 59: // additive_expression: additive_expression MINUS multiplicative_expression
+#line 777 "src/parser.yy"
+                                                        {
+        /* std::cout << "additive_expression: additive_expression MINUS multiplicative_expression" << std::endl; */
+        if (yystack_[2].value.as < ast::Expression > ().type() == Type::INT and yystack_[0].value.as < ast::Expression > ().type() == Type::INT) {
+            yylhs.value.as < ast::Expression > () = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::SUBTRACTION, yystack_[2].value.as < ast::Expression > (), yystack_[0].value.as < ast::Expression > ());
+        } else {
+            std::ostringstream oss;
+            oss
+                << "Cannot do '-' operation between types '"
+                << type_str(yystack_[2].value.as < ast::Expression > ().type()) << "' and '" << type_str(yystack_[0].value.as < ast::Expression > ().type())
+                << "'."
+                ;
+            throw syntax_error(yylhs.location, oss.str());
+        }
+    }
+#line 1999 "src/parser.tab.cpp"
+    break;
+
+  case 60: // multiplicative_expression: unary_expression
+#line 794 "src/parser.yy"
+                                                        {
+        /* std::cout << "multiplicative_expression: unary_expression" << std::endl; */
+        yylhs.value.as < ast::Expression > () = yystack_[0].value.as < ast::Expression > ();
+    }
+#line 2008 "src/parser.tab.cpp"
+    break;
+
+  case 61: // multiplicative_expression: multiplicative_expression MULTIPLY unary_expression
+#line 798 "src/parser.yy"
+                                                        {
+        /* std::cout << "multiplicative_expression: multiplicative_expression MULTIPLY unary_expression" << std::endl; */
+        if (yystack_[2].value.as < ast::Expression > ().type() == Type::INT and yystack_[0].value.as < ast::Expression > ().type() == Type::INT) {
+            yylhs.value.as < ast::Expression > () = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::MULTIPLICATION, yystack_[2].value.as < ast::Expression > (), yystack_[0].value.as < ast::Expression > ());
+        } else {
+            std::ostringstream oss;
+            oss
+                << "Cannot do '*' operation between types '"
+                << type_str(yystack_[2].value.as < ast::Expression > ().type()) << "' and '" << type_str(yystack_[0].value.as < ast::Expression > ().type())
+                << "'."
+                ;
+            throw syntax_error(yylhs.location, oss.str());
+        }
+    }
+#line 2027 "src/parser.tab.cpp"
+    break;
+
+  case 62: // multiplicative_expression: multiplicative_expression DIVIDE unary_expression
+#line 812 "src/parser.yy"
+                                                        {
+        /* std::cout << "multiplicative_expression: multiplicative_expression DIVIDE unary_expression" << std::endl; */
+        if (yystack_[2].value.as < ast::Expression > ().type() == Type::INT and yystack_[0].value.as < ast::Expression > ().type() == Type::INT) {
+            yylhs.value.as < ast::Expression > () = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::DIVISION, yystack_[2].value.as < ast::Expression > (), yystack_[0].value.as < ast::Expression > ());
+        } else {
+            std::ostringstream oss;
+            oss
+                << "Cannot do '/' operation between types '"
+                << type_str(yystack_[2].value.as < ast::Expression > ().type()) << "' and '" << type_str(yystack_[0].value.as < ast::Expression > ().type())
+                << "'."
+                ;
+            throw syntax_error(yylhs.location, oss.str());
+        }
+    }
+#line 2046 "src/parser.tab.cpp"
+    break;
+
+  case 63: // multiplicative_expression: multiplicative_expression MODULO unary_expression
+#line 826 "src/parser.yy"
+                                                        {
+        /* std::cout << "multiplicative_expression: multiplicative_expression MODULO unary_expression" << std::endl; */
+        if (yystack_[2].value.as < ast::Expression > ().type() == Type::INT and yystack_[0].value.as < ast::Expression > ().type() == Type::INT) {
+            yylhs.value.as < ast::Expression > () = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::MODULUS, yystack_[2].value.as < ast::Expression > (), yystack_[0].value.as < ast::Expression > ());
+        } else {
+            std::ostringstream oss;
+            oss
+                << "Cannot do '%' operation between types '"
+                << type_str(yystack_[2].value.as < ast::Expression > ().type()) << "' and '" << type_str(yystack_[0].value.as < ast::Expression > ().type())
+                << "'."
+                ;
+            throw syntax_error(yylhs.location, oss.str());
+        }
+    }
+#line 2065 "src/parser.tab.cpp"
+    break;
+
+  case 64: // unary_expression: postfix_expression
+#line 843 "src/parser.yy"
+                           {
+        /* std::cout << "unary_expression: postfix_expression" << std::endl; */
+        yylhs.value.as < ast::Expression > () = yystack_[0].value.as < ast::Expression > ();
+    }
+#line 2074 "src/parser.tab.cpp"
+    break;
+
+  case 65: // unary_expression: MINUS unary_expression
+#line 847 "src/parser.yy"
+                           {
+        /* std::cout << "unary_expression: MINUS unary_expression" << std::endl; */
+        if (yystack_[0].value.as < ast::Expression > ().type() == Type::INT) {
+            // $$ = ast::make<ast::Unary_Expression>(Type::INT, ast::Operation::SUBTRACTION, $2);
+            yylhs.value.as < ast::Expression > () = ast::make<ast::Unary_Expression>(yystack_[0].value.as < ast::Expression > ());
+        } else {
+            std::ostringstream oss;
+            oss
+                << "Cannot do unary '-' operation on type '"
+                << type_str(yystack_[0].value.as < ast::Expression > ().type()) << "'."
+                ;
+            throw syntax_error(yylhs.location, oss.str());
+        }
+    }
+#line 2093 "src/parser.tab.cpp"
+    break;
+
+  case 66: // postfix_expression: primary_expression
+#line 864 "src/parser.yy"
+                                           {
+        /* std::cout << "postfix_expression: primary_expression" << std::endl; */
+        yylhs.value.as < ast::Expression > () = yystack_[0].value.as < ast::Expression > ();
+    }
+#line 2102 "src/parser.tab.cpp"
+    break;
+
+  case 67: // postfix_expression: IDENT '(' argument_expression_list ')'
+#line 868 "src/parser.yy"
+                                           {
+        /* std::cout << "postfix_expression: IDENT '(' argument_expression_list ')'" << std::endl; */
+        /* std::cout << "postfix_expression: IDENT '(' ')'" << *$1 << std::endl; */
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
+
+        // Check if IDENT is defined.
+        auto symbol = symbol_table->lookup(yystack_[3].value.as < atom::Atom > ());
+        if (not symbol) {
+            throw syntax_error(yylhs.location, yystack_[3].value.as < atom::Atom > ().str() + " is not defined");
+        }
+
+        // Check if IDENT is a function.
+        auto declared_func = std::dynamic_pointer_cast<Function>(symbol);
+        if (not declared_func) {
+            throw syntax_error(yylhs.location, "'" + yystack_[3].value.as < atom::Atom > ().str() + "' identifies a variable, not a function.");
+        }
+        reference(state, declared_func);
+
+        // Verify the argument list. (type-checking)
+        if (yystack_[1].value.as < Expression_List > ().size() != declared_func->argument_list().size()) {
+            throw syntax_error(yylhs.location, "Signature mismatch between function definition and function call.");
+        }
+        auto pair = std::mismatch(
+            std::begin(yystack_[1].value.as < Expression_List > ()), std::end(yystack_[1].value.as < Expression_List > ()),
+            std::begin(declared_func->argument_list()),
+            [] (const ast::Expression& a, Symbol::Ptr b) { return a.type() == b->type(); }
+        );
+        if (pair.first != std::end(yystack_[1].value.as < Expression_List > ())) {
+            throw syntax_error(yylhs.location, "Signature mismatch between function definition and function call.");
+        }
+
+        yylhs.value.as < ast::Expression > () = ast::make<ast::Function_Call>(declared_func, yystack_[1].value.as < Expression_List > ());
+    }
+#line 2140 "src/parser.tab.cpp"
+    break;
+
+  case 68: // postfix_expression: IDENT '(' ')'
+#line 901 "src/parser.yy"
+                                           {
+        /* std::cout << "postfix_expression: IDENT '(' ')'" << *$1 << std::endl; */
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
+
+        // Check if IDENT is defined.
+        auto symbol = symbol_table->lookup(yystack_[2].value.as < atom::Atom > ());
+        if (not symbol) {
+            throw syntax_error(yylhs.location, yystack_[2].value.as < atom::Atom > ().str() + " is not defined");
+        }
+
+        // Check if IDENT is a function.
+        auto declared_func = std::dynamic_pointer_cast<Function>(symbol);
+        if (not declared_func) {
+            throw syntax_error(yylhs.location, "'" + yystack_[2].value.as < atom::Atom > ().str() + "' identifies a variable, not a function.");
+        }
+        reference(state, declared_func);
+
+        // Verify the argument list. (type-checking)
+        if (0 != declared_func->argument_list().size()) {
+            throw syntax_error(yylhs.location, "Signature mismatch between function definition and function call.");
+        }
+
+        yylhs.value.as < ast::Expression > () = ast::make<ast::Function_Call>(declared_func);
+    }
+#line 2169 "src/parser.tab.cpp"
+    break;
+
+  case 69: // argument_expression_list: expression
+#line 928 "src/parser.yy"
+                                            {
+        /* std::cout << "argument_expression_list: expression" << std::endl; */
+        yylhs.value.as < Expression_List > ().push_back(yystack_[0].value.as < ast::Expression > ());
+    }
+#line 2178 "src/parser.tab.cpp"
+    break;
+
+  case 70: // argument_expression_list: argument_expression_list ',' expression
+#line 932 "src/parser.yy"
+                                            {
+        /* std::cout << "argument_expression_list: argument_expression_list ',' expression" << std::endl; */
+        yylhs.value.as < Expression_List > () = std::move(yystack_[2].value.as < Expression_List > ());
+        yylhs.value.as < Expression_List > ().push_back(yystack_[0].value.as < ast::Expression > ());
+  }
+#line 2188 "src/parser.tab.cpp"
+    break;
+
+  case 71: // primary_expression: IDENT
+#line 940 "src/parser.yy"
+                       {
+        /* std::cout << "primary_expression: IDENT " << *$1 << std::endl; */
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
+
+        // Check if IDENT is defined.
+        auto symbol = symbol_table->lookup(yystack_[0].value.as < atom::Atom > ());
+        if (not symbol) {
+            throw syntax_error(yylhs.location, yystack_[0].value.as < atom::Atom > ().str() + " is not defined");
+        }
+        reference(state, symbol);
+
+        yylhs.value.as < ast::Expression > () = ast::make<ast::Variable>(symbol);
+    }
+#line 2206 "src/parser.tab.cpp"
+    break;
+
+  case 72: // primary_expression: CONST_INT
+#line 953 "src/parser.yy"
+                       {
+        /* std::cout << "primary_expression: CONST_INT " << $1 << std::endl; */
+        yylhs.value.as < ast::Expression > () = ast::make<ast::Const_Integer>(yystack_[0].value.as < int > ());
+    }
+#line 2215 "src/parser.tab.cpp"
+    break;
+
+  case 73: // primary_expression: CONST_STRING
+#line 957 "src/parser.yy"
+                       {
+        /* std::cout << "primary_expression: CONST_STRING " << $1 << std::endl; */
+        // remove "
+        yylhs.value.as < ast::Expression > () = ast::make<ast::Const_String>(yystack_[0].value.as < std::string > ().substr(1,yystack_[0].value.as < std::string > ().size()-2));
+    }
+#line 2225 "src/parser.tab.cpp"
+    break;
+
+  case 74: // primary_expression: '(' expression ')'
+#line 962 "src/parser.yy"
+                       {
+        /* std::cout << "primary_expression: '(' expression ')'" << std::endl; */
+        yylhs.value.as < ast::Expression > () = yystack_[1].value.as < ast::Expression > ();
+    }
+#line 2234 "src/parser.tab.cpp"
+    break;
+
+
+#line 2238 "src/parser.tab.cpp"
+
+            default:
+              break;
+            }
+        }
+#if YY_EXCEPTIONS
+      catch (const syntax_error& yyexc)
+        {
+          YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+          error (yyexc);
+          YYERROR;
+        }
+#endif // YY_EXCEPTIONS
+      YY_SYMBOL_PRINT ("-> $$ =", yylhs);
+      yypop_ (yylen);
+      yylen = 0;
+
+      // Shift the result of the reduction.
+      yypush_ (YY_NULLPTR, YY_MOVE (yylhs));
+    }
+    goto yynewstate;
+
+
+  /*--------------------------------------.
+  | yyerrlab -- here on detecting error.  |
+  `--------------------------------------*/
+  yyerrlab:
+    // If not already recovering from an error, report this error.
+    if (!yyerrstatus_)
+      {
+        ++yynerrs_;
+        std::string msg = YY_("syntax error");
+        error (yyla.location, YY_MOVE (msg));
+      }
+
+
+    yyerror_range[1].location = yyla.location;
+    if (yyerrstatus_ == 3)
+      {
+        /* If just tried and failed to reuse lookahead token after an
+           error, discard it.  */
+
+        // Return failure if at end of input.
+        if (yyla.kind () == symbol_kind::S_YYEOF)
+          YYABORT;
+        else if (!yyla.empty ())
+          {
+            yy_destroy_ ("Error: discarding", yyla);
+            yyla.clear ();
+          }
+      }
+
+    // Else will try to reuse lookahead token after shifting the error token.
+    goto yyerrlab1;
+
+
+  /*---------------------------------------------------.
+  | yyerrorlab -- error raised explicitly by YYERROR.  |
+  `---------------------------------------------------*/
+  yyerrorlab:
+    /* Pacify compilers when the user code never invokes YYERROR and
+       the label yyerrorlab therefore never appears in user code.  */
+    if (false)
+      YYERROR;
+
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYERROR.  */
+    yypop_ (yylen);
+    yylen = 0;
+    YY_STACK_PRINT ();
+    goto yyerrlab1;
+
+
+  /*-------------------------------------------------------------.
+  | yyerrlab1 -- common code for both syntax error and YYERROR.  |
+  `-------------------------------------------------------------*/
+  yyerrlab1:
+    yyerrstatus_ = 3;   // Each real token shifted decrements this.
+    // Pop stack until we find a state that shifts the error token.
+    for (;;)
+      {
+        yyn = yypact_[+yystack_[0].state];
+        if (!yy_pact_value_is_default_ (yyn))
+          {
+            yyn += symbol_kind::S_YYerror;
+            if (0 <= yyn && yyn <= yylast_
+                && yycheck_[yyn] == symbol_kind::S_YYerror)
+              {
+                yyn = yytable_[yyn];
+                if (0 < yyn)
+                  break;
+              }
+          }
+
+        // Pop the current state because it cannot handle the error token.
+        if (yystack_.size () == 1)
+          YYABORT;
+
+        yyerror_range[1].location = yystack_[0].location;
+        yy_destroy_ ("Error: popping", yystack_[0]);
+        yypop_ ();
+        YY_STACK_PRINT ();
+      }
+    {
+      stack_symbol_type error_token;
+
+      yyerror_range[2].location = yyla.location;
+      YYLLOC_DEFAULT (error_token.location, yyerror_range, 2);
+
+      // Shift the error token.
+      error_token.state = state_type (yyn);
+      yypush_ ("Shifting", YY_MOVE (error_token));
+    }
+    goto yynewstate;
+
+
+  /*-------------------------------------.
+  | yyacceptlab -- YYACCEPT comes here.  |
+  `-------------------------------------*/
+  yyacceptlab:
+    yyresult = 0;
+    goto yyreturn;
+
+
+  /*-----------------------------------.
+  | yyabortlab -- YYABORT comes here.  |
+  `-----------------------------------*/
+  yyabortlab:
+    yyresult = 1;
+    goto yyreturn;
+
+
+  /*-----------------------------------------------------.
+  | yyreturn -- parsing is finished, return the result.  |
+  `-----------------------------------------------------*/
+  yyreturn:
+    if (!yyla.empty ())
+      yy_destroy_ ("Cleanup: discarding lookahead", yyla);
+
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYABORT or YYACCEPT.  */
+    yypop_ (yylen);
+    YY_STACK_PRINT ();
+    while (1 < yystack_.size ())
+      {
+        yy_destroy_ ("Cleanup: popping", yystack_[0]);
+        yypop_ ();
+      }
+
+    return yyresult;
+  }
+#if YY_EXCEPTIONS
+    catch (...)
+      {
+        YYCDEBUG << "Exception caught: cleaning lookahead and stack\n";
+        // Do not try to display the values of the reclaimed symbols,
+        // as their printers might throw an exception.
+        if (!yyla.empty ())
+          yy_destroy_ (YY_NULLPTR, yyla);
+
+        while (1 < yystack_.size ())
+          {
+            yy_destroy_ (YY_NULLPTR, yystack_[0]);
+            yypop_ ();
+          }
+        throw;
+      }
+#endif // YY_EXCEPTIONS
+  }
+
+  void
+  Parser::error (const syntax_error& yyexc)
+  {
+    error (yyexc.location, yyexc.what ());
+  }
+
+#if YYDEBUG || 0
+  const char *
+  Parser::symbol_name (symbol_kind_type yysymbol)
+  {
+    return yytname_[yysymbol];
+  }
+#endif // #if YYDEBUG || 0
+
+
+
+
+
+
+
+
+
+  const signed char Parser::yypact_ninf_ = -69;
+
+  const signed char Parser::yytable_ninf_ = -9;
+
+  const short
+  Parser::yypact_[] =
+  {
+      31,   -69,   -69,    29,    55,   -69,   -69,   -69,    10,   -69,
+      10,   -69,   -69,   -27,    51,   -69,     7,   -69,    16,   -69,
+      10,    28,   -69,    60,   -21,   -69,   -69,   -69,   -69,    84,
+     -69,    29,   -69,   -69,   -69,   -17,    54,    62,   144,    69,
+      38,    38,   -69,    38,   -69,   -69,    84,   -69,   -69,    44,
+     -69,   -69,   114,   -69,   144,   -69,   -69,    45,    86,    42,
+     -69,   -69,   -69,   -69,    19,    38,    38,    38,    66,    74,
+      79,    50,   -69,    -4,   -69,   -69,   114,   -69,   -69,   -69,
+     103,    38,    38,   -69,    38,    38,    38,    38,    38,   -69,
+      90,    17,    90,    91,    85,    93,   104,   101,   107,   -69,
+     -69,   -69,   144,    86,    86,    42,    42,   -69,   -69,   -69,
+      38,   -69,   -69,   -69,   -69,   -69,   -69,   -69,   -69,    38,
+     144,    38,    38,   -69,    90,    90,   -69,   106,   110,   -69,
+      74,   108,   144,   -69
+  };
+
+  const signed char
+  Parser::yydefact_[] =
+  {
+       0,    10,    11,     0,     0,     2,     6,     4,     0,     5,
+       0,     1,     3,    16,     0,    12,    17,    17,     0,     9,
+       0,     0,    18,     0,     0,    20,    13,    36,     7,     0,
+      22,     0,    19,    72,    73,    71,     0,     0,     0,     0,
+       0,     0,    23,     0,    37,    14,     0,    38,    25,     0,
+      24,    35,     0,    27,     0,    26,    28,     0,    54,    57,
+      60,    64,    66,    21,     0,     0,     0,     0,     0,     0,
+      71,     0,    65,     0,    15,    33,     0,    30,    39,    34,
+      40,     0,     0,    29,     0,     0,     0,     0,     0,    68,
+      69,     0,    31,     0,     0,     0,     0,     0,     0,    46,
+      74,    32,     0,    56,    55,    58,    59,    61,    62,    63,
+       0,    67,    42,    48,    49,    50,    51,    52,    53,     0,
+       0,     0,     0,    41,    70,    47,    43,     0,     0,    44,
+       0,     0,     0,    45
+  };
+
+  const short
+  Parser::yypgoto_[] =
+  {
+     -69,   -69,   136,   -69,   -69,     8,     5,   -69,   -69,   121,
+     135,   -69,   115,   -38,   -69,   -68,   124,   -69,   -34,   113,
+     -69,   -69,   -69,   -69,   -65,   -69,   -36,    48,    47,   -35,
+     -69,   -69,   -69
+  };
+
+  const signed char
+  Parser::yydefgoto_[] =
+  {
+       0,     4,     5,     6,    21,     7,    10,    14,    46,    15,
+      17,    24,    25,    47,    48,    49,    50,    29,    51,    52,
+      53,    54,    55,    56,    93,   119,    57,    58,    59,    60,
+      61,    91,    62
+  };
+
+  const short
+  Parser::yytable_[] =
+  {
+      68,    98,    95,    18,    71,     8,    72,    73,    31,     8,
+      32,     9,    75,    64,    78,    65,    80,    13,    79,     1,
+       2,    81,    82,    23,    33,    34,    70,   100,    90,    92,
+      94,    94,     1,     2,     1,     2,    23,    45,    78,     3,
+      -8,    41,   101,    33,    34,    70,   110,    22,   111,    43,
+      89,   107,   108,   109,    74,    11,   127,   128,     1,     2,
+      41,    27,   131,     3,   123,    86,    87,    30,    43,    88,
+      81,    82,    77,    83,   124,    81,    82,    96,    99,    19,
+      20,    97,   126,   125,    66,    94,    94,     1,     2,    33,
+      34,    35,    67,    36,   133,    37,    38,    39,    40,    69,
+     113,   114,   115,   116,   117,   118,    41,    84,    85,    64,
+      81,    82,    42,   102,    43,    81,    82,    27,    44,    33,
+      34,    35,   112,    36,   120,    37,    38,    39,    40,   103,
+     104,   105,   106,    65,   121,   122,    41,   129,   130,   132,
+      12,    26,    42,    16,    43,    28,    63,    27,    44,    33,
+      34,    35,     0,    36,     0,    37,    38,    39,    40,    76,
+       0,     0,     0,     0,     0,     0,    41,     0,     0,     0,
+       0,     0,    42,     0,    43,     0,     0,    27
+  };
+
+  const short
+  Parser::yycheck_[] =
+  {
+      38,    69,    67,    30,    40,     0,    41,    43,    29,     4,
+      31,     3,    46,    30,    52,    32,    54,     7,    52,     3,
+       4,    25,    26,    18,     5,     6,     7,    31,    64,    65,
+      66,    67,     3,     4,     3,     4,    31,    29,    76,     8,
+      33,    22,    76,     5,     6,     7,    29,    31,    31,    30,
+      31,    86,    87,    88,    46,     0,   121,   122,     3,     4,
+      22,    33,   130,     8,   102,    23,    24,     7,    30,    27,
+      25,    26,    28,    28,   110,    25,    26,    11,    28,    28,
+      29,     7,   120,   119,    30,   121,   122,     3,     4,     5,
+       6,     7,    30,     9,   132,    11,    12,    13,    14,    30,
+      15,    16,    17,    18,    19,    20,    22,    21,    22,    30,
+      25,    26,    28,    10,    30,    25,    26,    33,    34,     5,
+       6,     7,    31,     9,    31,    11,    12,    13,    14,    81,
+      82,    84,    85,    32,    30,    28,    22,    31,    28,    31,
+       4,    20,    28,     8,    30,    21,    31,    33,    34,     5,
+       6,     7,    -1,     9,    -1,    11,    12,    13,    14,    46,
+      -1,    -1,    -1,    -1,    -1,    -1,    22,    -1,    -1,    -1,
+      -1,    -1,    28,    -1,    30,    -1,    -1,    33
+  };
+
+  const signed char
+  Parser::yystos_[] =
+  {
+       0,     3,     4,     8,    36,    37,    38,    40,    41,    40,
+      41,     0,    37,     7,    42,    44,    45,    45,    30,    28,
+      29,    39,    31,    41,    46,    47,    44,    33,    51,    52,
+       7,    29,    31,     5,     6,     7,     9,    11,    12,    13,
+      14,    22,    28,    30,    34,    40,    43,    48,    49,    50,
+      51,    53,    54,    55,    56,    57,    58,    61,    62,    63,
+      64,    65,    67,    47,    30,    32,    30,    30,    48,    30,
+       7,    61,    64,    61,    40,    53,    54,    28,    48,    53,
+      48,    25,    26,    28,    21,    22,    23,    24,    27,    31,
+      61,    66,    61,    59,    61,    59,    11,     7,    50,    28,
+      31,    53,    10,    62,    62,    63,    63,    64,    64,    64,
+      29,    31,    31,    15,    16,    17,    18,    19,    20,    60,
+      31,    30,    28,    48,    61,    61,    48,    59,    59,    31,
+      28,    50,    31,    48
+  };
+
+  const signed char
+  Parser::yyr1_[] =
+  {
+       0,    35,    36,    36,    37,    37,    37,    38,    39,    40,
+      41,    41,    42,    42,    43,    43,    44,    44,    45,    45,
+      46,    46,    47,    48,    48,    48,    48,    48,    48,    49,
+      49,    50,    51,    51,    51,    51,    52,    53,    54,    54,
+      55,    55,    56,    57,    57,    57,    58,    59,    60,    60,
+      60,    60,    60,    60,    61,    61,    61,    62,    62,    62,
+      63,    63,    63,    63,    64,    64,    65,    65,    65,    66,
+      66,    67,    67,    67,    67
+  };
+
+  const signed char
+  Parser::yyr2_[] =
+  {
+       0,     2,     1,     2,     1,     2,     1,     4,     0,     3,
+       1,     1,     1,     3,     1,     2,     1,     1,     3,     4,
+       1,     3,     2,     1,     1,     1,     1,     1,     1,     2,
+       2,     3,     4,     3,     3,     2,     1,     1,     1,     2,
+       2,     4,     4,     5,     6,     9,     3,     3,     1,     1,
+       1,     1,     1,     1,     1,     3,     3,     1,     3,     3,
+       1,     3,     3,     3,     1,     2,     1,     4,     3,     1,
+       3,     1,     1,     1,     3
+  };
+
+
+#if YYDEBUG
+  // YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+  // First, the terminals, then, starting at \a YYNTOKENS, nonterminals.
+  const char*
+  const Parser::yytname_[] =
+  {
+  "END", "error", "\"invalid token\"", "INT", "STRING", "CONST_INT",
+  "CONST_STRING", "IDENT", "EXTERN", "IF", "ELSE", "WHILE", "DO", "FOR",
+  "RETURN", "EQUAL", "NEQUAL", "LESS", "GREATER", "LESSEQUAL",
+  "GREATEREQUAL", "PLUS", "MINUS", "MULTIPLY", "DIVIDE", "SHIFTRIGHT",
+  "SHIFTLEFT", "MODULO", "';'", "','", "'('", "')'", "'='", "'{'", "'}'",
+  "$accept", "program", "external_declaration", "function_definition",
+  "decl_glb_fct", "declaration", "type", "declarator_list",
+  "declaration_list", "declarator", "function_declarator",
+  "parameter_list", "parameter_declaration", "instruction",
+  "expression_instruction", "assignment", "compound_instruction",
+  "block_start", "block_end", "instruction_list", "select_instruction",
+  "cond_instruction", "iteration_instruction", "jump_instruction",
+  "condition", "comparison_operator", "expression", "additive_expression",
+  "multiplicative_expression", "unary_expression", "postfix_expression",
+  "argument_expression_list", "primary_expression", YY_NULLPTR
+  };
+#endif
+
+
+#if YYDEBUG
+  const short
+  Parser::yyrline_[] =
+  {
+       0,   283,   283,   286,   292,   310,   328,   343,   361,   436,
+     457,   461,   468,   471,   478,   482,   494,   497,   503,   510,
+     524,   527,   534,   542,   546,   550,   554,   558,   562,   569,
+     573,   580,   608,   615,   619,   623,   631,   641,   647,   651,
+     659,   663,   670,   677,   681,   685,   693,   700,   707,   708,
+     709,   710,   711,   712,   716,   720,   734,   751,   755,   777,
+     794,   798,   812,   826,   843,   847,   864,   868,   901,   928,
+     932,   940,   953,   957,   962
+  };
+
+  void
+  Parser::yy_stack_print_ () const
+  {
+    *yycdebug_ << "Stack now";
+    for (stack_type::const_iterator
+           i = yystack_.begin (),
+           i_end = yystack_.end ();
+         i != i_end; ++i)
+      *yycdebug_ << ' ' << int (i->state);
+    *yycdebug_ << '\n';
+  }
+
+  void
+  Parser::yy_reduce_print_ (int yyrule) const
+  {
+    int yylno = yyrline_[yyrule];
+    int yynrhs = yyr2_[yyrule];
+    // Print the symbols being reduced, and their result.
+    *yycdebug_ << "Reducing stack by rule " << yyrule - 1
+               << " (line " << yylno << "):\n";
+    // The symbols being reduced.
+    for (int yyi = 0; yyi < yynrhs; yyi++)
+      YY_SYMBOL_PRINT ("   $" << yyi + 1 << " =",
+                       yystack_[(yynrhs) - (yyi + 1)]);
+  }
+#endif // YYDEBUG
+
+  Parser::symbol_kind_type
+  Parser::yytranslate_ (int t) YY_NOEXCEPT
+  {
+    // YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to
+    // TOKEN-NUM as returned by yylex.
+    static
+    const signed char
+    translate_table[] =
+    {
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+      30,    31,     2,     2,    29,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    28,
+       2,    32,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    33,     2,    34,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27
+    };
+    // Last valid token kind.
+    const int code_max = 282;
+
+    if (t <= 0)
+      return symbol_kind::S_YYEOF;
+    else if (t <= code_max)
+      return static_cast <symbol_kind_type> (translate_table[t]);
+    else
+      return symbol_kind::S_YYUNDEF;
+  }
+
+#line 132 "src/parser.yy"
+} // parser
+#line 2701 "src/parser.tab.cpp"
+
+#line 969 "src/parser.yy"
+
+
+
+void parser::Parser::error (
+    const parser::Parser::location_type& loc,
+    const std::string& message
+) {
+    }
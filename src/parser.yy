@@ -3,17 +3,13 @@
 #include "scanner.hpp"
 
 #include <cctype>
+#include <cstdint>
 
 #include <algorithm>
 #include <stack>
 #include <string>
 
-
-// WARNING: USE OF A DIRTY MACRO
-//          The parser will by default try to use a global yylex function. We
-//          want it to use the lex function of its member reference "scanner".
-//          So #define yylex to refer to this.
-#define yylex scanner.lex
+#include "ir_cache.hpp"
 
 
 std::string type_str (const parser::Type& type) {
@@ -27,6 +23,99 @@ std::string type_str (const parser::Type& type) {
     }
 }
 
+
+// WARNING: USE OF A DIRTY MACRO
+//          The parser will by default try to use a global yylex function. We
+//          want it to use the lex function of its member reference "scanner".
+//          So #define yylex to refer to this.
+#define yylex(yylval, yylloc) lex_token(scanner, state, yylval, yylloc)
+
+
+// Calls the scanner, charging the time to the scanning phase of --time-report.
+// Records the token for the cache keys of function definitions if needed.
+static parser::Parser::token_type lex_token (
+    scanner::Scanner& scanner,
+    parser::Parse_State& state,
+    parser::Parser::semantic_type* yylval,
+    parser::Parser::location_type* yylloc
+) {
+    stats::Phase_Timer timer (stats::Phase::SCANNING);
+    stats::count(stats::Counter::TOKENS);
+    parser::Parser::token_type token = scanner.lex(yylval, yylloc);
+
+    if (state.hash_functions) {
+        ir_cache::Hasher hasher;
+        hasher.add(static_cast<std::uint64_t>(token));
+        switch (token) {
+            case parser::Parser::token::IDENT:
+                hasher.add(yylval->as<atom::Atom>().str());
+                break;
+            case parser::Parser::token::CONST_STRING:
+                hasher.add(yylval->as<std::string>());
+                break;
+            case parser::Parser::token::CONST_INT:
+                hasher.add(static_cast<std::uint64_t>(yylval->as<int>()));
+                break;
+            default:
+                break;
+        }
+        state.tokens.push_back(
+            parser::Parse_State::Token {yylloc->begin, yylloc->end, hasher.digest()});
+    }
+
+    return token;
+}
+
+
+static bool before (const parser::position& a, const parser::position& b) {
+    return a.line < b.line or (a.line == b.line and a.column < b.column);
+}
+
+// Forget the tokens of the external declaration that ends at `end`. Tokens
+// after it have already been read ahead, and belong to the next one.
+static void forget_tokens (parser::Parse_State& state, const parser::position& end) {
+    auto first_kept = std::find_if(
+        std::begin(state.tokens), std::end(state.tokens),
+        [&] (const parser::Parse_State::Token& token) { return not before(token.begin, end); });
+    state.tokens.erase(std::begin(state.tokens), first_kept);
+}
+
+// Record that the function being defined refers to a symbol declared outside
+// of it. Its IR depends on that symbol's signature, not just on its tokens.
+static void reference (parser::Parse_State& state, const parser::Symbol::Ptr& symbol) {
+    if (not state.hash_functions) {
+        return;
+    }
+
+    if (auto function = std::dynamic_pointer_cast<parser::Function>(symbol)) {
+        state.referenced_signatures.insert(
+            "function " + function->name() + ' '
+            + type_str(function->type()) + ' ' + function->type_str());
+    } else if (symbol->get(parser::Symbol::Attribute::GLOBAL)) {
+        state.referenced_signatures.insert(
+            "global " + symbol->name() + ' ' + symbol->type_str());
+    }
+}
+
+// Cache key of the function definition at `location`: a hash of its tokens
+// and of the signatures of the globals and functions it refers to.
+static std::string cache_key (parser::Parse_State& state, const parser::location& location) {
+    ir_cache::Hasher hasher;
+    for (auto& token : state.tokens) {
+        if (before(token.begin, location.begin)) {
+            continue;
+        }
+        if (not before(token.begin, location.end)) {
+            break;
+        }
+        hasher.add(token.hash);
+    }
+    for (auto& signature : state.referenced_signatures) {
+        hasher.add(signature);
+    }
+    return hasher.hex();
+}
+
 %}
 
 // Generate a header file.
@@ -47,11 +136,64 @@ std::string type_str (const parser::Type& type) {
 %parse-param { scanner::Scanner& scanner }
 %parse-param { Symbol_Table::Ptr symbol_table }
 %parse-param { ast::Code_Generator& code_generator }
+%parse-param { Parse_State& state }
 
 %code requires {
+    #include <cstdint>
+
+    #include <set>
+    #include <stack>
+    #include <string>
+    #include <vector>
+
+    #include "arena.hpp"
     #include "ast.hpp"
+    #include "atom.hpp"
     #include "symbol_table.hpp"
     namespace scanner { class Scanner; }
+
+    namespace parser {
+        // State shared between the grammar actions while parsing one
+        // translation unit. Each compilation owns its own instance, so several
+        // translation units can be parsed at the same time.
+        struct Parse_State {
+            std::stack<Type> unclaimed_types;
+            Function::Ptr last_function;
+            bool new_function_definition = false;
+
+            // Compute the cache keys of function definitions (see
+            // ast::Function_Definition::cache_key()).
+            bool hash_functions = false;
+
+            // Tokens read since the start of the current external declaration.
+            struct Token {
+                position begin;
+                position end;
+                std::uint64_t hash;
+            };
+            std::vector<Token> tokens;
+
+            // Signatures of the globals and functions referenced by the
+            // function being defined.
+            std::set<std::string> referenced_signatures;
+
+            // Arena and expression store of the function being defined,
+            // from the start of its scope until its code is generated.
+            arena::Scope     function_arena;
+            ast::Store_Scope function_expressions;
+        };
+
+        // Lists built up by the grammar actions. Like Symbol_List, they are
+        // charged to the semantic values in --mem-report.
+        typedef std::vector<
+            ast::Expression,
+            stats::Allocator<ast::Expression, stats::Pool::SEMANTIC_VALUES>
+        > Expression_List;
+        typedef std::vector<
+            ast::Instruction::Ptr,
+            stats::Allocator<ast::Instruction::Ptr, stats::Pool::SEMANTIC_VALUES>
+        > Instruction_List;
+    }
 }
 
 // Track locations within source file (stdin) for error reporting.
@@ -60,12 +202,6 @@ std::string type_str (const parser::Type& type) {
     @$.begin.filename = @$.end.filename = new std::string("<stdin>");
 }
 
-%code {
-    std::stack<parser::Type> unclaimed_types_;
-    parser::Function::Ptr last_function_;
-    bool new_function_definition_;
-}
-
 %define api.value.type variant
 
 
@@ -74,7 +210,7 @@ std::string type_str (const parser::Type& type) {
 %token <int>         CONST_INT
 %token <std::string> CONST_STRING
 
-%token <std::string> IDENT
+%token <atom::Atom>  IDENT
 
 %token EXTERN
 
@@ -115,18 +251,18 @@ std::string type_str (const parser::Type& type) {
 %type <Symbol::Ptr> parameter_declaration
 %type <Type> type
 
-%type <ast::Expression::Ptr> primary_expression
-%type <ast::Expression::Ptr> postfix_expression
-%type <ast::Expression::Ptr> unary_expression
-%type <ast::Expression::Ptr> multiplicative_expression
-%type <ast::Expression::Ptr> additive_expression
-%type <ast::Expression::Ptr> assignment
-%type <ast::Expression::Ptr> expression
+%type <ast::Expression> primary_expression
+%type <ast::Expression> postfix_expression
+%type <ast::Expression> unary_expression
+%type <ast::Expression> multiplicative_expression
+%type <ast::Expression> additive_expression
+%type <ast::Expression> assignment
+%type <ast::Expression> expression
 
 // FIXME: must be condition. Changing to Expression breaks the compiler somehow.
 %type <ast::Comparison_Operation> comparison_operator
-%type <ast::Condition::Ptr> condition
-%type <ast::Condition::Ptr> cond_instruction  // This doesn't seem right, but it is.
+%type <ast::Condition> condition
+%type <ast::Condition> cond_instruction  // This doesn't seem right, but it is.
 
 %type <ast::Instruction::Ptr> instruction
 %type <ast::Compound_Instruction::Ptr> compound_instruction
@@ -135,8 +271,8 @@ std::string type_str (const parser::Type& type) {
 %type <ast::Instruction::Ptr> select_instruction
 %type <ast::Instruction::Ptr> jump_instruction
 
-%type <std::vector<ast::Expression::Ptr>> argument_expression_list
-%type <std::vector<ast::Instruction::Ptr>> instruction_list
+%type <Expression_List> argument_expression_list
+%type <Instruction_List> instruction_list
 
 %type <ast::Function_Definition::Ptr> function_definition
 
@@ -154,14 +290,14 @@ program :
 
 external_declaration :
     declaration         {
-        auto declaration_list = std::make_shared<ast::Declaration_List>();
+        auto declaration_list = ast::make<ast::Declaration_List>();
 
         for (auto& symbol : $1) {
             symbol->set(Symbol::Attribute::GLOBAL);
 
             // Emit function declarations.
             if (auto function = std::dynamic_pointer_cast<Function>(symbol)) {
-                auto func_decl = std::make_shared<ast::Function_Declaration>(function->type(), function);
+                auto func_decl = ast::make<ast::Function_Declaration>(function->type(), function);
                 func_decl->emit_code(code_generator);
             } else {
                 declaration_list->push_back(symbol);
@@ -169,16 +305,17 @@ external_declaration :
         }
 
         declaration_list->emit_code(code_generator);
+        forget_tokens(state, @$.end);
     }
   | EXTERN declaration  {
-        auto declaration_list = std::make_shared<ast::Declaration_List>();
+        auto declaration_list = ast::make<ast::Declaration_List>();
 
         for (auto& symbol : $2) {
             symbol->set(Symbol::Attribute::GLOBAL);
             symbol->set(Symbol::Attribute::EXTERN);
 
             if (auto function = std::dynamic_pointer_cast<Function>(symbol)) {
-                auto func_decl = std::make_shared<ast::Function_Declaration>(function->type(), function);
+                auto func_decl = ast::make<ast::Function_Declaration>(function->type(), function);
                 func_decl->emit_code(code_generator);
             } else {
                 declaration_list->push_back(symbol);
@@ -186,12 +323,19 @@ external_declaration :
         }
 
         declaration_list->emit_code(code_generator);
+        forget_tokens(state, @$.end);
     }
   | function_definition {
         /* std::cout << "external_declaration: function_definition" << std::endl; */
 
         // emit function definition
         $1->emit_code(code_generator);
+        forget_tokens(state, @$.end);
+
+        // The function's nodes, local symbols and scopes are released all at
+        // once, as soon as nothing refers to them anymore.
+        state.function_arena.close();
+        state.function_expressions.close();
     }
 ;
 
@@ -200,27 +344,29 @@ function_definition :
         // Verify the function return type. (Should have been set when
         // processing `function_declarator`.)
         auto function = $2;
-        unclaimed_types_.pop();
+        state.unclaimed_types.pop();
         if (function->type() != $1) {
             throw std::runtime_error("INTERNAL ERROR: Type mismatch.");
         }
 
         // Type checking is done when processing `decl_glb_fct`.
 
-        $$ = std::make_shared<ast::Function_Definition>($1, function, $4);
+        $$ = ast::make<ast::Function_Definition>($1, function, $4);
+        if (state.hash_functions) {
+            $$->cache_key(cache_key(state, @$));
+        }
     }
 ;
 
 decl_glb_fct : {
-        std::cout << "; Define function '" << last_function_->name() << "'" << std::endl;
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
 
-        Function::Ptr function = last_function_;
+        Function::Ptr function = state.last_function;
 
         // A function can be declared before it is defined.
-        if (symbol_table->is_visible(function->name())) {
+        if (auto declared = symbol_table->lookup(function->atom())) {
             // Retrieve previously declared function.
-            auto declared_func = std::dynamic_pointer_cast<Function>(
-                symbol_table->lookup(function->name()));
+            auto declared_func = std::dynamic_pointer_cast<Function>(declared);
 
             // Verify that previously declared identifier is a function.
             if (not declared_func) {
@@ -258,45 +404,50 @@ decl_glb_fct : {
         // If function is not yet declared, add it to the symbol table before we
         // attempt to define it. This enables recursion.
         else {
-            symbol_table->add(function->name(), Symbol::Ptr(function));
+            symbol_table->add(function->atom(), Symbol::Ptr(function));
             // $2->print_semantic_action();
         }
 
         // Raise a flag to let "block_start" know that the symbol-table has
         // already been created.
-        new_function_definition_ = true;
+        state.new_function_definition = true;
 
-        // Create the new symbol-table for this function.
-        symbol_table = Symbol_Table::construct(
-            "function scope - " + function->name(),
-            @$,
-            symbol_table
-        );
+        state.referenced_signatures.clear();
+
+        // Everything created from here to the end of the definition goes in
+        // the function's arena.
+        state.function_arena.open();
+        state.function_expressions.open();
+
+        // Open the scope of this function.
+        symbol_table->push("function scope - " + function->name(), @$);
 
         // NOTE: compound_instruction will have not yet already taken care of
-        //       creating a new symbol-table for the new scope. However, it will
+        //       opening a new scope in the symbol-table. However, it will
         //       not add the function parameters to this scope. We must do that
         //       here.
         for (auto& symbol : function->argument_list()) {
-            symbol_table->add(symbol->name(), symbol);
+            symbol_table->add(symbol->atom(), symbol);
         }
     }
 ;
 
 declaration :
     type declarator_list ';' {
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
+
         $$ = $2;
-        unclaimed_types_.pop();
+        state.unclaimed_types.pop();
 
         for (auto& symbol : $$) {
             symbol->type($1);
 
-            if (symbol_table->is_in_this_scope(symbol->name())) {
+            if (symbol_table->is_in_this_scope(symbol->atom())) {
                 throw syntax_error(@$, "Duplicate declaration of symbol '" +
                     symbol->name() + "'");
             }
 
-            symbol_table->add(symbol->name(), symbol);
+            symbol_table->add(symbol->atom(), symbol);
             // symbol->print_semantic_action();  // TODO: Remove for Part 3.
         }
     }
@@ -304,11 +455,11 @@ declaration :
 
 type :
     INT    {
-        unclaimed_types_.push(Type::INT);
+        state.unclaimed_types.push(Type::INT);
         $$ = Type::INT;
     }
   | STRING {
-        unclaimed_types_.push(Type::STRING);
+        state.unclaimed_types.push(Type::STRING);
         $$ = Type::STRING;
     }
 ;
@@ -341,7 +492,7 @@ declaration_list :
 
 declarator :
     IDENT               {
-        $$ = std::make_shared<Symbol>(std::move($1));
+        $$ = make_symbol<Symbol>($1);
     }
   | function_declarator {
         $$ = $1;
@@ -351,17 +502,17 @@ declarator :
 function_declarator :
     IDENT '(' ')'                 {
         // Create function and set return type.
-        $$ = std::make_shared<Function>(std::move($1));
-        $$->type(unclaimed_types_.top());
+        $$ = make_symbol<Function>($1);
+        $$->type(state.unclaimed_types.top());
 
-        last_function_ = $$;
+        state.last_function = $$;
     }
   | IDENT '(' parameter_list ')'  {
         // Create function and set return type.
-        $$ = std::make_shared<Function>(std::move($1));
-        $$->type(unclaimed_types_.top());
+        $$ = make_symbol<Function>($1);
+        $$->type(state.unclaimed_types.top());
 
-        last_function_ = $$;
+        state.last_function = $$;
         for (auto& symbol : $3) {
             symbol->set(Symbol::Attribute::FUNCTION_PARAM);
             std::static_pointer_cast<Function>($$)->argument_list().push_back(symbol);
@@ -381,8 +532,8 @@ parameter_list :
 
 parameter_declaration :
     type IDENT {
-        $$ = std::make_shared<Symbol>(std::move($2));
-        unclaimed_types_.pop();
+        $$ = make_symbol<Symbol>($2);
+        state.unclaimed_types.pop();
         $$->type($1);
     }
 ;
@@ -417,11 +568,11 @@ instruction :
 expression_instruction :
     expression ';' {
         /* std::cout << "expression_instruction: expression ';'" << std::endl; */
-        $$ = std::make_shared<ast::Expression_Instruction>($1);
+        $$ = ast::make<ast::Expression_Instruction>($1);
     }
   | assignment ';' {
         /* std::cout << "expression_instruction: assignment ';'" << std::endl; */
-        $$ = std::make_shared<ast::Expression_Instruction>($1);
+        $$ = ast::make<ast::Expression_Instruction>($1);
     }
 ;
 
@@ -429,17 +580,18 @@ assignment :
     IDENT '=' expression {
         /* std::cout << "assignment: IDENT '=' expression" << std::endl; */
         // std::cout << "- assignment " << $1 << std::endl;
-
-        if (not symbol_table->is_visible($1)) {
-            throw syntax_error(@$, $1 + " is not defined.");
-        }
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
 
         Symbol::Ptr symbol = symbol_table->lookup($1);
-        if (symbol->type() != $3->type()) {
+        if (not symbol) {
+            throw syntax_error(@$, $1.str() + " is not defined.");
+        }
+        reference(state, symbol);
+        if (symbol->type() != $3.type()) {
             std::string expression_str;
-            if ($3->type() == Type::INT) {
+            if ($3.type() == Type::INT) {
                 expression_str = "int";
-            } else if ($3->type() == Type::STRING) {
+            } else if ($3.type() == Type::STRING) {
                 expression_str = "string";
             } else {
                 expression_str = "expression is not defined.";
@@ -447,18 +599,18 @@ assignment :
             throw syntax_error(@$, "Type checking error. Assign " + symbol->type_str() + " to " + expression_str + ".");
         }
 
-        auto variable = std::make_shared<ast::Variable>(symbol);
-        $$ = std::make_shared<ast::Assignment>(variable, $3);
+        auto variable = ast::make<ast::Variable>(symbol);
+        $$ = ast::make<ast::Assignment>(variable, $3);
     }
 ;
 
 compound_instruction :
     block_start declaration_list instruction_list block_end {
         /* std::cout << "compound_instruction: block_start declaration_list instruction_list block_end" << std::endl; */
-        ast::Declaration_List::Ptr ast_declaration_list = std::make_shared<ast::Declaration_List>(std::move($2));
+        ast::Declaration_List::Ptr ast_declaration_list = ast::make<ast::Declaration_List>(std::move($2));
         $3.insert($3.begin()+0, ast_declaration_list);
 
-        $$ = std::make_shared<ast::Compound_Instruction>(std::move($3));
+        $$ = ast::make<ast::Compound_Instruction>(std::move($3));
     }
   | block_start declaration_list block_end {
         /* std::cout << "compound_instruction: block_start declaration_list block_end" << std::endl; */
@@ -466,7 +618,7 @@ compound_instruction :
     }
   | block_start instruction_list block_end {
         /* std::cout << "compound_instruction: block_start instruction_list block_end" << std::endl; */
-        $$ = std::make_shared<ast::Compound_Instruction>(std::move($2));
+        $$ = ast::make<ast::Compound_Instruction>(std::move($2));
     }
   | block_start block_end {
         /* std::cout << "compound_instruction: block_start block_end" << std::endl; */
@@ -477,18 +629,17 @@ compound_instruction :
 
 block_start :
     '{' {
-        if (not new_function_definition_) {
-            symbol_table = Symbol_Table::construct("anonymous block", @$, symbol_table);
+        if (not state.new_function_definition) {
+            symbol_table->push("anonymous block", @$);
         } else {
-            new_function_definition_ = false;
+            state.new_function_definition = false;
         }
     }
 ;
 
 block_end :
     '}' {
-        symbol_table->loc.end = @$.end;
-        symbol_table = symbol_table->parent();
+        symbol_table->pop();
     }
 ;
 
@@ -507,11 +658,11 @@ instruction_list :
 select_instruction :
     cond_instruction instruction                  {
         /* std::cout << "select_instruction: cond_instruction instruction" << std::endl; */
-        $$ = std::make_shared<ast::Cond_Instruction>($1, $2);
+        $$ = ast::make<ast::Cond_Instruction>($1, $2);
     }
   | cond_instruction instruction ELSE instruction {
         /* std::cout << "select_instruction: cond_instruction instruction ELSE instruction" << std::endl; */
-        $$ = std::make_shared<ast::Cond_Instruction>($1, $2, $4);
+        $$ = ast::make<ast::Cond_Instruction>($1, $2, $4);
     }
 ;
 
@@ -525,15 +676,15 @@ cond_instruction :
 iteration_instruction :
     WHILE '(' condition ')' instruction                             {
         /* std::cout << "iteration_instruction: WHILE '(' condition ')' instruction" << std::endl; */
-        $$ = std::make_shared<ast::While_Instruction>($3, $5);
+        $$ = ast::make<ast::While_Instruction>($3, $5);
     }
   | DO instruction WHILE '(' condition ')'                          {
         /* std::cout << "iteration_instruction: DO instruction WHILE '(' condition ')'" << std::endl; */
-        $$ = std::make_shared<ast::Do_Instruction>($5, $2);
+        $$ = ast::make<ast::Do_Instruction>($5, $2);
     }
   | FOR '(' assignment ';' condition ';' assignment ')' instruction {
         /* std::cout << "iteration_instruction: FOR '(' assignment ';' condition ';' assignment ')' instruction" << std::endl; */
-        $$ = std::make_shared<ast::For_Instruction>($3, $5, $7, $9);
+        $$ = ast::make<ast::For_Instruction>($3, $5, $7, $9);
 
     }
 ;
@@ -541,14 +692,14 @@ iteration_instruction :
 jump_instruction:
     RETURN expression ';' {
         /* std::cout << "jump_instruction: RETURN expression ';'" << std::endl; */
-        $$ = std::make_shared<ast::Return_Instruction>($2);
+        $$ = ast::make<ast::Return_Instruction>($2);
     }
 ;
 
 condition :
     expression comparison_operator expression {
         /* std::cout << "condition: expression comparison_operator expression" << std::endl; */
-        $$ = std::make_shared<ast::Condition>($2, $1, $3);
+        $$ = ast::make<ast::Condition>($2, $1, $3);
     }
 ;
 
@@ -568,13 +719,13 @@ expression :
     }
   | expression SHIFTLEFT additive_expression  {
         /* std::cout << "expression: expression SHIFTLEFT additive_expression" << std::endl; */
-        if ($1->type() == Type::INT and $3->type() == Type::INT) {
-            $$ = std::make_shared<ast::Binary_Expression>(Type::INT, ast::Operation::LEFT_SHIFT, $1, $3);
+        if ($1.type() == Type::INT and $3.type() == Type::INT) {
+            $$ = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::LEFT_SHIFT, $1, $3);
         } else {
             std::ostringstream oss;
             oss
                 << "Cannot do '<<' operation between types '"
-                << type_str($1->type()) << "' and '" << type_str($3->type())
+                << type_str($1.type()) << "' and '" << type_str($3.type())
                 << "'."
                 ;
             throw syntax_error(@$, oss.str());
@@ -582,13 +733,13 @@ expression :
     }
   | expression SHIFTRIGHT additive_expression {
         /* std::cout << "expression: expression SHIFTRIGHT additive_expression" << std::endl; */
-        if ($1->type() == Type::INT and $3->type() == Type::INT) {
-            $$ = std::make_shared<ast::Binary_Expression>(Type::INT, ast::Operation::RIGHT_SHIFT, $1, $3);
+        if ($1.type() == Type::INT and $3.type() == Type::INT) {
+            $$ = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::RIGHT_SHIFT, $1, $3);
         } else {
             std::ostringstream oss;
             oss
                 << "Cannot do '>>' operation between types '"
-                << type_str($1->type()) << "' and '" << type_str($3->type())
+                << type_str($1.type()) << "' and '" << type_str($3.type())
                 << "'."
                 ;
             throw syntax_error(@$, oss.str());
@@ -603,13 +754,13 @@ additive_expression :
     }
   | additive_expression PLUS multiplicative_expression  {
         /* std::cout << "additive_expression: additive_expression PLUS multiplicative_expression" << std::endl; */
-        if ($1->type() == $3->type()) {
-            switch ($1->type()) {
+        if ($1.type() == $3.type()) {
+            switch ($1.type()) {
                 case Type::INT:
-                    $$ = std::make_shared<ast::Binary_Expression>(Type::INT, ast::Operation::ADDITION, $1, $3);
+                    $$ = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::ADDITION, $1, $3);
                     break;
                 case Type::STRING:
-                    $$ = std::make_shared<ast::Binary_Expression>(Type::STRING, ast::Operation::ADDITION, $1, $3);
+                    $$ = ast::make<ast::Binary_Expression>(Type::STRING, ast::Operation::ADDITION, $1, $3);
                     break;
             }
         } else {
@@ -617,7 +768,7 @@ additive_expression :
             std::ostringstream oss;
             oss
                 << "Cannot do '+' operation between types '"
-                << type_str($1->type()) << "' and '" << type_str($3->type())
+                << type_str($1.type()) << "' and '" << type_str($3.type())
                 << "'."
                 ;
             throw syntax_error(@$, oss.str());
@@ -625,13 +776,13 @@ additive_expression :
     }
   | additive_expression MINUS multiplicative_expression {
         /* std::cout << "additive_expression: additive_expression MINUS multiplicative_expression" << std::endl; */
-        if ($1->type() == Type::INT and $3->type() == Type::INT) {
-            $$ = std::make_shared<ast::Binary_Expression>(Type::INT, ast::Operation::SUBTRACTION, $1, $3);
+        if ($1.type() == Type::INT and $3.type() == Type::INT) {
+            $$ = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::SUBTRACTION, $1, $3);
         } else {
             std::ostringstream oss;
             oss
                 << "Cannot do '-' operation between types '"
-                << type_str($1->type()) << "' and '" << type_str($3->type())
+                << type_str($1.type()) << "' and '" << type_str($3.type())
                 << "'."
                 ;
             throw syntax_error(@$, oss.str());
@@ -646,13 +797,13 @@ multiplicative_expression :
     }
   | multiplicative_expression MULTIPLY unary_expression {
         /* std::cout << "multiplicative_expression: multiplicative_expression MULTIPLY unary_expression" << std::endl; */
-        if ($1->type() == Type::INT and $3->type() == Type::INT) {
-            $$ = std::make_shared<ast::Binary_Expression>(Type::INT, ast::Operation::MULTIPLICATION, $1, $3);
+        if ($1.type() == Type::INT and $3.type() == Type::INT) {
+            $$ = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::MULTIPLICATION, $1, $3);
         } else {
             std::ostringstream oss;
             oss
                 << "Cannot do '*' operation between types '"
-                << type_str($1->type()) << "' and '" << type_str($3->type())
+                << type_str($1.type()) << "' and '" << type_str($3.type())
                 << "'."
                 ;
             throw syntax_error(@$, oss.str());
@@ -660,13 +811,13 @@ multiplicative_expression :
     }
   | multiplicative_expression DIVIDE unary_expression   {
         /* std::cout << "multiplicative_expression: multiplicative_expression DIVIDE unary_expression" << std::endl; */
-        if ($1->type() == Type::INT and $3->type() == Type::INT) {
-            $$ = std::make_shared<ast::Binary_Expression>(Type::INT, ast::Operation::DIVISION, $1, $3);
+        if ($1.type() == Type::INT and $3.type() == Type::INT) {
+            $$ = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::DIVISION, $1, $3);
         } else {
             std::ostringstream oss;
             oss
                 << "Cannot do '/' operation between types '"
-                << type_str($1->type()) << "' and '" << type_str($3->type())
+                << type_str($1.type()) << "' and '" << type_str($3.type())
                 << "'."
                 ;
             throw syntax_error(@$, oss.str());
@@ -674,13 +825,13 @@ multiplicative_expression :
     }
   | multiplicative_expression MODULO unary_expression   {
         /* std::cout << "multiplicative_expression: multiplicative_expression MODULO unary_expression" << std::endl; */
-        if ($1->type() == Type::INT and $3->type() == Type::INT) {
-            $$ = std::make_shared<ast::Binary_Expression>(Type::INT, ast::Operation::MODULUS, $1, $3);
+        if ($1.type() == Type::INT and $3.type() == Type::INT) {
+            $$ = ast::make<ast::Binary_Expression>(Type::INT, ast::Operation::MODULUS, $1, $3);
         } else {
             std::ostringstream oss;
             oss
                 << "Cannot do '%' operation between types '"
-                << type_str($1->type()) << "' and '" << type_str($3->type())
+                << type_str($1.type()) << "' and '" << type_str($3.type())
                 << "'."
                 ;
             throw syntax_error(@$, oss.str());
@@ -695,14 +846,14 @@ unary_expression:
     }
   | MINUS unary_expression {
         /* std::cout << "unary_expression: MINUS unary_expression" << std::endl; */
-        if ($2->type() == Type::INT) {
-            // $$ = std::make_shared<ast::Unary_Expression>(Type::INT, ast::Operation::SUBTRACTION, $2);
-            $$ = std::make_shared<ast::Unary_Expression>($2);
+        if ($2.type() == Type::INT) {
+            // $$ = ast::make<ast::Unary_Expression>(Type::INT, ast::Operation::SUBTRACTION, $2);
+            $$ = ast::make<ast::Unary_Expression>($2);
         } else {
             std::ostringstream oss;
             oss
                 << "Cannot do unary '-' operation on type '"
-                << type_str($2->type()) << "'."
+                << type_str($2.type()) << "'."
                 ;
             throw syntax_error(@$, oss.str());
         }
@@ -717,21 +868,20 @@ postfix_expression :
   | IDENT '(' argument_expression_list ')' {
         /* std::cout << "postfix_expression: IDENT '(' argument_expression_list ')'" << std::endl; */
         /* std::cout << "postfix_expression: IDENT '(' ')'" << *$1 << std::endl; */
-        if (not symbol_table->is_visible($1)) {
-            throw syntax_error(@$, $1 + " is not defined");
-        }
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
 
         // Check if IDENT is defined.
         auto symbol = symbol_table->lookup($1);
         if (not symbol) {
-            throw syntax_error(@$, "Attempt to call function that is not defined '" + $1 + "'.");
+            throw syntax_error(@$, $1.str() + " is not defined");
         }
 
         // Check if IDENT is a function.
         auto declared_func = std::dynamic_pointer_cast<Function>(symbol);
         if (not declared_func) {
-            throw syntax_error(@$, "'" + $1 + "' identifies a variable, not a function.");
+            throw syntax_error(@$, "'" + $1.str() + "' identifies a variable, not a function.");
         }
+        reference(state, declared_func);
 
         // Verify the argument list. (type-checking)
         if ($3.size() != declared_func->argument_list().size()) {
@@ -740,38 +890,37 @@ postfix_expression :
         auto pair = std::mismatch(
             std::begin($3), std::end($3),
             std::begin(declared_func->argument_list()),
-            [] (ast::Expression::Ptr a, Symbol::Ptr b) { return a->type() == b->type(); }
+            [] (const ast::Expression& a, Symbol::Ptr b) { return a.type() == b->type(); }
         );
         if (pair.first != std::end($3)) {
             throw syntax_error(@$, "Signature mismatch between function definition and function call.");
         }
 
-        $$ = std::make_shared<ast::Function_Call>(declared_func, $3);
+        $$ = ast::make<ast::Function_Call>(declared_func, $3);
     }
   | IDENT '(' ')'                          {
         /* std::cout << "postfix_expression: IDENT '(' ')'" << *$1 << std::endl; */
-        if (not symbol_table->is_visible($1)) {
-            throw syntax_error(@$, $1 + " is not defined");
-        }
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
 
         // Check if IDENT is defined.
         auto symbol = symbol_table->lookup($1);
         if (not symbol) {
-            throw syntax_error(@$, "Attempt to call function that is not defined '" + $1 + "'.");
+            throw syntax_error(@$, $1.str() + " is not defined");
         }
 
         // Check if IDENT is a function.
         auto declared_func = std::dynamic_pointer_cast<Function>(symbol);
         if (not declared_func) {
-            throw syntax_error(@$, "'" + $1 + "' identifies a variable, not a function.");
+            throw syntax_error(@$, "'" + $1.str() + "' identifies a variable, not a function.");
         }
+        reference(state, declared_func);
 
         // Verify the argument list. (type-checking)
         if (0 != declared_func->argument_list().size()) {
             throw syntax_error(@$, "Signature mismatch between function definition and function call.");
         }
 
-        $$ = std::make_shared<ast::Function_Call>(declared_func);
+        $$ = ast::make<ast::Function_Call>(declared_func);
     }
 ;
 
@@ -790,26 +939,25 @@ argument_expression_list:
 primary_expression :
     IDENT              {
         /* std::cout << "primary_expression: IDENT " << *$1 << std::endl; */
-        if (not symbol_table->is_visible($1)) {
-            throw syntax_error(@$, $1 + " is not defined");
-        }
+        stats::Phase_Timer timer (stats::Phase::SEMANTIC_CHECKS);
 
         // Check if IDENT is defined.
         auto symbol = symbol_table->lookup($1);
         if (not symbol) {
-            throw syntax_error(@$, "Attempt to reference symbol that is not defined '" + $1 + "'.");
+            throw syntax_error(@$, $1.str() + " is not defined");
         }
+        reference(state, symbol);
 
-        $$ = std::make_shared<ast::Variable>(symbol);
+        $$ = ast::make<ast::Variable>(symbol);
     }
   | CONST_INT          {
         /* std::cout << "primary_expression: CONST_INT " << $1 << std::endl; */
-        $$ = std::make_shared<ast::Const_Integer>($1);
+        $$ = ast::make<ast::Const_Integer>($1);
     }
   | CONST_STRING       {
         /* std::cout << "primary_expression: CONST_STRING " << $1 << std::endl; */
         // remove "
-        $$ = std::make_shared<ast::Const_String>($1.substr(1,$1.size()-2));
+        $$ = ast::make<ast::Const_String>($1.substr(1,$1.size()-2));
     }
   | '(' expression ')' {
         /* std::cout << "primary_expression: '(' expression ')'" << std::endl; */
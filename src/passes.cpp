@@ -0,0 +1,833 @@
+#include "passes.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "ast.hpp"
+#include "ir_cache.hpp"
+#include "stats.hpp"
+#include "symbol.hpp"
+
+
+namespace passes {
+
+
+// Transform - member function definitions
+
+ast::Function_Definition::Ptr Transform::run (const ast::Function_Definition::Ptr& node) {
+    // New expressions go in the store of the definition.
+    ast::Store_Scope expressions;
+    expressions.open(node->expressions());
+    rewritten_.reset(node->expression_count());
+
+    node->emit_code(*this);
+    auto result = pop_<ast::Function_Definition>();
+    results_.clear();
+    return result;
+}
+
+ast::Expression Transform::rewrite (const ast::Expression& node) {
+    if (not node) {
+        return node;
+    }
+    node.emit_code(*this);
+    return rewritten_[node];
+}
+
+ast::Condition Transform::rewrite (const ast::Condition& node) {
+    ast::Expression result = rewrite(static_cast<const ast::Expression&>(node));
+    if (result and result.kind() != ast::Kind::CONDITION) {
+        throw std::logic_error("A pass replaced a condition with another kind of expression.");
+    }
+    return result ? ast::Condition(result) : ast::Condition();
+}
+
+void Transform::rewrite (const ast::Instruction::Ptr& node) {
+    if (node) {
+        work_.generate(*this, node);
+    } else {
+        then([this] { results_.push_back(nullptr); });
+    }
+}
+
+ast::List<ast::Instruction::Ptr> Transform::pop_list_ (std::size_t count) {
+    ast::List<ast::Instruction::Ptr> list;
+    for (auto iter = std::end(results_) - count; iter != std::end(results_); ++iter) {
+        list.push_back(std::static_pointer_cast<ast::Instruction>(*iter));
+    }
+    results_.resize(results_.size() - count);
+    return list;
+}
+
+void Transform::visit (ast::Declaration_List&       node) {
+    results_.push_back(ast::shared(node));
+}
+void Transform::visit (ast::Variable&               node) {
+    rewritten_[node] = node;
+}
+void Transform::visit (ast::Const_Integer&          node) {
+    rewritten_[node] = node;
+}
+void Transform::visit (ast::Const_String&           node) {
+    rewritten_[node] = node;
+}
+void Transform::visit (ast::Unary_Expression&       node) {
+    auto rhs = rewritten_[node.rhs()];
+    if (rhs == node.rhs()) {
+        rewritten_[node] = node;
+    } else {
+        rewritten_[node] = ast::make<ast::Unary_Expression>(rhs);
+    }
+}
+void Transform::visit (ast::Binary_Expression&      node) {
+    auto lhs = rewritten_[node.lhs()];
+    auto rhs = rewritten_[node.rhs()];
+    if (lhs == node.lhs() and rhs == node.rhs()) {
+        rewritten_[node] = node;
+    } else {
+        rewritten_[node] = ast::make<ast::Binary_Expression>(node.type(), node.op(), lhs, rhs);
+    }
+}
+void Transform::visit (ast::Condition&              node) {
+    auto lhs = rewritten_[node.lhs()];
+    auto rhs = rewritten_[node.rhs()];
+    if (lhs == node.lhs() and rhs == node.rhs()) {
+        rewritten_[node] = node;
+    } else {
+        rewritten_[node] = ast::make<ast::Condition>(node.op(), lhs, rhs);
+    }
+}
+void Transform::visit (ast::Assignment&             node) {
+    auto rhs = rewritten_[node.rhs()];
+    if (rhs == node.rhs()) {
+        rewritten_[node] = node;
+    } else {
+        rewritten_[node] = ast::make<ast::Assignment>(node.lhs(), rhs);
+    }
+}
+void Transform::visit (ast::Function_Call&          node) {
+    ast::List<ast::Expression> arguments;
+    bool changed = false;
+    for (auto argument : node.argument_list()) {
+        arguments.push_back(rewritten_[argument]);
+        changed = changed or arguments.back() != argument;
+    }
+    if (not changed) {
+        rewritten_[node] = node;
+    } else {
+        rewritten_[node] = ast::make<ast::Function_Call>(node.function(), arguments);
+    }
+}
+void Transform::visit (ast::Instruction&            node) {
+    results_.push_back(ast::shared(node));
+}
+void Transform::visit (ast::Expression_Instruction& node) {
+    auto expression = rewrite(node.expression());
+    if (expression == node.expression()) {
+        results_.push_back(ast::shared(node));
+    } else {
+        results_.push_back(ast::make<ast::Expression_Instruction>(expression));
+    }
+}
+void Transform::visit (ast::Cond_Instruction&       node) {
+    auto condition = rewrite(node.condition());
+    rewrite(node.instruction());
+    rewrite(node.else_instruction());
+    then([this, &node, condition] {
+        auto else_instruction = pop_<ast::Instruction>();
+        auto instruction      = pop_<ast::Instruction>();
+        if (condition == node.condition() and instruction == node.instruction() and
+            else_instruction == node.else_instruction()) {
+            results_.push_back(ast::shared(node));
+        } else {
+            results_.push_back(ast::make<ast::Cond_Instruction>(condition, instruction, else_instruction));
+        }
+    });
+}
+void Transform::visit (ast::While_Instruction&      node) {
+    auto condition = rewrite(node.condition());
+    rewrite(node.instruction());
+    then([this, &node, condition] {
+        auto instruction = pop_<ast::Instruction>();
+        if (condition == node.condition() and instruction == node.instruction()) {
+            results_.push_back(ast::shared(node));
+        } else {
+            results_.push_back(ast::make<ast::While_Instruction>(condition, instruction));
+        }
+    });
+}
+void Transform::visit (ast::Do_Instruction&         node) {
+    auto condition = rewrite(node.condition());
+    rewrite(node.instruction());
+    then([this, &node, condition] {
+        auto instruction = pop_<ast::Instruction>();
+        if (condition == node.condition() and instruction == node.instruction()) {
+            results_.push_back(ast::shared(node));
+        } else {
+            results_.push_back(ast::make<ast::Do_Instruction>(condition, instruction));
+        }
+    });
+}
+void Transform::visit (ast::For_Instruction&        node) {
+    auto initialization = rewrite(node.initialization());
+    auto condition      = rewrite(node.condition());
+    auto increment      = rewrite(node.increment());
+    rewrite(node.instruction());
+    then([this, &node, initialization, condition, increment] {
+        auto instruction = pop_<ast::Instruction>();
+        if (initialization == node.initialization() and condition == node.condition() and
+            increment == node.increment() and instruction == node.instruction()) {
+            results_.push_back(ast::shared(node));
+        } else {
+            results_.push_back(ast::make<ast::For_Instruction>(
+                initialization, condition, increment, instruction));
+        }
+    });
+}
+void Transform::visit (ast::Return_Instruction&     node) {
+    auto expression = rewrite(node.expression());
+    if (expression == node.expression()) {
+        results_.push_back(ast::shared(node));
+    } else {
+        results_.push_back(ast::make<ast::Return_Instruction>(expression));
+    }
+}
+void Transform::visit (ast::Compound_Instruction&   node) {
+    for (auto& instruction : node.instruction_list()) {
+        rewrite(instruction);
+    }
+    then([this, &node] {
+        auto instructions = pop_list_(node.instruction_list().size());
+        if (instructions == node.instruction_list()) {
+            results_.push_back(ast::shared(node));
+        } else {
+            results_.push_back(ast::make<ast::Compound_Instruction>(instructions));
+        }
+    });
+}
+void Transform::visit (ast::Function_Declaration&   node) {
+    results_.push_back(ast::shared(node));
+}
+void Transform::visit (ast::Function_Definition&    node) {
+    rewrite(node.body());
+    then([this, &node] {
+        auto body = std::dynamic_pointer_cast<ast::Compound_Instruction>(pop_<ast::Instruction>());
+        if (node.body() and not body) {
+            throw std::logic_error("A pass replaced a function body with another kind of instruction.");
+        }
+        if (body == node.body()) {
+            results_.push_back(ast::shared(node));
+        } else {
+            auto definition = ast::make<ast::Function_Definition>(
+                node.type(), node.function_declarator(), body);
+            definition->cache_key(std::string(node.cache_key()));
+            results_.push_back(definition);
+        }
+    });
+}
+
+
+// Pass_Manager - member function definitions
+
+Pass_Manager::Pass_Manager (
+    ast::Code_Generator& next,
+    int level,
+    const std::string& print_after,
+    std::ostream& dump
+) : next_(next), passes_(pipeline(level)), print_after_(print_after), dump_(dump) {}
+
+ast::Function_Definition::Ptr Pass_Manager::run (ast::Function_Definition::Ptr node) {
+    if (passes_.empty()) {
+        return node;
+    }
+
+    ir_cache::Hasher hasher;
+    hasher.add(node->cache_key());
+
+    for (auto& pass : passes_) {
+        {
+            stats::Phase_Timer timer (pass->name());
+            node = pass->run(node);
+        }
+        hasher.add(std::string(pass->name()));
+
+        if (print_after_ == pass->name()) {
+            dump_ << "// *** " << node->function_declarator()->name()
+                << " after " << pass->name() << " ***" << std::endl;
+            print(node, dump_);
+        }
+    }
+
+    // The IR of the definition depends on the passes run on it.
+    if (not node->cache_key().empty()) {
+        node->cache_key(hasher.hex());
+    }
+    return node;
+}
+
+
+std::vector<std::unique_ptr<Pass>> pipeline (int level) {
+    std::vector<std::unique_ptr<Pass>> passes;
+    if (level >= 2) {
+        passes.emplace_back(new Fold_Constants());
+    }
+    if (level >= 1) {
+        passes.emplace_back(new Dead_Code());
+    }
+    if (level >= 2) {
+        passes.emplace_back(new Simplify());
+    }
+    return passes;
+}
+
+std::vector<std::string> pass_names () {
+    std::vector<std::string> names;
+    for (auto& pass : pipeline(2)) {
+        names.push_back(pass->name());
+    }
+    return names;
+}
+
+
+// Printer - writes a tree out as source code, for --print-after.
+
+namespace {
+
+class Printer final : public ast::Code_Generator {
+  public:
+    explicit Printer (std::ostream& out) : out_(out) {}
+
+    void visit (ast::Declaration_List& node) override {
+        for (auto& symbol : node.symbol_list()) {
+            indent_();
+            out_ << symbol->type_str() << ' ' << symbol->name() << ";\n";
+        }
+    }
+    void visit (ast::Instruction& node) override {
+        indent_();
+        out_ << ";\n";
+    }
+    void visit (ast::Expression_Instruction& node) override {
+        indent_();
+        expression_(node.expression());
+        out_ << ";\n";
+    }
+    void visit (ast::Cond_Instruction& node) override {
+        indent_();
+        out_ << "if (";
+        expression_(node.condition());
+        out_ << ")\n";
+        nested_(node.instruction());
+        if (node.else_instruction()) {
+            work_.then([this] {
+                indent_();
+                out_ << "else\n";
+            });
+            nested_(node.else_instruction());
+        }
+    }
+    void visit (ast::While_Instruction& node) override {
+        indent_();
+        out_ << "while (";
+        expression_(node.condition());
+        out_ << ")\n";
+        nested_(node.instruction());
+    }
+    void visit (ast::Do_Instruction& node) override {
+        indent_();
+        out_ << "do\n";
+        nested_(node.instruction());
+        work_.then([this, &node] {
+            indent_();
+            out_ << "while (";
+            expression_(node.condition());
+            out_ << ");\n";
+        });
+    }
+    void visit (ast::For_Instruction& node) override {
+        indent_();
+        out_ << "for (";
+        expression_(node.initialization());
+        out_ << "; ";
+        expression_(node.condition());
+        out_ << "; ";
+        expression_(node.increment());
+        out_ << ")\n";
+        nested_(node.instruction());
+    }
+    void visit (ast::Return_Instruction& node) override {
+        indent_();
+        out_ << "return ";
+        expression_(node.expression());
+        out_ << ";\n";
+    }
+    void visit (ast::Compound_Instruction& node) override {
+        indent_();
+        out_ << "{\n";
+        ++depth_;
+        for (auto& instruction : node.instruction_list()) {
+            instruction_(instruction);
+        }
+        work_.then([this] {
+            --depth_;
+            indent_();
+            out_ << "}\n";
+        });
+    }
+    void visit (ast::Function_Declaration& node) override {
+        signature_(node.type(), *node.function_declarator());
+        out_ << ";\n";
+    }
+    void visit (ast::Function_Definition& node) override {
+        signature_(node.type(), *node.function_declarator());
+        out_ << '\n';
+        instruction_(node.body());
+    }
+
+  private:
+    std::ostream& out_;
+    int depth_ = 0;
+
+    void indent_ () {
+        for (int i = 0; i < depth_; ++i) {
+            out_ << "    ";
+        }
+    }
+
+    void signature_ (parser::Type type, parser::Function& declarator) {
+        out_ << (type == parser::Type::INT ? "int" : "string")
+            << ' ' << declarator.name() << '(';
+        const char* separator = "";
+        for (auto& symbol : declarator.argument_list()) {
+            out_ << separator << symbol->type_str() << ' ' << symbol->name();
+            separator = ", ";
+        }
+        out_ << ')';
+    }
+
+    // Writes `node` out from an explicit stack of what is left to write:
+    // expressions, and the text between them.
+    void expression_ (const ast::Expression& node) {
+        static const char* const kOperators[] = {" + ", " - ", " * ", " / ", " % ", " << ", " >> "};
+        static const char* const kComparisons[] = {" == ", " != ", " < ", " > ", " <= ", " >= "};
+
+        struct Item {
+            ast::Expression node;
+            const char*     text;
+        };
+        std::vector<Item> stack;
+        auto push = [&] (const ast::Expression& node) { stack.push_back(Item {node, nullptr}); };
+        auto text = [&] (const char* value) { stack.push_back(Item {ast::Expression(), value}); };
+
+        // Pushed last to first.
+        push(node);
+        while (not stack.empty()) {
+            Item item = stack.back();
+            stack.pop_back();
+            if (item.text) {
+                out_ << item.text;
+                continue;
+            }
+            switch (item.node.kind()) {
+                case ast::Kind::VARIABLE:
+                    out_ << ast::Variable(item.node).symbol()->name();
+                    break;
+                case ast::Kind::CONST_INTEGER:
+                    out_ << ast::Const_Integer(item.node).value();
+                    break;
+                case ast::Kind::CONST_STRING:
+                    out_ << '"' << ast::Const_String(item.node).value() << '"';
+                    break;
+                case ast::Kind::UNARY_EXPRESSION:
+                    out_ << "-(";
+                    text(")");
+                    push(ast::Unary_Expression(item.node).rhs());
+                    break;
+                case ast::Kind::BINARY_EXPRESSION: {
+                    ast::Binary_Expression binary (item.node);
+                    out_ << '(';
+                    text(")");
+                    push(binary.rhs());
+                    text(kOperators[static_cast<int>(binary.op())]);
+                    push(binary.lhs());
+                    break;
+                }
+                case ast::Kind::CONDITION: {
+                    ast::Condition condition (item.node);
+                    push(condition.rhs());
+                    text(kComparisons[static_cast<int>(condition.op())]);
+                    push(condition.lhs());
+                    break;
+                }
+                case ast::Kind::ASSIGNMENT: {
+                    ast::Assignment assignment (item.node);
+                    out_ << assignment.lhs().symbol()->name() << " = ";
+                    push(assignment.rhs());
+                    break;
+                }
+                case ast::Kind::FUNCTION_CALL: {
+                    ast::Function_Call call (item.node);
+                    auto arguments = call.argument_list();
+                    out_ << call.function()->name() << '(';
+                    text(")");
+                    for (std::size_t i = arguments.size(); i > 0; --i) {
+                        push(arguments[i - 1]);
+                        if (i > 1) {
+                            text(", ");
+                        }
+                    }
+                    break;
+                }
+                default:
+                    throw std::logic_error("Expression of unknown kind.");
+            }
+        }
+    }
+
+    // The parser leaves empty instructions and blocks out of the tree.
+    void instruction_ (const ast::Instruction::Ptr& node) {
+        if (node) {
+            work_.generate(*this, node);
+        } else {
+            work_.then([this] {
+                indent_();
+                out_ << ";\n";
+            });
+        }
+    }
+
+    void nested_ (const ast::Instruction::Ptr& node) {
+        work_.then([this] { ++depth_; });
+        instruction_(node);
+        work_.then([this] { --depth_; });
+    }
+};
+
+}  // namespace
+
+void print (const ast::Function_Definition::Ptr& node, std::ostream& out) {
+    Printer printer (out);
+    node->emit_code(printer);
+    out << std::flush;
+}
+
+
+// Dead_Code - member function definitions
+
+void Dead_Code::visit (ast::Compound_Instruction& node) {
+    // All but the empty instructions, and whatever follows a return in the
+    // same block.
+    std::size_t count = 0;
+    for (auto& instruction : node.instruction_list()) {
+        if (not instruction or instruction->kind() == ast::Kind::INSTRUCTION) {
+            continue;
+        }
+        rewrite(instruction);
+        ++count;
+        if (instruction->kind() == ast::Kind::RETURN_INSTRUCTION) {
+            break;
+        }
+    }
+
+    then([this, &node, count] {
+        auto instructions = pop_list_(count);
+        if (instructions == node.instruction_list()) {
+            results_.push_back(ast::shared(node));
+        } else {
+            results_.push_back(ast::make<ast::Compound_Instruction>(instructions));
+        }
+    });
+}
+
+
+// Fold_Constants - member function definitions
+
+namespace {
+
+// Counts the assignments to each symbol of a definition, which it leaves as
+// it is.
+class Assignment_Counter final : public Transform {
+  public:
+    std::unordered_map<const parser::Symbol*, int> counts;
+
+    const char* name () const override { return "count-assignments"; }
+
+    void visit (ast::Assignment& node) override {
+        ++counts[node.lhs().symbol().get()];
+        Transform::visit(node);
+    }
+};
+
+// `value` as a 32-bit int, wrapped around.
+int wrap (std::uint32_t value) {
+    return value <= INT32_MAX ? static_cast<int>(value) : -static_cast<int>(~value) - 1;
+}
+
+// Whether `lhs op rhs` can be evaluated at compile time, and if so its value.
+bool fold (ast::Operation op, const ast::Expression& lhs, const ast::Expression& rhs, int& value) {
+    if (lhs.kind() != ast::Kind::CONST_INTEGER or rhs.kind() != ast::Kind::CONST_INTEGER) {
+        return false;
+    }
+    std::int32_t a = ast::Const_Integer(lhs).value();
+    std::int32_t b = ast::Const_Integer(rhs).value();
+
+    switch (op) {
+        case ast::Operation::ADDITION:
+            value = wrap(static_cast<std::uint32_t>(a) + static_cast<std::uint32_t>(b));
+            return true;
+        case ast::Operation::SUBTRACTION:
+            value = wrap(static_cast<std::uint32_t>(a) - static_cast<std::uint32_t>(b));
+            return true;
+        case ast::Operation::MULTIPLICATION:
+            value = wrap(static_cast<std::uint32_t>(a) * static_cast<std::uint32_t>(b));
+            return true;
+
+        // Division is unsigned (udiv) and modulus signed (srem), as the code
+        // generators emit them. What would trap at run time is left to run.
+        case ast::Operation::DIVISION:
+            if (b == 0) {
+                return false;
+            }
+            value = wrap(static_cast<std::uint32_t>(a) / static_cast<std::uint32_t>(b));
+            return true;
+        case ast::Operation::MODULUS:
+            if (b == 0 or (a == INT32_MIN and b == -1)) {
+                return false;
+            }
+            value = a % b;
+            return true;
+
+        // The code generators do not agree on shifts out of range: the
+        // machine masks the count, where LLVM leaves the result undefined.
+        case ast::Operation::LEFT_SHIFT:
+        case ast::Operation::RIGHT_SHIFT:
+            if (b < 0 or b > 31) {
+                return false;
+            }
+            if (op == ast::Operation::LEFT_SHIFT) {
+                value = wrap(static_cast<std::uint32_t>(a) << b);
+            } else {
+                // Arithmetic, without relying on >> of a negative int.
+                value = a < 0 ? ~(~a >> b) : a >> b;
+            }
+            return true;
+    }
+    return false;
+}
+
+// Whether `node` compares two integer constants, and if so its value.
+bool fold (const ast::Condition& node, bool& value) {
+    if (node.lhs().kind() != ast::Kind::CONST_INTEGER or node.rhs().kind() != ast::Kind::CONST_INTEGER) {
+        return false;
+    }
+    int a = ast::Const_Integer(node.lhs()).value();
+    int b = ast::Const_Integer(node.rhs()).value();
+
+    switch (node.op()) {
+        case ast::Comparison_Operation::EQUAL:                 value = a == b; return true;
+        case ast::Comparison_Operation::NOT_EQUAL:             value = a != b; return true;
+        case ast::Comparison_Operation::LESS_THAN:             value = a <  b; return true;
+        case ast::Comparison_Operation::GREATER_THAN:          value = a >  b; return true;
+        case ast::Comparison_Operation::LESS_THAN_OR_EQUAL:    value = a <= b; return true;
+        case ast::Comparison_Operation::GREATER_THAN_OR_EQUAL: value = a >= b; return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+ast::Function_Definition::Ptr Fold_Constants::run (const ast::Function_Definition::Ptr& node) {
+    Assignment_Counter counter;
+    counter.run(node);
+    assignments_.swap(counter.counts);
+    locals_.clear();
+    constants_.clear();
+    conditional_ = 0;
+
+    return Transform::run(node);
+}
+
+void Fold_Constants::visit (ast::Declaration_List& node) {
+    for (auto& symbol : node.symbol_list()) {
+        locals_.insert(symbol.get());
+    }
+    Transform::visit(node);
+}
+
+void Fold_Constants::visit (ast::Variable& node) {
+    auto constant = constants_.find(node.symbol().get());
+    if (constant == std::end(constants_)) {
+        Transform::visit(node);
+    } else {
+        rewritten_[node] = ast::make<ast::Const_Integer>(constant->second);
+    }
+}
+
+void Fold_Constants::visit (ast::Unary_Expression& node) {
+    Transform::visit(node);
+    ast::Expression& result = rewritten_[node];
+    ast::Expression rhs = ast::Unary_Expression(result).rhs();
+    if (rhs.kind() == ast::Kind::CONST_INTEGER) {
+        result = ast::make<ast::Const_Integer>(
+            wrap(0u - static_cast<std::uint32_t>(ast::Const_Integer(rhs).value())));
+    }
+}
+
+void Fold_Constants::visit (ast::Binary_Expression& node) {
+    Transform::visit(node);
+    if (node.type() != parser::Type::INT) {
+        return;
+    }
+
+    ast::Expression& result = rewritten_[node];
+    ast::Binary_Expression rewritten (result);
+    int value;
+    if (fold(rewritten.op(), rewritten.lhs(), rewritten.rhs(), value)) {
+        result = ast::make<ast::Const_Integer>(value);
+    }
+}
+
+void Fold_Constants::visit (ast::Expression_Instruction& node) {
+    Transform::visit(node);
+
+    // Instructions are rewritten in the order they run. Outside of ifs and
+    // loops, an assignment runs once, before everything rewritten after it:
+    // if it is the only one to its local, they all read its value.
+    ast::Expression expression =
+        std::static_pointer_cast<ast::Expression_Instruction>(results_.back())->expression();
+    if (conditional_ > 0 or expression.kind() != ast::Kind::ASSIGNMENT) {
+        return;
+    }
+    ast::Assignment assignment (expression);
+    const parser::Symbol* symbol = assignment.lhs().symbol().get();
+    if (assignment.rhs().kind() == ast::Kind::CONST_INTEGER and locals_.count(symbol) and
+        assignments_[symbol] == 1) {
+        constants_[symbol] = ast::Const_Integer(assignment.rhs()).value();
+    }
+}
+
+void Fold_Constants::visit (ast::Cond_Instruction& node) {
+    ++conditional_;
+    Transform::visit(node);
+    then([this] {
+        --conditional_;
+        auto instruction = pop_<ast::Cond_Instruction>();
+        bool value;
+        if (not fold(instruction->condition(), value)) {
+            results_.push_back(instruction);
+            return;
+        }
+        auto taken = value ? instruction->instruction() : instruction->else_instruction();
+        results_.push_back(taken ? taken : ast::make<ast::Instruction>());
+    });
+}
+
+void Fold_Constants::visit (ast::While_Instruction& node) {
+    ++conditional_;
+    Transform::visit(node);
+    then([this] {
+        --conditional_;
+        auto instruction = pop_<ast::While_Instruction>();
+        bool value;
+        if (fold(instruction->condition(), value) and not value) {
+            results_.push_back(ast::make<ast::Instruction>());
+        } else {
+            results_.push_back(instruction);
+        }
+    });
+}
+
+void Fold_Constants::visit (ast::Do_Instruction& node) {
+    ++conditional_;
+    Transform::visit(node);
+    then([this] { --conditional_; });
+}
+
+void Fold_Constants::visit (ast::For_Instruction& node) {
+    ++conditional_;
+    Transform::visit(node);
+    then([this] { --conditional_; });
+}
+
+
+// Simplify - member function definitions
+
+// Whether `node` is the integer constant `value`.
+static bool is_constant (const ast::Expression& node, int value) {
+    return node.kind() == ast::Kind::CONST_INTEGER and ast::Const_Integer(node).value() == value;
+}
+
+// The base-2 logarithm of `node` if it is a power of two constant greater
+// than 1 (and positive as an int), otherwise 0.
+static int log2_constant (const ast::Expression& node) {
+    if (node.kind() != ast::Kind::CONST_INTEGER) {
+        return 0;
+    }
+    int value = ast::Const_Integer(node).value();
+    if (value <= 1 or (value & (value - 1)) != 0) {
+        return 0;
+    }
+    int log = 0;
+    while ((1 << log) != value) {
+        ++log;
+    }
+    return log;
+}
+
+void Simplify::visit (ast::Binary_Expression& node) {
+    Transform::visit(node);
+    if (node.type() != parser::Type::INT) {
+        return;
+    }
+
+    ast::Expression& result = rewritten_[node];
+    ast::Binary_Expression rewritten (result);
+    ast::Expression lhs = rewritten.lhs();
+    ast::Expression rhs = rewritten.rhs();
+
+    switch (rewritten.op()) {
+        case ast::Operation::ADDITION:
+            if (is_constant(rhs, 0)) {
+                result = lhs;
+            } else if (is_constant(lhs, 0)) {
+                result = rhs;
+            }
+            break;
+
+        case ast::Operation::SUBTRACTION:
+        case ast::Operation::LEFT_SHIFT:
+        case ast::Operation::RIGHT_SHIFT:
+            if (is_constant(rhs, 0)) {
+                result = lhs;
+            }
+            break;
+
+        // Multiplication wraps around like a shift does.
+        case ast::Operation::MULTIPLICATION:
+            if (is_constant(rhs, 1)) {
+                result = lhs;
+            } else if (is_constant(lhs, 1)) {
+                result = rhs;
+            } else if (int log = log2_constant(rhs)) {
+                result = ast::make<ast::Binary_Expression>(parser::Type::INT,
+                    ast::Operation::LEFT_SHIFT, lhs, ast::make<ast::Const_Integer>(log));
+            } else if (int log = log2_constant(lhs)) {
+                result = ast::make<ast::Binary_Expression>(parser::Type::INT,
+                    ast::Operation::LEFT_SHIFT, rhs, ast::make<ast::Const_Integer>(log));
+            }
+            break;
+
+        case ast::Operation::DIVISION:
+            if (is_constant(rhs, 1)) {
+                result = lhs;
+            }
+            break;
+
+        case ast::Operation::MODULUS:
+            break;
+    }
+}
+
+
+}  // namespace passes
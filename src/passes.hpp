@@ -0,0 +1,198 @@
+#ifndef __CSTR_COMPILER__PASSES_HPP
+#define __CSTR_COMPILER__PASSES_HPP
+
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ast.hpp"
+
+
+namespace passes {
+
+
+// An AST-to-AST transformation of function definitions. Passes never modify
+// the nodes they are given (nodes are shared, e.g. with ast::Module): they
+// return a new tree, which shares the subtrees they left alone, or the
+// definition itself if they changed nothing.
+class Pass {
+  public:
+    virtual ~Pass () {}
+
+    // Name, for --print-after and --time-report.
+    virtual const char* name () const = 0;
+
+    virtual ast::Function_Definition::Ptr run (const ast::Function_Definition::Ptr& node) = 0;
+};
+
+
+// Base of the passes: rebuilds a tree bottom up, without recursing (see
+// ast::Expression::emit_code() and ast::Work_List). Each visit of an
+// expression leaves the rewritten expression in `rewritten_`, and each visit
+// of an instruction pushes the rewritten instruction on `results_`, after
+// those of its children; the default visits rebuild a node only if one of
+// its children changed. Passes override the visits of the nodes they
+// transform.
+class Transform : public Pass, public ast::Code_Generator {
+  public:
+    ast::Function_Definition::Ptr run (const ast::Function_Definition::Ptr& node) override;
+
+    void visit (ast::Declaration_List&       node) override;
+    void visit (ast::Variable&               node) override;
+    void visit (ast::Const_Integer&          node) override;
+    void visit (ast::Const_String&           node) override;
+    void visit (ast::Unary_Expression&       node) override;
+    void visit (ast::Binary_Expression&      node) override;
+    void visit (ast::Condition&              node) override;
+    void visit (ast::Assignment&             node) override;
+    void visit (ast::Function_Call&          node) override;
+    void visit (ast::Instruction&            node) override;
+    void visit (ast::Expression_Instruction& node) override;
+    void visit (ast::Cond_Instruction&       node) override;
+    void visit (ast::While_Instruction&      node) override;
+    void visit (ast::Do_Instruction&         node) override;
+    void visit (ast::For_Instruction&        node) override;
+    void visit (ast::Return_Instruction&     node) override;
+    void visit (ast::Compound_Instruction&   node) override;
+    void visit (ast::Function_Declaration&   node) override;
+    void visit (ast::Function_Definition&    node) override;
+
+  protected:
+    ast::Value_Table<ast::Expression> rewritten_;
+    std::vector<ast::Node::Ptr>       results_;
+
+    // The rewritten `node`, or a null view for a null view.
+    ast::Expression rewrite (const ast::Expression& node);
+    ast::Condition  rewrite (const ast::Condition& node);
+
+    // Rewrites `node` once the visit has returned, pushing the result, or
+    // nullptr for nullptr (the parser leaves empty instructions and blocks
+    // out of the tree).
+    void rewrite (const ast::Instruction::Ptr& node);
+
+    // Runs `step` after the instructions given to rewrite() so far.
+    void then (ast::Work_List::Step step) { work_.then(std::move(step)); }
+
+    template <typename T>
+    std::shared_ptr<T> pop_ () {
+        auto node = std::static_pointer_cast<T>(results_.back());
+        results_.pop_back();
+        return node;
+    }
+
+    // The last `count` results, in order, removed.
+    ast::List<ast::Instruction::Ptr> pop_list_ (std::size_t count);
+};
+
+
+// Pipeline of passes run on each function definition between the parser and
+// a code generator: it forwards every top level node it is given to `next`,
+// function definitions after the passes. Each pass is timed on its own in
+// --time-report.
+class Pass_Manager : public ast::Code_Generator {
+  public:
+    // The passes of optimization level `level` (0 to 2, see pipeline()).
+    // After each pass named `print_after`, the function is printed to
+    // `dump`.
+    Pass_Manager (
+        ast::Code_Generator& next,
+        int level = 0,
+        const std::string& print_after = std::string(),
+        std::ostream& dump = std::cerr
+    );
+
+    void add (std::unique_ptr<Pass> pass) { passes_.push_back(std::move(pass)); }
+
+    // Runs the passes on `node`.
+    ast::Function_Definition::Ptr run (ast::Function_Definition::Ptr node);
+
+    void visit (ast::Declaration_List&     node) override { node.emit_code(next_); }
+    void visit (ast::Function_Declaration& node) override { node.emit_code(next_); }
+    void visit (ast::Function_Definition&  node) override { run(ast::shared(node))->emit_code(next_); }
+
+  private:
+    ast::Code_Generator&               next_;
+    std::vector<std::unique_ptr<Pass>> passes_;
+    std::string                        print_after_;
+    std::ostream&                      dump_;
+};
+
+
+// The passes of optimization level `level`, in order:
+//   -O0  none
+//   -O1  dead-code
+//   -O2  fold-constants, dead-code, simplify
+std::vector<std::unique_ptr<Pass>> pipeline (int level);
+
+// Names of all the passes.
+std::vector<std::string> pass_names ();
+
+// Writes `node` out as source code.
+void print (const ast::Function_Definition::Ptr& node, std::ostream& out);
+
+
+// Removes the instructions that never run: those following a return in the
+// same block, and empty instructions.
+class Dead_Code : public Transform {
+  public:
+    const char* name () const override { return "dead-code"; }
+
+    void visit (ast::Compound_Instruction& node) override;
+};
+
+
+// Evaluates integer arithmetic on constants at compile time, with the 32-bit
+// wraparound of the generated code: Binary_Expression and Unary_Expression
+// nodes whose operands are constants become constants, except divisions and
+// modulus by 0 (or INT_MIN % -1) and shifts by less than 0 or more than 31,
+// which are left to run. A local assigned a constant exactly once, by an instruction
+// outside of any if or loop, is replaced by the constant after that
+// instruction. An if whose condition compares two constants is replaced by
+// the branch taken, and a while whose condition is false by an empty
+// instruction.
+class Fold_Constants : public Transform {
+  public:
+    const char* name () const override { return "fold-constants"; }
+
+    ast::Function_Definition::Ptr run (const ast::Function_Definition::Ptr& node) override;
+
+    void visit (ast::Declaration_List&       node) override;
+    void visit (ast::Variable&               node) override;
+    void visit (ast::Unary_Expression&       node) override;
+    void visit (ast::Binary_Expression&      node) override;
+    void visit (ast::Expression_Instruction& node) override;
+    void visit (ast::Cond_Instruction&       node) override;
+    void visit (ast::While_Instruction&      node) override;
+    void visit (ast::Do_Instruction&         node) override;
+    void visit (ast::For_Instruction&        node) override;
+
+  private:
+    // Number of assignments to each symbol in the definition.
+    std::unordered_map<const parser::Symbol*, int> assignments_;
+    // Locals declared so far, and the constants known to be in some of them.
+    std::unordered_set<const parser::Symbol*>      locals_;
+    std::unordered_map<const parser::Symbol*, int> constants_;
+    // Number of ifs and loops the instruction being rewritten is in.
+    int conditional_ = 0;
+};
+
+
+// Algebraic simplifications of integer arithmetic by a constant: drops
+// additions, subtractions and shifts of 0 and multiplications and divisions
+// by 1, and turns multiplications by a power of two into left shifts.
+class Simplify : public Transform {
+  public:
+    const char* name () const override { return "simplify"; }
+
+    void visit (ast::Binary_Expression& node) override;
+};
+
+
+}  // namespace passes
+
+
+#endif  // __CSTR_COMPILER__PASSES_HPP
@@ -10,6 +10,35 @@
 #define yyFlexLexer PreprocessorFlexLexer
 #include <FlexLexer.h>
 
+#include <cstddef>
+
+#include <iostream>
+
+
+namespace preprocessor {
+
+class Preprocessor : public PreprocessorFlexLexer {
+  public:
+    Preprocessor (
+        std::istream* arg_yyin = nullptr,
+        std::ostream* arg_yyout = nullptr
+    ) : PreprocessorFlexLexer(arg_yyin, arg_yyout) {}
+
+    virtual ~Preprocessor () {}
+
+    // Preprocess the `size` bytes at `text` in place, like
+    // scanner::Scanner::scan_in_place. Macro expansions are pushed back in
+    // front of the current position, so `slack` writable bytes must precede
+    // `text` as well. Throws std::runtime_error if a line is longer than the
+    // scanner can match (which reading from a stream would fail on, too).
+    void scan_in_place (char* text, std::size_t size, std::size_t slack);
+
+    // Push-back room to reserve in front of the text (see
+    // input::Mapped_File).
+    static const std::size_t kSlack = 64 * 1024;
+};
+
+}  // namespace preprocessor
 
 
 #endif  // __CSTR_COMPILER__PREPROCESSOR_HPP
@@ -0,0 +1,33 @@
+#include "preprocessor.hpp"
+
+#include <exception>
+#include <iostream>
+#include <memory>
+
+#include "mapped_file.hpp"
+
+
+// usage: preprocessor [input.c]
+//
+// Preprocesses the standard input, or `input.c` mapped into memory, to the
+// standard output.
+int main (int argc, char* argv[]) {
+    if (argc > 2) {
+        std::cerr << "usage: " << argv[0] << " [input.c]" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<input::Mapped_File> file;
+    preprocessor::Preprocessor pp;
+    try {
+        if (argc == 2) {
+            file.reset(new input::Mapped_File(argv[1], preprocessor::Preprocessor::kSlack));
+            pp.scan_in_place(file->text(), file->size(), file->slack());
+        }
+        pp.yylex();
+    } catch (const std::exception& e) {
+        std::cerr << (argc == 2 ? argv[1] : "<stdin>") << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
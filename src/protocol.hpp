@@ -0,0 +1,91 @@
+#ifndef __CSTR_COMPILER__PROTOCOL_HPP
+#define __CSTR_COMPILER__PROTOCOL_HPP
+
+
+// Wire format between `compiler --serve` and bin/client, over a Unix domain
+// stream socket. Kept free of iostreams so that the client stays small.
+//
+// Request:   "cstr <command>\n" <source text up to the end of the stream>
+//
+//            command is one of
+//                compile             compile the source as is
+//                compile-preprocess  run the preprocessor on it first
+//                shutdown            stop the server (no source)
+//
+// Response:  "<status> <diagnostics length>\n" <diagnostics> <LLVM IR>
+//
+//            status is the exit status of the compilation, diagnostics the
+//            text the client should print to stderr.
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+
+#include <string>
+
+
+namespace protocol {
+
+
+const char kMagic[] = "cstr";
+
+const char kCompile[]           = "compile";
+const char kCompilePreprocess[] = "compile-preprocess";
+const char kShutdown[]          = "shutdown";
+
+
+// Socket used when none is given: one per user, in the temporary directory.
+inline std::string default_socket_path () {
+    const char* tmpdir = std::getenv("TMPDIR");
+    return std::string(tmpdir && *tmpdir ? tmpdir : "/tmp")
+        + "/cstr-compiler-" + std::to_string(getuid()) + ".sock";
+}
+
+
+// Writes all of `size` bytes. Returns false on error. Uses send() rather than
+// write() so that a client hanging up does not raise SIGPIPE.
+inline bool write_all (int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 and errno == ENOTSOCK) {
+            n = write(fd, data, size);
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Appends everything up to the end of the stream to `out`. Returns false on
+// error.
+inline bool read_all (int fd, std::string& out) {
+    char buffer[64 * 1024];
+    for (;;) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n == 0) {
+            return true;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        out.append(buffer, n);
+    }
+}
+
+
+}  // namespace protocol
+
+
+#endif  // __CSTR_COMPILER__PROTOCOL_HPP
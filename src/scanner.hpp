@@ -35,6 +35,13 @@ class Scanner : public ScannerFlexLexer {
 
     virtual ~Scanner () {}
 
+    // Scan the `size` bytes at `text` in place instead of reading from the
+    // input stream, without copying them into a buffer of Flex's. text[size]
+    // and text[size + 1] must be NUL, and the text writable: Flex terminates
+    // each token with a NUL while it is current. (input::Mapped_File lays out
+    // files that way.)
+    void scan_in_place (char* text, std::size_t size);
+
     // This is the main function generated by Flex in the scanner.yy.cpp file.
     // Its signature is specified in the macro YY_DECL above.
     parser::Parser::token_type lex (
@@ -0,0 +1,192 @@
+#include "server.hpp"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "driver.hpp"
+#include "protocol.hpp"
+
+
+namespace server {
+
+
+// Closes a file descriptor when going out of scope.
+class File_Descriptor {
+  public:
+    explicit File_Descriptor (int fd) : fd_(fd) {}
+    ~File_Descriptor () { if (fd_ >= 0) close(fd_); }
+
+    File_Descriptor             (const File_Descriptor&) = delete;
+    File_Descriptor& operator = (const File_Descriptor&) = delete;
+
+    int get () const { return fd_; }
+
+  private:
+    int fd_;
+};
+
+
+// Handles the request on `connection`. Returns false once the server should
+// stop.
+static bool handle (int connection, const driver::Options& server_options) {
+    std::string request;
+    if (not protocol::read_all(connection, request)) {
+        std::cerr << "server: cannot read request: " << std::strerror(errno) << std::endl;
+        return true;
+    }
+    // A connection closed without a request, e.g. by another server checking
+    // whether this one is running.
+    if (request.empty()) {
+        return true;
+    }
+
+    // Split off the header line.
+    std::string::size_type end_of_header = request.find('\n');
+    std::string header = request.substr(0, end_of_header);
+    std::string::size_type source_start =
+        end_of_header == std::string::npos ? request.size() : end_of_header + 1;
+
+    std::string magic = std::string(protocol::kMagic) + ' ';
+    std::string command = header.compare(0, magic.size(), magic) == 0
+        ? header.substr(magic.size()) : std::string();
+
+    if (command == protocol::kShutdown) {
+        return false;
+    }
+
+    int status = 1;
+    std::string diagnostics;
+    std::ostringstream ir;
+
+    if (command == protocol::kCompile or command == protocol::kCompilePreprocess) {
+        driver::Options options = server_options;
+        options.preprocess = command == protocol::kCompilePreprocess;
+
+        // The IR is sent back in one piece, so there is no point flushing it
+        // any earlier.
+        options.flush_policy = output::Flush_Policy::EXPLICIT;
+
+        std::istringstream source (request.substr(source_start));
+        request.clear();
+
+        try {
+            status = driver::compile(source, ir, options, "<request>");
+            if (status != 0) {
+                diagnostics = "compilation failed\n";
+            }
+        } catch (const std::exception& e) {
+            status = 1;
+            diagnostics = std::string(e.what()) + '\n';
+        }
+    } else {
+        diagnostics = "malformed request '" + header + "'\n";
+    }
+
+    std::string ir_text = ir.str();
+    std::string response =
+        std::to_string(status) + ' ' + std::to_string(diagnostics.size()) + '\n'
+        + diagnostics;
+    if (not protocol::write_all(connection, response.data(), response.size()) or
+        not protocol::write_all(connection, ir_text.data(), ir_text.size())) {
+        std::cerr << "server: cannot send response: " << std::strerror(errno) << std::endl;
+    }
+
+    return true;
+}
+
+
+// Removes the socket at `address` left by a server that did not shut down
+// cleanly, so that it can be bound again. Leaves anything else alone: a file
+// that is not a socket, or the socket of a server still running. Returns
+// false if the path cannot be used.
+static bool remove_stale_socket (const sockaddr_un& address) {
+    const char* path = address.sun_path;
+    struct stat status;
+    if (lstat(path, &status) < 0) {
+        if (errno == ENOENT) {
+            return true;
+        }
+        std::cerr << "server: " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (not S_ISSOCK(status.st_mode)) {
+        std::cerr << "server: " << path << ": not a socket" << std::endl;
+        return false;
+    }
+
+    File_Descriptor probe (socket(AF_UNIX, SOCK_STREAM, 0));
+    if (probe.get() < 0) {
+        std::cerr << "server: socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (connect(probe.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0) {
+        std::cerr << "server: " << path << ": socket in use" << std::endl;
+        return false;
+    }
+    if (errno != ECONNREFUSED) {
+        std::cerr << "server: " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (unlink(path) < 0 and errno != ENOENT) {
+        std::cerr << "server: " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int serve (const std::string& socket_path, const driver::Options& options) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "server: socket path too long: " << socket_path << std::endl;
+        return 1;
+    }
+    std::strcpy(address.sun_path, socket_path.c_str());
+
+    File_Descriptor listener (socket(AF_UNIX, SOCK_STREAM, 0));
+    if (listener.get() < 0) {
+        std::cerr << "server: socket: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    if (not remove_stale_socket(address)) {
+        return 1;
+    }
+    if (bind(listener.get(), reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 or
+        listen(listener.get(), 16) < 0) {
+        std::cerr << "server: " << socket_path << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::cerr << "server: listening on " << socket_path << std::endl;
+
+    bool running = true;
+    while (running) {
+        File_Descriptor connection (accept(listener.get(), nullptr, nullptr));
+        if (connection.get() < 0) {
+            if (errno == EINTR or errno == ECONNABORTED) {
+                continue;
+            }
+            std::cerr << "server: accept: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        running = handle(connection.get(), options);
+    }
+
+    unlink(socket_path.c_str());
+    return running ? 1 : 0;
+}
+
+
+}  // namespace server
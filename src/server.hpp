@@ -0,0 +1,26 @@
+#ifndef __CSTR_COMPILER__SERVER_HPP
+#define __CSTR_COMPILER__SERVER_HPP
+
+
+#include <string>
+
+#include "driver.hpp"
+
+
+namespace server {
+
+
+// Listen on the Unix domain socket `socket_path` and compile every request
+// received on it (see protocol.hpp), one at a time, until a shutdown request
+// arrives. Each request is compiled by driver::compile(), so it gets its own
+// symbol tables and code generator; whatever outlives a request lives in the
+// server process. A socket left at `socket_path` by a server that is no
+// longer running is replaced; anything else there (a running server, a file
+// that is not a socket) makes it fail. Returns the exit status of the server.
+int serve (const std::string& socket_path, const driver::Options& options);
+
+
+}  // namespace server
+
+
+#endif  // __CSTR_COMPILER__SERVER_HPP
@@ -0,0 +1,320 @@
+#include "stats.hpp"
+
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "ast.hpp"
+
+
+namespace stats {
+
+
+thread_local Report* current_report = nullptr;
+
+
+static const char* phase_name (Phase phase) {
+    switch (phase) {
+        case Phase::PREPROCESSING:   return "preprocessing";
+        case Phase::LOADING:         return "loading";
+        case Phase::SCANNING:        return "scanning";
+        case Phase::PARSING:         return "parsing";
+        case Phase::SEMANTIC_CHECKS: return "semantic checks";
+        case Phase::OPTIMIZATION:    return "optimization";
+        case Phase::CODE_GENERATION: return "code generation";
+        default:                     return "(unknown)";
+    }
+}
+
+static const char* counter_name (Counter counter) {
+    switch (counter) {
+        case Counter::TOKENS:         return "tokens";
+        case Counter::SYMBOLS_ADDED:  return "symbols added";
+        case Counter::SYMBOL_LOOKUPS: return "symbol lookups";
+        case Counter::BYTES_EMITTED:  return "bytes emitted";
+        case Counter::CACHE_HITS:     return "IR cache hits";
+        case Counter::CACHE_MISSES:   return "IR cache misses";
+        default:                      return "(unknown)";
+    }
+}
+
+static const char* pool_name (Pool pool) {
+    switch (pool) {
+        case Pool::AST:             return "AST";
+        case Pool::SYMBOL_TABLES:   return "symbol tables";
+        case Pool::CODEGEN:         return "code generation";
+        case Pool::SEMANTIC_VALUES: return "semantic values";
+        default:                    return "(unknown)";
+    }
+}
+
+static double wall_clock () {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// CPU time of the calling thread, so that concurrent compilations (-j) are
+// not charged for each other.
+static double cpu_clock () {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+// Report - member function definitions
+
+Report::Report ()
+      : codegen_(static_cast<std::size_t>(ast::Kind::kSize)),
+        counters_(),
+        nodes_(static_cast<std::size_t>(ast::Kind::kSize), 0) {}
+
+const Timing& Report::timing (Phase phase) const {
+    return phases_[static_cast<std::size_t>(phase)];
+}
+
+std::size_t Report::counter (Counter counter) const {
+    return counters_[static_cast<std::size_t>(counter)];
+}
+
+const Timing& Report::pass_timing (const std::string& pass) const {
+    static const Timing kNever;
+    for (auto& timing : passes_) {
+        if (timing.first == pass) {
+            return timing.second;
+        }
+    }
+    return kNever;
+}
+
+// The timing of `pass`, added on its first run. Passes are few: a linear
+// search is enough.
+Timing* Report::pass_ (const char* pass) {
+    for (auto& timing : passes_) {
+        if (timing.first == pass) {
+            return &timing.second;
+        }
+    }
+    passes_.emplace_back(pass, Timing());
+    return &passes_.back().second;
+}
+
+void Report::add_counters (const Report& other) {
+    for (std::size_t i = 0; i < static_cast<std::size_t>(Counter::kSize); ++i) {
+        counters_[i] += other.counters_[i];
+    }
+}
+
+void Report::start_ (Timing* timing) {
+    double wall = wall_clock();
+    double cpu = cpu_clock();
+
+    // Pause the enclosing phase.
+    if (not running_.empty()) {
+        Running& outer = running_.back();
+        outer.timing->wall += wall - outer.wall_start;
+        outer.timing->cpu  += cpu  - outer.cpu_start;
+    }
+
+    running_.push_back(Running {timing, wall, cpu});
+}
+
+void Report::stop_ () {
+    double wall = wall_clock();
+    double cpu = cpu_clock();
+
+    Running& inner = running_.back();
+    inner.timing->wall += wall - inner.wall_start;
+    inner.timing->cpu  += cpu  - inner.cpu_start;
+    running_.pop_back();
+
+    // Resume the enclosing phase.
+    if (not running_.empty()) {
+        running_.back().wall_start = wall;
+        running_.back().cpu_start  = cpu;
+    }
+}
+
+void Report::print_times (std::ostream& out, const std::string& title) const {
+    // Format into a string first so that reports of concurrent compilations
+    // do not interleave.
+    std::ostringstream oss;
+    char line[128];
+
+    Timing codegen = timing(Phase::CODE_GENERATION);
+    for (auto& t : codegen_) {
+        codegen.wall += t.wall;
+        codegen.cpu  += t.cpu;
+    }
+    Timing optimization = timing(Phase::OPTIMIZATION);
+    for (auto& t : passes_) {
+        optimization.wall += t.second.wall;
+        optimization.cpu  += t.second.cpu;
+    }
+    auto phase_timing = [&] (Phase phase) -> const Timing& {
+        switch (phase) {
+            case Phase::CODE_GENERATION: return codegen;
+            case Phase::OPTIMIZATION:    return optimization;
+            default:                     return phases_[static_cast<std::size_t>(phase)];
+        }
+    };
+
+    Timing total;
+    for (std::size_t i = 0; i < static_cast<std::size_t>(Phase::kSize); ++i) {
+        const Timing& t = phase_timing(static_cast<Phase>(i));
+        total.wall += t.wall;
+        total.cpu  += t.cpu;
+    }
+
+    oss << "===--- time report: " << title << " ---===" << std::endl;
+    std::snprintf(line, sizeof(line), "  %-28s %12s %12s\n", "phase", "wall (ms)", "cpu (ms)");
+    oss << line;
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(Phase::kSize); ++i) {
+        Phase phase = static_cast<Phase>(i);
+        const Timing& t = phase_timing(phase);
+        std::snprintf(line, sizeof(line), "  %-28s %12.3f %12.3f\n",
+            phase_name(phase), t.wall * 1e3, t.cpu * 1e3);
+        oss << line;
+
+        // Break optimization down by pass, in the order they first ran.
+        if (phase == Phase::OPTIMIZATION) {
+            for (auto& p : passes_) {
+                std::snprintf(line, sizeof(line), "    %-26s %12.3f %12.3f\n",
+                    p.first.c_str(), p.second.wall * 1e3, p.second.cpu * 1e3);
+                oss << line;
+            }
+        }
+
+        // Break code generation down by LLVM_Generator::visit family.
+        if (phase == Phase::CODE_GENERATION) {
+            for (std::size_t kind = 0; kind < codegen_.size(); ++kind) {
+                const Timing& k = codegen_[kind];
+                if (k.wall == 0.0 and k.cpu == 0.0) {
+                    continue;
+                }
+                std::snprintf(line, sizeof(line), "    %-26s %12.3f %12.3f\n",
+                    ast::kind_name(static_cast<ast::Kind>(kind)), k.wall * 1e3, k.cpu * 1e3);
+                oss << line;
+            }
+        }
+    }
+    std::snprintf(line, sizeof(line), "  %-28s %12.3f %12.3f\n", "total", total.wall * 1e3, total.cpu * 1e3);
+    oss << line << std::endl;
+
+    std::snprintf(line, sizeof(line), "  %-28s %12s\n", "counter", "value");
+    oss << line;
+    for (std::size_t i = 0; i < static_cast<std::size_t>(Counter::kSize); ++i) {
+        std::snprintf(line, sizeof(line), "  %-28s %12zu\n",
+            counter_name(static_cast<Counter>(i)), counters_[i]);
+        oss << line;
+    }
+
+    std::size_t total_nodes = 0;
+    for (auto n : nodes_) {
+        total_nodes += n;
+    }
+    std::snprintf(line, sizeof(line), "  %-28s %12zu\n", "AST nodes", total_nodes);
+    oss << line;
+    for (std::size_t kind = 0; kind < nodes_.size(); ++kind) {
+        if (nodes_[kind] == 0) {
+            continue;
+        }
+        std::snprintf(line, sizeof(line), "    %-26s %12zu\n",
+            ast::kind_name(static_cast<ast::Kind>(kind)), nodes_[kind]);
+        oss << line;
+    }
+
+    out << oss.str() << std::flush;
+}
+
+void Report::print_memory (std::ostream& out, const std::string& title) const {
+    std::ostringstream oss;
+    char line[128];
+
+    oss << "===--- memory report: " << title << " ---===" << std::endl;
+    std::snprintf(line, sizeof(line), "  %-28s %12s %12s %12s\n", "pool", "live (KiB)", "peak (KiB)", "allocations");
+    oss << line;
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(Pool::kSize); ++i) {
+        const Memory& m = pools_[i];
+        std::snprintf(line, sizeof(line), "  %-28s %12.1f %12.1f %12zu\n",
+            pool_name(static_cast<Pool>(i)), m.live / 1024.0, m.peak / 1024.0, m.allocations);
+        oss << line;
+    }
+
+    // The pools do not peak at the same time, so the total peak is tracked on
+    // its own rather than summed.
+    std::snprintf(line, sizeof(line), "  %-28s %12.1f %12.1f %12zu\n",
+        "total", total_memory_.live / 1024.0, total_memory_.peak / 1024.0, total_memory_.allocations);
+    oss << line << std::endl;
+
+    out << oss.str() << std::flush;
+}
+
+
+void* allocate (Pool pool, std::size_t size) {
+    charge(pool, size);
+    return ::operator new(size);
+}
+
+void deallocate (Pool pool, void* p, std::size_t size) {
+    discharge(pool, size);
+    ::operator delete(p);
+}
+
+void charge (Pool pool, std::size_t size) {
+    if (Report* report = current()) {
+        Memory& m = report->pools_[static_cast<std::size_t>(pool)];
+        m.live += size;
+        m.peak = std::max(m.peak, m.live);
+        ++m.allocations;
+
+        Memory& total = report->total_memory_;
+        total.live += size;
+        total.peak = std::max(total.peak, total.live);
+        ++total.allocations;
+    }
+}
+
+void discharge (Pool pool, std::size_t size) {
+    if (Report* report = current()) {
+        report->pools_[static_cast<std::size_t>(pool)].live -= size;
+        report->total_memory_.live -= size;
+    }
+}
+
+
+// Phase_Timer - member function definitions
+
+Phase_Timer::Phase_Timer (Phase phase) : report_(current()) {
+    if (report_) {
+        report_->start_(&report_->phases_[static_cast<std::size_t>(phase)]);
+    }
+}
+
+Phase_Timer::Phase_Timer (ast::Kind kind) : report_(current()) {
+    if (report_) {
+        report_->start_(&report_->codegen_[static_cast<std::size_t>(kind)]);
+    }
+}
+
+Phase_Timer::Phase_Timer (const char* pass) : report_(current()) {
+    if (report_) {
+        report_->start_(report_->pass_(pass));
+    }
+}
+
+Phase_Timer::~Phase_Timer () {
+    if (report_) {
+        report_->stop_();
+    }
+}
+
+
+}  // namespace stats
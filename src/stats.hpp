@@ -0,0 +1,245 @@
+#ifndef __CSTR_COMPILER__STATS_HPP
+#define __CSTR_COMPILER__STATS_HPP
+
+
+#include <cstddef>
+
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+
+namespace ast {
+enum class Kind : std::size_t;
+}  // namespace ast
+
+
+namespace stats {
+
+
+// Phases of a compilation, as reported by --time-report.
+enum class Phase : std::size_t {
+    PREPROCESSING,
+    LOADING,
+    SCANNING,
+    PARSING,
+    SEMANTIC_CHECKS,
+    OPTIMIZATION,
+    CODE_GENERATION,
+    kSize
+};
+
+enum class Counter : std::size_t {
+    TOKENS,
+    SYMBOLS_ADDED,
+    SYMBOL_LOOKUPS,
+    BYTES_EMITTED,
+    CACHE_HITS,
+    CACHE_MISSES,
+    kSize
+};
+
+
+// Owners of heap memory, as reported by --mem-report.
+enum class Pool : std::size_t {
+    AST,
+    SYMBOL_TABLES,
+    CODEGEN,
+    SEMANTIC_VALUES,
+    kSize
+};
+
+
+// Time spent in a phase, in seconds.
+struct Timing {
+    double wall = 0.0;
+    double cpu  = 0.0;
+};
+
+
+// Heap usage of a pool, in bytes.
+struct Memory {
+    long long   live        = 0;
+    long long   peak        = 0;
+    std::size_t allocations = 0;
+};
+
+
+// Timings, counters and heap usage of one compilation.
+//
+// Phases nest (the parser drives the scanner and the code generator), and
+// each one is only charged for the time spent in it exclusively: while a
+// nested phase runs, the enclosing one is paused.
+class Report {
+  public:
+    Report ();
+
+    const Timing& timing      (Phase phase)            const;
+    const Timing& timing      (ast::Kind kind)         const { return codegen_[static_cast<std::size_t>(kind)]; }
+    const Timing& pass_timing (const std::string& pass) const;
+    std::size_t   counter     (Counter counter)        const;
+    std::size_t   node_count  (ast::Kind kind)         const { return nodes_[static_cast<std::size_t>(kind)]; }
+    const Memory& memory      (Pool pool)              const { return pools_[static_cast<std::size_t>(pool)]; }
+    const Memory& memory      ()                       const { return total_memory_; }
+
+    // Adds the counters of `other` to those of this report, e.g. those of
+    // work done for this compilation on another thread.
+    void add_counters (const Report& other);
+
+    void print_times  (std::ostream& out, const std::string& title) const;
+    void print_memory (std::ostream& out, const std::string& title) const;
+
+  private:
+    friend class Phase_Timer;
+    friend void count (Counter counter, std::size_t n);
+    friend void count_node (ast::Kind kind);
+    friend void charge (Pool pool, std::size_t size);
+    friend void discharge (Pool pool, std::size_t size);
+
+    struct Running {
+        Timing* timing;
+        double wall_start;
+        double cpu_start;
+    };
+
+    Timing phases_[static_cast<std::size_t>(Phase::kSize)];
+    std::vector<Timing> codegen_;   // Code generation, by AST node kind.
+    std::deque<std::pair<std::string, Timing>> passes_;  // Optimization, by pass.
+
+    std::size_t counters_[static_cast<std::size_t>(Counter::kSize)];
+    std::vector<std::size_t> nodes_;  // AST nodes created, by node kind.
+
+    std::vector<Running> running_;
+
+    Memory pools_[static_cast<std::size_t>(Pool::kSize)];
+    Memory total_memory_;
+
+    void start_ (Timing* timing);
+    void stop_ ();
+
+    Timing* pass_ (const char* pass);
+};
+
+
+// The report of the compilation running on this thread, or nullptr if no
+// report was requested.
+extern thread_local Report* current_report;
+
+inline Report* current () { return current_report; }
+
+
+// Makes `report` the current report of this thread for the lifetime of the
+// scope.
+class Scope {
+  public:
+    explicit Scope (Report* report) : previous_(current_report) {
+        current_report = report;
+    }
+    ~Scope () { current_report = previous_; }
+
+  private:
+    Report* previous_;
+};
+
+
+// Charges the time until its destruction to a phase of the current report.
+// Does nothing if there is no current report.
+class Phase_Timer {
+  public:
+    explicit Phase_Timer (Phase phase);
+
+    // Code generation for one class of AST node.
+    explicit Phase_Timer (ast::Kind kind);
+
+    // Optimization by one pass (see passes::Pass).
+    explicit Phase_Timer (const char* pass);
+
+    ~Phase_Timer ();
+
+    Phase_Timer             (const Phase_Timer&) = delete;
+    Phase_Timer& operator = (const Phase_Timer&) = delete;
+
+  private:
+    Report* report_;
+};
+
+
+inline void count (Counter counter, std::size_t n = 1) {
+    if (Report* report = current()) {
+        report->counters_[static_cast<std::size_t>(counter)] += n;
+    }
+}
+
+inline void count_node (ast::Kind kind) {
+    if (Report* report = current()) {
+        ++report->nodes_[static_cast<std::size_t>(kind)];
+    }
+}
+
+
+// Heap memory charged to `pool` of the current report, if there is one.
+// Memory must be released to the same pool, with the same size, on the same
+// thread.
+void* allocate (Pool pool, std::size_t size);
+void  deallocate (Pool pool, void* p, std::size_t size);
+
+// Charges (or discharges) `size` bytes to `pool` without allocating them, for
+// memory obtained elsewhere (see arena::Arena). Same rules as above.
+void charge    (Pool pool, std::size_t size);
+void discharge (Pool pool, std::size_t size);
+
+
+// Standard allocator charging the memory of a container (or, through
+// std::allocate_shared, of a node) to `pool`.
+template <typename T, Pool pool>
+class Allocator {
+  public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind { typedef Allocator<U, pool> other; };
+
+    Allocator () {}
+
+    template <typename U>
+    Allocator (const Allocator<U, pool>&) {}
+
+    T* allocate (std::size_t n) {
+        return static_cast<T*>(stats::allocate(pool, n * sizeof(T)));
+    }
+
+    void deallocate (T* p, std::size_t n) {
+        stats::deallocate(pool, p, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U, Pool pool>
+bool operator == (const Allocator<T, pool>&, const Allocator<U, pool>&) { return true; }
+
+template <typename T, typename U, Pool pool>
+bool operator != (const Allocator<T, pool>&, const Allocator<U, pool>&) { return false; }
+
+// Standard containers charging their memory to `pool`.
+template <typename Key, typename Value, Pool pool>
+using Map = std::unordered_map<
+    Key, Value, std::hash<Key>, std::equal_to<Key>,
+    Allocator<std::pair<const Key, Value>, pool>
+>;
+template <typename Key, Pool pool>
+using Set = std::unordered_set<
+    Key, std::hash<Key>, std::equal_to<Key>,
+    Allocator<Key, pool>
+>;
+template <typename T, Pool pool>
+using Vector = std::vector<T, Allocator<T, pool>>;
+
+
+}  // namespace stats
+
+
+#endif  // __CSTR_COMPILER__STATS_HPP
@@ -12,6 +12,10 @@
 #include <utility>
 #include <vector>
 
+#include "arena.hpp"
+#include "atom.hpp"
+#include "stats.hpp"
+
 
 namespace parser {
 
@@ -33,15 +37,18 @@ class Symbol {
         kSize
     };
 
-    Symbol (std::string&& name) : name_(std::move(name)), access_count_(0) {}
+    Symbol (atom::Atom name) : name_(name), access_count_(0) {}
+    Symbol (const std::string& name) : Symbol(atom::intern(name)) {}
     virtual ~Symbol() {}
 
-    const std::string& name             () const { return name_; }
+    const std::string& name             () const { return name_.str(); }
+    atom::Atom         atom             () const { return name_; }
     const Type         type             () const { return type_; }
     const int          access_count () const { return access_count_; }
 
-    void name (std::string&& value) { name_ = std::move(value); }
+    void name (atom::Atom    value) { name_ = value; }
     void type (Type          value) { type_ = value; }
+    void access_count (int   value) { access_count_ = value; }
     void increment_access_count () { ++access_count_; }
 
     virtual std::string type_str () const { return type_ == Type::INT ? "int" : "string"; }
@@ -66,7 +73,7 @@ class Symbol {
     // }
 
   protected:
-    std::string name_;
+    atom::Atom name_;
     Type type_;
     int access_count_;
 
@@ -77,9 +84,12 @@ class Symbol {
 class Function : public Symbol {
   public:
     typedef std::shared_ptr<Function> Ptr;
-    typedef std::vector<Symbol::Ptr> Argument_List;
+    typedef std::vector<
+        Symbol::Ptr, stats::Allocator<Symbol::Ptr, stats::Pool::SYMBOL_TABLES>
+    > Argument_List;
 
-    Function (std::string&& name) : Symbol(std::move(name)) {}
+    Function (atom::Atom name) : Symbol(name) {}
+    Function (const std::string& name) : Symbol(name) {}
 
     virtual std::string type_str () const {
         std::ostringstream oss;
@@ -102,7 +112,20 @@ class Function : public Symbol {
 };
 
 
-typedef std::vector<Symbol::Ptr> Symbol_List;
+// Lists of symbols built up by the grammar actions.
+typedef std::vector<
+    Symbol::Ptr, stats::Allocator<Symbol::Ptr, stats::Pool::SEMANTIC_VALUES>
+> Symbol_List;
+
+
+// Creates a symbol (or function), charging its memory to the symbol tables in
+// the current stats::Report. Symbols local to a function definition are
+// placed in its arena::Arena.
+template <typename T>
+std::shared_ptr<T> make_symbol (atom::Atom name) {
+    return std::allocate_shared<T>(
+        arena::Allocator<T, stats::Pool::SYMBOL_TABLES>(), name);
+}
 
 
 }  // namespace parser
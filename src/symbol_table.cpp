@@ -1,4 +1,3 @@
-
 #include "symbol_table.hpp"
 
 #include <iomanip>
@@ -7,81 +6,113 @@
 #include <string>
 #include <utility>
 
+#include "atom.hpp"
 #include "location.hh"
+#include "stats.hpp"
 #include "symbol.hpp"
 
 
 namespace parser {
 
 
-// static
+const std::size_t Symbol_Table::kNone;
+const std::size_t Symbol_Table::kDeadNames;
 
-std::vector<Symbol_Table::Ptr> Symbol_Table::all_tables_ = std::vector<Symbol_Table::Ptr>();
 
-void Symbol_Table::print_tables () {
-    for (auto& symbol_table : all_tables_) {
-        std::cout
-            << symbol_table->name() << std::endl
-            << "    start: " << symbol_table->loc.begin << std::endl
-            << "    end:   " << symbol_table->loc.end   << std::endl
-            << std::endl
-            << "  name               | type                      | attributes" << std::endl
-            //  <-      20        -> | <-         25          -> |
-            << "---------------------+---------------------------+-----------------------" << std::endl
-            ;
-        for (auto& pair : symbol_table->table_) {
-            Symbol::Ptr symbol = pair.second;
-            std::cout
-                << std::left << std::setw(20) << symbol->name() << " | "
-                << std::left << std::setw(25) << symbol->type_str() << " | "
-                ;
+Symbol_Table::Ptr Symbol_Table::construct (std::string&& name, const location& arg_loc) {
+    return Ptr(new Symbol_Table(std::move(name), arg_loc));
+}
 
-            if (symbol->get(Symbol::Attribute::EXTERN))
-                std::cout << "extern";
-            if (symbol->get(Symbol::Attribute::FUNCTION_PARAM))
-                std::cout << "function parameter";
+Symbol_Table::Symbol_Table (std::string&& name, const location& arg_loc) {
+    push(std::move(name), arg_loc);
+}
 
-            std::cout << std::endl;
-        }
 
-        std::cout << std::endl;
+void Symbol_Table::push (std::string&& name, const location& arg_loc) {
+    scopes_.push_back(Scope {std::move(name), arg_loc, bindings_.size()});
+}
+
+void Symbol_Table::pop () {
+    std::size_t first = scopes_.back().first;
+    for (std::size_t i = bindings_.size(); i-- > first; ) {
+        innermost_[bindings_[i].name] = bindings_[i].shadowed;
+    }
+    bindings_.erase(std::begin(bindings_) + first, std::end(bindings_));
+    scopes_.pop_back();
+
+    // Back in the global scope, forget the names bound only by the functions
+    // parsed so far, if there are many: the table stays as large as the
+    // globals and the largest function, not the whole translation unit.
+    if (scopes_.size() == 1 and innermost_.size() > 2 * bindings_.size() + kDeadNames) {
+        for (auto iter = std::begin(innermost_); iter != std::end(innermost_); ) {
+            if (iter->second == kNone) {
+                iter = innermost_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
     }
 }
 
+// Every probe counts as one symbol lookup.
 
-Symbol_Table::Symbol_Table (std::string&& name, const location& arg_loc)
-      : Symbol_Table(std::move(name), arg_loc, nullptr) {}
+bool Symbol_Table::is_in_this_scope (atom::Atom name) {
+    stats::count(stats::Counter::SYMBOL_LOOKUPS);
+    auto iter = innermost_.find(name);
+    return iter != std::end(innermost_)
+        and iter->second != kNone
+        and iter->second >= scopes_.back().first;
+}
 
-Symbol_Table::Symbol_Table (
-    std::string&& name,
-    const location& arg_loc,
-    Symbol_Table::Ptr parent
-)
-      : loc(arg_loc), name_(std::move(name)), parent_(parent) {}
+Symbol::Ptr Symbol_Table::lookup (atom::Atom name) {
+    stats::count(stats::Counter::SYMBOL_LOOKUPS);
+    auto iter = innermost_.find(name);
+    if (iter == std::end(innermost_) or iter->second == kNone)
+        return nullptr;
+    return bindings_[iter->second].symbol;
+}
 
-bool Symbol_Table::is_in_this_scope (const std::string& name) {
-    return table_.find(name) != std::end(table_);
+void Symbol_Table::add (atom::Atom name, Symbol::Ptr symbol) {
+    stats::count(stats::Counter::SYMBOLS_ADDED);
+    auto result = innermost_.emplace(name, kNone);
+    std::size_t& innermost = result.first->second;
+    if (innermost != kNone and innermost >= scopes_.back().first) {
+        return;
+    }
+    bindings_.push_back(Binding {name, std::move(symbol), innermost});
+    innermost = bindings_.size() - 1;
 }
 
-bool Symbol_Table::is_visible (const std::string& name) {
-    if (is_in_this_scope(name))
-        return true;
 
-    if (parent_ == nullptr)
-        return false;
+void Symbol_Table::print (std::ostream& out) const {
+    for (std::size_t s = 0; s < scopes_.size(); ++s) {
+        const Scope& scope = scopes_[s];
+        std::size_t end = s + 1 < scopes_.size() ? scopes_[s + 1].first : bindings_.size();
+        out
+            << scope.name << std::endl
+            << "    start: " << scope.loc.begin << std::endl
+            << std::endl
+            << "  name               | type                      | attributes" << std::endl
+            //  <-      20        -> | <-         25          -> |
+            << "---------------------+---------------------------+-----------------------" << std::endl
+            ;
+        for (std::size_t i = scope.first; i < end; ++i) {
+            const Symbol::Ptr& symbol = bindings_[i].symbol;
+            out
+                << std::left << std::setw(20) << symbol->name() << " | "
+                << std::left << std::setw(25) << symbol->type_str() << " | "
+                ;
 
-    return parent_->is_visible(name);
-}
+            if (symbol->get(Symbol::Attribute::EXTERN))
+                out << "extern";
+            if (symbol->get(Symbol::Attribute::FUNCTION_PARAM))
+                out << "function parameter";
 
-Symbol::Ptr Symbol_Table::lookup (const std::string& name) {
-    auto iter = table_.find(name);
-    if (iter != std::end(table_))
-        return iter->second;
-    return parent_->lookup(name);
-}
+            out << std::endl;
+        }
 
-void Symbol_Table::add (const std::string& name, Symbol::Ptr symbol) {
-    table_.emplace(std::make_pair(name, symbol));
+        out << std::endl;
+    }
 }
 
 
@@ -1,26 +1,37 @@
-
 #ifndef _CSTR_COMPILER__SYMBOL_TABLE_HPP
 #define _CSTR_COMPILER__SYMBOL_TABLE_HPP
 
 
+#include <cstddef>
+
+#include <functional>
+#include <iostream>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "atom.hpp"
 #include "location.hh"
+#include "stats.hpp"
 #include "symbol.hpp"
 
 namespace parser {
 
 
+// The symbols visible at the current point of a translation unit, as a stack
+// of scopes. Each name maps straight to its innermost binding, which
+// remembers the binding of the same name it shadows: looking a name up is a
+// single probe however deeply the scope is nested, and leaving a scope only
+// undoes the bindings made in it.
+//
+// Each compilation owns its own table. Its memory is charged to the symbol
+// tables in --mem-report.
 class Symbol_Table {
   public:
     typedef std::shared_ptr<Symbol_Table> Ptr;
 
-    static void print_tables ();
-
     // Delete all default constructors/assignment operators.
     Symbol_Table ()                                = delete;
     Symbol_Table (const Symbol_Table&)             = delete;
@@ -28,38 +39,76 @@ class Symbol_Table {
     Symbol_Table& operator = (const Symbol_Table&) = delete;
     Symbol_Table& operator = (Symbol_Table&&)      = delete;
 
-    // Factory constructor.
-    template <typename... T>
-    static Ptr construct (T&&... t) {
-        Ptr p (new Symbol_Table(std::forward<T>(t)...));
-        all_tables_.push_back(p);
-        return p;
-    }
+    // Factory constructor. The table starts with one scope open, the global
+    // scope, named `name`.
+    static Ptr construct (std::string&& name, const location& arg_loc);
+
+    // Opens a scope nested in the current one.
+    void push (std::string&& name, const location& arg_loc);
 
-    const std::string& name   () const { return name_; }
-    Ptr                parent ()       { return parent_; }
+    // Closes the current scope, dropping the symbols declared in it.
+    void pop ();
 
-    void name (std::string&& value) { name_ = std::move(value); }
+    // Number of open scopes, the global one included.
+    std::size_t depth () const { return scopes_.size(); }
 
-    bool is_in_this_scope (const std::string& name);
-    bool is_visible       (const std::string& name);
-    Symbol::Ptr lookup    (const std::string& name);
+    bool is_in_this_scope (atom::Atom name);
+    bool is_visible       (atom::Atom name) { return lookup(name) != nullptr; }
 
-    void add (const std::string& name, Symbol::Ptr symbol);
+    // The innermost symbol named `name`, or nullptr if there is none.
+    Symbol::Ptr lookup (atom::Atom name);
 
-    location loc;
+    // A name already declared in the current scope keeps its symbol.
+    void add (atom::Atom name, Symbol::Ptr symbol);
+
+    // Writes the symbols of the open scopes, outermost first.
+    void print (std::ostream& out) const;
+
+    // Calls `f` on each symbol of the global scope, in declaration order.
+    template <typename Function>
+    void for_each_global (Function f) const {
+        std::size_t end = scopes_.size() > 1 ? scopes_[1].first : bindings_.size();
+        for (std::size_t i = 0; i < end; ++i) {
+            f(bindings_[i].symbol);
+        }
+    }
 
   private:
     // Constructors private to control new object creation.
     Symbol_Table (std::string&& name, const location& arg_loc);
-    Symbol_Table (std::string&& name, const location& arg_loc, Ptr parent);
-
-    std::string name_;
-    Ptr parent_;
-
-    std::unordered_map<std::string, Symbol::Ptr> table_;
 
-    static std::vector<Ptr> all_tables_;
+    static const std::size_t kNone = static_cast<std::size_t>(-1);
+
+    // Dead entries of `innermost_` tolerated on top of twice the live ones.
+    static const std::size_t kDeadNames = 4096;
+
+    template <typename T>
+    using Vector = std::vector<T, stats::Allocator<T, stats::Pool::SYMBOL_TABLES>>;
+
+    struct Binding {
+        atom::Atom  name;
+        Symbol::Ptr symbol;
+        std::size_t shadowed;  // Index of the binding hidden by this one, or kNone.
+    };
+
+    struct Scope {
+        std::string name;
+        location    loc;
+        std::size_t first;  // Index of the first binding made in the scope.
+    };
+
+    Vector<Binding> bindings_;
+    Vector<Scope>   scopes_;
+
+    // Index of the innermost binding of each name, or kNone once the scopes
+    // binding it have been left. Entries are kept rather than erased, since
+    // the same names come back function after function, until they are
+    // mostly dead (see pop()).
+    std::unordered_map<
+        atom::Atom, std::size_t,
+        std::hash<atom::Atom>, std::equal_to<atom::Atom>,
+        stats::Allocator<std::pair<const atom::Atom, std::size_t>, stats::Pool::SYMBOL_TABLES>
+    > innermost_;
 };
 
 
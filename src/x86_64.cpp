@@ -0,0 +1,727 @@
+#include "x86_64.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "ast.hpp"
+#include "stats.hpp"
+#include "symbol.hpp"
+
+
+namespace x86_64 {
+
+
+std::string string_bytes (const std::string& value) {
+    std::string bytes;
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        char c = value[i];
+        if (c == '\\' and i + 1 < value.size()) {
+            switch (value[i + 1]) {
+                case '0': bytes += '\0'; ++i; continue;
+                case 'n': bytes += '\n'; ++i; continue;
+                case 'r': bytes += '\r'; ++i; continue;
+                case 't': bytes += '\t'; ++i; continue;
+                case 'v': bytes += '\v'; ++i; continue;
+            }
+        }
+        bytes += c;
+    }
+    return bytes;
+}
+
+
+// Text_Assembler - member function definitions
+
+// Names of each register as a 64-bit and as a 32-bit operand.
+static const char* const kRegisterNames[][2] = {
+    {"%rbx", "%ebx"},  {"%r12", "%r12d"}, {"%r13", "%r13d"}, {"%r14", "%r14d"},
+    {"%r15", "%r15d"}, {"%rax", "%eax"},  {"%rcx", "%ecx"},  {"%rdx", "%edx"},
+    {"%rsi", "%esi"},  {"%rdi", "%edi"},  {"%r8",  "%r8d"},  {"%r9",  "%r9d"},
+    {"%r11", "%r11d"},
+};
+
+static const char* const kConditionNames[] = {"e", "ne", "l", "g", "le", "ge"};
+
+// `bytes` as the operand of .string.
+static std::string string_directive (const std::string& bytes) {
+    std::string result;
+    for (char c : bytes) {
+        if (c == '"' or c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (c < ' ' or c > '~') {
+            const char* digits = "01234567";
+            unsigned byte = static_cast<unsigned char>(c);
+            result += '\\';
+            result += digits[(byte >> 6) & 7];
+            result += digits[(byte >> 3) & 7];
+            result += digits[byte & 7];
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+void Text_Assembler::global_variable (const std::string& name, int size) {
+    out_ << "\t.comm\t" << name << ',' << size << ',' << size << '\n';
+}
+
+void Text_Assembler::string_constant (const std::string& label, const std::string& bytes) {
+    strings_.emplace_back(label, bytes);
+}
+
+void Text_Assembler::begin_function (const std::string& name) {
+    strings_.clear();
+}
+
+void Text_Assembler::end_function (const Frame& frame) {
+    long size = frame.size + 8 * static_cast<long>(frame.saved.size());
+    size = (size + 15) / 16 * 16;
+
+    const std::string& name = frame.name;
+    out_
+        << "\t.text\n"
+        << "\t.globl\t" << name << '\n'
+        << "\t.type\t" << name << ", @function\n"
+        << name << ":\n"
+        << "\tpushq\t%rbp\n"
+        << "\tmovq\t%rsp, %rbp\n"
+        ;
+    if (size > 0) {
+        out_ << "\tsubq\t$" << size << ", %rsp\n";
+    }
+    for (std::size_t i = 0; i < frame.saved.size(); ++i) {
+        out_
+            << "\tmovq\t" << kRegisterNames[frame.saved[i]][0] << ", "
+            << -frame.size - 8 * static_cast<long>(i + 1) << "(%rbp)\n";
+    }
+    for (long slot : frame.zeroed_slots) {
+        out_ << "\tmovq\t$0, " << slot << "(%rbp)\n";
+    }
+
+    text_.flush();
+    out_ << text_stream_.str();
+    text_stream_.str(std::string());
+
+    out_ << frame.epilogue << ":\n";
+    for (std::size_t i = 0; i < frame.saved.size(); ++i) {
+        out_
+            << "\tmovq\t" << -frame.size - 8 * static_cast<long>(i + 1) << "(%rbp), "
+            << kRegisterNames[frame.saved[i]][0] << '\n';
+    }
+    out_
+        << "\tleave\n"
+        << "\tret\n"
+        << "\t.size\t" << name << ", .-" << name << '\n'
+        ;
+
+    // const strings
+    if (not strings_.empty()) {
+        out_ << "\t.section\t.rodata\n";
+        for (auto& string : strings_) {
+            out_ << string.first << ":\n\t.string\t\"" << string_directive(string.second) << "\"\n";
+        }
+    }
+    out_ << '\n';
+
+    // Function boundaries are the flush points for buffered output.
+    out_.flush();
+}
+
+void Text_Assembler::finish () {
+    // The stack does not need to be executable.
+    out_ << "\t.section\t.note.GNU-stack,\"\",@progbits\n";
+    out_.flush();
+}
+
+void Text_Assembler::move (const Operand& from, const Operand& to) {
+    text_
+        << "\tmov" << (to.type == parser::Type::INT ? 'l' : 'q') << '\t'
+        << operand_(from) << ", " << operand_(to) << '\n';
+}
+
+void Text_Assembler::load_address (const std::string& label, Register to) {
+    text_ << "\tleaq\t" << label << "(%rip), " << kRegisterNames[to][0] << '\n';
+}
+
+void Text_Assembler::arithmetic (Operation operation, const Operand& source, const Operand& destination) {
+    const char* name = nullptr;
+    switch (operation) {
+        case Operation::ADD:  name = "\taddl\t";  break;
+        case Operation::SUB:  name = "\tsubl\t";  break;
+        case Operation::IMUL: name = "\timull\t"; break;
+        case Operation::CMP:  name = "\tcmpl\t";  break;
+    }
+    text_ << name << operand_(source) << ", " << operand_(destination) << '\n';
+}
+
+void Text_Assembler::negate (Register value) {
+    text_ << "\tnegl\t" << kRegisterNames[value][1] << '\n';
+}
+
+void Text_Assembler::divide (Register divisor, bool is_signed) {
+    if (is_signed) {
+        text_ << "\tcltd\n\tidivl\t" << kRegisterNames[divisor][1] << '\n';
+    } else {
+        text_ << "\txorl\t%edx, %edx\n\tdivl\t" << kRegisterNames[divisor][1] << '\n';
+    }
+}
+
+void Text_Assembler::shift (Shift shift, Register value) {
+    text_
+        << (shift == Shift::LEFT ? "\tshll\t%cl, " : "\tsarl\t%cl, ")
+        << kRegisterNames[value][1] << '\n';
+}
+
+void Text_Assembler::set (Condition_Code condition) {
+    text_ << "\tset" << kConditionNames[static_cast<int>(condition)] << "\t%al\n";
+}
+
+void Text_Assembler::zero_extend () {
+    text_ << "\tmovzbl\t%al, %eax\n";
+}
+
+void Text_Assembler::push (const Operand& value) {
+    Operand quad = value;
+    quad.type = parser::Type::STRING;  // as a 64-bit operand
+    text_ << "\tpushq\t" << operand_(quad) << '\n';
+}
+
+void Text_Assembler::adjust_stack (long bytes) {
+    if (bytes < 0) {
+        text_ << "\tsubq\t$" << -bytes << ", %rsp\n";
+    } else {
+        text_ << "\taddq\t$" << bytes << ", %rsp\n";
+    }
+}
+
+void Text_Assembler::call (const std::string& function) {
+    text_ << "\tcall\t" << function << "@PLT\n";
+}
+
+void Text_Assembler::jump (const std::string& label) {
+    text_ << "\tjmp\t" << label << '\n';
+}
+
+void Text_Assembler::jump_if (Condition_Code condition, const std::string& label) {
+    text_ << "\tj" << kConditionNames[static_cast<int>(condition)] << '\t' << label << '\n';
+}
+
+void Text_Assembler::place (const std::string& label) {
+    text_ << label << ":\n";
+}
+
+std::string Text_Assembler::operand_ (const Operand& operand) {
+    switch (operand.kind) {
+        case Operand::Kind::IMMEDIATE:
+            return '$' + std::to_string(operand.value);
+        case Operand::Kind::REGISTER:
+            return kRegisterNames[operand.value][operand.type == parser::Type::INT ? 1 : 0];
+        case Operand::Kind::FRAME:
+            return std::to_string(operand.value) + "(%rbp)";
+        case Operand::Kind::SYMBOL:
+            return operand.symbol + "(%rip)";
+    }
+    throw std::logic_error("unknown operand kind");
+}
+
+
+// X86_64_Generator - member function definitions
+
+void X86_64_Generator::visit (ast::Declaration_List&       node) {
+    stats::Phase_Timer timer (ast::Kind::DECLARATION_LIST);
+    for (auto& symbol : node.symbol_list()) {
+        // Declare global variable, zero-initialized.
+        if (symbol->get(parser::Symbol::Attribute::GLOBAL)) {
+            assembler_.global_variable(symbol->name(), symbol->type() == parser::Type::INT ? 4 : 8);
+        }
+
+        // Declare local variable.
+        else {
+            variables_[symbol] = Operand {
+                Operand::Kind::FRAME, new_slot_(), symbol->type()};
+        }
+    }
+}
+void X86_64_Generator::visit (ast::Variable&               node) {
+    stats::Phase_Timer timer (ast::Kind::VARIABLE);
+    Operand value = allocate_(node.type());
+    move_(variable_(node.symbol()), value);
+    values_[node] = value;
+}
+void X86_64_Generator::visit (ast::Const_Integer&          node) {
+    stats::Phase_Timer timer (ast::Kind::CONST_INTEGER);
+    values_[node] = immediate_(node.value());
+}
+void X86_64_Generator::visit (ast::Const_String&           node) {
+    stats::Phase_Timer timer (ast::Kind::CONST_STRING);
+    std::string label = ".Lstr." + function_name_ + '.' + std::to_string(next_string_++);
+    assembler_.string_constant(label, string_bytes(node.value()));
+
+    Operand value = allocate_(parser::Type::STRING);
+    assembler_.load_address(label, RAX);
+    move_(register_(RAX, parser::Type::STRING), value);
+    values_[node] = value;
+}
+void X86_64_Generator::visit (ast::Unary_Expression&       node) {
+    stats::Phase_Timer timer (ast::Kind::UNARY_EXPRESSION);
+    Operand rhs = take_(node.rhs());
+    Operand eax = register_(RAX, parser::Type::INT);
+    move_(rhs, eax);
+    assembler_.negate(RAX);
+    release_(rhs);
+
+    Operand value = allocate_(parser::Type::INT);
+    move_(eax, value);
+    values_[node] = value;
+}
+void X86_64_Generator::visit (ast::Binary_Expression&      node) {
+    stats::Phase_Timer timer (ast::Kind::BINARY_EXPRESSION);
+    Operand lhs = take_(node.lhs());
+    Operand rhs = take_(node.rhs());
+
+    switch (node.type()) {
+        case parser::Type::INT: {
+            Operand eax = register_(RAX, parser::Type::INT);
+            Operand ecx = register_(RCX, parser::Type::INT);
+            Operand result = eax;
+
+            move_(lhs, eax);
+            switch (node.op()) {
+                case ast::Operation::ADDITION:
+                    assembler_.arithmetic(Operation::ADD, rhs, eax);
+                    break;
+                case ast::Operation::SUBTRACTION:
+                    assembler_.arithmetic(Operation::SUB, rhs, eax);
+                    break;
+                case ast::Operation::MULTIPLICATION:
+                    assembler_.arithmetic(Operation::IMUL, rhs, eax);
+                    break;
+                // Unsigned, like the udiv of the LLVM IR.
+                case ast::Operation::DIVISION:
+                    move_(rhs, ecx);
+                    assembler_.divide(RCX, false);
+                    break;
+                case ast::Operation::MODULUS:
+                    move_(rhs, ecx);
+                    assembler_.divide(RCX, true);
+                    result = register_(RDX, parser::Type::INT);
+                    break;
+                case ast::Operation::LEFT_SHIFT:
+                    move_(rhs, ecx);
+                    assembler_.shift(Shift::LEFT, RAX);
+                    break;
+                case ast::Operation::RIGHT_SHIFT:
+                    move_(rhs, ecx);
+                    assembler_.shift(Shift::RIGHT, RAX);
+                    break;
+            }
+            release_(lhs);
+            release_(rhs);
+
+            Operand value = allocate_(parser::Type::INT);
+            move_(result, value);
+            values_[node] = value;
+            break;
+        }
+
+        case parser::Type::STRING: {
+            // '+' is the only operation allowed between strings.
+            call_("__string_concat__", {lhs, rhs});
+            release_(lhs);
+            release_(rhs);
+
+            // The result is freed when the function returns, from a slot of
+            // its own (zeroed in the prologue, in case it is never computed).
+            Operand value = allocate_(parser::Type::STRING);
+            Operand rax = register_(RAX, parser::Type::STRING);
+            move_(rax, value);
+            value.free_slot = new_slot_();
+            move_(rax, Operand {Operand::Kind::FRAME, value.free_slot, parser::Type::STRING});
+            strings_to_free_.push_back(value.free_slot);
+            values_[node] = value;
+            break;
+        }
+    }
+}
+void X86_64_Generator::visit (ast::Condition&              node) {
+    stats::Phase_Timer timer (ast::Kind::CONDITION);
+    Operand lhs = take_(node.lhs());
+    Operand rhs = take_(node.rhs());
+
+    switch (node.type()) {
+        case parser::Type::INT: {
+            Condition_Code condition = Condition_Code::E;
+            switch (node.op()) {
+                case ast::Comparison_Operation::EQUAL:                 condition = Condition_Code::E;  break;
+                case ast::Comparison_Operation::NOT_EQUAL:             condition = Condition_Code::NE; break;
+                case ast::Comparison_Operation::LESS_THAN:             condition = Condition_Code::L;  break;
+                case ast::Comparison_Operation::GREATER_THAN:          condition = Condition_Code::G;  break;
+                case ast::Comparison_Operation::LESS_THAN_OR_EQUAL:    condition = Condition_Code::LE; break;
+                case ast::Comparison_Operation::GREATER_THAN_OR_EQUAL: condition = Condition_Code::GE; break;
+            }
+            Operand eax = register_(RAX, parser::Type::INT);
+            move_(lhs, eax);
+            assembler_.arithmetic(Operation::CMP, rhs, eax);
+            assembler_.set(condition);
+            break;
+        }
+
+        case parser::Type::STRING: {
+            switch (node.op()) {
+                case ast::Comparison_Operation::EQUAL:
+                    call_("__string_equal__", {lhs, rhs});
+                    break;
+                case ast::Comparison_Operation::NOT_EQUAL:
+                    call_("__string_not_equal__", {lhs, rhs});
+                    break;
+                default:
+                    throw std::runtime_error("Operation not supported for strings.");
+            }
+            break;
+        }
+    }
+    release_(lhs);
+    release_(rhs);
+
+    // Conditions are i1 values: only %al is meaningful.
+    assembler_.zero_extend();
+    Operand value = allocate_(parser::Type::INT);
+    move_(register_(RAX, parser::Type::INT), value);
+    values_[node] = value;
+}
+void X86_64_Generator::visit (ast::Assignment&             node) {
+    stats::Phase_Timer timer (ast::Kind::ASSIGNMENT);
+    // The value of an assignment is the value assigned.
+    Operand value = take_(node.rhs());
+    move_(value, variable_(node.lhs().symbol()));
+    values_[node] = value;
+}
+void X86_64_Generator::visit (ast::Function_Call&          node) {
+    stats::Phase_Timer timer (ast::Kind::FUNCTION_CALL);
+    Vector<Operand> arguments;
+    for (auto argument : node.argument_list()) {
+        arguments.push_back(take_(argument));
+    }
+
+    call_(node.function()->name(), arguments);
+    for (auto& argument : arguments) {
+        release_(argument);
+    }
+
+    Operand value = allocate_(node.type());
+    move_(register_(RAX, node.type()), value);
+    values_[node] = value;
+}
+void X86_64_Generator::visit (ast::Instruction&            node) {
+    // This is an empty instruction. Do nothing.
+}
+void X86_64_Generator::visit (ast::Expression_Instruction& node) {
+    stats::Phase_Timer timer (ast::Kind::EXPRESSION_INSTRUCTION);
+    node.expression().emit_code(*this);
+    release_(take_(node.expression()));
+}
+void X86_64_Generator::visit (ast::Cond_Instruction&       node) {
+    stats::Phase_Timer timer (ast::Kind::COND_INSTRUCTION);
+    std::string label_else = new_label_();
+    std::string label_end  = new_label_();
+
+    node.condition().emit_code(*this);
+    Operand condition = take_(node.condition());
+    release_(condition);
+    jump_if_zero_(condition, label_else);
+
+    work_.generate(*this, node.instruction());
+    work_.then([this, label_else, label_end] {
+        assembler_.jump(label_end);
+        assembler_.place(label_else);
+    });
+    if (const auto& else_instruction = node.else_instruction()) {
+        work_.generate(*this, else_instruction);
+    }
+    work_.then([this, label_end] { assembler_.place(label_end); });
+}
+void X86_64_Generator::visit (ast::While_Instruction&      node) {
+    stats::Phase_Timer timer (ast::Kind::WHILE_INSTRUCTION);
+    std::string label_condition = new_label_();
+    std::string label_end       = new_label_();
+
+    assembler_.place(label_condition);
+    node.condition().emit_code(*this);
+    Operand condition = take_(node.condition());
+    release_(condition);
+    jump_if_zero_(condition, label_end);
+
+    work_.generate(*this, node.instruction());
+    work_.then([this, label_condition, label_end] {
+        assembler_.jump(label_condition);
+        assembler_.place(label_end);
+    });
+}
+void X86_64_Generator::visit (ast::Do_Instruction&         node) {
+    stats::Phase_Timer timer (ast::Kind::DO_INSTRUCTION);
+    std::string label_body = new_label_();
+
+    assembler_.place(label_body);
+    work_.generate(*this, node.instruction());
+
+    work_.then([this, &node, label_body] {
+        node.condition().emit_code(*this);
+        Operand condition = take_(node.condition());
+        release_(condition);
+        if (condition.kind == Operand::Kind::IMMEDIATE) {
+            if (condition.value != 0) {
+                assembler_.jump(label_body);
+            }
+        } else {
+            assembler_.arithmetic(Operation::CMP, immediate_(0), condition);
+            assembler_.jump_if(Condition_Code::NE, label_body);
+        }
+    });
+}
+void X86_64_Generator::visit (ast::For_Instruction&        node) {
+    stats::Phase_Timer timer (ast::Kind::FOR_INSTRUCTION);
+    std::string label_condition = new_label_();
+    std::string label_end       = new_label_();
+
+    node.initialization().emit_code(*this);
+    release_(take_(node.initialization()));
+
+    assembler_.place(label_condition);
+    node.condition().emit_code(*this);
+    Operand condition = take_(node.condition());
+    release_(condition);
+    jump_if_zero_(condition, label_end);
+
+    work_.generate(*this, node.instruction());
+    work_.then([this, &node, label_condition, label_end] {
+        node.increment().emit_code(*this);
+        release_(take_(node.increment()));
+        assembler_.jump(label_condition);
+
+        assembler_.place(label_end);
+    });
+}
+void X86_64_Generator::visit (ast::Return_Instruction&     node) {
+    stats::Phase_Timer timer (ast::Kind::RETURN_INSTRUCTION);
+    node.expression().emit_code(*this);
+
+    Operand value = take_(node.expression());
+
+    // A string built in this function is freed below: return a copy of it,
+    // which the caller can free later.
+    if (value.free_slot != 0) {
+        call_("__string_copy__", {value});
+        release_(value);
+        value = allocate_(parser::Type::STRING);
+        move_(register_(RAX, parser::Type::STRING), value);
+    }
+
+    // Free any strings created in this function
+    for (long slot : strings_to_free_) {
+        call_("__string_free__", {
+            Operand {Operand::Kind::FRAME, slot, parser::Type::STRING}});
+    }
+
+    move_(value, register_(RAX, value.type));
+    release_(value);
+    assembler_.jump(epilogue_label_());
+}
+void X86_64_Generator::visit (ast::Compound_Instruction&   node) {
+    stats::Phase_Timer timer (ast::Kind::COMPOUND_INSTRUCTION);
+    for (auto& instruction : node.instruction_list()) {
+        work_.generate(*this, instruction);
+    }
+}
+void X86_64_Generator::visit (ast::Function_Declaration&   node) {
+    // External functions are resolved by the linker. Do nothing.
+}
+void X86_64_Generator::visit (ast::Function_Definition&    node) {
+    stats::Phase_Timer timer (ast::Kind::FUNCTION_DEFINITION);
+    auto& declarator = node.function_declarator();
+
+    // Everything is numbered from zero again in each function, like in the
+    // LLVM IR.
+    function_name_ = declarator->name();
+    values_.reset(node.expression_count());
+    variables_.clear();
+    registers_free_.assign(kPoolSize, true);
+    registers_used_.assign(kPoolSize, false);
+    free_slots_.clear();
+    frame_size_ = 0;
+    next_label_ = 0;
+    next_string_ = 0;
+    strings_to_free_.clear();
+
+    assembler_.begin_function(function_name_);
+
+    // The first six arguments come in registers, and are stored in the frame
+    // like local variables. The others are already on the stack, above the
+    // return address.
+    static const Register arguments[] = {RDI, RSI, RDX, RCX, R8, R9};
+    std::size_t index = 0;
+    for (auto& symbol : declarator->argument_list()) {
+        Operand variable;
+        if (index < 6) {
+            variable = Operand {
+                Operand::Kind::FRAME, new_slot_(), symbol->type()};
+            move_(register_(arguments[index], symbol->type()), variable);
+        } else {
+            variable = Operand {
+                Operand::Kind::FRAME, static_cast<long>(16 + 8 * (index - 6)),
+                symbol->type()};
+        }
+        variables_[symbol] = variable;
+        ++index;
+    }
+
+    // function body
+    node.body()->emit_code(*this);
+
+    // The callee-saved registers the body used are saved below the frame.
+    Frame frame;
+    frame.name = function_name_;
+    frame.size = frame_size_;
+    for (std::size_t i = 0; i < kPoolSize; ++i) {
+        if (registers_used_[i]) {
+            frame.saved.push_back(static_cast<Register>(i));
+        }
+    }
+    frame.zeroed_slots = strings_to_free_;
+    frame.epilogue = epilogue_label_();
+    assembler_.end_function(frame);
+}
+
+
+// A register of the pool, or else a spill slot.
+Operand X86_64_Generator::allocate_ (parser::Type type) {
+    for (std::size_t i = 0; i < kPoolSize; ++i) {
+        if (registers_free_[i]) {
+            registers_free_[i] = false;
+            registers_used_[i] = true;
+            return register_(static_cast<Register>(i), type);
+        }
+    }
+
+    long slot;
+    if (free_slots_.empty()) {
+        slot = new_slot_();
+    } else {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    }
+    return Operand {Operand::Kind::FRAME, slot, type};
+}
+
+// Gives back where a value was, once the value is no longer needed. Only for
+// values, which are never in variables.
+void X86_64_Generator::release_ (const Operand& operand) {
+    switch (operand.kind) {
+        case Operand::Kind::REGISTER:
+            registers_free_[operand.value] = true;
+            break;
+        case Operand::Kind::FRAME:
+            free_slots_.push_back(operand.value);
+            break;
+        default:
+            break;
+    }
+}
+
+// The value of `node`, which it hands over to its user.
+Operand X86_64_Generator::take_ (const ast::Expression& node) {
+    Operand* iter = values_.find(node);
+    if (not iter) {
+        throw std::logic_error("expression without a value");
+    }
+    Operand value = std::move(*iter);
+    values_.erase(node);
+    return value;
+}
+
+Operand X86_64_Generator::variable_ (const parser::Symbol::Ptr& symbol) {
+    if (symbol->get(parser::Symbol::Attribute::GLOBAL)) {
+        return Operand {Operand::Kind::SYMBOL, 0, symbol->type(), symbol->name()};
+    }
+    auto iter = variables_.find(symbol);
+    if (iter == std::end(variables_)) {
+        throw std::runtime_error("Variable '" + symbol->name() + "' is not declared.");
+    }
+    return iter->second;
+}
+
+// A new 8-byte slot of the frame.
+long X86_64_Generator::new_slot_ () {
+    frame_size_ += 8;
+    return -frame_size_;
+}
+
+Operand X86_64_Generator::register_ (Register number, parser::Type type) {
+    return Operand {Operand::Kind::REGISTER, static_cast<long>(number), type};
+}
+
+Operand X86_64_Generator::immediate_ (long value) {
+    return Operand {Operand::Kind::IMMEDIATE, value, parser::Type::INT};
+}
+
+
+void X86_64_Generator::move_ (const Operand& from, const Operand& to) {
+    if (from.kind == to.kind and from.value == to.value and from.symbol == to.symbol) {
+        return;
+    }
+
+    // There is no memory to memory move.
+    if (from.in_memory() and to.in_memory()) {
+        Operand r11 = register_(R11, to.type);
+        assembler_.move(from, r11);
+        assembler_.move(r11, to);
+        return;
+    }
+
+    assembler_.move(from, to);
+}
+
+// Calls `function` with `arguments`, leaving its result in %rax. Arguments
+// past the sixth are pushed, keeping %rsp aligned on 16 bytes.
+void X86_64_Generator::call_ (const std::string& function, const Vector<Operand>& arguments) {
+    static const Register registers[] = {RDI, RSI, RDX, RCX, R8, R9};
+
+    std::size_t pushed = arguments.size() > 6 ? arguments.size() - 6 : 0;
+    if (pushed % 2 != 0) {
+        assembler_.adjust_stack(-8);
+    }
+    for (std::size_t i = arguments.size(); i > 6; --i) {
+        assembler_.push(arguments[i - 1]);
+    }
+
+    for (std::size_t i = 0; i < arguments.size() and i < 6; ++i) {
+        move_(arguments[i], register_(registers[i], arguments[i].type));
+    }
+
+    assembler_.call(function);
+
+    if (pushed > 0) {
+        assembler_.adjust_stack(static_cast<long>(8 * (pushed + pushed % 2)));
+    }
+}
+
+void X86_64_Generator::jump_if_zero_ (const Operand& condition, const std::string& label) {
+    if (condition.kind == Operand::Kind::IMMEDIATE) {
+        if (condition.value == 0) {
+            assembler_.jump(label);
+        }
+        return;
+    }
+    assembler_.arithmetic(Operation::CMP, immediate_(0), condition);
+    assembler_.jump_if(Condition_Code::E, label);
+}
+
+
+std::string X86_64_Generator::new_label_ () {
+    return ".L" + function_name_ + '.' + std::to_string(next_label_++);
+}
+
+
+}  // namespace x86_64
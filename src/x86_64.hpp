@@ -0,0 +1,252 @@
+#ifndef __CSTR_COMPILER__X86_64_HPP
+#define __CSTR_COMPILER__X86_64_HPP
+
+
+#include <cstddef>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ast.hpp"
+#include "output_buffer.hpp"
+#include "stats.hpp"
+#include "symbol.hpp"
+
+
+namespace x86_64 {
+
+
+// The registers X86_64_Generator uses. The first kPoolSize are the ones
+// holding values.
+enum Register : std::size_t {
+    RBX, R12, R13, R14, R15,
+    RAX, RCX, RDX, RSI, RDI, R8, R9, R11,
+};
+const std::size_t kPoolSize = 5;
+
+// Where a value is.
+struct Operand {
+    enum class Kind {
+        IMMEDIATE,  // `value`
+        REGISTER,   // register `value`
+        FRAME,      // at offset `value` from %rbp
+        SYMBOL,     // at `symbol`(%rip)
+    };
+
+    Operand (
+        Kind kind = Kind::IMMEDIATE,
+        long value = 0,
+        parser::Type type = parser::Type::INT,
+        const std::string& symbol = std::string()
+    ) : kind(kind), value(value), type(type), symbol(symbol) {}
+
+    // Whether it is in memory, which at most one operand of an instruction
+    // can be.
+    bool in_memory () const { return kind == Kind::FRAME or kind == Kind::SYMBOL; }
+
+    Kind         kind;
+    long         value;
+    parser::Type type;  // INT operands are 32-bit, STRING operands 64-bit.
+    std::string  symbol;
+
+    // The frame offset of the slot freeing this string at the end of the
+    // function, or 0 if it is not to be freed.
+    long         free_slot = 0;
+};
+
+// 32-bit operations of arithmetic(): `destination` op= `source`.
+enum class Operation { ADD, SUB, IMUL, CMP };
+
+enum class Condition_Code { E, NE, L, G, LE, GE };
+
+enum class Shift { LEFT, RIGHT };  // RIGHT is arithmetic.
+
+// The bytes of a string constant, with the escape sequences that
+// llvm::LLVM_Generator understands resolved.
+std::string string_bytes (const std::string& value);
+
+// What a function needs around its body, known once the body is complete.
+struct Frame {
+    std::string           name;
+    long                  size;          // Bytes below %rbp, not counting saves.
+    std::vector<Register> saved;         // Callee-saved registers the body uses.
+    std::vector<long>     zeroed_slots;  // Slots to set to 0 on entry.
+    std::string           epilogue;      // Label the returns jump to.
+};
+
+
+// Where X86_64_Generator sends the instructions it selects: assembly text
+// (Text_Assembler), or machine code (jit::Machine_Code_Assembler).
+//
+// The instructions of a function body come before its prologue, which
+// depends on the whole body: assemblers buffer the body from begin_function()
+// and write the function out at end_function().
+class Assembler {
+  public:
+    virtual ~Assembler () {}
+
+    // Module.
+    virtual void global_variable (const std::string& name, int size) = 0;
+
+    // Private string constant `bytes`, plus a terminating NUL, at `label`.
+    virtual void string_constant (const std::string& label, const std::string& bytes) = 0;
+
+    virtual void begin_function (const std::string& name) = 0;
+    virtual void end_function   (const Frame& frame)      = 0;
+
+    // Complete the module.
+    virtual void finish () = 0;
+
+    // Instructions. Operands follow the rules of the instruction set: at most
+    // one in memory, and an immediate only as a source.
+    virtual void move         (const Operand& from, const Operand& to) = 0;
+    virtual void load_address (const std::string& label, Register to) = 0;
+    virtual void arithmetic   (Operation operation, const Operand& source, const Operand& destination) = 0;
+    virtual void negate       (Register value) = 0;
+    // %eax = %edx:%eax / `divisor`, %edx = the remainder.
+    virtual void divide       (Register divisor, bool is_signed) = 0;
+    virtual void shift        (Shift shift, Register value) = 0;  // by %cl
+    virtual void set          (Condition_Code condition) = 0;     // %al
+    virtual void zero_extend  () = 0;                             // %al to %eax
+    virtual void push         (const Operand& value) = 0;         // 64-bit
+    virtual void adjust_stack (long bytes) = 0;                   // %rsp += bytes
+    virtual void call         (const std::string& function) = 0;
+    virtual void jump         (const std::string& label) = 0;
+    virtual void jump_if      (Condition_Code condition, const std::string& label) = 0;
+    virtual void place        (const std::string& label) = 0;
+};
+
+
+// Assembler writing assembly for the GNU assembler, in AT&T syntax.
+class Text_Assembler : public Assembler {
+  public:
+    Text_Assembler (
+        std::ostream& out,
+        output::Flush_Policy policy = output::Flush_Policy::LINE
+    ) : out_(out, policy), text_(text_stream_, output::Flush_Policy::EXPLICIT) {}
+
+    const output::Output_Buffer& output () const { return out_; }
+    std::size_t bytes_written () const { return out_.bytes_written(); }
+
+    void global_variable (const std::string& name, int size) override;
+    void string_constant (const std::string& label, const std::string& bytes) override;
+    void begin_function  (const std::string& name) override;
+    void end_function    (const Frame& frame) override;
+    void finish          () override;
+
+    void move         (const Operand& from, const Operand& to) override;
+    void load_address (const std::string& label, Register to) override;
+    void arithmetic   (Operation operation, const Operand& source, const Operand& destination) override;
+    void negate       (Register value) override;
+    void divide       (Register divisor, bool is_signed) override;
+    void shift        (Shift shift, Register value) override;
+    void set          (Condition_Code condition) override;
+    void zero_extend  () override;
+    void push         (const Operand& value) override;
+    void adjust_stack (long bytes) override;
+    void call         (const std::string& function) override;
+    void jump         (const std::string& label) override;
+    void jump_if      (Condition_Code condition, const std::string& label) override;
+    void place        (const std::string& label) override;
+
+  private:
+    output::Output_Buffer out_;
+
+    // The body of the function being defined.
+    std::ostringstream    text_stream_;
+    output::Output_Buffer text_;
+
+    std::vector<std::pair<std::string, std::string>> strings_;  // label, bytes
+
+    static std::string operand_ (const Operand& operand);
+};
+
+
+// Code generator writing x86-64 code, through an Assembler, for the same node
+// set as llvm::LLVM_Generator (System V calling convention). It is meant for
+// builds that need code fast rather than good code: nothing is optimized, but
+// the output needs neither llc nor libLLVM.
+//
+// Local variables and arguments live in the stack frame. The values of
+// expressions live in registers: each one takes a callee-saved register
+// (%rbx, %r12 - %r15) when it is computed and gives it back when the
+// expression using it is computed, so values survive the calls made while
+// computing their siblings. When all five are taken, values are spilled to
+// slots of the frame instead. The other registers are only used within the
+// code of one node.
+class X86_64_Generator final : public ast::Code_Generator {
+  public:
+    explicit X86_64_Generator (Assembler& assembler) : assembler_(assembler) {}
+
+    void visit (ast::Declaration_List&       node) override;
+    void visit (ast::Variable&               node) override;
+    void visit (ast::Const_Integer&          node) override;
+    void visit (ast::Const_String&           node) override;
+    void visit (ast::Unary_Expression&       node) override;
+    void visit (ast::Binary_Expression&      node) override;
+    void visit (ast::Condition&              node) override;
+    void visit (ast::Assignment&             node) override;
+    void visit (ast::Function_Call&          node) override;
+    void visit (ast::Instruction&            node) override;
+    void visit (ast::Expression_Instruction& node) override;
+    void visit (ast::Cond_Instruction&       node) override;
+    void visit (ast::While_Instruction&      node) override;
+    void visit (ast::Do_Instruction&         node) override;
+    void visit (ast::For_Instruction&        node) override;
+    void visit (ast::Return_Instruction&     node) override;
+    void visit (ast::Compound_Instruction&   node) override;
+    void visit (ast::Function_Declaration&   node) override;
+    void visit (ast::Function_Definition&    node) override;
+
+  private:
+    Assembler& assembler_;
+
+    // Containers of the generator state, charged to code generation in
+    // --mem-report.
+    template <typename Key, typename Value>
+    using Map = stats::Map<Key, Value, stats::Pool::CODEGEN>;
+    template <typename T>
+    using Vector = stats::Vector<T, stats::Pool::CODEGEN>;
+
+    ast::Value_Table<Operand>            values_;
+    Map<parser::Symbol::Ptr, Operand>    variables_;
+
+    // Register allocation.
+    Vector<bool> registers_free_;
+    Vector<bool> registers_used_;  // Used anywhere in the function.
+    Vector<long> free_slots_;      // Spill slots not holding anything.
+    long         frame_size_ = 0;  // Bytes below %rbp, not counting saves.
+
+    std::string       function_name_;
+    std::size_t       next_label_  = 0;
+    std::size_t       next_string_ = 0;
+    std::vector<long> strings_to_free_;  // frame offsets
+
+    // Values.
+    Operand allocate_ (parser::Type type);
+    void    release_  (const Operand& operand);
+    Operand take_     (const ast::Expression& node);
+    Operand variable_ (const parser::Symbol::Ptr& symbol);
+    long    new_slot_ ();
+
+    static Operand register_  (Register number, parser::Type type);
+    static Operand immediate_ (long value);
+
+    // Instructions.
+    void move_ (const Operand& from, const Operand& to);
+    void call_ (const std::string& function, const Vector<Operand>& arguments);
+    void jump_if_zero_ (const Operand& condition, const std::string& label);
+
+    std::string new_label_ ();
+    std::string epilogue_label_ () const { return ".L" + function_name_ + ".return"; }
+};
+
+
+}  // namespace x86_64
+
+
+#endif  // __CSTR_COMPILER__X86_64_HPP
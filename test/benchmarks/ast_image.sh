@@ -0,0 +1,52 @@
+#! /bin/bash
+
+# Compare compiling a large generated input from its source and from an AST
+# image of it (--emit=ast):
+#
+#   source  scanning, parsing and semantic checks, then code generation
+#   image   the parsed translation unit is loaded (ast_image), then code
+#           generation
+#
+#   usage: ast_image.sh [functions] [statements per function]
+#
+# Reports the sizes of the source and of the image, real/user/sys time of
+# each, and the time spent before code generation from --time-report. Both
+# must write the same IR.
+
+root_dir=$(cd `dirname $0`/../..; pwd)
+pushd $root_dir > /dev/null
+
+work_dir=$(mktemp -d)
+trap "rm -rf $work_dir" EXIT
+
+bash test/benchmarks/generate_source.sh ${1:-1000} ${2:-200} > $work_dir/source.c
+bin/compiler --emit=ast < $work_dir/source.c > $work_dir/image.ast
+echo "source: $(wc -c < $work_dir/source.c) bytes"
+echo "image:  $(wc -c < $work_dir/image.ast) bytes"
+echo
+
+# Wall time of the phases before code generation, in ms, from --time-report.
+front_end_ms () {
+    awk '$1 == "preprocessing" || $1 == "loading" || $1 == "scanning" || $1 == "parsing" { ms += $2 }
+         $1 == "semantic" { ms += $3 }
+         END { print ms }'
+}
+
+for input in source.c image.ast
+do
+    TIMEFORMAT="%R %U %S"
+    times=( $( { time bin/compiler $work_dir/$input ; } 2>&1 ) )
+    front_end=$(bin/compiler --time-report $work_dir/$input 2>&1 | front_end_ms)
+
+    printf "  %-9s  %7.3f s real %7.3f s user %7.3f s sys  %9.1f ms before code generation\n" \
+        $input ${times[0]} ${times[1]} ${times[2]} $front_end
+done
+
+if ! cmp -s $work_dir/source.ll $work_dir/image.ll
+then
+    echo
+    echo "the IR compiled from the image differs from the IR compiled from the source"
+    exit 1
+fi
+
+popd > /dev/null  # $root_dir
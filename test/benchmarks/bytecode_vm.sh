@@ -0,0 +1,75 @@
+#! /bin/bash
+
+# Compare the ways of running the test cases of test/test_cases:
+#
+#   llc      bin/compiler, then llc, then gcc links the program, which runs
+#   --run    machine code compiled in memory runs in the compiler (jit::Program)
+#   --run=vm bytecode runs in the compiler's interpreter
+#            (bytecode::Interpreter)
+#
+#   usage: bytecode_vm.sh [repetitions]
+#
+# Each way runs every test case `repetitions` times (10 by default). Reports
+# the mean wall time of one run, from source to exit, in milliseconds, and
+# checks that the three print the same. expr does not: llc folds its shift by
+# 43 to 0, where x86-64 and the interpreter mask the count.
+
+root_dir=$(cd `dirname $0`/../..; pwd)
+pushd $root_dir > /dev/null
+
+repetitions=${1:-10}
+
+test_cases=(add cond expr functions lsh mod mul neg rsh string string2 sub)
+
+work_dir=$(mktemp -d)
+trap "rm -rf $work_dir" EXIT
+
+pushd test/lib > /dev/null
+make > /dev/null
+popd > /dev/null  # test/lib
+
+# Milliseconds since the epoch.
+now () {
+    date +%s%N | cut -c1-13
+}
+
+printf "  %-10s  %10s  %10s  %10s\n" "test case" "llc" "--run" "--run=vm"
+for t in ${test_cases[@]}
+do
+    cpp test/test_cases/${t}.c > $work_dir/${t}.i 2> /dev/null
+
+    start=$(now)
+    for i in $(seq $repetitions)
+    do
+        bin/compiler < $work_dir/${t}.i > $work_dir/${t}.ll
+        llc -relocation-model=pic $work_dir/${t}.ll -o $work_dir/${t}.s
+        gcc -o $work_dir/${t} $work_dir/${t}.s test/lib/lib.o build/string_lib.o
+        $work_dir/${t} > $work_dir/${t}.llc.stdout
+    done
+    llc_ms=$(( ($(now) - start) / repetitions ))
+
+    start=$(now)
+    for i in $(seq $repetitions)
+    do
+        bin/compiler --run < $work_dir/${t}.i > $work_dir/${t}.jit.stdout
+    done
+    jit_ms=$(( ($(now) - start) / repetitions ))
+
+    start=$(now)
+    for i in $(seq $repetitions)
+    do
+        bin/compiler --run=vm < $work_dir/${t}.i > $work_dir/${t}.vm.stdout
+    done
+    vm_ms=$(( ($(now) - start) / repetitions ))
+
+    status=""
+    if ! cmp -s $work_dir/${t}.llc.stdout $work_dir/${t}.jit.stdout ||
+       ! cmp -s $work_dir/${t}.llc.stdout $work_dir/${t}.vm.stdout
+    then
+        status="  (outputs differ)"
+    fi
+
+    printf "  %-10s  %7d ms  %7d ms  %7d ms%s\n" $t $llc_ms $jit_ms $vm_ms "$status"
+done
+
+popd > /dev/null  # $root_dir
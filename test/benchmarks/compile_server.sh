@@ -0,0 +1,60 @@
+#! /bin/bash
+
+# Compare cold invocations of bin/compiler with requests to a resident
+# `bin/compiler --serve` through bin/client, on many small translation units.
+#
+#   usage: compile_server.sh [requests] [functions] [statements per function]
+#
+# Reports the total and per-request wall time of both, and checks that they
+# produce the same IR.
+
+root_dir=$(cd `dirname $0`/../..; pwd)
+pushd $root_dir > /dev/null
+
+requests=${1:-200}
+
+work_dir=$(mktemp -d)
+socket=$work_dir/compiler.sock
+trap "bin/client --socket $socket --shutdown 2> /dev/null; rm -rf $work_dir" EXIT
+
+bash test/benchmarks/generate_source.sh ${2:-5} ${3:-10} > $work_dir/input.c
+echo "input: $(wc -c < $work_dir/input.c) bytes, $requests compilations"
+echo
+
+bin/compiler --serve=$socket 2> $work_dir/server.log &
+
+# Wait for the server to listen.
+for i in $(seq 50)
+do
+    [ -S $socket ] && break
+    sleep 0.1
+done
+
+bin/compiler < $work_dir/input.c > $work_dir/cold.ll
+bin/client --socket $socket < $work_dir/input.c > $work_dir/server.ll
+if ! cmp -s $work_dir/cold.ll $work_dir/server.ll
+then
+    echo "IR from the server differs from bin/compiler"
+    exit 1
+fi
+
+TIMEFORMAT="%R"
+for mode in cold server
+do
+    if [ $mode = cold ]
+    then
+        command="bin/compiler"
+    else
+        command="bin/client --socket $socket"
+    fi
+
+    seconds=$( { time for i in $(seq $requests)
+    do
+        $command < $work_dir/input.c > /dev/null
+    done ; } 2>&1 )
+
+    per_request=$(awk "BEGIN { print $seconds * 1000 / $requests }")
+    printf "  %-7s %8.3f s total %8.3f ms per compilation\n" $mode $seconds $per_request
+done
+
+popd > /dev/null  # $root_dir
@@ -0,0 +1,62 @@
+#! /bin/bash
+
+# Measure what the fold-constants pass of -O2 saves on a large generated input
+# full of arithmetic on constants, as sources written with macros are (e.g.
+# `N * 4 + 1` once N is expanded): compiles it at -O1, without the pass, and at
+# -O2, and reports the lines of IR of each and, when llc is available, the
+# time llc takes on them.
+#
+#   usage: constant_folding.sh [functions] [statements per function]
+
+root_dir=$(cd `dirname $0`/../..; pwd)
+pushd $root_dir > /dev/null
+
+work_dir=$(mktemp -d)
+trap "rm -rf $work_dir" EXIT
+
+awk -v functions=${1:-1000} -v statements=${2:-100} '
+BEGIN {
+    for (f = 0; f < functions; ++f) {
+        printf "int f%d(int a) {\n", f
+        print "    int n;"
+        print "    int x;"
+        printf "    n = %d;\n", f % 64 + 1
+        print "    x = a;"
+        for (s = 0; s < statements; ++s) {
+            if (s % 3 == 0) {
+                printf "    x = x + n * 4 + %d;\n", s
+            } else if (s % 3 == 1) {
+                printf "    if (n * 2 > %d) x = x - (%d << 2); else x = x + 1;\n", s, s
+            } else {
+                printf "    x = x * (%d - 2 * n + 3) / 8;\n", s
+            }
+        }
+        print "    return x;"
+        print "}"
+        print ""
+    }
+}' > $work_dir/input.c
+echo "input: $(wc -c < $work_dir/input.c) bytes"
+echo
+
+for level in -O1 -O2
+do
+    bin/compiler $level < $work_dir/input.c > $work_dir/output$level.ll
+    printf "  %s  %9d lines of IR" $level $(wc -l < $work_dir/output$level.ll)
+
+    if command -v llc > /dev/null
+    then
+        TIMEFORMAT="%R"
+        seconds=$( { time llc $work_dir/output$level.ll -o /dev/null ; } 2>&1 )
+        printf "  %7.3f s of llc" $seconds
+    fi
+    echo
+done
+
+if ! command -v llc > /dev/null
+then
+    echo
+    echo "(llc not found; llc times skipped)"
+fi
+
+popd > /dev/null  # $root_dir
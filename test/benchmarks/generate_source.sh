@@ -0,0 +1,47 @@
+#! /bin/bash
+
+# Print a large, machine-generated CSTR translation unit on stdout.
+#
+#   usage: generate_source.sh [functions] [statements per function]
+#
+# The generated code only uses constructs that bin/compiler supports, so it can
+# be fed to it directly (no preprocessing needed).
+
+functions=${1:-1000}
+statements=${2:-200}
+
+awk -v functions=$functions -v statements=$statements '
+BEGIN {
+    print "extern int printd(int i);"
+    print ""
+    for (f = 0; f < functions; ++f) {
+        printf "int f%d(int a, int b) {\n", f
+        print "    int x;"
+        print "    int y;"
+        print "    x = a;"
+        print "    y = b;"
+        for (s = 0; s < statements; ++s) {
+            if (s % 4 == 0) {
+                printf "    x = x + y * %d - (a << 1);\n", s
+            } else if (s % 4 == 1) {
+                printf "    if (x > %d) y = y - 1; else y = y + x %% 7;\n", s
+            } else if (s % 4 == 2) {
+                printf "    while (y > %d) y = y - 3;\n", s * 10
+            } else {
+                printf "    y = (x >> 2) + %d;\n", s
+            }
+        }
+        print "    return x + y;"
+        print "}"
+        print ""
+    }
+    print "int main() {"
+    print "    int total;"
+    print "    total = 0;"
+    for (f = 0; f < functions; f += 100) {
+        printf "    total = total + f%d(%d, 3);\n", f, f
+    }
+    print "    printd(total);"
+    print "    return 0;"
+    print "}"
+}'
@@ -0,0 +1,52 @@
+#! /bin/bash
+
+# Compare the two IR emission paths of bin/compiler on a large generated input:
+#
+#   --flush=line      every line is written and flushed on its own (the
+#                     behaviour of the std::endl based emitter)
+#   --flush=function  IR is collected in output::Output_Buffer and written once
+#                     per function
+#
+#   usage: ir_emission.sh [functions] [statements per function]
+#
+# Reports real/user/sys time, MB/s of IR emitted and, when strace is
+# available, the number of write syscalls.
+
+root_dir=$(cd `dirname $0`/../..; pwd)
+pushd $root_dir > /dev/null
+
+work_dir=$(mktemp -d)
+trap "rm -rf $work_dir" EXIT
+
+bash test/benchmarks/generate_source.sh ${1:-1000} ${2:-200} > $work_dir/input.c
+echo "input: $(wc -c < $work_dir/input.c) bytes"
+echo
+
+for mode in line function
+do
+    TIMEFORMAT="%R %U %S"
+    times=( $( { time bin/compiler --flush=$mode \
+        < $work_dir/input.c > $work_dir/output.ll ; } 2>&1 ) )
+
+    bytes=$(wc -c < $work_dir/output.ll)
+    mb_per_s=$(awk "BEGIN { print $bytes / 1048576 / ${times[0]} }")
+
+    printf "  --flush=%-8s  %7.3f s real %7.3f s user %7.3f s sys  %8.2f MB/s of IR" \
+        $mode ${times[0]} ${times[1]} ${times[2]} $mb_per_s
+
+    if command -v strace > /dev/null
+    then
+        writes=$(strace -f -c -e trace=write bin/compiler --flush=$mode \
+            < $work_dir/input.c 2>&1 > /dev/null | awk '$NF == "write" { print $4 }')
+        printf "  %8d write syscalls" ${writes:-0}
+    fi
+    echo
+done
+
+if ! command -v strace > /dev/null
+then
+    echo
+    echo "(strace not found; write syscall counts skipped)"
+fi
+
+popd > /dev/null  # $root_dir
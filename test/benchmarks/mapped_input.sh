@@ -0,0 +1,44 @@
+#! /bin/bash
+
+# Compare the two input paths of bin/preprocessor on a large generated input:
+#
+#   stdin   Flex refills its buffer from std::cin, copying every chunk
+#   file    the input file is mapped into memory and scanned in place
+#           (input::Mapped_File)
+#
+#   usage: mapped_input.sh [functions] [statements per function]
+#
+# The default size generates a little over 300 MB of source. Reports
+# real/user/sys time and MB/s of input.
+
+root_dir=$(cd `dirname $0`/../..; pwd)
+pushd $root_dir > /dev/null
+
+work_dir=$(mktemp -d)
+trap "rm -rf $work_dir" EXIT
+
+bash test/benchmarks/generate_source.sh ${1:-50000} ${2:-200} > $work_dir/input.c
+bytes=$(wc -c < $work_dir/input.c)
+echo "input: $bytes bytes"
+echo
+
+# Read the input once so that both runs find it in the page cache.
+cat $work_dir/input.c > /dev/null
+
+for mode in stdin file
+do
+    TIMEFORMAT="%R %U %S"
+    if [ $mode = stdin ]
+    then
+        times=( $( { time bin/preprocessor < $work_dir/input.c > /dev/null ; } 2>&1 ) )
+    else
+        times=( $( { time bin/preprocessor $work_dir/input.c > /dev/null ; } 2>&1 ) )
+    fi
+
+    mb_per_s=$(awk "BEGIN { print $bytes / 1048576 / ${times[0]} }")
+
+    printf "  %-5s  %7.3f s real %7.3f s user %7.3f s sys  %8.2f MB/s of source\n" \
+        $mode ${times[0]} ${times[1]} ${times[2]} $mb_per_s
+done
+
+popd > /dev/null  # $root_dir
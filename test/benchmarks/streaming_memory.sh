@@ -0,0 +1,54 @@
+#! /bin/bash
+
+# Check that bin/compiler compiles in bounded memory: generates inputs of
+# growing numbers of functions of the same size, and reports the peak heap
+# usage (--mem-report) of each, in the default mode, where a function's nodes,
+# symbols and scopes are released once its code is generated, and with
+# --whole-module, which keeps the whole translation unit.
+#
+#   usage: streaming_memory.sh [statements per function]
+#
+# The peak of the default mode should not grow with the number of functions
+# beyond the signatures of the functions (a few hundred bytes each), which stay
+# resident. Reports the peak resident set size too, when /usr/bin/time is
+# available.
+
+root_dir=$(cd `dirname $0`/../..; pwd)
+pushd $root_dir > /dev/null
+
+statements=${1:-50}
+
+work_dir=$(mktemp -d)
+trap "rm -rf $work_dir" EXIT
+
+# Peak heap of every pool together, in KiB, from the --mem-report of a run.
+peak_kib () {
+    awk '$1 == "total" { print $3 }'
+}
+
+printf "  %-10s  %12s  %22s  %22s\n" "functions" "input (MB)" "peak heap (KiB)" "--whole-module (KiB)"
+for functions in 500 2000 8000
+do
+    bash test/benchmarks/generate_source.sh $functions $statements > $work_dir/input.c
+    input_mb=$(awk "BEGIN { print $(wc -c < $work_dir/input.c) / 1048576 }")
+
+    streaming=$(bin/compiler --mem-report < $work_dir/input.c 2>&1 > /dev/null | peak_kib)
+    whole=$(bin/compiler --mem-report --whole-module < $work_dir/input.c 2>&1 > /dev/null | peak_kib)
+
+    printf "  %-10d  %12.1f  %22s  %22s" $functions $input_mb $streaming $whole
+
+    if [ -x /usr/bin/time ]
+    then
+        rss=$( { /usr/bin/time -f "%M" bin/compiler < $work_dir/input.c > /dev/null ; } 2>&1 )
+        printf "  %8s KiB max RSS" $rss
+    fi
+    echo
+done
+
+if [ ! -x /usr/bin/time ]
+then
+    echo
+    echo "(/usr/bin/time not found; resident set sizes skipped)"
+fi
+
+popd > /dev/null  # $root_dir
@@ -10,6 +10,7 @@ test_cases=(
     # 'div'  # compiles
     # 'erato'
     'expr'
+    'fold'
     # 'expr_temp'
     'functions'
     # 'loops'  # segmentation fault
@@ -44,9 +45,15 @@ mkdir test/test_cases.gcc
 
 echo "running integeration tests (test/test_cases):"
 
+# Each test case is compiled to textual IR, to bitcode and to assembly, and
+# run in-process by the compiler, as machine code and as bytecode. O2 is
+# textual IR again, after the passes of -O2. ast is written as an AST image,
+# which is then compiled instead of the source.
+for format in ll bc asm run vm O2 ast
+do
 for t in ${test_cases[@]}
 do
-    echo -n "  ${t}.c ..."
+    echo -n "  ${t}.c (${format}) ..."
 
     (
         # If any stage of the compilation fails, this will cause the script to
@@ -57,14 +64,36 @@ do
         gcc -o test/test_cases.gcc/${t}.s -S -D GCC test/test_cases/${t}.c -Wno-format-security
         gcc -o test/test_cases.gcc/${t} test/test_cases.gcc/${t}.s test/lib/lib.o
 
-        # Compile with cstr.
-        cpp test/test_cases/${t}.c | bin/compiler > test/test_cases.cstr/${t}.ll
-        llc test/test_cases.cstr/${t}.ll -o test/test_cases.cstr/${t}.s
-        gcc -o test/test_cases.cstr/${t} test/test_cases.cstr/${t}.s test/lib/lib.o build/string_lib.o
-
         # Run gcc version.
         test/test_cases.gcc/${t} > test/test_cases.gcc/${t}.stdout 2> test/test_cases.gcc/${t}.stderr
 
+        # Compile with cstr, and run.
+        if [ "${format}" == "run" ]
+        then
+            cpp test/test_cases/${t}.c | bin/compiler --run > test/test_cases.cstr/${t}.stdout 2> test/test_cases.cstr/${t}.stderr
+            exit
+        elif [ "${format}" == "vm" ]
+        then
+            cpp test/test_cases/${t}.c | bin/compiler --run=vm > test/test_cases.cstr/${t}.stdout 2> test/test_cases.cstr/${t}.stderr
+            exit
+        elif [ "${format}" == "asm" ]
+        then
+            cpp test/test_cases/${t}.c | bin/compiler --emit=asm > test/test_cases.cstr/${t}.s
+        elif [ "${format}" == "O2" ]
+        then
+            cpp test/test_cases/${t}.c | bin/compiler -O2 > test/test_cases.cstr/${t}.ll
+            llc test/test_cases.cstr/${t}.ll -o test/test_cases.cstr/${t}.s
+        elif [ "${format}" == "ast" ]
+        then
+            cpp test/test_cases/${t}.c | bin/compiler --emit=ast > test/test_cases.cstr/${t}.ast
+            bin/compiler test/test_cases.cstr/${t}.ast
+            llc test/test_cases.cstr/${t}.ll -o test/test_cases.cstr/${t}.s
+        else
+            cpp test/test_cases/${t}.c | bin/compiler --emit=${format} > test/test_cases.cstr/${t}.${format}
+            llc test/test_cases.cstr/${t}.${format} -o test/test_cases.cstr/${t}.s
+        fi
+        gcc -o test/test_cases.cstr/${t} test/test_cases.cstr/${t}.s test/lib/lib.o build/string_lib.o
+
         # Run cstr version.
         test/test_cases.cstr/${t} > test/test_cases.cstr/${t}.stdout 2> test/test_cases.cstr/${t}.stderr
     )
@@ -83,5 +112,67 @@ do
         echo -e " ${RED}FAILED${NC} - stdout does not match"
     fi
 done
+done
+
+# Machine-generated sources: an expression of 100000 terms and 100000 nested
+# instructions, which must neither overflow the stack of the compiler nor
+# take more than linear time. main returns 42.
+echo "running deep nesting tests:"
+deep=test/test_cases.cstr/deep.c
+{
+    echo "int main() {"
+    echo "    int a;"
+    echo "    a = 1;"
+    echo -n "    a = a"
+    for i in $(seq 100000); do echo -n " + a"; done
+    echo " - 99960;"
+    for i in $(seq 100000); do echo -n "if (a > 0) "; done
+    echo "a = a + 1;"
+    echo "    return a;"
+    echo "}"
+} > ${deep}
+# Blocks nested 5000 deep, each declaring a variable that shadows the one of
+# the enclosing block.
+scopes=test/test_cases.cstr/scopes.c
+{
+    echo "int g;"
+    echo "int main() {"
+    echo "    int a;"
+    echo "    g = 0;"
+    for i in $(seq 5000); do echo "{ int a; a = 1; g = g + a;"; done
+    for i in $(seq 5000); do echo -n "} "; done
+    echo
+    echo "    return g - 4958;"
+    echo "}"
+} > ${scopes}
+for source in ${deep} ${scopes}
+do
+    for format in ll bc asm O2 run vm ast
+    do
+        echo -n "  $(basename ${source}) (${format}) ..."
+        case ${format} in
+            run) options="--run" ;;
+            vm)  options="--run=vm" ;;
+            O2)  options="-O2" ;;
+            *)   options="--emit=${format}" ;;
+        esac
+        if [ "${format}" == "ast" ]
+        then
+            # Written as an image, which is then loaded and run.
+            bin/compiler ${options} < ${source} > ${source%.c}.ast 2> ${source%.c}.stderr &&
+                bin/compiler --run ${source%.c}.ast > /dev/null 2>> ${source%.c}.stderr
+        else
+            bin/compiler ${options} < ${source} > /dev/null 2> ${source%.c}.stderr
+        fi
+        status=$?
+        if [ "${format}" != "run" -a "${format}" != "vm" -a "${format}" != "ast" -a "${status}" == "0" ] ||
+           [ "${status}" == "42" ]
+        then
+            echo -e " ${GREEN}GOOD${NC}"
+        else
+            echo -e " ${RED}FAILED${NC} - exit status ${status}"
+        fi
+    done
+done
 
 popd > /dev/null  # $root_dir
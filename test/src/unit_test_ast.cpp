@@ -2,6 +2,8 @@
 #include "catch.hpp"
 #include "symbol.hpp"
 
+#include <cstdint>
+#include <cstring>
 #include <sstream>
 #include <vector>
 
@@ -14,17 +16,13 @@
 #undef protected
 #undef private
 
-
-void reset () {
-    llvm::Label::id_factory_.reset();
-    // llvm::String::id_factory_.reset();
-    // ast::Nonterminal::id_factory_.reset();
-
-}
+#include "ast_image.hpp"
+#include "symbol_table.hpp"
 
 
 TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
-    reset();
+    // NOTE: Label ids are numbered per generator, so every section starts
+    //       again from Label_0.
     std::string expected_output;
     std::ostringstream output_stream;
 
@@ -119,7 +117,7 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
         expected_output = std::string("ret i32 0\n");
 
         // Expression - Const_Integer
-        ast::Const_Integer::Ptr const_integer = std::make_shared<ast::Const_Integer>(std::move(0));
+        ast::Const_Integer const_integer = ast::make<ast::Const_Integer>(std::move(0));
 
         // Return_Instruction
         ast::Return_Instruction::Ptr return_instruction = std::make_shared<ast::Return_Instruction>(const_integer);
@@ -141,7 +139,7 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
         // Expression - Variable
         parser::Symbol::Ptr symbol_1 = std::make_shared<parser::Symbol>(std::move("a"));
         symbol_1->type(parser::Type::INT);
-        ast::Variable::Ptr variable_1 = std::make_shared<ast::Variable>(symbol_1);
+        ast::Variable variable_1 = ast::make<ast::Variable>(symbol_1);
 
         // Return_Instruction
         ast::Return_Instruction::Ptr return_instruction_1 = std::make_shared<ast::Return_Instruction>(variable_1);
@@ -158,14 +156,14 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
 
         parser::Symbol::Ptr symbol = std::make_shared<parser::Symbol>(std::move("i"));
         symbol->type(parser::Type::INT);
-        ast::Variable::Ptr variable = std::make_shared<ast::Variable>(symbol);
+        ast::Variable variable = ast::make<ast::Variable>(symbol);
 
-        ast::Const_Integer::Ptr const_integer_1 = std::make_shared<ast::Const_Integer>(std::move(1));
-        ast::Const_Integer::Ptr const_integer_2 = std::make_shared<ast::Const_Integer>(std::move(2));
+        ast::Const_Integer const_integer_1 = ast::make<ast::Const_Integer>(std::move(1));
+        ast::Const_Integer const_integer_2 = ast::make<ast::Const_Integer>(std::move(2));
 
-        ast::Binary_Expression::Ptr add_expression = std::make_shared<ast::Binary_Expression>(parser::Type::INT, ast::Operation::ADDITION, const_integer_1, const_integer_2);
+        ast::Binary_Expression add_expression = ast::make<ast::Binary_Expression>(parser::Type::INT, ast::Operation::ADDITION, const_integer_1, const_integer_2);
 
-        add_expression->emit_code(generator);
+        add_expression.emit_code(generator);
         REQUIRE (output_stream.str() == expected_output);
     }
 
@@ -181,7 +179,7 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
     //     // Expression - Variable
     //     parser::Symbol::Ptr symbol_2 = std::make_shared<parser::Symbol>(std::move("a"));
     //     symbol_2->type(parser::Type::STRING);
-    //     ast::Variable::Ptr variable_2 = std::make_shared<ast::Variable>(symbol_2);
+    //     ast::Variable variable_2 = ast::make<ast::Variable>(symbol_2);
 
     //     // Return_Instruction
     //     ast::Return_Instruction::Ptr return_instruction_2 = std::make_shared<ast::Return_Instruction>(variable_2);
@@ -205,13 +203,13 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
         // Expression - Variable
         parser::Symbol::Ptr symbol = std::make_shared<parser::Symbol>(std::move("a"));
         symbol->type(parser::Type::INT);
-        ast::Variable::Ptr variable = std::make_shared<ast::Variable>(symbol);
+        ast::Variable variable = ast::make<ast::Variable>(symbol);
 
-        ast::Const_Integer::Ptr const_integer_1 = std::make_shared<ast::Const_Integer>(std::move(1));
-        ast::Const_Integer::Ptr const_integer_2 = std::make_shared<ast::Const_Integer>(std::move(2));
+        ast::Const_Integer const_integer_1 = ast::make<ast::Const_Integer>(std::move(1));
+        ast::Const_Integer const_integer_2 = ast::make<ast::Const_Integer>(std::move(2));
 
-        ast::Binary_Expression::Ptr add_expression = std::make_shared<ast::Binary_Expression>(parser::Type::INT, ast::Operation::ADDITION, variable, const_integer_1);
-        ast::Binary_Expression::Ptr minus_expression = std::make_shared<ast::Binary_Expression>(parser::Type::INT, ast::Operation::SUBTRACTION, add_expression, const_integer_2);
+        ast::Binary_Expression add_expression = ast::make<ast::Binary_Expression>(parser::Type::INT, ast::Operation::ADDITION, variable, const_integer_1);
+        ast::Binary_Expression minus_expression = ast::make<ast::Binary_Expression>(parser::Type::INT, ast::Operation::SUBTRACTION, add_expression, const_integer_2);
 
         // Return_Instruction
         ast::Return_Instruction::Ptr return_instruction = std::make_shared<ast::Return_Instruction>(minus_expression);
@@ -234,22 +232,22 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
         // rhs
         parser::Symbol::Ptr symbol = std::make_shared<parser::Symbol>(std::move("i"));
         symbol->type(parser::Type::INT);
-        ast::Variable::Ptr variable = std::make_shared<ast::Variable>(symbol);
+        ast::Variable variable = ast::make<ast::Variable>(symbol);
 
         // lhs
-        ast::Const_Integer::Ptr const_integer = std::make_shared<ast::Const_Integer>(std::move(450));
+        ast::Const_Integer const_integer = ast::make<ast::Const_Integer>(std::move(450));
 
-        ast::Assignment::Ptr assignment = std::make_shared<ast::Assignment>(variable, const_integer);
+        ast::Assignment assignment = ast::make<ast::Assignment>(variable, const_integer);
 
-        assignment->emit_code(generator);
+        assignment.emit_code(generator);
         REQUIRE (output_stream.str() == expected_output);
     }
 
 
     SECTION ("Const String") {
         std::string expected_output_1 = "%str.0 = getelementptr inbounds [12 x i8]* @str.0, i32 0, i32 0\n";
-        ast::Const_String::Ptr const_string_1 = std::make_shared<ast::Const_String>(std::string("hello world"));
-        const_string_1->emit_code(generator);
+        ast::Const_String const_string_1 = ast::make<ast::Const_String>(std::string("hello world"));
+        const_string_1.emit_code(generator);
         REQUIRE (output_stream.str() == expected_output_1 );
     }
 
@@ -267,11 +265,11 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
     //     // rhs
     //     parser::Symbol::Ptr symbol = std::make_shared<parser::Symbol>(std::move("s"));
     //     symbol->type(parser::Type::STRING);
-    //     ast::Variable::Ptr variable = std::make_shared<ast::Variable>(symbol);
+    //     ast::Variable variable = ast::make<ast::Variable>(symbol);
     //     // lhs
-    //     ast::Const_String::Ptr const_string = std::make_shared<ast::Const_String>(std::string("hello world"));
+    //     ast::Const_String const_string = ast::make<ast::Const_String>(std::string("hello world"));
 
-    //     ast::Assignment::Ptr assignment = std::make_shared<ast::Assignment>(variable, const_string);
+    //     ast::Assignment assignment = ast::make<ast::Assignment>(variable, const_string);
 
     //     REQUIRE (assignment->emit_llvm_ir() == expected_output );
     // }
@@ -311,31 +309,31 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
         // create i
         parser::Symbol::Ptr symbol = std::make_shared<parser::Symbol>(std::move("i"));
         symbol->type(parser::Type::INT);
-        ast::Variable::Ptr variable = std::make_shared<ast::Variable>(symbol);
+        ast::Variable variable = ast::make<ast::Variable>(symbol);
 
         // -10
-        ast::Const_Integer::Ptr const_integer_1 = std::make_shared<ast::Const_Integer>(std::move(-10));
+        ast::Const_Integer const_integer_1 = ast::make<ast::Const_Integer>(std::move(-10));
 
         // i = -10 Assignment
-        ast::Assignment::Ptr initialization = std::make_shared<ast::Assignment>(variable, const_integer_1);
+        ast::Assignment initialization = ast::make<ast::Assignment>(variable, const_integer_1);
 
         // condition
         // i <= 10
         // 10
-        ast::Const_Integer::Ptr const_integer_2 = std::make_shared<ast::Const_Integer>(std::move(10));
+        ast::Const_Integer const_integer_2 = ast::make<ast::Const_Integer>(std::move(10));
 
         // i <= 10 Condition
-        ast::Condition::Ptr condition = std::make_shared<ast::Condition>(ast::Comparison_Operation::LESS_THAN_OR_EQUAL, variable, const_integer_2);
+        ast::Condition condition = ast::make<ast::Condition>(ast::Comparison_Operation::LESS_THAN_OR_EQUAL, variable, const_integer_2);
 
         // increment - Assignment with expression.
         // i = i + 1
         // 1
-        ast::Const_Integer::Ptr const_integer_3 = std::make_shared<ast::Const_Integer>(std::move(1));
+        ast::Const_Integer const_integer_3 = ast::make<ast::Const_Integer>(std::move(1));
         // i + 1
-        ast::Binary_Expression::Ptr add_expression = std::make_shared<ast::Binary_Expression>(parser::Type::INT, ast::Operation::ADDITION, variable, const_integer_3);
+        ast::Binary_Expression add_expression = ast::make<ast::Binary_Expression>(parser::Type::INT, ast::Operation::ADDITION, variable, const_integer_3);
 
         // i = i + 1
-        ast::Assignment::Ptr increment = std::make_shared<ast::Assignment>(variable, add_expression);
+        ast::Assignment increment = ast::make<ast::Assignment>(variable, add_expression);
 
         // instruction
         // It's the body of the loop. Only empty instruction, not multiply lines.
@@ -376,15 +374,16 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
         //
 
         std::string expected_output =
+            "; Define function 'foo'\n"
             "define i8* @foo() {\n"
             "entry:\n"
             "  %symbol_identifier = alloca i8*, align 8\n"
-            "  %str.0 = getelementptr inbounds [6 x i8]* @str.0, i32 0, i32 0\n"
-            "  store i8* %str.0, i8** %symbol_identifier\n"
+            "  %str.foo.0 = getelementptr inbounds [6 x i8]* @str.foo.0, i32 0, i32 0\n"
+            "  store i8* %str.foo.0, i8** %symbol_identifier\n"
             "  %symbol_identifier.1 = load i8*, i8** %symbol_identifier\n"
             "  ret i8* %symbol_identifier.1\n"
             "}\n"
-            "@str.0 = private unnamed_addr constant [6 x i8] c\"hello\\00\"\n"
+            "@str.foo.0 = private unnamed_addr constant [6 x i8] c\"hello\\00\"\n"
             "\n"
             ;
 
@@ -399,7 +398,7 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
         symbol->type(parser::Type::STRING);
 
         // ast variable
-        auto variable = std::make_shared<ast::Variable>(symbol);
+        auto variable = ast::make<ast::Variable>(symbol);
 
         auto function_definition = std::make_shared<ast::Function_Definition>(
             function_symbol->type(),
@@ -407,9 +406,9 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
             std::make_shared<ast::Compound_Instruction>(std::vector<ast::Instruction::Ptr> {
                 std::make_shared<ast::Declaration_List>(parser::Symbol_List {symbol}),
                 std::make_shared<ast::Expression_Instruction>(
-                    std::make_shared<ast::Assignment>(
+                    ast::make<ast::Assignment>(
                         variable,
-                        std::make_shared<ast::Const_String>("hello")
+                        ast::make<ast::Const_String>("hello")
                     )
                 ),
                 std::make_shared<ast::Return_Instruction>(variable)
@@ -451,19 +450,19 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
             "Label_2:\n"
             ;
 
-        ast::Const_Integer::Ptr const_integer_1 = std::make_shared<ast::Const_Integer>(std::move(-10));
-        ast::Const_Integer::Ptr const_integer_2 = std::make_shared<ast::Const_Integer>(std::move(10));
-        ast::Const_Integer::Ptr const_integer_3 = std::make_shared<ast::Const_Integer>(std::move(1));
-        ast::Const_Integer::Ptr const_integer_4 = std::make_shared<ast::Const_Integer>(std::move(-1));
+        ast::Const_Integer const_integer_1 = ast::make<ast::Const_Integer>(std::move(-10));
+        ast::Const_Integer const_integer_2 = ast::make<ast::Const_Integer>(std::move(10));
+        ast::Const_Integer const_integer_3 = ast::make<ast::Const_Integer>(std::move(1));
+        ast::Const_Integer const_integer_4 = ast::make<ast::Const_Integer>(std::move(-1));
 
-        ast::Condition::Ptr condition = std::make_shared<ast::Condition>(ast::Comparison_Operation::EQUAL, const_integer_1, const_integer_2);
+        ast::Condition condition = ast::make<ast::Condition>(ast::Comparison_Operation::EQUAL, const_integer_1, const_integer_2);
 
         parser::Symbol::Ptr symbol_1 = std::make_shared<parser::Symbol>(std::move("i"));
         symbol_1->type(parser::Type::INT);
-        ast::Variable::Ptr variable_1 = std::make_shared<ast::Variable>(symbol_1);
+        ast::Variable variable_1 = ast::make<ast::Variable>(symbol_1);
 
-        ast::Assignment::Ptr assignment_1 = std::make_shared<ast::Assignment>(variable_1, const_integer_3);
-        ast::Assignment::Ptr assignment_2 = std::make_shared<ast::Assignment>(variable_1, const_integer_4);
+        ast::Assignment assignment_1 = ast::make<ast::Assignment>(variable_1, const_integer_3);
+        ast::Assignment assignment_2 = ast::make<ast::Assignment>(variable_1, const_integer_4);
 
         ast::Expression_Instruction::Ptr instruction_1 = std::make_shared<ast::Expression_Instruction>(assignment_1);
         ast::Expression_Instruction::Ptr instruction_2 = std::make_shared<ast::Expression_Instruction>(assignment_2);
@@ -495,17 +494,17 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
             "Label_2:\n"
             ;
 
-        ast::Const_Integer::Ptr const_integer_1 = std::make_shared<ast::Const_Integer>(std::move(-10));
-        ast::Const_Integer::Ptr const_integer_2 = std::make_shared<ast::Const_Integer>(std::move(10));
-        ast::Const_Integer::Ptr const_integer_3 = std::make_shared<ast::Const_Integer>(std::move(1));
+        ast::Const_Integer const_integer_1 = ast::make<ast::Const_Integer>(std::move(-10));
+        ast::Const_Integer const_integer_2 = ast::make<ast::Const_Integer>(std::move(10));
+        ast::Const_Integer const_integer_3 = ast::make<ast::Const_Integer>(std::move(1));
 
-        ast::Condition::Ptr condition = std::make_shared<ast::Condition>(ast::Comparison_Operation::EQUAL, const_integer_1, const_integer_2);
+        ast::Condition condition = ast::make<ast::Condition>(ast::Comparison_Operation::EQUAL, const_integer_1, const_integer_2);
 
         parser::Symbol::Ptr symbol_1 = std::make_shared<parser::Symbol>(std::move("i"));
         symbol_1->type(parser::Type::INT);
-        ast::Variable::Ptr variable_1 = std::make_shared<ast::Variable>(symbol_1);
+        ast::Variable variable_1 = ast::make<ast::Variable>(symbol_1);
 
-        ast::Assignment::Ptr assignment_1 = std::make_shared<ast::Assignment>(variable_1, const_integer_3);
+        ast::Assignment assignment_1 = ast::make<ast::Assignment>(variable_1, const_integer_3);
         ast::Expression_Instruction::Ptr instruction_1 = std::make_shared<ast::Expression_Instruction>(assignment_1);
 
         ast::Cond_Instruction::Ptr cond_instruction_1 = std::make_shared<ast::Cond_Instruction>(condition, instruction_1);
@@ -542,15 +541,15 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
 
         parser::Symbol::Ptr symbol = std::make_shared<parser::Symbol>(std::move("i"));
         symbol->type(parser::Type::INT);
-        ast::Variable::Ptr variable = std::make_shared<ast::Variable>(symbol);
+        ast::Variable variable = ast::make<ast::Variable>(symbol);
 
-        ast::Const_Integer::Ptr const_integer_1 = std::make_shared<ast::Const_Integer>(std::move(10));
-        ast::Const_Integer::Ptr const_integer_2 = std::make_shared<ast::Const_Integer>(std::move(2));
+        ast::Const_Integer const_integer_1 = ast::make<ast::Const_Integer>(std::move(10));
+        ast::Const_Integer const_integer_2 = ast::make<ast::Const_Integer>(std::move(2));
 
-        ast::Condition::Ptr condition = std::make_shared<ast::Condition>(ast::Comparison_Operation::LESS_THAN, variable, const_integer_1);
+        ast::Condition condition = ast::make<ast::Condition>(ast::Comparison_Operation::LESS_THAN, variable, const_integer_1);
 
-        ast::Binary_Expression::Ptr add_expression = std::make_shared<ast::Binary_Expression>(parser::Type::INT, ast::Operation::ADDITION, variable, const_integer_2);
-        ast::Assignment::Ptr assignment_1 = std::make_shared<ast::Assignment>(variable, add_expression);
+        ast::Binary_Expression add_expression = ast::make<ast::Binary_Expression>(parser::Type::INT, ast::Operation::ADDITION, variable, const_integer_2);
+        ast::Assignment assignment_1 = ast::make<ast::Assignment>(variable, add_expression);
         ast::Expression_Instruction::Ptr instruction_1 = std::make_shared<ast::Expression_Instruction>(assignment_1);
 
         ast::While_Instruction::Ptr while_instruction = std::make_shared<ast::While_Instruction>(condition, instruction_1);
@@ -586,15 +585,15 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
 
         parser::Symbol::Ptr symbol = std::make_shared<parser::Symbol>(std::move("i"));
         symbol->type(parser::Type::INT);
-        ast::Variable::Ptr variable = std::make_shared<ast::Variable>(symbol);
+        ast::Variable variable = ast::make<ast::Variable>(symbol);
 
-        ast::Const_Integer::Ptr const_integer_1 = std::make_shared<ast::Const_Integer>(std::move(10));
-        ast::Const_Integer::Ptr const_integer_2 = std::make_shared<ast::Const_Integer>(std::move(2));
+        ast::Const_Integer const_integer_1 = ast::make<ast::Const_Integer>(std::move(10));
+        ast::Const_Integer const_integer_2 = ast::make<ast::Const_Integer>(std::move(2));
 
-        ast::Condition::Ptr condition = std::make_shared<ast::Condition>(ast::Comparison_Operation::LESS_THAN, variable, const_integer_1);
+        ast::Condition condition = ast::make<ast::Condition>(ast::Comparison_Operation::LESS_THAN, variable, const_integer_1);
 
-        ast::Binary_Expression::Ptr add_expression = std::make_shared<ast::Binary_Expression>(parser::Type::INT, ast::Operation::ADDITION, variable, const_integer_2);
-        ast::Assignment::Ptr assignment_1 = std::make_shared<ast::Assignment>(variable, add_expression);
+        ast::Binary_Expression add_expression = ast::make<ast::Binary_Expression>(parser::Type::INT, ast::Operation::ADDITION, variable, const_integer_2);
+        ast::Assignment assignment_1 = ast::make<ast::Assignment>(variable, add_expression);
         ast::Expression_Instruction::Ptr instruction_1 = std::make_shared<ast::Expression_Instruction>(assignment_1);
 
         ast::Do_Instruction::Ptr do_instruction = std::make_shared<ast::Do_Instruction>(condition, instruction_1);
@@ -609,17 +608,17 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
         expected_output = "store i32 -10, i32* %i\n";
         expected_output += "store i32 10, i32* %i\n";
 
-        ast::Const_Integer::Ptr const_integer_1 = std::make_shared<ast::Const_Integer>(std::move(-10));
-        ast::Const_Integer::Ptr const_integer_2 = std::make_shared<ast::Const_Integer>(std::move(10));
+        ast::Const_Integer const_integer_1 = ast::make<ast::Const_Integer>(std::move(-10));
+        ast::Const_Integer const_integer_2 = ast::make<ast::Const_Integer>(std::move(10));
 
-        ast::Condition::Ptr condition = std::make_shared<ast::Condition>(ast::Comparison_Operation::EQUAL, const_integer_1, const_integer_2);
+        ast::Condition condition = ast::make<ast::Condition>(ast::Comparison_Operation::EQUAL, const_integer_1, const_integer_2);
 
         parser::Symbol::Ptr symbol_1 = std::make_shared<parser::Symbol>(std::move("i"));
         symbol_1->type(parser::Type::INT);
-        ast::Variable::Ptr variable_1 = std::make_shared<ast::Variable>(symbol_1);
+        ast::Variable variable_1 = ast::make<ast::Variable>(symbol_1);
 
-        ast::Assignment::Ptr assignment_1 = std::make_shared<ast::Assignment>(variable_1, const_integer_1);
-        ast::Assignment::Ptr assignment_2 = std::make_shared<ast::Assignment>(variable_1, const_integer_2);
+        ast::Assignment assignment_1 = ast::make<ast::Assignment>(variable_1, const_integer_1);
+        ast::Assignment assignment_2 = ast::make<ast::Assignment>(variable_1, const_integer_2);
 
         ast::Expression_Instruction::Ptr instruction_1 = std::make_shared<ast::Expression_Instruction>(assignment_1);
         ast::Expression_Instruction::Ptr instruction_2 = std::make_shared<ast::Expression_Instruction>(assignment_2);
@@ -650,19 +649,19 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
         parser::Function::Ptr function = std::make_shared<parser::Function>(std::move("foo"));
         function->type(parser::Type::INT);
 
-        ast::Const_Integer::Ptr const_integer_1 = std::make_shared<ast::Const_Integer>(std::move(2));
-        ast::Const_Integer::Ptr const_integer_2 = std::make_shared<ast::Const_Integer>(std::move(4));
-        ast::Const_String::Ptr const_string_1 = std::make_shared<ast::Const_String>(std::string("hello world"));
+        ast::Const_Integer const_integer_1 = ast::make<ast::Const_Integer>(std::move(2));
+        ast::Const_Integer const_integer_2 = ast::make<ast::Const_Integer>(std::move(4));
+        ast::Const_String const_string_1 = ast::make<ast::Const_String>(std::string("hello world"));
 
 
-        std::vector<ast::Expression::Ptr> argument_list;
+        std::vector<ast::Expression> argument_list;
         argument_list.push_back(const_integer_1);
         argument_list.push_back(const_integer_2);
         argument_list.push_back(const_string_1);
 
-        ast::Function_Call::Ptr function_call = std::make_shared<ast::Function_Call>(function, argument_list);
+        ast::Function_Call function_call = ast::make<ast::Function_Call>(function, argument_list);
 
-        function_call->emit_code(generator);
+        function_call.emit_code(generator);
         REQUIRE (output_stream.str() == expected_output);
     }
 
@@ -673,15 +672,14 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
         // A constant integer should have no prep-work and no inline execution.
         // It is only referenced by others.
 
-        ast::Const_Integer::Ptr const_integer_1 = std::make_shared<ast::Const_Integer>(std::move(2));
+        ast::Const_Integer const_integer_1 = ast::make<ast::Const_Integer>(std::move(2));
 
-        const_integer_1->emit_code(generator);
+        const_integer_1.emit_code(generator);
         REQUIRE (output_stream.str() == "");
         REQUIRE (generator.register_reference_.size() == 1);
 
-        auto iter = std::begin(generator.register_reference_);
-        REQUIRE (iter->first == const_integer_1);
-        REQUIRE (iter->second == "2");
+        REQUIRE (generator.register_reference_.find(const_integer_1) != nullptr);
+        REQUIRE (llvm::to_string(*generator.register_reference_.find(const_integer_1)) == "2");
     }
 
     SECTION ( "Unary_Expression" ) {
@@ -695,11 +693,96 @@ TEST_CASE ("Generate LLVM --from-- Abstract Syntax Tree") {
 
         parser::Symbol::Ptr symbol_1 = std::make_shared<parser::Symbol>(std::move("a"));
         symbol_1->type(parser::Type::INT);
-        ast::Variable::Ptr variable_1 = std::make_shared<ast::Variable>(symbol_1);
+        ast::Variable variable_1 = ast::make<ast::Variable>(symbol_1);
 
-        ast::Unary_Expression::Ptr unary_expression = std::make_shared<ast::Unary_Expression>(variable_1);
+        ast::Unary_Expression unary_expression = ast::make<ast::Unary_Expression>(variable_1);
 
-        unary_expression->emit_code(generator);
+        unary_expression.emit_code(generator);
         REQUIRE (output_stream.str() == expected_output);
     }
 }
+
+
+TEST_CASE ("Load an AST image back") {
+    // int twice(int a) {
+    //   int b;
+    //   b = a * 2;
+    //   if (b > 10) b = b - twice(1);
+    //   return b;
+    // }
+
+    ast::Store_Scope expressions;
+    expressions.open();
+
+    auto twice = std::make_shared<parser::Function>("twice");
+    twice->type(parser::Type::INT);
+    auto a = std::make_shared<parser::Symbol>("a");
+    a->type(parser::Type::INT);
+    a->set(parser::Symbol::Attribute::FUNCTION_PARAM);
+    twice->argument_list().push_back(a);
+    auto b = std::make_shared<parser::Symbol>("b");
+    b->type(parser::Type::INT);
+
+    auto definition = std::make_shared<ast::Function_Definition>(
+        parser::Type::INT,
+        twice,
+        std::make_shared<ast::Compound_Instruction>(std::vector<ast::Instruction::Ptr> {
+            std::make_shared<ast::Declaration_List>(parser::Symbol_List {b}),
+            std::make_shared<ast::Expression_Instruction>(
+                ast::make<ast::Assignment>(
+                    ast::make<ast::Variable>(b),
+                    ast::make<ast::Binary_Expression>(parser::Type::INT, ast::Operation::MULTIPLICATION,
+                        ast::make<ast::Variable>(a), ast::make<ast::Const_Integer>(2))
+                )
+            ),
+            std::make_shared<ast::Cond_Instruction>(
+                ast::make<ast::Condition>(ast::Comparison_Operation::GREATER_THAN,
+                    ast::make<ast::Variable>(b), ast::make<ast::Const_Integer>(10)),
+                std::make_shared<ast::Expression_Instruction>(
+                    ast::make<ast::Assignment>(
+                        ast::make<ast::Variable>(b),
+                        ast::make<ast::Binary_Expression>(parser::Type::INT, ast::Operation::SUBTRACTION,
+                            ast::make<ast::Variable>(b),
+                            ast::make<ast::Function_Call>(twice,
+                                std::vector<ast::Expression> {ast::make<ast::Const_Integer>(1)}))
+                    )
+                )
+            ),
+            std::make_shared<ast::Return_Instruction>(ast::make<ast::Variable>(b))
+        })
+    );
+    definition->cache_key("key");
+
+    ast::Module module;
+    module.visit(*definition);
+    auto symbol_table = parser::Symbol_Table::construct("global scope", parser::location());
+    symbol_table->add(twice->atom(), twice);
+
+    std::ostringstream out;
+    ast_image::write(module, *symbol_table, out);
+    std::string bytes = out.str();
+    std::vector<std::uint64_t> image ((bytes.size() + 7) / 8);
+    std::memcpy(image.data(), bytes.data(), bytes.size());
+    const char* data = reinterpret_cast<const char*>(image.data());
+    REQUIRE (ast_image::is_image(data, bytes.size()));
+
+    ast::Module loaded;
+    auto loaded_symbol_table = ast_image::load(data, bytes.size(), loaded);
+    REQUIRE (loaded.nodes().size() == 1);
+    auto copy = std::dynamic_pointer_cast<ast::Function_Definition>(loaded.nodes()[0]);
+    REQUIRE (copy);
+    REQUIRE (copy->cache_key() == "key");
+    REQUIRE (copy->function_declarator()->name() == "twice");
+    REQUIRE (copy->function_declarator()->argument_list().size() == 1);
+    REQUIRE (copy->function_declarator()->argument_list()[0]->get(parser::Symbol::Attribute::FUNCTION_PARAM));
+    REQUIRE (loaded_symbol_table->lookup(atom::intern("twice")) == copy->function_declarator());
+
+    std::ostringstream expected_output, output;
+    llvm::LLVM_Generator expected_generator(expected_output), generator(output);
+    definition->emit_code(expected_generator);
+    copy->emit_code(generator);
+    REQUIRE (output.str() == expected_output.str());
+
+    ast::Module truncated;
+    REQUIRE_THROWS (ast_image::load(data, bytes.size() / 2, truncated));
+}
@@ -376,7 +376,7 @@ TEST_CASE ("scanner::Scanner recognizes lexemes") {
         auto tok = scanner.lex(&value, &location);
 
         REQUIRE (tok == token::IDENT);
-        REQUIRE (value.as<std::string>() == input_value);
+        REQUIRE (value.as<atom::Atom>().str() == input_value);
         REQUIRE (output.str() == "");
 
         REQUIRE (location.begin == initial_position);
@@ -0,0 +1,30 @@
+int printd( int i );
+
+int scale( int n ) {
+  int width, height, area, unused;
+  width = 16;
+  height = width * 4 + 1;
+  area = width * height;
+  if ( width > 8 ) printd(area); else printd(0);
+  if ( height < 8 ) printd(0);
+  while ( width == 0 ) printd(0);
+  unused = 3;
+  if ( n > 0 ) unused = 4;
+  while ( n > area ) n = n - height;
+  return n + unused;
+}
+
+int main() {
+  int i;
+  i = 7;
+  printd(3 + 4 * 5);
+  printd((1 << 10) - 1);
+  printd(-7 >> 1);
+  printd(-(2 - 9));
+  printd(100 / 7 + 100 % 7);
+  printd(-100 % 7);
+  printd(i * 6 + 1);
+  printd(scale(5000));
+  printd(scale(-3));
+  return 0;
+}